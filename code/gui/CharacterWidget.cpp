@@ -5,11 +5,14 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <charconv>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "events.h"
+#include "frame_arena.h"
+#include "frame_profiler.h"
 #include "imgui.h"
 #include "imgui_internal.h"
 
@@ -45,66 +48,81 @@ bool IsCharacterWindowFocused() {
                                   ImGuiFocusedFlags_NoPopupHierarchy);
 }
 
-std::string TrimCopy(const std::string& value) {
+// Key the row rects are recorded under: "<tab id>:<row index>"
+template <typename String>
+void BuildRowId(String& out, const std::string& tab_id, size_t row_index) {
+    out.assign(tab_id.data(), tab_id.size());
+    out.push_back(':');
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), row_index);
+    out.append(digits, result.ptr);
+}
+
+std::string_view Trim(std::string_view value) {
     const auto first = value.find_first_not_of(" \t");
-    if (first == std::string::npos) {
-        return std::string();
+    if (first == std::string_view::npos) {
+        return std::string_view();
     }
     const auto last = value.find_last_not_of(" \t");
     return value.substr(first, last - first + 1);
 }
 
-std::string ToUpperCopy(const std::string& value) {
-    std::string result;
-    result.reserve(value.size());
-    for (char ch : value) {
-        result.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(ch))));
+// Compares against an upper-case name without building an upper-case copy
+bool EqualsUpper(std::string_view value, std::string_view upper) {
+    if (value.size() != upper.size()) {
+        return false;
     }
-    return result;
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(value[i])) != static_cast<unsigned char>(upper[i])) {
+            return false;
+        }
+    }
+    return true;
 }
 
-std::vector<std::string> SplitBindingTokens(const std::string& binding) {
-    std::vector<std::string> tokens;
-    std::string current;
-    for (char ch : binding) {
-        if (ch == '+') {
-            tokens.push_back(TrimCopy(current));
-            current.clear();
-        } else {
-            current.push_back(ch);
+// Tokens view into binding, which must outlive them
+FrameVector<std::string_view> SplitBindingTokens(std::string_view binding) {
+    FrameVector<std::string_view> tokens;
+    size_t start = 0;
+    while (true) {
+        const size_t end = binding.find('+', start);
+        if (end == std::string_view::npos) {
+            tokens.push_back(Trim(binding.substr(start)));
+            return tokens;
         }
+        tokens.push_back(Trim(binding.substr(start, end - start)));
+        start = end + 1;
     }
-    tokens.push_back(TrimCopy(current));
-    return tokens;
 }
 
-SDL_Keycode LookupKeycode(const std::string& token) {
+SDL_Keycode LookupKeycode(std::string_view token) {
     if (token.empty()) {
         return SDLK_UNKNOWN;
     }
 
-    SDL_Keycode keycode = SDL_GetKeyFromName(token.c_str());
+    // SDL wants a terminated name; the copy lives in the frame arena
+    const FrameString name(token.data(), token.size());
+    SDL_Keycode keycode = SDL_GetKeyFromName(name.c_str());
     if (keycode != SDLK_UNKNOWN) {
         return keycode;
     }
 
-    const std::string upper = ToUpperCopy(token);
-    if (upper == "ESC" || upper == "ESCAPE") {
+    if (EqualsUpper(token, "ESC") || EqualsUpper(token, "ESCAPE")) {
         return SDLK_ESCAPE;
     }
-    if (upper == "ENTER" || upper == "RETURN") {
+    if (EqualsUpper(token, "ENTER") || EqualsUpper(token, "RETURN")) {
         return SDLK_RETURN;
     }
-    if (upper == "SPACE" || upper == "SPACEBAR") {
+    if (EqualsUpper(token, "SPACE") || EqualsUpper(token, "SPACEBAR")) {
         return SDLK_SPACE;
     }
-    if (upper == "DEL" || upper == "DELETE") {
+    if (EqualsUpper(token, "DEL") || EqualsUpper(token, "DELETE")) {
         return SDLK_DELETE;
     }
-    if (upper == "PGUP" || upper == "PAGEUP") {
+    if (EqualsUpper(token, "PGUP") || EqualsUpper(token, "PAGEUP")) {
         return SDLK_PAGEUP;
     }
-    if (upper == "PGDN" || upper == "PAGEDOWN") {
+    if (EqualsUpper(token, "PGDN") || EqualsUpper(token, "PAGEDOWN")) {
         return SDLK_PAGEDOWN;
     }
 
@@ -130,24 +148,24 @@ ParsedBinding ParseBinding(const std::string& binding) {
     }
 
     const auto tokens = SplitBindingTokens(binding);
-    for (const auto& token : tokens) {
+    for (const std::string_view token : tokens) {
         if (token.empty()) {
             continue;
         }
-        const std::string upper = ToUpperCopy(token);
-        if (upper == "SHIFT") {
+        if (EqualsUpper(token, "SHIFT")) {
             parsed.require_shift = true;
             continue;
         }
-        if (upper == "CTRL" || upper == "CONTROL" || upper == "CTL") {
+        if (EqualsUpper(token, "CTRL") || EqualsUpper(token, "CONTROL") || EqualsUpper(token, "CTL")) {
             parsed.require_ctrl = true;
             continue;
         }
-        if (upper == "ALT") {
+        if (EqualsUpper(token, "ALT")) {
             parsed.require_alt = true;
             continue;
         }
-        if (upper == "GUI" || upper == "META" || upper == "WIN" || upper == "SUPER") {
+        if (EqualsUpper(token, "GUI") || EqualsUpper(token, "META") || EqualsUpper(token, "WIN") ||
+            EqualsUpper(token, "SUPER")) {
             parsed.require_gui = true;
             continue;
         }
@@ -225,6 +243,30 @@ void DrawInfoPanel(std::string_view text) {
         start = end + 1;
     }
 }
+
+// Same layout as ImGui::TextUnformatted(), but with the size measured once per
+// tab content change instead of every frame, and the color passed straight to
+// the draw list instead of through the style stack.
+void DrawMeasuredText(const std::string& text, const ImVec2& size, ImU32 color) {
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (window->SkipItems) {
+        return;
+    }
+    const ImVec2 pos(window->DC.CursorPos.x, window->DC.CursorPos.y + window->DC.CurrLineTextBaseOffset);
+    const ImRect bb(pos, ImVec2(pos.x + size.x, pos.y + size.y));
+    ImGui::ItemSize(size, 0.0f);
+    if (!ImGui::ItemAdd(bb, 0)) {
+        return;
+    }
+    window->DrawList->AddText(pos, color, text.c_str(), text.c_str() + text.size());
+}
+
+void ShowTooltip(const std::string& text) {
+    if (ImGui::BeginTooltip()) {
+        ImGui::TextUnformatted(text.c_str(), text.c_str() + text.size());
+        ImGui::EndTooltip();
+    }
+}
 } // namespace
 
 CharacterWidget::CharacterWidget(cataclysm::gui::EventBusAdapter& event_bus_adapter)
@@ -234,9 +276,12 @@ CharacterWidget::CharacterWidget(cataclysm::gui::EventBusAdapter& event_bus_adap
 CharacterWidget::~CharacterWidget() = default;
 
 void CharacterWidget::Draw(const character_overlay_state& state) {
-    tab_rects_.clear();
-    row_rects_.clear();
-    command_button_rects_.clear();
+    GUI_PROFILE_ZONE("CharacterWidget::Draw");
+    tab_rects_.BeginLayout();
+    row_rects_.BeginLayout();
+    command_button_rects_.BeginLayout();
+    // Reused for every row id this frame; backed by the overlay's frame arena
+    FrameString row_id;
     ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_FirstUseEver);
     ImGui::Begin("Character");
 
@@ -273,20 +318,22 @@ void CharacterWidget::Draw(const character_overlay_state& state) {
             ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
             ImGui::TableHeadersRow();
 
+            const TabTextLayout& text_layout = GetTabTextLayout(tab);
             for (size_t i = 0; i < tab.rows.size(); ++i) {
                 const auto& row = tab.rows[i];
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
                 const bool is_selected = row.highlighted || (static_cast<int>(i) == active_row_index);
                 if (ImGui::Selectable(row.name.c_str(), is_selected, ImGuiSelectableFlags_SpanAllColumns)) {
-                    event_bus_adapter_.publish(cataclysm::gui::CharacterRowActivatedEvent(tab.id, i));
+                    event_bus_adapter_.enqueue(cataclysm::gui::CharacterRowActivatedEvent(cataclysm::gui::Symbol(tab.id), i));
                 }
-                RecordRect(row_rects_, tab.id + ":" + std::to_string(i));
+                BuildRowId(row_id, tab.id, i);
+                RecordRect(row_rects_, row_id);
                 if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal) && !row.tooltip.empty()) {
-                    ImGui::SetTooltip("%s", row.tooltip.c_str());
+                    ShowTooltip(row.tooltip);
                 }
                 ImGui::TableSetColumnIndex(1);
-                ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(row.color), "%s", row.value.c_str());
+                DrawMeasuredText(row.value, text_layout.value_sizes[i], row.color);
             }
             ImGui::EndTable();
         }
@@ -335,9 +382,8 @@ void CharacterWidget::Draw(const character_overlay_state& state) {
                 ImGui::PushID(tab.id.c_str());
                 const ImGuiTabItemFlags tab_flags = is_active_tab ? ImGuiTabItemFlags_SetSelected : ImGuiTabItemFlags_None;
                 bool tab_open = ImGui::BeginTabItem(tab.title.c_str(), nullptr, tab_flags);
-                RecordRect(tab_rects_, tab.id);
-                ImVec2 tab_min = tab_rects_.back().min;
-                ImVec2 tab_max = tab_rects_.back().max;
+                ImVec2 tab_min = ImGui::GetItemRectMin();
+                ImVec2 tab_max = ImGui::GetItemRectMax();
                 if (ImGuiTabBar* tab_bar = ImGui::GetCurrentTabBar()) {
                     const ImGuiID tab_item_id = ImGui::GetItemID();
                     const float spacing = ImGui::GetStyle().ItemInnerSpacing.x;
@@ -349,22 +395,20 @@ void CharacterWidget::Draw(const character_overlay_state& state) {
                             tab_max.x = tab_min.x + tab_item.Width;
                             tab_min.y = tab_bar->BarRect.Min.y;
                             tab_max.y = tab_bar->BarRect.Max.y;
-                            tab_rects_.back().min = tab_min;
-                            tab_rects_.back().max = tab_max;
                             break;
                         }
                         computed_offset += tab_bar->Tabs[tab_index].Width + spacing;
                     }
                 }
+                tab_rects_.Add(tab_min, tab_max, tab.id);
                 const bool tab_clicked = ImGui::IsItemClicked(ImGuiMouseButton_Left);
                 const bool tab_activated = ImGui::IsItemActivated();
                 const bool tab_mouse_released = ImGui::IsMouseReleased(ImGuiMouseButton_Left);
                 const ImVec2 mouse_pos = ImGui::GetMousePos();
-                const bool within_tab = mouse_pos.x >= tab_min.x && mouse_pos.x <= tab_max.x &&
-                                        mouse_pos.y >= tab_min.y && mouse_pos.y <= tab_max.y;
+                const bool within_tab = RectContains(tab_min, tab_max, mouse_pos);
                 const bool tab_clicked_by_bounds = tab_mouse_released && within_tab;
                 if (!is_active_tab && (tab_clicked || tab_activated || tab_clicked_by_bounds)) {
-                    event_bus_adapter_.publish(cataclysm::gui::CharacterTabRequestedEvent(tab.id));
+                    event_bus_adapter_.enqueue(cataclysm::gui::CharacterTabRequestedEvent(cataclysm::gui::Symbol(tab.id)));
                 }
                 if (tab_open) {
                     const int active_row_index =
@@ -373,36 +417,46 @@ void CharacterWidget::Draw(const character_overlay_state& state) {
                         ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthFixed, 200.0f);
                         ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
                         ImGui::TableHeadersRow();
-                        for (size_t j = 0; j < tab.rows.size(); ++j) {
-                            const auto& row = tab.rows[j];
-                            ImGui::TableNextRow();
-                            ImGui::TableSetColumnIndex(0);
-                            bool is_selected = row.highlighted || (static_cast<int>(j) == active_row_index);
-                            const bool row_pressed = ImGui::Selectable(row.name.c_str(), is_selected,
-                                                                         ImGuiSelectableFlags_SpanAllColumns);
-                            RecordRect(row_rects_, tab.id + ":" + std::to_string(j));
-                            const InteractiveRect& row_rect = row_rects_.back();
-                            const bool row_clicked = ImGui::IsItemClicked(ImGuiMouseButton_Left);
-                            const bool row_activated = row_pressed || ImGui::IsItemActivated();
-                            const bool row_mouse_released = ImGui::IsMouseReleased(ImGuiMouseButton_Left);
-                            const ImVec2 row_mouse_pos = ImGui::GetMousePos();
-                            const bool row_bounds_clicked =
-                                row_mouse_released &&
-                                row_mouse_pos.x >= row_rect.min.x && row_mouse_pos.x <= row_rect.max.x &&
-                                row_mouse_pos.y >= row_rect.min.y && row_mouse_pos.y <= row_rect.max.y;
-                            if (row_clicked || row_activated || row_bounds_clicked) {
-                                const int event_row_index = AdjustRowEventIndex(tab, static_cast<int>(j));
-                                if (event_row_index >= 0) {
-                                    event_bus_adapter_.publish(
-                                        cataclysm::gui::CharacterRowActivatedEvent(tab.id, event_row_index));
+                        const TabTextLayout& text_layout = GetTabTextLayout(tab);
+                        const int row_count = static_cast<int>(tab.rows.size());
+                        ImGuiListClipper clipper;
+                        clipper.Begin(row_count);
+                        if (active_row_index >= 0 && active_row_index < row_count) {
+                            clipper.IncludeItemByIndex(active_row_index);
+                        }
+                        while (clipper.Step()) {
+                            for (int row_index = clipper.DisplayStart; row_index < clipper.DisplayEnd; ++row_index) {
+                                const size_t j = static_cast<size_t>(row_index);
+                                const auto& row = tab.rows[j];
+                                ImGui::TableNextRow();
+                                ImGui::TableSetColumnIndex(0);
+                                bool is_selected = row.highlighted || (static_cast<int>(j) == active_row_index);
+                                const bool row_pressed = ImGui::Selectable(row.name.c_str(), is_selected,
+                                                                             ImGuiSelectableFlags_SpanAllColumns);
+                                BuildRowId(row_id, tab.id, j);
+                                const int row_slot = RecordRect(row_rects_, row_id);
+                                const bool row_clicked = ImGui::IsItemClicked(ImGuiMouseButton_Left);
+                                const bool row_activated = row_pressed || ImGui::IsItemActivated();
+                                const bool row_mouse_released = ImGui::IsMouseReleased(ImGuiMouseButton_Left);
+                                const ImVec2 row_mouse_pos = ImGui::GetMousePos();
+                                const bool row_bounds_clicked =
+                                    row_mouse_released &&
+                                    RectContains(row_rects_.Min(row_slot), row_rects_.Max(row_slot), row_mouse_pos);
+                                if (row_clicked || row_activated || row_bounds_clicked) {
+                                    const int event_row_index = AdjustRowEventIndex(tab, static_cast<int>(j));
+                                    if (event_row_index >= 0) {
+                                        event_bus_adapter_.enqueue(
+                                            cataclysm::gui::CharacterRowActivatedEvent(cataclysm::gui::Symbol(tab.id), event_row_index));
+                                    }
                                 }
+                                if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal) && !row.tooltip.empty()) {
+                                    ShowTooltip(row.tooltip);
+                                }
+                                ImGui::TableSetColumnIndex(1);
+                                DrawMeasuredText(row.value, text_layout.value_sizes[j], row.color);
                             }
-                            if (ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal) && !row.tooltip.empty()) {
-                                ImGui::SetTooltip("%s", row.tooltip.c_str());
-                            }
-                            ImGui::TableSetColumnIndex(1);
-                            ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(row.color), "%s", row.value.c_str());
                         }
+                        clipper.End();
                         ImGui::EndTable();
                     }
                     ImGui::EndTabItem();
@@ -433,18 +487,17 @@ void CharacterWidget::Draw(const character_overlay_state& state) {
                                    const std::string& binding,
                                    cataclysm::gui::CharacterCommand command) {
         const bool button_pressed = ImGui::SmallButton(label);
-        RecordRect(command_button_rects_, label);
-        const InteractiveRect& button_rect = command_button_rects_.back();
+        const int button_slot = RecordRect(command_button_rects_, label);
         const bool button_clicked = ImGui::IsItemClicked(ImGuiMouseButton_Left);
         const bool button_activated = button_pressed || ImGui::IsItemActivated();
         const bool button_mouse_released = ImGui::IsMouseReleased(ImGuiMouseButton_Left);
         const ImVec2 button_mouse_pos = ImGui::GetMousePos();
         const bool button_bounds_clicked =
             button_mouse_released &&
-            button_mouse_pos.x >= button_rect.min.x && button_mouse_pos.x <= button_rect.max.x &&
-            button_mouse_pos.y >= button_rect.min.y && button_mouse_pos.y <= button_rect.max.y;
+            RectContains(command_button_rects_.Min(button_slot), command_button_rects_.Max(button_slot),
+                         button_mouse_pos);
         if (button_clicked || button_activated || button_bounds_clicked) {
-            event_bus_adapter_.publish(cataclysm::gui::CharacterCommandEvent(command));
+            event_bus_adapter_.enqueue(cataclysm::gui::CharacterCommandEvent(command));
         }
         if (!binding.empty()) {
             ImGui::SameLine(0.0f, 4.0f);
@@ -470,6 +523,10 @@ void CharacterWidget::Draw(const character_overlay_state& state) {
                 state.bindings.rename.c_str());
 
     ImGui::End();
+
+    tab_rects_.EndLayout();
+    row_rects_.EndLayout();
+    command_button_rects_.EndLayout();
 }
 
 bool CharacterWidget::HandleEvent(const SDL_Event& event, const character_overlay_state& state) {
@@ -521,7 +578,7 @@ bool CharacterWidget::HandleEvent(const SDL_Event& event, const character_overla
         const int target_index = (active_index - 1 + tab_count) % tab_count;
         if (target_index != active_index) {
             event_bus_adapter_.publish(
-                cataclysm::gui::CharacterTabRequestedEvent(state.tabs[target_index].id));
+                cataclysm::gui::CharacterTabRequestedEvent(cataclysm::gui::Symbol(state.tabs[target_index].id)));
         }
         return true;
     }
@@ -530,7 +587,7 @@ bool CharacterWidget::HandleEvent(const SDL_Event& event, const character_overla
         const int target_index = (active_index + 1) % tab_count;
         if (target_index != active_index) {
             event_bus_adapter_.publish(
-                cataclysm::gui::CharacterTabRequestedEvent(state.tabs[target_index].id));
+                cataclysm::gui::CharacterTabRequestedEvent(cataclysm::gui::Symbol(state.tabs[target_index].id)));
         }
         return true;
     }
@@ -538,10 +595,38 @@ bool CharacterWidget::HandleEvent(const SDL_Event& event, const character_overla
     return false;
 }
 
-void CharacterWidget::RecordRect(std::vector<InteractiveRect>& container, const std::string& id) {
-    ImVec2 min = ImGui::GetItemRectMin();
-    ImVec2 max = ImGui::GetItemRectMax();
-    container.push_back({id, min, max});
+void CharacterWidget::InvalidateTextLayout(const std::string& tab_id) {
+    text_layouts_.erase(tab_id);
+}
+
+void CharacterWidget::InvalidateTextLayout() {
+    text_layouts_.clear();
+}
+
+const CharacterWidget::TabTextLayout& CharacterWidget::GetTabTextLayout(const character_overlay_tab& tab) {
+    TabTextLayout& layout = text_layouts_[tab.id];
+    const ImFont* font = ImGui::GetFont();
+    const float font_size = ImGui::GetFontSize();
+    // Row count and font act as a backstop for callers that change a tab
+    // without invalidating it.
+    if (layout.font == font && layout.font_size == font_size &&
+        layout.value_sizes.size() == tab.rows.size()) {
+        return layout;
+    }
+
+    layout.font = font;
+    layout.font_size = font_size;
+    layout.value_sizes.clear();
+    layout.value_sizes.reserve(tab.rows.size());
+    for (const auto& row : tab.rows) {
+        layout.value_sizes.push_back(
+            ImGui::CalcTextSize(row.value.c_str(), row.value.c_str() + row.value.size()));
+    }
+    return layout;
+}
+
+int CharacterWidget::RecordRect(HitTestIndex& container, std::string_view id) {
+    return container.Add(ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), id);
 }
 
 bool CharacterWidget::GetTabRect(const std::string& tab_id, ImVec2* min, ImVec2* max) const {
@@ -549,14 +634,16 @@ bool CharacterWidget::GetTabRect(const std::string& tab_id, ImVec2* min, ImVec2*
 }
 
 bool CharacterWidget::GetRowRect(const std::string& tab_id, size_t row_index, ImVec2* min, ImVec2* max) const {
-    return FindRect(row_rects_, tab_id + ":" + std::to_string(row_index), min, max);
+    std::string row_id;
+    BuildRowId(row_id, tab_id, row_index);
+    return FindRect(row_rects_, row_id, min, max);
 }
 
 bool CharacterWidget::GetCommandButtonRect(const std::string& label, ImVec2* min, ImVec2* max) const {
     return FindRect(command_button_rects_, label, min, max);
 }
 
-bool CharacterWidget::FindRect(const std::vector<InteractiveRect>& container,
+bool CharacterWidget::FindRect(const HitTestIndex& container,
                                const std::string& id,
                                ImVec2* min,
                                ImVec2* max) const {
@@ -564,13 +651,12 @@ bool CharacterWidget::FindRect(const std::vector<InteractiveRect>& container,
         return false;
     }
 
-    for (const auto& rect : container) {
-        if (rect.id == id) {
-            *min = rect.min;
-            *max = rect.max;
-            return true;
-        }
+    const int slot = container.FindId(id);
+    if (slot == HitTestIndex::kNoSlot) {
+        return false;
     }
 
-    return false;
+    *min = container.Min(slot);
+    *max = container.Max(slot);
+    return true;
 }
@@ -1,10 +1,16 @@
 #ifndef CHARACTER_WIDGET_H
 #define CHARACTER_WIDGET_H
 
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 #include <SDL_events.h>
 
 #include "CharacterOverlayState.h"
 #include "event_bus_adapter.h"
+#include "hit_test_index.h"
 
 class CharacterWidget {
 public:
@@ -23,23 +29,35 @@ public:
     [[nodiscard]] bool GetRowRect(const std::string& tab_id, size_t row_index, ImVec2* min, ImVec2* max) const;
     [[nodiscard]] bool GetCommandButtonRect(const std::string& label, ImVec2* min, ImVec2* max) const;
 
+    /**
+     * Drops the measured text of a tab so it is re-measured on the next draw.
+     * @param tab_id Tab whose rows changed.
+     */
+    void InvalidateTextLayout(const std::string& tab_id);
+    void InvalidateTextLayout();
+
 private:
-    struct InteractiveRect {
-        std::string id;
-        ImVec2 min{0.0f, 0.0f};
-        ImVec2 max{0.0f, 0.0f};
+    // Value text sizes per row, measured once per tab content change.
+    struct TabTextLayout {
+        const ImFont* font = nullptr;
+        float font_size = 0.0f;
+        std::vector<ImVec2> value_sizes;
     };
 
-    void RecordRect(std::vector<InteractiveRect>& container, const std::string& id);
-    bool FindRect(const std::vector<InteractiveRect>& container,
+    const TabTextLayout& GetTabTextLayout(const character_overlay_tab& tab);
+    int RecordRect(HitTestIndex& container, std::string_view id);
+    bool FindRect(const HitTestIndex& container,
                   const std::string& id,
                   ImVec2* min,
                   ImVec2* max) const;
 
     cataclysm::gui::EventBusAdapter& event_bus_adapter_;
-    std::vector<InteractiveRect> tab_rects_;
-    std::vector<InteractiveRect> row_rects_;
-    std::vector<InteractiveRect> command_button_rects_;
+    // Each index keeps last frame's rects keyed by id and only re-keys when
+    // the layout changes.
+    HitTestIndex tab_rects_;
+    HitTestIndex row_rects_;
+    HitTestIndex command_button_rects_;
+    std::unordered_map<std::string, TabTextLayout> text_layouts_;
 };
 
 #endif // CHARACTER_WIDGET_H
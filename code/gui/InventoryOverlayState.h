@@ -2,6 +2,7 @@
 #define INVENTORY_OVERLAY_STATE_H
 
 #include <array>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -33,4 +34,26 @@ struct inventory_overlay_state {
     int active_column;
 };
 
+// A single entry-level change. Operations are applied in order, so row indices
+// refer to the column as left by the preceding operations.
+struct inventory_entry_patch {
+    enum class operation {
+        set_flags, // Copy is_selected / is_highlighted from entry
+        replace,   // Overwrite the entry at row
+        insert,    // Insert entry before row (row == size appends)
+        erase      // Remove the entry at row
+    };
+
+    operation op = operation::set_flags;
+    int column = 0;
+    int row = 0;
+    inventory_entry entry{};
+};
+
+struct inventory_overlay_patch {
+    std::vector<inventory_entry_patch> entries;
+    std::optional<int> active_column;
+    std::array<std::optional<int>, 3> scroll_positions;
+};
+
 #endif // INVENTORY_OVERLAY_STATE_H
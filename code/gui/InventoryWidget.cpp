@@ -1,10 +1,11 @@
 #include "InventoryWidget.h"
 #include "events.h"
+#include "frame_profiler.h"
+#include "theme_palette.h"
 #include "imgui.h"
 
 #include <SDL.h>
 
-#include <algorithm>
 #include <cmath>
 #include <string>
 
@@ -22,7 +23,7 @@ public:
         }
     }
 
-    void Push(ImGuiCol idx, const ImVec4& color) {
+    void Push(ImGuiCol idx, ImU32 color) {
         ImGui::PushStyleColor(idx, color);
         ++count_;
     }
@@ -31,44 +32,59 @@ private:
     int count_ = 0;
 };
 
-constexpr float kHighlightLightenAmount = 0.1f;
-constexpr float kTextLightenAmount = 0.2f;
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
 
-ImVec4 LightenColor(const ImVec4& color, float amount) {
-    return ImVec4(std::min(color.x + amount, 1.0f),
-                  std::min(color.y + amount, 1.0f),
-                  std::min(color.z + amount, 1.0f),
-                  color.w);
-}
-
-ImVec4 ActiveColumnBackgroundColor() {
-    return LightenColor(ImGui::GetStyleColorVec4(ImGuiCol_ChildBg), kHighlightLightenAmount);
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
 }
 
-const ImVec4 kFavoriteColor = ImVec4(1.0f, 0.85f, 0.2f, 1.0f);
-const ImVec4 kDisabledColor = ImVec4(0.8f, 0.3f, 0.3f, 1.0f);
-
 }  // namespace
 
-std::string InventoryWidget::BuildEntryKey(int column_index,
-                                           int row_index,
-                                           const inventory_entry& entry) {
-    return std::to_string(column_index) + ":" + std::to_string(row_index) + ":" +
-           entry.hotkey + ":" + entry.label;
+uint64_t InventoryWidget::BuildEntryIdentity(const std::string& hotkey, const std::string& label) {
+    uint64_t hash = kFnvOffsetBasis;
+    hash = HashBytes(hash, hotkey.data(), hotkey.size());
+    // Separator keeps ("ab", "c") and ("a", "bc") apart.
+    hash = HashBytes(hash, "\0", 1);
+    return HashBytes(hash, label.data(), label.size());
+}
+
+uint64_t InventoryWidget::BuildEntryKey(int column_index, int row_index, uint64_t identity) {
+    const uint32_t position[2] = {static_cast<uint32_t>(column_index), static_cast<uint32_t>(row_index)};
+    return HashBytes(identity, position, sizeof(position));
 }
 
 const InventoryWidget::EntryBounds* InventoryWidget::FindEntryAtPosition(const ImVec2& position) const {
-    for (const auto& bounds : last_entry_bounds_) {
-        if (position.x >= bounds.min.x && position.x <= bounds.max.x &&
-            position.y >= bounds.min.y && position.y <= bounds.max.y) {
-            return &bounds;
-        }
+    const int slot = entry_hit_index_.Find(position);
+    if (slot == HitTestIndex::kNoSlot) {
+        return nullptr;
     }
-    return nullptr;
+    return &last_entry_bounds_[static_cast<size_t>(slot)];
 }
 
-bool InventoryWidget::DispatchEntryEvent(const EntryBounds& bounds) {
-    if (bounds.entry.is_category || bounds.entry.is_disabled) {
+const inventory_entry* InventoryWidget::ResolveEntry(const EntryBounds& bounds,
+                                                     const inventory_overlay_state& state) {
+    if (bounds.column_index < 0 || bounds.column_index >= static_cast<int>(state.columns.size())) {
+        return nullptr;
+    }
+    const auto& entries = state.columns[bounds.column_index].entries;
+    if (bounds.row_index < 0 || bounds.row_index >= static_cast<int>(entries.size())) {
+        return nullptr;
+    }
+    const inventory_entry& entry = entries[bounds.row_index];
+    if (BuildEntryIdentity(entry.hotkey, entry.label) != bounds.identity) {
+        return nullptr;
+    }
+    return &entry;
+}
+
+bool InventoryWidget::DispatchEntryEvent(const EntryBounds& bounds, const inventory_entry& entry) {
+    if (entry.is_category || entry.is_disabled) {
         return false;
     }
 
@@ -77,11 +93,12 @@ bool InventoryWidget::DispatchEntryEvent(const EntryBounds& bounds) {
         return true;
     }
 
-    event_bus_adapter_.publish(cataclysm::gui::InventoryItemClickedEvent(bounds.entry));
+    event_bus_adapter_.enqueue(cataclysm::gui::InventoryItemClickedEvent(entry));
     return true;
 }
 
-bool InventoryWidget::HandleMouseButtonEvent(const SDL_MouseButtonEvent& button_event) {
+bool InventoryWidget::HandleMouseButtonEvent(const SDL_MouseButtonEvent& button_event,
+                                             const inventory_overlay_state& state) {
     if (button_event.button != SDL_BUTTON_LEFT) {
         return false;
     }
@@ -92,7 +109,12 @@ bool InventoryWidget::HandleMouseButtonEvent(const SDL_MouseButtonEvent& button_
         return false;
     }
 
-    return DispatchEntryEvent(*bounds);
+    const inventory_entry* entry = ResolveEntry(*bounds, state);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    return DispatchEntryEvent(*bounds, *entry);
 }
 
 bool InventoryWidget::HandleMouseWheelEvent(const SDL_MouseWheelEvent& wheel_event) {
@@ -155,12 +177,12 @@ bool InventoryWidget::HandleMouseWheelEvent(const SDL_MouseWheelEvent& wheel_eve
         key_event.repeat = 0;
         key_event.keysym.mod = KMOD_NONE;
 
-        const int iterations = std::abs(steps);
-        for (int i = 0; i < iterations; ++i) {
-            key_event.keysym.scancode = (steps > 0) ? positive_scancode : negative_scancode;
-            key_event.keysym.sym = (steps > 0) ? positive_key : negative_key;
-            event_bus_adapter_.publish(cataclysm::gui::InventoryKeyInputEvent(key_event));
-        }
+        key_event.keysym.scancode = (steps > 0) ? positive_scancode : negative_scancode;
+        key_event.keysym.sym = (steps > 0) ? positive_key : negative_key;
+        cataclysm::gui::InventoryKeyInputEvent step_event(key_event);
+        step_event.setRepeatCount(std::abs(steps));
+        // Queued so further steps in this frame merge into it.
+        event_bus_adapter_.enqueue(step_event);
     };
 
     dispatch_delta(vertical_delta,
@@ -184,19 +206,101 @@ bool InventoryWidget::HandleKeyEvent(const SDL_KeyboardEvent& key_event) {
         return false;
     }
 
-    event_bus_adapter_.publish(cataclysm::gui::InventoryKeyInputEvent(key_event));
+    // Queued like wheel steps, so input reaches the host in the order it arrived.
+    event_bus_adapter_.enqueue(cataclysm::gui::InventoryKeyInputEvent(key_event));
     return true;
 }
 
+void InventoryWidget::DrawCategoryRow(const std::string& label) {
+    // A single-line stand-in for SeparatorText: dimmed label followed by a rule.
+    ImGui::TextDisabled("%s", label.c_str());
+    const ImVec2 text_max = ImGui::GetItemRectMax();
+    const ImVec2 text_min = ImGui::GetItemRectMin();
+    const float rule_y = (text_min.y + text_max.y) * 0.5f;
+    const float rule_start = text_max.x + ImGui::GetStyle().ItemInnerSpacing.x;
+    const float rule_end = ImGui::GetWindowPos().x + ImGui::GetWindowContentRegionMax().x;
+    if (rule_end > rule_start) {
+        ImGui::GetWindowDrawList()->AddLine(ImVec2(rule_start, rule_y), ImVec2(rule_end, rule_y),
+                                            ImGui::GetColorU32(ImGuiCol_Separator));
+    }
+}
+
+void InventoryWidget::DrawInventoryRow(const inventory_entry& entry,
+                                       int column_index,
+                                       int row_index,
+                                       const ThemePalette::Colors& palette) {
+    ImGui::PushID(row_index);
+
+    if (entry.is_category) {
+        DrawCategoryRow(entry.label);
+        ImGui::PopID();
+        return;
+    }
+
+    const bool is_selected = entry.is_selected;
+    const bool is_highlighted = entry.is_highlighted;
+    const bool row_selected = is_selected || is_highlighted;
+    const bool overlap_selected_and_highlighted = is_selected && is_highlighted;
+    const bool is_interactable = !entry.is_disabled;
+
+    // Plain rows draw with the style's own colors and push nothing.
+    StyleColorScope row_color_scope;
+    const PaletteColor text_color =
+        palette.RowText(entry.is_favorite, entry.is_disabled, overlap_selected_and_highlighted);
+    if (text_color != PaletteColor::Text) {
+        row_color_scope.Push(ImGuiCol_Text, palette.Packed(text_color));
+    }
+
+    if (is_highlighted) {
+        const ImU32 header_color = palette.Packed(overlap_selected_and_highlighted
+                                                      ? PaletteColor::HighlightEmphasis
+                                                      : PaletteColor::Highlight);
+        row_color_scope.Push(ImGuiCol_Header, header_color);
+        row_color_scope.Push(ImGuiCol_HeaderHovered, header_color);
+        row_color_scope.Push(ImGuiCol_HeaderActive, header_color);
+    }
+
+    row_label_buffer_.clear();
+    if (!entry.hotkey.empty()) {
+        row_label_buffer_.append(entry.hotkey).append(1, ' ');
+    }
+    row_label_buffer_.append(entry.label);
+
+    const bool selectable_pressed = ImGui::Selectable(row_label_buffer_.c_str(), row_selected,
+                                                      ImGuiSelectableFlags_None);
+    const bool should_dispatch_selection = selectable_pressed && is_interactable;
+
+    EntryBounds bounds;
+    bounds.min = ImGui::GetItemRectMin();
+    bounds.max = ImGui::GetItemRectMax();
+    bounds.column_index = column_index;
+    bounds.row_index = row_index;
+    bounds.identity = BuildEntryIdentity(entry.hotkey, entry.label);
+    bounds.entry_key = BuildEntryKey(column_index, row_index, bounds.identity);
+    last_entry_bounds_.push_back(bounds);
+    entry_hit_index_.Add(bounds.min, bounds.max);
+
+    if (should_dispatch_selection) {
+        DispatchEntryEvent(bounds, entry);
+    }
+
+    if (!entry.disabled_msg.empty() && ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal)) {
+        ImGui::SetTooltip("%s", entry.disabled_msg.c_str());
+    }
+
+    ImGui::PopID();
+}
+
 void InventoryWidget::DrawInventoryColumn(const inventory_column& column,
                                           int column_index,
-                                          int active_column) {
+                                          int active_column,
+                                          const ThemePalette::Colors& palette) {
     ImGui::PushID(column_index);
 
     const bool is_active_column = column_index == active_column;
     StyleColorScope column_color_scope;
     if (is_active_column) {
-        column_color_scope.Push(ImGuiCol_ChildBg, ActiveColumnBackgroundColor());
+        column_color_scope.Push(ImGuiCol_ChildBg, palette.Packed(PaletteColor::ActiveColumnBackground));
     }
 
     ImGui::TextUnformatted(column.name.c_str());
@@ -206,83 +310,41 @@ void InventoryWidget::DrawInventoryColumn(const inventory_column& column,
     constexpr ImGuiWindowFlags kWindowFlags = ImGuiWindowFlags_HorizontalScrollbar;
     ImGui::BeginChild("InventoryColumnBody", ImVec2(0, 0), kChildFlags, kWindowFlags);
 
-    if (column.scroll_position > 0) {
+    // The game's scroll position counts unfiltered rows, so it is not applied
+    // while filtering
+    if (column.scroll_position > 0 && !IsFiltering()) {
         const float line_height = ImGui::GetTextLineHeightWithSpacing();
         ImGui::SetScrollY(column.scroll_position * line_height);
     }
 
-    const ImVec4 default_text_color = ImGui::GetStyleColorVec4(ImGuiCol_Text);
-    for (size_t row_index = 0; row_index < column.entries.size(); ++row_index) {
-        const auto& entry = column.entries[row_index];
-        ImGui::PushID(static_cast<int>(row_index));
-
-        if (entry.is_category) {
-            StyleColorScope category_color_scope;
-            category_color_scope.Push(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
-            ImGui::SeparatorText(entry.label.c_str());
-            ImGui::PopID();
-            continue;
-        }
-
-        const bool is_selected = entry.is_selected;
-        const bool is_highlighted = entry.is_highlighted;
-        const bool row_selected = is_selected || is_highlighted;
-        const bool overlap_selected_and_highlighted = is_selected && is_highlighted;
-        const bool is_interactable = !entry.is_disabled;
-
-        ImVec4 text_color = default_text_color;
-        if (entry.is_favorite) {
-            text_color = kFavoriteColor;
-        }
-        if (entry.is_disabled) {
-            text_color = kDisabledColor;
-        }
-        if (overlap_selected_and_highlighted) {
-            text_color = LightenColor(text_color, kTextLightenAmount);
-        }
-
-        StyleColorScope row_color_scope;
-        if (entry.is_favorite || entry.is_disabled || overlap_selected_and_highlighted) {
-            row_color_scope.Push(ImGuiCol_Text, text_color);
-        }
-
-        if (is_highlighted) {
-            ImVec4 header_color = ImGui::GetStyleColorVec4(ImGuiCol_Header);
-            if (overlap_selected_and_highlighted) {
-                header_color = LightenColor(header_color, kHighlightLightenAmount);
+    const int entry_count = static_cast<int>(column.entries.size());
+
+    // Every row, category headers included, is one text line tall so the
+    // clipper can skip off-screen rows without measuring them.
+    ImGuiListClipper clipper;
+    if (IsFiltering()) {
+        const std::vector<int>& rows = filtered_rows_[column_index];
+        clipper.Begin(static_cast<int>(rows.size()), ImGui::GetTextLineHeightWithSpacing());
+        while (clipper.Step()) {
+            for (int display_index = clipper.DisplayStart; display_index < clipper.DisplayEnd; ++display_index) {
+                const int row_index = rows[display_index];
+                if (row_index < entry_count) {
+                    DrawInventoryRow(column.entries[row_index], column_index, row_index, palette);
+                }
             }
-            row_color_scope.Push(ImGuiCol_Header, header_color);
-            row_color_scope.Push(ImGuiCol_HeaderHovered, header_color);
-            row_color_scope.Push(ImGuiCol_HeaderActive, header_color);
-        }
-
-        std::string label = entry.label;
-        if (!entry.hotkey.empty()) {
-            label = entry.hotkey + " " + label;
         }
-
-        const bool selectable_pressed = ImGui::Selectable(label.c_str(), row_selected,
-                                                          ImGuiSelectableFlags_None);
-        const bool should_dispatch_selection = selectable_pressed && is_interactable;
-
-        EntryBounds bounds;
-        bounds.entry = entry;
-        bounds.min = ImGui::GetItemRectMin();
-        bounds.max = ImGui::GetItemRectMax();
-        bounds.column_index = column_index;
-        bounds.row_index = static_cast<int>(row_index);
-        bounds.entry_key = BuildEntryKey(column_index, bounds.row_index, entry);
-        last_entry_bounds_.push_back(bounds);
-
-        if (should_dispatch_selection) {
-            DispatchEntryEvent(bounds);
+        clipper.End();
+    } else {
+        clipper.Begin(entry_count, ImGui::GetTextLineHeightWithSpacing());
+        if (column.scroll_position > 0 && column.scroll_position < entry_count) {
+            clipper.IncludeItemsByIndex(column.scroll_position, column.scroll_position + 1);
         }
-
-        if (!entry.disabled_msg.empty() && ImGui::IsItemHovered(ImGuiHoveredFlags_DelayNormal)) {
-            ImGui::SetTooltip("%s", entry.disabled_msg.c_str());
+        while (clipper.Step()) {
+            for (int row_index = clipper.DisplayStart; row_index < clipper.DisplayEnd; ++row_index) {
+                DrawInventoryRow(column.entries[row_index], column_index, row_index, palette);
+            }
         }
-
-        ImGui::PopID();
+        clipper.End();
     }
 
     ImGui::EndChild();
@@ -295,8 +357,31 @@ InventoryWidget::InventoryWidget(cataclysm::gui::EventBusAdapter& event_bus_adap
 
 InventoryWidget::~InventoryWidget() = default;
 
+void InventoryWidget::SetFilter(const std::string& filter_text, const inventory_overlay_state& state) {
+    filter_text_ = filter_text;
+    filter_.Index(state);
+    const auto matches = filter_.Apply(filter_text_);
+
+    for (auto& rows : filtered_rows_) {
+        rows.clear();
+    }
+    for (const InventoryFilter::Match& match : *matches) {
+        if (match.column_index >= 0 && match.column_index < static_cast<int>(filtered_rows_.size())) {
+            filtered_rows_[match.column_index].push_back(match.row_index);
+        }
+    }
+
+    cataclysm::gui::UiFilterAppliedEvent event(filter_text_, cataclysm::gui::event_sources::inventoryWidget());
+    event.setSource(cataclysm::gui::event_sources::inventoryWidget());
+    event.setMatches(matches);
+    event_bus_adapter_.publish(event);
+}
+
 void InventoryWidget::Draw(const inventory_overlay_state& state) {
+    GUI_PROFILE_ZONE("InventoryWidget::Draw");
     last_entry_bounds_.clear();
+    entry_hit_index_.BeginLayout();
+    const ThemePalette::Colors& palette = ThemePalette::Get().Current();
     ImGui::Begin("Inventory");
 
     // Header
@@ -329,7 +414,7 @@ void InventoryWidget::Draw(const inventory_overlay_state& state) {
         }
         for (int column_index = 0; column_index < 3; ++column_index) {
             ImGui::TableNextColumn();
-            DrawInventoryColumn(state.columns[column_index], column_index, state.active_column);
+            DrawInventoryColumn(state.columns[column_index], column_index, state.active_column, palette);
         }
         ImGui::EndTable();
     }
@@ -347,14 +432,15 @@ void InventoryWidget::Draw(const inventory_overlay_state& state) {
     }
 
     ImGui::End();
+    entry_hit_index_.EndLayout();
 
     handled_entries_.clear();
 }
 
-bool InventoryWidget::HandleEvent(const SDL_Event& event) {
+bool InventoryWidget::HandleEvent(const SDL_Event& event, const inventory_overlay_state& state) {
     switch (event.type) {
         case SDL_MOUSEBUTTONDOWN: {
-            return HandleMouseButtonEvent(event.button);
+            return HandleMouseButtonEvent(event.button, state);
         }
         case SDL_MOUSEWHEEL: {
             return HandleMouseWheelEvent(event.wheel);
@@ -374,8 +460,9 @@ bool InventoryWidget::GetEntryRect(const std::string& hotkey,
     if (min == nullptr || max == nullptr) {
         return false;
     }
+    const uint64_t identity = BuildEntryIdentity(hotkey, label);
     for (const auto& bounds : last_entry_bounds_) {
-        if (bounds.entry.hotkey == hotkey && bounds.entry.label == label) {
+        if (bounds.identity == identity) {
             *min = bounds.min;
             *max = bounds.max;
             return true;
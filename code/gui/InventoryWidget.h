@@ -1,6 +1,8 @@
 #ifndef INVENTORY_WIDGET_H
 #define INVENTORY_WIDGET_H
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -9,6 +11,9 @@
 
 #include "InventoryOverlayState.h"
 #include "event_bus_adapter.h"
+#include "hit_test_index.h"
+#include "inventory_filter.h"
+#include "theme_palette.h"
 #include "imgui.h"
 
 class InventoryWidget {
@@ -23,31 +28,70 @@ public:
 
     void Draw(const inventory_overlay_state& state);
 
-    bool HandleEvent(const SDL_Event& event);
+    /**
+     * Routes an SDL event to the widget.
+     * @param state The state the widget was last drawn with; mouse hits are
+     *        resolved against it rather than against copies of the entries.
+     */
+    bool HandleEvent(const SDL_Event& event, const inventory_overlay_state& state);
 
+    // Only rows built in the last frame have a rect; columns are clipped to
+    // their visible rows.
     [[nodiscard]] bool GetEntryRect(const std::string& hotkey,
                                     const std::string& label,
                                     ImVec2* min,
                                     ImVec2* max) const;
 
+    /**
+     * Show only the entries whose label contains filter_text, ignoring ASCII
+     * case, and publish a UiFilterAppliedEvent carrying the matches. Call
+     * again with the same text after the state changes; an empty filter
+     * shows every row again.
+     * @param state The state the widget will be drawn with
+     */
+    void SetFilter(const std::string& filter_text, const inventory_overlay_state& state);
+
+    [[nodiscard]] const std::string& GetFilter() const { return filter_text_; }
+    [[nodiscard]] bool IsFiltering() const { return !filter_text_.empty(); }
+    [[nodiscard]] const InventoryFilter& GetFilterIndex() const { return filter_; }
+
 private:
     cataclysm::gui::EventBusAdapter& event_bus_adapter_;
+    // Refers to its entry by position in the drawn state; identity guards
+    // against the state having changed since the frame was laid out.
     struct EntryBounds {
-        inventory_entry entry;
         ImVec2 min{0.0f, 0.0f};
         ImVec2 max{0.0f, 0.0f};
         int column_index = 0;
         int row_index = 0;
-        std::string entry_key;
+        uint64_t identity = 0;
+        uint64_t entry_key = 0;
     };
     std::vector<EntryBounds> last_entry_bounds_;
-    std::unordered_set<std::string> handled_entries_;
+    // Slots mirror last_entry_bounds_ so mouse hit-tests skip the linear scan.
+    HitTestIndex entry_hit_index_;
+    std::unordered_set<uint64_t> handled_entries_;
+    // Reused across rows so building "hotkey label" does not allocate per row.
+    std::string row_label_buffer_;
+    InventoryFilter filter_;
+    std::string filter_text_;
+    // Rows of each column left by the filter, in display order.
+    std::array<std::vector<int>, 3> filtered_rows_;
 
-    void DrawInventoryColumn(const inventory_column& column, int column_index, int active_column);
-    static std::string BuildEntryKey(int column_index, int row_index, const inventory_entry& entry);
+    void DrawInventoryColumn(const inventory_column& column, int column_index, int active_column,
+                             const ThemePalette::Colors& palette);
+    void DrawInventoryRow(const inventory_entry& entry, int column_index, int row_index,
+                          const ThemePalette::Colors& palette);
+    static void DrawCategoryRow(const std::string& label);
+    static uint64_t BuildEntryIdentity(const std::string& hotkey, const std::string& label);
+    static uint64_t BuildEntryKey(int column_index, int row_index, uint64_t identity);
     const EntryBounds* FindEntryAtPosition(const ImVec2& position) const;
-    bool DispatchEntryEvent(const EntryBounds& bounds);
-    bool HandleMouseButtonEvent(const SDL_MouseButtonEvent& button_event);
+    static const inventory_entry* ResolveEntry(const EntryBounds& bounds,
+                                               const inventory_overlay_state& state);
+    // Queued with wheel and key input until the overlay flushes after rendering.
+    bool DispatchEntryEvent(const EntryBounds& bounds, const inventory_entry& entry);
+    bool HandleMouseButtonEvent(const SDL_MouseButtonEvent& button_event,
+                                const inventory_overlay_state& state);
     bool HandleMouseWheelEvent(const SDL_MouseWheelEvent& wheel_event);
     bool HandleKeyEvent(const SDL_KeyboardEvent& key_event);
 
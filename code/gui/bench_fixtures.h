@@ -0,0 +1,85 @@
+#ifndef BENCH_FIXTURES_H
+#define BENCH_FIXTURES_H
+
+#include <string>
+
+#include "CharacterOverlayState.h"
+#include "InventoryOverlayState.h"
+
+/**
+ * Deterministic overlay states for gui_bench and gui_frame_replay. The same
+ * arguments always build the same state, so runs stay comparable.
+ */
+namespace bench_fixtures {
+
+/**
+ * Build an inventory with entry_count entries spread over the three columns,
+ * with a category header every 25 rows and a mix of row flags.
+ * @param selected_row Row of the active column that is highlighted
+ */
+inline inventory_overlay_state BuildInventoryState(int entry_count, int selected_row = 3) {
+    inventory_overlay_state state{};
+    state.title = "Inventory";
+    state.hotkey_hint = "[?] help";
+    state.weight_label = "Weight: 12.5/40.0 kg";
+    state.volume_label = "Volume: 8.2/20.0 L";
+    state.navigation_mode = "item";
+    state.active_column = 1;
+
+    const char* const kColumnNames[] = {"Worn", "Inventory", "Ground"};
+    for (size_t column = 0; column < state.columns.size(); ++column) {
+        state.columns[column].name = kColumnNames[column];
+        state.columns[column].scroll_position = 0;
+    }
+
+    for (int i = 0; i < entry_count; ++i) {
+        const int column_index = i % 3;
+        inventory_column& column = state.columns[static_cast<size_t>(column_index)];
+        const int row = static_cast<int>(column.entries.size());
+        inventory_entry entry{};
+        entry.is_category = (row % 25) == 0;
+        entry.label = entry.is_category ? "Category " + std::to_string(row / 25) : "item " + std::to_string(i);
+        entry.hotkey = entry.is_category ? "" : std::string(1, static_cast<char>('a' + (row % 26)));
+        entry.is_selected = (row % 7) == 0;
+        entry.is_highlighted = column_index == state.active_column && row == selected_row;
+        entry.is_favorite = (row % 11) == 0;
+        entry.is_disabled = (row % 13) == 0;
+        if (entry.is_disabled) {
+            entry.disabled_msg = "too heavy";
+        }
+        column.entries.push_back(std::move(entry));
+    }
+    return state;
+}
+
+/**
+ * Build a character sheet with tab_count tabs of row_count rows each.
+ */
+inline character_overlay_state BuildCharacterState(int tab_count, int row_count, int active_tab = 0) {
+    character_overlay_state state;
+    state.header_left = "Survivor - Day 12";
+    state.header_right = "[?] Help";
+    state.info_panel_text = "Row details go here.\nThey can span multiple lines.";
+    state.active_tab_index = active_tab;
+    state.active_row_index = 0;
+    state.footer_lines = {"Press TAB to switch tabs.", "Press ENTER to inspect a row."};
+    state.bindings = {"?", "TAB", "SHIFT+TAB", "ENTER", "ESC", "r"};
+
+    for (int tab = 0; tab < tab_count; ++tab) {
+        character_overlay_tab entry;
+        entry.id = "tab_" + std::to_string(tab);
+        entry.title = "Tab " + std::to_string(tab);
+        for (int row = 0; row < row_count; ++row) {
+            const ImU32 color = (row % 5) == 0 ? IM_COL32(255, 255, 0, 255) : IM_COL32(255, 255, 255, 255);
+            entry.rows.push_back({"Row " + std::to_string(row), std::to_string(row * 10),
+                                  (row % 3) == 0 ? "Tooltip for row " + std::to_string(row) : std::string(), color,
+                                  row == 0});
+        }
+        state.tabs.push_back(std::move(entry));
+    }
+    return state;
+}
+
+} // namespace bench_fixtures
+
+#endif // BENCH_FIXTURES_H
@@ -1,5 +1,8 @@
 #include "data_binding_manager.h"
+#include "debug.h"
+#include "frame_profiler.h"
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 
@@ -7,7 +10,7 @@ namespace cataclysm {
 namespace gui {
 
 DataBindingManager::DataBindingManager()
-    : event_adapter_(EventBusAdapter::getInstance()), initialized_(false), 
+    : event_adapter_(ThreadLocalEventBusAdapter::getInstance()), initialized_(false), 
       update_rate_limit_ms_(16), total_updates_(0), skipped_updates_(0) {
 }
 
@@ -17,9 +20,12 @@ DataBindingManager::DataBindingManager(EventBusAdapter& event_adapter)
 }
 
 DataBindingManager::~DataBindingManager() {
-    if (initialized_.load()) {
-        shutdown();
-    }
+    shutdown();
+    
+    // Bindings can be created before initialize(), and their sources hold
+    // listeners that capture this.
+    std::lock_guard<std::mutex> lock(bindings_mutex_);
+    clearBindingsLocked();
 }
 
 void DataBindingManager::initialize() {
@@ -30,8 +36,8 @@ void DataBindingManager::initialize() {
     initialized_.store(true);
     setupEventSubscriptions();
     
-    std::cout << "DataBindingManager initialized with rate limit: " 
-              << update_rate_limit_ms_.load() << "ms" << std::endl;
+    debuglog(DebugLevel::Info, "DataBindingManager initialized with rate limit: ",
+             update_rate_limit_ms_.load(), "ms");
 }
 
 void DataBindingManager::shutdown() {
@@ -43,49 +49,76 @@ void DataBindingManager::shutdown() {
     
     {
         std::lock_guard<std::mutex> lock(bindings_mutex_);
-        bindings_.clear();
-        binding_index_map_.clear();
+        clearBindingsLocked();
     }
     
     cleanupEventSubscriptions();
     
-    std::cout << "DataBindingManager shutdown completed" << std::endl;
+    debuglog(DebugLevel::Info, "DataBindingManager shutdown completed");
 }
 
 bool DataBindingManager::createBinding(const std::string& binding_id, 
                                       std::shared_ptr<IDataSource> data_source,
                                       DataBindingUpdateCallback update_callback) {
     if (!data_source) {
-        std::cerr << "Failed to create binding '" << binding_id << "': invalid data source" << std::endl;
+        reportCreateFailure(binding_id, "invalid data source");
         return false;
     }
     
+    return addBinding(std::make_shared<DataBinding>(binding_id, std::move(data_source),
+                                                    std::move(update_callback)));
+}
+
+bool DataBindingManager::addBinding(BindingPtr binding, const std::vector<std::string>& dependency_ids) {
+    const std::string& binding_id = binding->getBindingId();
+    const std::shared_ptr<IDataSource> data_source = binding->getDataSource();
+    
     std::lock_guard<std::mutex> lock(bindings_mutex_);
     
     // Check if binding already exists
     if (binding_index_map_.find(binding_id) != binding_index_map_.end()) {
-        std::cerr << "Failed to create binding '" << binding_id << "': binding already exists" << std::endl;
+        reportCreateFailure(binding_id, "binding already exists");
         return false;
     }
     
-    // Create the binding
-    DataBinding binding(binding_id, data_source);
-    binding.setDirty(true);
-    binding.setLastUpdateTimestamp(getCurrentTimestamp());
+    for (const std::string& dependency_id : dependency_ids) {
+        auto dependency = binding_index_map_.find(dependency_id);
+        if (dependency == binding_index_map_.end()) {
+            reportCreateFailure(binding_id, "unknown dependency");
+            return false;
+        }
+        const BindingPtr& input = bindings_[dependency->second];
+        binding->dependencies_.push_back(input);
+        binding->rank_ = std::max(binding->rank_, input->rank_ + 1);
+    }
+    binding->input_versions_.assign(binding->dependencies_.size(), 0);
+    for (const BindingPtr& input : binding->dependencies_) {
+        input->dependents_.push_back(binding);
+    }
+    
+    binding->inventory_related_ = data_source->getName().find("inventory") != std::string::npos ||
+                                  binding_id.find("inventory") != std::string::npos;
     
-    // Store callback separately (in a real implementation, you'd store it with the binding)
-    // For now, we'll invoke the callback directly when updating
+    auto& readers = source_bindings_[data_source.get()];
+    if (readers.empty()) {
+        data_source->setChangeListener([this](IDataSource& source) { onSourceChanged(source); });
+    }
+    readers.push_back(binding);
     
-    size_t index = bindings_.size();
-    bindings_.push_back(std::move(binding));
-    binding_index_map_[binding_id] = index;
+    binding_index_map_[binding_id] = bindings_.size();
+    bindings_.push_back(binding);
+    queueLocked(binding);
     
-    std::cout << "Created data binding: " << binding_id 
-              << " (type: " << data_source->getDataType().name() << ")" << std::endl;
+    debuglog(DebugLevel::Debug, "Created data binding: ", binding_id,
+             " (type: ", data_source->getDataType().name(), ")");
     
     return true;
 }
 
+void DataBindingManager::reportCreateFailure(const std::string& binding_id, const char* reason) {
+    std::cerr << "Failed to create binding '" << binding_id << "': " << reason << std::endl;
+}
+
 bool DataBindingManager::removeBinding(const std::string& binding_id) {
     std::lock_guard<std::mutex> lock(bindings_mutex_);
     
@@ -95,59 +128,89 @@ bool DataBindingManager::removeBinding(const std::string& binding_id) {
     }
     
     size_t index = it->second;
+    BindingPtr removed = bindings_[index];
+    if (!removed->dependents_.empty()) {
+        std::cerr << "Failed to remove binding '" << binding_id << "': other bindings depend on it" << std::endl;
+        return false;
+    }
+    removed->removed_ = true;
+    detachSourceLocked(removed);
+    for (const BindingPtr& input : removed->dependencies_) {
+        auto& dependents = input->dependents_;
+        dependents.erase(std::remove_if(dependents.begin(), dependents.end(),
+                                        [&removed](const std::weak_ptr<DataBinding>& dependent) {
+                                            return dependent.lock() == removed;
+                                        }),
+                         dependents.end());
+    }
     
     // Remove from vector by swapping with last element (if not the last)
     if (index < bindings_.size() - 1) {
         bindings_[index] = std::move(bindings_.back());
         
         // Update the index map for the moved binding
-        const std::string& moved_binding_id = bindings_[index].getBindingId();
-        binding_index_map_[moved_binding_id] = index;
+        binding_index_map_[bindings_[index]->getBindingId()] = index;
     }
     
     // Remove last element
     bindings_.pop_back();
     binding_index_map_.erase(it);
     
-    std::cout << "Removed data binding: " << binding_id << std::endl;
+    debuglog(DebugLevel::Debug, "Removed data binding: ", binding_id);
     return true;
 }
 
 void DataBindingManager::updateDirtyBindings() {
+    GUI_PROFILE_ZONE("DataBindingManager::updateDirtyBindings");
     if (!initialized_.load()) {
         return;
     }
     
-    std::vector<DataBinding*> dirty_bindings;
+    std::vector<BindingPtr> ready;
     std::uint64_t current_time = getCurrentTimestamp();
     int rate_limit = update_rate_limit_ms_.load();
     
     {
         std::lock_guard<std::mutex> lock(bindings_mutex_);
         
-        for (auto& binding : bindings_) {
-            if (binding.needsUpdate()) {
-                // Check rate limiting
-                if (rate_limit > 0) {
-                    std::uint64_t time_since_update = current_time - binding.getLastUpdateTimestamp();
-                    if (time_since_update < static_cast<std::uint64_t>(rate_limit)) {
-                        skipped_updates_.fetch_add(1);
-                        continue;
-                    }
+        std::vector<BindingPtr> deferred;
+        for (BindingPtr& binding : dirty_queue_) {
+            if (binding->removed_) {
+                continue;
+            }
+            // Check rate limiting
+            if (rate_limit > 0 && binding->getLastUpdateTimestamp() != 0) {
+                std::uint64_t time_since_update = current_time - binding->getLastUpdateTimestamp();
+                if (time_since_update < static_cast<std::uint64_t>(rate_limit)) {
+                    skipped_updates_.fetch_add(1);
+                    deferred.push_back(std::move(binding));
+                    continue;
                 }
-                
-                dirty_bindings.push_back(&binding);
             }
+            // Leaves the queue now, so changes from here on queue it again.
+            binding->queued_ = false;
+            binding->in_pass_ = true;
+            ready.push_back(std::move(binding));
         }
+        dirty_queue_ = std::move(deferred);
     }
     
-    // Update dirty bindings outside the mutex
-    for (DataBinding* binding : dirty_bindings) {
+    // Inputs before the values computed from them.
+    std::stable_sort(ready.begin(), ready.end(), [](const BindingPtr& a, const BindingPtr& b) {
+        return a->rank_ < b->rank_;
+    });
+    
+    // Update dirty bindings outside the mutex. A binding waiting in this pass
+    // is not queued again when an input is recomputed before it; whatever
+    // moved its source during its own update is picked up by finishUpdateLocked().
+    for (const BindingPtr& binding : ready) {
         updateBinding(*binding);
+        std::lock_guard<std::mutex> lock(bindings_mutex_);
+        finishUpdateLocked(binding);
     }
 }
 
-bool DataBindingManager::forceUpdateBinding(const std::string& binding_id) {
+bool DataBindingManager::markBindingDirty(const std::string& binding_id) {
     std::lock_guard<std::mutex> lock(bindings_mutex_);
     
     auto it = binding_index_map_.find(binding_id);
@@ -155,9 +218,58 @@ bool DataBindingManager::forceUpdateBinding(const std::string& binding_id) {
         return false;
     }
     
-    DataBinding& binding = bindings_[it->second];
-    updateBinding(binding);
+    const BindingPtr& binding = bindings_[it->second];
+    binding->setDirty(true);
+    queueLocked(binding);
+    return true;
+}
+
+size_t DataBindingManager::markSourceChanged(const std::string& source_name) {
+    std::vector<std::shared_ptr<IDataSource>> sources;
+    {
+        std::lock_guard<std::mutex> lock(bindings_mutex_);
+        for (const auto& entry : source_bindings_) {
+            const BindingPtr& reader = entry.second.front();
+            if (reader->getDataSource()->getName() == source_name) {
+                sources.push_back(reader->getDataSource());
+            }
+        }
+    }
+    
+    // markChanged() calls back into onSourceChanged(), which queues the readers.
+    size_t queued = 0;
+    for (const auto& source : sources) {
+        source->markChanged();
+        std::lock_guard<std::mutex> lock(bindings_mutex_);
+        auto it = source_bindings_.find(source.get());
+        if (it != source_bindings_.end()) {
+            queued += it->second.size();
+        }
+    }
+    return queued;
+}
+
+bool DataBindingManager::forceUpdateBinding(const std::string& binding_id) {
+    BindingPtr binding;
+    {
+        std::lock_guard<std::mutex> lock(bindings_mutex_);
+        
+        auto it = binding_index_map_.find(binding_id);
+        if (it == binding_index_map_.end()) {
+            return false;
+        }
+        
+        binding = bindings_[it->second];
+    }
+    
+    binding->setDirty(true);
+    updateBinding(*binding);
     
+    // Retry a failed delivery on the next update
+    std::lock_guard<std::mutex> lock(bindings_mutex_);
+    if (binding->needsUpdate()) {
+        queueLocked(binding);
+    }
     return true;
 }
 
@@ -173,10 +285,12 @@ std::unordered_map<std::string, std::string> DataBindingManager::getBindingStatu
     
     for (const auto& binding : bindings_) {
         std::ostringstream oss;
-        oss << "dirty=" << (binding.isDirty() ? "true" : "false")
-            << ",type=" << binding.getDataSource()->getDataType().name()
-            << ",last_update=" << binding.getLastUpdateTimestamp();
-        status[binding.getBindingId()] = oss.str();
+        oss << "dirty=" << (binding->needsUpdate() ? "true" : "false")
+            << ",type=" << binding->getDataSource()->getDataType().name()
+            << ",version=" << binding->getDataSource()->getVersion()
+            << ",delivered=" << binding->getDeliveredVersion()
+            << ",last_update=" << binding->getLastUpdateTimestamp();
+        status[binding->getBindingId()] = oss.str();
     }
     
     return status;
@@ -184,15 +298,14 @@ std::unordered_map<std::string, std::string> DataBindingManager::getBindingStatu
 
 void DataBindingManager::clearAllBindings() {
     std::lock_guard<std::mutex> lock(bindings_mutex_);
-    bindings_.clear();
-    binding_index_map_.clear();
+    clearBindingsLocked();
     
-    std::cout << "Cleared all data bindings" << std::endl;
+    debuglog(DebugLevel::Debug, "Cleared all data bindings");
 }
 
 void DataBindingManager::setUpdateRateLimit(int rate_limit_ms) {
     update_rate_limit_ms_.store(rate_limit_ms);
-    std::cout << "Set data binding update rate limit to " << rate_limit_ms << "ms" << std::endl;
+    debuglog(DebugLevel::Debug, "Set data binding update rate limit to ", rate_limit_ms, "ms");
 }
 
 bool DataBindingManager::isEmpty() const {
@@ -200,14 +313,20 @@ bool DataBindingManager::isEmpty() const {
 }
 
 void DataBindingManager::setupEventSubscriptions() {
-    // Subscribe to UI data binding update events
+    // Subscribe to UI data binding update events. A binding id targets one
+    // binding; a bare source name reports that the source itself changed.
     event_subscriptions_.push_back(
         event_adapter_.subscribe<UiDataBindingUpdateEvent>(
             [this](const UiDataBindingUpdateEvent& event) {
-                std::cout << "Received data binding update event: " << event.getBindingId() << std::endl;
+                debuglog(DebugLevel::Trace, "Received data binding update event: ", event.getBindingId());
                 
-                // Force update the specific binding
-                forceUpdateBinding(event.getBindingId());
+                if (event.getBindingId().empty()) {
+                    markSourceChanged(event.getDataSource());
+                } else if (event.isForced()) {
+                    forceUpdateBinding(event.getBindingId());
+                } else {
+                    markBindingDirty(event.getBindingId());
+                }
             }
         )
     );
@@ -215,15 +334,15 @@ void DataBindingManager::setupEventSubscriptions() {
     // Subscribe to inventory change events to update related bindings
     event_subscriptions_.push_back(
         event_adapter_.subscribeToInventoryChange(
-            [this](const GameplayInventoryChangeEvent& event) {
-                std::cout << "Inventory change detected, marking related bindings as dirty" << std::endl;
+            [this](const GameplayInventoryChangeEvent&) {
+                debuglog(DebugLevel::Trace, "Inventory change detected, marking related bindings as dirty");
                 
                 std::lock_guard<std::mutex> lock(bindings_mutex_);
-                for (auto& binding : bindings_) {
+                for (const auto& binding : bindings_) {
                     // Mark bindings as dirty if they might be affected by inventory changes
-                    if (binding.getDataSource()->getName().find("inventory") != std::string::npos ||
-                        binding.getBindingId().find("inventory") != std::string::npos) {
-                        binding.setDirty(true);
+                    if (binding->inventory_related_) {
+                        binding->setDirty(true);
+                        queueLocked(binding);
                     }
                 }
             }
@@ -234,15 +353,16 @@ void DataBindingManager::setupEventSubscriptions() {
     event_subscriptions_.push_back(
         event_adapter_.subscribeToStatusChange(
             [this](const GameplayStatusChangeEvent& event) {
-                std::cout << "Status change detected: " << event.getStatusType() 
-                          << ", marking related bindings as dirty" << std::endl;
+                debuglog(DebugLevel::Trace, "Status change detected: ", event.getStatusType(),
+                         ", marking related bindings as dirty");
                 
                 std::lock_guard<std::mutex> lock(bindings_mutex_);
-                for (auto& binding : bindings_) {
+                for (const auto& binding : bindings_) {
                     // Mark bindings as dirty if they might be affected by status changes
-                    if (binding.getDataSource()->getName().find("status") != std::string::npos ||
-                        binding.getBindingId().find(event.getStatusType()) != std::string::npos) {
-                        binding.setDirty(true);
+                    if (binding->getDataSource()->getName().find("status") != std::string::npos ||
+                        binding->getBindingId().find(event.getStatusType()) != std::string::npos) {
+                        binding->setDirty(true);
+                        queueLocked(binding);
                     }
                 }
             }
@@ -252,9 +372,7 @@ void DataBindingManager::setupEventSubscriptions() {
 
 void DataBindingManager::cleanupEventSubscriptions() {
     for (auto& subscription : event_subscriptions_) {
-        if (subscription) {
-            subscription->unsubscribe();
-        }
+        subscription.unsubscribe();
     }
     event_subscriptions_.clear();
 }
@@ -265,31 +383,112 @@ void DataBindingManager::updateBinding(DataBinding& binding) {
         return;
     }
     
-    // Check if data has actually changed
-    if (!data_source->hasChanged() && !binding.isDirty()) {
-        return;
-    }
-    
     try {
-        // Get the data
-        std::any data = data_source->getData();
+        if (!binding.dependencies_.empty()) {
+            recomputeIfInputsChanged(binding);
+        }
+        
+        // Skip bindings whose source has not moved since the last delivery,
+        // without running the provider.
+        const std::uint64_t version = data_source->getVersion();
+        if (version == binding.getDeliveredVersion() && !binding.isDirty()) {
+            return;
+        }
         
         // Update the binding timestamp
         binding.setLastUpdateTimestamp(getCurrentTimestamp());
+        binding.setDeliveredVersion(version);
         binding.setDirty(false);
         
         total_updates_.fetch_add(1);
         
-        // In a real implementation, you would invoke the stored callback here
-        // For now, we just log the update
-        std::cout << "Updated binding: " << binding.getBindingId() 
-                  << " (data type: " << data_source->getDataType().name() << ")" << std::endl;
+        // Runs the provider only if no binding has read this version yet
+        binding.deliver();
         
     } catch (const std::exception& e) {
         std::cerr << "Error updating binding '" << binding.getBindingId() << "': " 
                   << e.what() << std::endl;
-        binding.setDirty(true); // Mark as dirty for retry
+        // Mark as dirty for retry, recomputing from the inputs again
+        binding.setDirty(true);
+        std::fill(binding.input_versions_.begin(), binding.input_versions_.end(), 0);
+    }
+}
+
+void DataBindingManager::recomputeIfInputsChanged(DataBinding& binding) {
+    bool inputs_changed = false;
+    for (size_t i = 0; i < binding.dependencies_.size(); ++i) {
+        const std::uint64_t input_version = binding.dependencies_[i]->getDataSource()->getVersion();
+        if (input_version != binding.input_versions_[i]) {
+            binding.input_versions_[i] = input_version;
+            inputs_changed = true;
+        }
+    }
+    if (inputs_changed) {
+        // Only moves the version when the computed value differs.
+        binding.getDataSource()->refresh();
+    }
+}
+
+void DataBindingManager::onSourceChanged(IDataSource& source) {
+    std::lock_guard<std::mutex> lock(bindings_mutex_);
+    auto it = source_bindings_.find(&source);
+    if (it == source_bindings_.end()) {
+        return;
     }
+    for (const BindingPtr& binding : it->second) {
+        queueLocked(binding);
+    }
+}
+
+void DataBindingManager::queueLocked(const BindingPtr& binding) {
+    // A binding still waiting in the current pass will read the change there.
+    if (binding->queued_ || binding->in_pass_ || binding->removed_) {
+        return;
+    }
+    binding->queued_ = true;
+    dirty_queue_.push_back(binding);
+    
+    // Dependents are visited too; they recompute only if this input moved.
+    for (const auto& dependent : binding->dependents_) {
+        if (BindingPtr next = dependent.lock()) {
+            queueLocked(next);
+        }
+    }
+}
+
+void DataBindingManager::finishUpdateLocked(const BindingPtr& binding) {
+    binding->in_pass_ = false;
+    // A failed delivery, or a change made while the binding was being
+    // delivered, is retried on the next update.
+    if (binding->needsUpdate()) {
+        queueLocked(binding);
+    }
+}
+
+void DataBindingManager::detachSourceLocked(const BindingPtr& binding) {
+    auto it = source_bindings_.find(binding->getDataSource().get());
+    if (it == source_bindings_.end()) {
+        return;
+    }
+    auto& readers = it->second;
+    readers.erase(std::remove(readers.begin(), readers.end(), binding), readers.end());
+    if (readers.empty()) {
+        binding->getDataSource()->setChangeListener(nullptr);
+        source_bindings_.erase(it);
+    }
+}
+
+void DataBindingManager::clearBindingsLocked() {
+    for (const BindingPtr& binding : bindings_) {
+        binding->removed_ = true;
+    }
+    for (const auto& entry : source_bindings_) {
+        entry.second.front()->getDataSource()->setChangeListener(nullptr);
+    }
+    source_bindings_.clear();
+    dirty_queue_.clear();
+    bindings_.clear();
+    binding_index_map_.clear();
 }
 
 std::uint64_t DataBindingManager::getCurrentTimestamp() const {
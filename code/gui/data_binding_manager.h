@@ -13,16 +13,35 @@
 #include <atomic>
 #include <typeindex>
 #include <any>
+#include <type_traits>
+#include <utility>
 
 namespace cataclysm {
 namespace gui {
 
+namespace detail {
+
+template<typename T, typename = void>
+struct is_equality_comparable : std::false_type {};
+
+template<typename T>
+struct is_equality_comparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+    : std::true_type {};
+
+} // namespace detail
+
 /**
  * Interface for data sources that can provide data for binding.
  * Implementations should provide type-safe access to data values.
+ *
+ * Sources are push-based: whoever owns the underlying data calls
+ * markChanged() when it changes, which bumps the source version and tells
+ * the manager to queue the bindings that read it. Nothing is polled.
  */
 class IDataSource {
 public:
+    using ChangeListener = std::function<void(IDataSource&)>;
+
     virtual ~IDataSource() = default;
     
     /**
@@ -51,12 +70,56 @@ public:
     
     /**
      * Force a data refresh (useful for polling-based data sources).
+     * Sources that can compare values only report a change when the value differs.
+     */
+    virtual void refresh() { markChanged(); }
+
+    /**
+     * Get the current version. It starts at 1 and increases on every change.
+     * @return Version counter of the underlying data
+     */
+    std::uint64_t getVersion() const { return version_.load(std::memory_order_acquire); }
+
+    /**
+     * Record that the underlying data changed and notify the listener.
      */
-    virtual void refresh() {}
+    void markChanged() {
+        version_.fetch_add(1, std::memory_order_acq_rel);
+        notifyListener();
+    }
+
+    /**
+     * Set the listener told about markChanged(). A source feeds one manager.
+     * @param listener Listener to invoke, or an empty function to clear it
+     */
+    void setChangeListener(ChangeListener listener) {
+        std::lock_guard<std::mutex> lock(listener_mutex_);
+        listener_ = std::move(listener);
+    }
+
+protected:
+    void notifyListener() {
+        ChangeListener listener;
+        {
+            std::lock_guard<std::mutex> lock(listener_mutex_);
+            listener = listener_;
+        }
+        if (listener) {
+            listener(*this);
+        }
+    }
+
+    std::atomic<std::uint64_t> version_{1};
+
+private:
+    std::mutex listener_mutex_;
+    ChangeListener listener_;
 };
 
 /**
  * Template implementation of IDataSource for type-safe data access.
+ * The provider runs at most once per source version; reads in between
+ * return the cached value.
  */
 template<typename T>
 class TypedDataSource : public IDataSource {
@@ -74,85 +137,193 @@ public:
     }
     
     bool hasChanged() const override {
-        T current_value = data_provider_();
-        if (!has_value_) {
-            return true;
-        }
-        return current_value != last_value_;
+        std::lock_guard<std::mutex> lock(value_mutex_);
+        return !has_value_ || cached_version_ != getVersion();
     }
     
     std::any getData() const override {
-        return data_provider_();
+        std::lock_guard<std::mutex> lock(value_mutex_);
+        return readLocked();
     }
     
     void refresh() override {
-        // Force a data refresh for polling-based sources
-        // This is a no-op for function-based sources but can be overridden
+        if constexpr (detail::is_equality_comparable<T>::value) {
+            {
+                std::lock_guard<std::mutex> lock(value_mutex_);
+                T current_value = data_provider_();
+                ++provider_calls_;
+                if (has_value_ && current_value == last_value_) {
+                    return;
+                }
+                last_value_ = std::move(current_value);
+                has_value_ = true;
+                cached_version_ = version_.fetch_add(1, std::memory_order_acq_rel) + 1;
+            }
+            notifyListener();
+        } else {
+            markChanged();
+        }
     }
+
     
     /**
      * Get the current value directly (type-safe).
      * @return Current value
      */
     T getValue() const {
-        return data_provider_();
+        std::lock_guard<std::mutex> lock(value_mutex_);
+        return readLocked();
+    }
+
+    /**
+     * Copy the current value into storage owned by the caller, reusing its
+     * capacity; no type-erased temporary is built.
+     * @param destination Value to overwrite
+     */
+    void copyTo(T& destination) const {
+        std::lock_guard<std::mutex> lock(value_mutex_);
+        destination = readLocked();
+    }
+
+    /**
+     * @return How many times the provider has run, for diagnostics.
+     */
+    std::uint64_t getProviderCallCount() const {
+        std::lock_guard<std::mutex> lock(value_mutex_);
+        return provider_calls_;
     }
     
 private:
+    const T& readLocked() const {
+        const std::uint64_t version = getVersion();
+        if (!has_value_ || cached_version_ != version) {
+            last_value_ = data_provider_();
+            has_value_ = true;
+            cached_version_ = version;
+            ++provider_calls_;
+        }
+        return last_value_;
+    }
+
     std::string name_;
     std::function<T()> data_provider_;
+    mutable std::mutex value_mutex_;
     mutable T last_value_;
     mutable bool has_value_;
+    mutable std::uint64_t cached_version_ = 0;
+    mutable std::uint64_t provider_calls_ = 0;
 };
 
+/**
+ * Callback for data binding updates.
+ * Called when bound data changes and UI needs to be updated.
+ */
+using DataBindingUpdateCallback = std::function<void(const std::string& binding_id, std::any data)>;
+
 /**
  * Data binding between a GUI element and a data source.
- * Handles automatic updates when the source data changes.
+ * Remembers which source version it last delivered so that unchanged sources
+ * are skipped without running their provider.
  */
 class DataBinding {
 public:
-    DataBinding() = default;
-    
-    DataBinding(std::string binding_id, std::shared_ptr<IDataSource> data_source)
+    DataBinding(std::string binding_id, std::shared_ptr<IDataSource> data_source,
+                DataBindingUpdateCallback update_callback)
         : binding_id_(std::move(binding_id)), data_source_(std::move(data_source)),
-          dirty_(true), last_update_timestamp_(0) {}
+          update_callback_(std::move(update_callback)) {}
     
-    // Delete copy operations, allow move
+    virtual ~DataBinding() = default;
+
     DataBinding(const DataBinding&) = delete;
     DataBinding& operator=(const DataBinding&) = delete;
     
-    DataBinding(DataBinding&&) = default;
-    DataBinding& operator=(DataBinding&&) = default;
-    
     const std::string& getBindingId() const { return binding_id_; }
     std::shared_ptr<IDataSource> getDataSource() const { return data_source_; }
+    const DataBindingUpdateCallback& getUpdateCallback() const { return update_callback_; }
     
     bool isDirty() const { return dirty_.load(); }
     void setDirty(bool dirty) { dirty_.store(dirty); }
     
     std::uint64_t getLastUpdateTimestamp() const { return last_update_timestamp_; }
     void setLastUpdateTimestamp(std::uint64_t timestamp) { last_update_timestamp_ = timestamp; }
+
+    std::uint64_t getDeliveredVersion() const { return delivered_version_; }
+    void setDeliveredVersion(std::uint64_t version) { delivered_version_ = version; }
     
     /**
      * Check if this binding should be updated.
-     * @return true if the binding needs updating
+     * @return true if marked dirty or the source moved past the delivered version
      */
     bool needsUpdate() const {
-        return dirty_.load() || (data_source_ && data_source_->hasChanged());
+        return dirty_.load() || (data_source_ && data_source_->getVersion() != delivered_version_);
+    }
+
+protected:
+    /**
+     * Read the source and hand the value to the subscriber.
+     * The base binding delivers a std::any copy to update_callback_.
+     */
+    virtual void deliver() {
+        std::any data = data_source_->getData();
+        if (update_callback_) {
+            update_callback_(binding_id_, std::move(data));
+        }
     }
 
 private:
+    friend class DataBindingManager;
+
     std::string binding_id_;
     std::shared_ptr<IDataSource> data_source_;
-    std::atomic<bool> dirty_;
-    std::uint64_t last_update_timestamp_;
+    DataBindingUpdateCallback update_callback_;
+    std::atomic<bool> dirty_{true};
+    std::uint64_t last_update_timestamp_ = 0;
+    std::uint64_t delivered_version_ = 0;
+    // Guarded by the manager's bindings mutex.
+    bool queued_ = false;
+    bool in_pass_ = false; // Taken by the running update and not yet finished
+    bool removed_ = false;
+    bool inventory_related_ = false;
+    // Dependency graph. Dependencies must exist before their dependents, so
+    // the graph is acyclic by construction and rank_ is a topological order.
+    std::vector<std::shared_ptr<DataBinding>> dependencies_;
+    std::vector<std::uint64_t> input_versions_;
+    std::vector<std::weak_ptr<DataBinding>> dependents_;
+    int rank_ = 0;
 };
 
 /**
- * Callback for data binding updates.
- * Called when bound data changes and UI needs to be updated.
+ * Binding that keeps its own copy of the source value and hands subscribers
+ * a const reference to it, avoiding the std::any copy of the base binding.
  */
-using DataBindingUpdateCallback = std::function<void(const std::string& binding_id, std::any data)>;
+template<typename T>
+class TypedDataBinding : public DataBinding {
+public:
+    using Callback = std::function<void(const T&)>;
+
+    TypedDataBinding(std::string binding_id, std::shared_ptr<TypedDataSource<T>> data_source,
+                     Callback update_callback)
+        : DataBinding(std::move(binding_id), data_source, nullptr),
+          typed_source_(std::move(data_source)), typed_callback_(std::move(update_callback)) {}
+
+    /**
+     * @return The value last delivered to the subscriber.
+     */
+    const T& getValue() const { return value_; }
+
+protected:
+    void deliver() override {
+        typed_source_->copyTo(value_);
+        if (typed_callback_) {
+            typed_callback_(value_);
+        }
+    }
+
+private:
+    std::shared_ptr<TypedDataSource<T>> typed_source_;
+    Callback typed_callback_;
+    T value_{};
+};
 
 /**
  * Manager for data bindings between GUI components and data sources.
@@ -192,18 +363,84 @@ public:
                       std::shared_ptr<IDataSource> data_source,
                       DataBindingUpdateCallback update_callback);
     
+    /**
+     * Create a typed data binding. The subscriber receives a const reference
+     * to a value cached in the binding, so updates make no std::any copies.
+     * @tparam T Type provided by the source
+     * @param binding_id Unique identifier for the binding
+     * @param data_source Source created for T, e.g. by DataSourceBuilder::create<T>
+     * @param update_callback Callback to invoke when data changes
+     * @return true if binding was created successfully
+     */
+    template<typename T>
+    bool createBinding(const std::string& binding_id,
+                       std::shared_ptr<IDataSource> data_source,
+                       std::function<void(const T&)> update_callback) {
+        auto typed_source = std::dynamic_pointer_cast<TypedDataSource<T>>(data_source);
+        if (!typed_source) {
+            reportCreateFailure(binding_id, data_source ? "data source type mismatch" : "invalid data source");
+            return false;
+        }
+        return addBinding(std::make_shared<TypedDataBinding<T>>(binding_id, std::move(typed_source),
+                                                                std::move(update_callback)));
+    }
+    
+    /**
+     * Create a binding whose value is derived from other bindings.
+     * The value is recomputed, in dependency order, on the first update
+     * after any dependency's source version moved. Comparable values that
+     * come out unchanged do not propagate, so their dependents are skipped.
+     * @tparam T Type of the computed value
+     * @param binding_id Unique identifier, also the computed source name
+     * @param dependency_ids Existing bindings this value is computed from
+     * @param compute Function producing the value from the dependencies
+     * @param update_callback Callback to invoke when the value changes
+     * @return true if the binding was created
+     */
+    template<typename T>
+    bool createComputedBinding(const std::string& binding_id,
+                               const std::vector<std::string>& dependency_ids,
+                               std::function<T()> compute,
+                               std::function<void(const T&)> update_callback) {
+        if (dependency_ids.empty() || !compute) {
+            reportCreateFailure(binding_id, "computed binding needs dependencies and a compute function");
+            return false;
+        }
+        auto source = std::make_shared<TypedDataSource<T>>(binding_id, std::move(compute));
+        return addBinding(std::make_shared<TypedDataBinding<T>>(binding_id, std::move(source),
+                                                                std::move(update_callback)),
+                          dependency_ids);
+    }
+    
     /**
      * Remove a data binding.
      * @param binding_id ID of the binding to remove
-     * @return true if binding was found and removed
+     * @return true if binding was found and removed; bindings that other
+     *         bindings depend on are kept
      */
     bool removeBinding(const std::string& binding_id);
     
     /**
-     * Update all dirty bindings.
-     * This should be called during the UI update cycle.
+     * Update the bindings queued since the last call.
+     * This should be called during the UI update cycle. Only queued bindings
+     * are visited; each source's provider runs at most once.
      */
     void updateDirtyBindings();
+
+    /**
+     * Queue a binding for redelivery on the next update even if its source
+     * version is unchanged.
+     * @param binding_id ID of the binding to mark
+     * @return true if the binding exists
+     */
+    bool markBindingDirty(const std::string& binding_id);
+
+    /**
+     * Bump every source with the given name and queue its bindings.
+     * @param source_name Name reported by IDataSource::getName()
+     * @return Number of bindings queued
+     */
+    size_t markSourceChanged(const std::string& source_name);
     
     /**
      * Force update of a specific binding.
@@ -242,16 +479,29 @@ public:
     bool isEmpty() const;
 
 private:
+    using BindingPtr = std::shared_ptr<DataBinding>;
+
+    bool addBinding(BindingPtr binding, const std::vector<std::string>& dependency_ids = {});
+    static void reportCreateFailure(const std::string& binding_id, const char* reason);
     void setupEventSubscriptions();
     void cleanupEventSubscriptions();
     void updateBinding(DataBinding& binding);
+    static void recomputeIfInputsChanged(DataBinding& binding);
     std::uint64_t getCurrentTimestamp() const;
+    void onSourceChanged(IDataSource& source);
+    void queueLocked(const BindingPtr& binding);
+    void finishUpdateLocked(const BindingPtr& binding);
+    void detachSourceLocked(const BindingPtr& binding);
+    void clearBindingsLocked();
     
     EventBusAdapter& event_adapter_;
-    std::vector<DataBinding> bindings_;
+    std::vector<BindingPtr> bindings_;
     std::unordered_map<std::string, size_t> binding_index_map_;
+    // Bindings per source, so a source change queues only its readers.
+    std::unordered_map<const IDataSource*, std::vector<BindingPtr>> source_bindings_;
+    std::vector<BindingPtr> dirty_queue_;
     mutable std::mutex bindings_mutex_;
-    std::vector<std::shared_ptr<EventSubscription>> event_subscriptions_;
+    std::vector<EventSubscription> event_subscriptions_;
     std::atomic<bool> initialized_;
     std::atomic<int> update_rate_limit_ms_;
     std::atomic<uint64_t> total_updates_;
@@ -0,0 +1,146 @@
+#include "debug.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* LevelName(DebugLevel level) {
+    switch (level) {
+        case DebugLevel::Trace: return "TRACE";
+        case DebugLevel::Debug: return "DEBUG";
+        case DebugLevel::Info: return "INFO";
+        case DebugLevel::Warning: return "WARNING";
+        case DebugLevel::Error: return "ERROR";
+    }
+    return "?";
+}
+
+void WriteToClog(DebugLevel level, const std::string& message) {
+    std::clog << '[' << LevelName(level) << "] " << message << '\n';
+}
+
+/**
+ * Double-buffered sink. Callers append under a short lock; the worker swaps
+ * the buffer out and writes the batch with a single flush, so the UI thread
+ * never waits on the stream.
+ */
+class DebugLogSink {
+public:
+    // Leaked on purpose so destructors of other statics can still log; the
+    // worker is left waiting at exit and pending lines are flushed instead.
+    static DebugLogSink& Get() {
+        static DebugLogSink* const sink = [] {
+            DebugLogSink* created = new DebugLogSink();
+            std::atexit([] { flushDebugLog(); });
+            return created;
+        }();
+        return *sink;
+    }
+
+    void Submit(DebugLevel level, std::string&& message) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.size() >= kMaxPending) {
+                ++dropped_;
+                return;
+            }
+            pending_.push_back({level, std::move(message)});
+            ++submitted_;
+            if (!worker_.joinable()) {
+                worker_ = std::thread(&DebugLogSink::Run, this);
+            }
+        }
+        wake_.notify_one();
+    }
+
+    void SetWriter(DebugLogWriter writer) {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        writer_ = writer ? std::move(writer) : DebugLogWriter(WriteToClog);
+    }
+
+    void Flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const uint64_t target = submitted_;
+        written_.wait(lock, [&] { return completed_ >= target || !worker_.joinable(); });
+    }
+
+    std::size_t GetDroppedCount() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+private:
+    struct Line {
+        DebugLevel level;
+        std::string message;
+    };
+
+    static constexpr std::size_t kMaxPending = 4096;
+
+    DebugLogSink() : writer_(WriteToClog) {}
+
+    void Run() {
+        std::vector<Line> batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return !pending_.empty(); });
+            batch.swap(pending_);
+            lock.unlock();
+
+            {
+                std::lock_guard<std::mutex> writer_lock(writer_mutex_);
+                for (const Line& line : batch) {
+                    writer_(line.level, line.message);
+                }
+            }
+            std::clog.flush();
+
+            const std::size_t count = batch.size();
+            batch.clear();
+            lock.lock();
+            completed_ += count;
+            written_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable written_;
+    std::vector<Line> pending_;
+    uint64_t submitted_ = 0;
+    uint64_t completed_ = 0;
+    std::size_t dropped_ = 0;
+
+    std::mutex writer_mutex_;
+    DebugLogWriter writer_;
+
+    std::thread worker_;
+};
+
+} // namespace
+
+namespace debug_detail {
+
+void submit(DebugLevel level, std::string&& message) {
+    DebugLogSink::Get().Submit(level, std::move(message));
+}
+
+} // namespace debug_detail
+
+void setDebugLogWriter(DebugLogWriter writer) {
+    DebugLogSink::Get().SetWriter(std::move(writer));
+}
+
+void flushDebugLog() {
+    DebugLogSink::Get().Flush();
+}
+
+std::size_t getDroppedDebugLogCount() {
+    return DebugLogSink::Get().GetDroppedCount();
+}
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <initializer_list>
+#include <sstream>
+#include <string>
+#include <utility>
 
 enum class DebugLevel {
     Trace,
@@ -10,9 +16,77 @@ enum class DebugLevel {
     Error
 };
 
+// Messages below this level are compiled out. Set through the
+// GUI_LOG_MIN_LEVEL cache variable in CMake (0 = Trace ... 4 = Error).
+#ifndef GUI_LOG_MIN_LEVEL
+#define GUI_LOG_MIN_LEVEL 0
+#endif
+
+constexpr DebugLevel kDebugLogCompiledMinLevel = static_cast<DebugLevel>(GUI_LOG_MIN_LEVEL);
+
+using DebugLogWriter = std::function<void(DebugLevel, const std::string&)>;
+
+namespace debug_detail {
+
+// Warning by default; Info and below are opt-in with setDebugLogLevel()
+inline std::atomic<int> runtime_min_level{static_cast<int>(DebugLevel::Warning)};
+
+/**
+ * Hands a formatted line to the background sink. Never blocks on output;
+ * lines are dropped (and counted) when the sink falls too far behind.
+ */
+void submit(DebugLevel level, std::string&& message);
+
+} // namespace debug_detail
+
+/**
+ * Sets the lowest level that is logged at runtime.
+ * @param level Messages below this level are discarded before formatting.
+ */
+inline void setDebugLogLevel(DebugLevel level) {
+    debug_detail::runtime_min_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+inline DebugLevel getDebugLogLevel() {
+    return static_cast<DebugLevel>(debug_detail::runtime_min_level.load(std::memory_order_relaxed));
+}
+
+/**
+ * @return True when a message at this level would be logged.
+ */
+inline bool isDebugLogEnabled(DebugLevel level) {
+    return level >= kDebugLogCompiledMinLevel &&
+           static_cast<int>(level) >= debug_detail::runtime_min_level.load(std::memory_order_relaxed);
+}
+
+/**
+ * Replaces the sink's output. The writer runs on the sink thread.
+ * @param writer Receives each line; nullptr restores the default std::clog writer.
+ */
+void setDebugLogWriter(DebugLogWriter writer);
+
+/**
+ * Blocks until every line submitted so far has been written.
+ */
+void flushDebugLog();
+
+/**
+ * @return How many lines were dropped because the sink was full.
+ */
+std::size_t getDroppedDebugLogCount();
+
+/**
+ * Logs the concatenation of args. The level check comes first, so filtered
+ * messages cost a relaxed load and none of their arguments are formatted;
+ * levels below GUI_LOG_MIN_LEVEL fold away entirely. Formatting happens on
+ * the caller, output on the sink thread.
+ */
 template <typename... Args>
 inline void debuglog(DebugLevel level, Args&&... args) {
-    (void)level;
-    (void)std::initializer_list<int>{((void)args, 0)...};
+    if (!isDebugLogEnabled(level)) {
+        return;
+    }
+    std::ostringstream out;
+    (void)std::initializer_list<int>{((out << std::forward<Args>(args)), 0)...};
+    debug_detail::submit(level, out.str());
 }
-
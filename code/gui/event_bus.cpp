@@ -1,125 +1,423 @@
 #include "event_bus.h"
+#include <chrono>
 #include <iostream>
+#include <map>
 
 namespace cataclysm {
 namespace gui {
 
+namespace detail {
+
+namespace {
+
+std::mutex& registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_map<std::type_index, size_t>& registryIds() {
+    static std::unordered_map<std::type_index, size_t> ids;
+    return ids;
+}
+
+} // namespace
+
+size_t EventTypeRegistry::registerType(const std::type_index& type) {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    auto& ids = registryIds();
+    auto it = ids.find(type);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    const size_t id = ids.size();
+    ids.emplace(type, id);
+    return id;
+}
+
+void HandlerCounters::record(uint64_t elapsed_ns) {
+    invocations_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(elapsed_ns, std::memory_order_relaxed);
+
+    uint64_t previous_max = max_ns_.load(std::memory_order_relaxed);
+    while (elapsed_ns > previous_max &&
+           !max_ns_.compare_exchange_weak(previous_max, elapsed_ns, std::memory_order_relaxed)) {
+    }
+
+    size_t bucket = 0;
+    while ((elapsed_ns >> 1) != 0 && bucket + 1 < histogram_.size()) {
+        elapsed_ns >>= 1;
+        ++bucket;
+    }
+    histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void HandlerCounters::reset() {
+    invocations_.store(0, std::memory_order_relaxed);
+    total_ns_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+    for (auto& bucket : histogram_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+EventHandlerProfile HandlerCounters::snapshot() const {
+    EventHandlerProfile profile;
+    profile.invocations = invocations_.load(std::memory_order_relaxed);
+    profile.total_ns = total_ns_.load(std::memory_order_relaxed);
+    profile.max_ns = max_ns_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < histogram_.size(); ++i) {
+        profile.latency_histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+    }
+    return profile;
+}
+
+} // namespace detail
+
 // EventBus implementation
-EventBus::EventBus() = default;
+EventBus::EventBus(size_t posted_event_capacity)
+    : subscriptions_(std::make_shared<const SubscriptionTable>()),
+      dynamic_routes_(std::make_shared<const DynamicRouteMap>()),
+      posted_events_(posted_event_capacity) {}
 
 EventBus::~EventBus() {
     clearAll();
 }
 
+void EventBus::publishDynamic(const Event& event) {
+    const auto routes = std::atomic_load(&dynamic_routes_);
+    auto it = routes->find(std::type_index(typeid(event)));
+    if (it == routes->end()) {
+        // Nobody has ever subscribed to this type, so there is no one to deliver to.
+        return;
+    }
+    it->second(*this, event);
+}
+
 void EventBus::publishDynamic(const std::unique_ptr<Event>& event) {
-    if (!event) {
+    if (event) {
+        publishDynamic(*event);
+    }
+}
+
+void EventBus::registerDynamicRoute(const DynamicRoute& route) {
+    if (!route.trampoline) {
         return;
     }
+    const auto current = std::atomic_load(&dynamic_routes_);
+    const std::type_index type(*route.type);
+    if (current->count(type) != 0) {
+        return;
+    }
+    auto routes = std::make_shared<DynamicRouteMap>(*current);
+    routes->emplace(type, route.trampoline);
+    std::atomic_store(&dynamic_routes_, std::shared_ptr<const DynamicRouteMap>(std::move(routes)));
+}
 
-    const std::type_index type_index(typeid(*event));
-    std::vector<std::shared_ptr<EventSubscription>> subscriptions_copy;
+namespace {
+constexpr size_t kInitialQueueCapacity = 64;
+} // namespace
 
-    {
-        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-        auto it = subscriptions_.find(type_index);
-        if (it == subscriptions_.end()) {
-            return;
+void EventBus::setCoalesceRule(size_t type_id, std::unique_ptr<CoalesceRule> rule) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (coalesce_rules_.size() <= type_id) {
+        coalesce_rules_.resize(type_id + 1);
+    }
+    coalesce_rules_[type_id] = std::move(rule);
+}
+
+bool EventBus::coalesceQueued(std::unique_ptr<QueuedEvent>& incoming) {
+    const size_t type_id = incoming->typeId();
+    if (type_id >= coalesce_rules_.size() || !coalesce_rules_[type_id]) {
+        return false;
+    }
+    const CoalesceRule& rule = *coalesce_rules_[type_id];
+
+    // Newest first: bursts usually repeat the most recently queued event.
+    // Merged counts must keep their place relative to everything else, so
+    // MergeCount only folds into the newest event.
+    const size_t mask = queue_slots_.size() - 1;
+    const size_t oldest = rule.mode() == CoalesceMode::MergeCount ? queue_size_ - 1 : 0;
+    for (size_t i = queue_size_; i > oldest; --i) {
+        auto& slot = queue_slots_[(queue_head_ + i - 1) & mask];
+        if (slot->typeId() != type_id || !rule.matches(*slot, *incoming)) {
+            continue;
+        }
+
+        switch (rule.mode()) {
+            case CoalesceMode::LatestWins:
+                slot = std::move(incoming);
+                break;
+            case CoalesceMode::MergeCount:
+                rule.merge(*slot, *incoming);
+                break;
+            case CoalesceMode::DedupeIdentical:
+            case CoalesceMode::None:
+                break;
         }
-        subscriptions_copy = it->second;
+        return true;
+    }
+    return false;
+}
+
+void EventBus::enqueueInternal(std::unique_ptr<QueuedEvent> event) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+
+    if (queue_size_ > 0 && coalesceQueued(event)) {
+        return;
     }
 
-    for (const auto& subscription : subscriptions_copy) {
-        if (subscription && subscription->isActive()) {
-            try {
-                // Dynamic dispatch not implemented; prefer typed publish.
-            } catch (const std::exception& e) {
-                std::cerr << "Error publishing dynamic event: " << e.what() << std::endl;
+    if (queue_size_ == queue_slots_.size()) {
+        const size_t new_capacity = queue_slots_.empty() ? kInitialQueueCapacity : queue_slots_.size() * 2;
+        std::vector<std::unique_ptr<QueuedEvent>> grown(new_capacity);
+        for (size_t i = 0; i < queue_size_; ++i) {
+            grown[i] = std::move(queue_slots_[(queue_head_ + i) & (queue_slots_.size() - 1)]);
+        }
+        queue_slots_ = std::move(grown);
+        queue_head_ = 0;
+    }
+
+    queue_slots_[(queue_head_ + queue_size_) & (queue_slots_.size() - 1)] = std::move(event);
+    ++queue_size_;
+}
+
+size_t EventBus::flush() {
+    size_t pending = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        pending = queue_size_;
+    }
+
+    size_t delivered = 0;
+    while (delivered < pending) {
+        std::unique_ptr<QueuedEvent> next;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (queue_size_ == 0) {
+                break;
             }
+            next = std::move(queue_slots_[queue_head_]);
+            queue_head_ = (queue_head_ + 1) & (queue_slots_.size() - 1);
+            --queue_size_;
         }
+
+        try {
+            next->dispatch(*this);
+        } catch (const std::exception& e) {
+            std::cerr << "Error dispatching queued event: " << e.what() << std::endl;
+        }
+        ++delivered;
     }
+    return delivered;
+}
 
+size_t EventBus::discardQueued() {
+    std::vector<std::unique_ptr<QueuedEvent>> dropped;
     {
-        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-        auto it = subscriptions_.find(type_index);
-        if (it == subscriptions_.end()) {
-            return;
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        dropped.reserve(queue_size_);
+        for (size_t i = 0; i < queue_size_; ++i) {
+            dropped.push_back(std::move(queue_slots_[(queue_head_ + i) & (queue_slots_.size() - 1)]));
         }
+        queue_head_ = 0;
+        queue_size_ = 0;
+    }
+    return dropped.size();
+}
 
-        auto& stored = it->second;
-        stored.erase(
-            std::remove_if(stored.begin(), stored.end(),
-                           [](const auto& sub) { return !sub || !sub->isActive(); }),
-            stored.end());
+size_t EventBus::getQueuedEventCount() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return queue_size_;
+}
 
-        if (stored.empty()) {
-            subscriptions_.erase(it);
+size_t EventBus::dispatchPosted() {
+    // Bound the drain to one channel's worth so producers can't starve the frame.
+    const size_t limit = posted_events_.capacity();
+    size_t delivered = 0;
+    std::unique_ptr<QueuedEvent> next;
+    while (delivered < limit && posted_events_.tryPop(next)) {
+        try {
+            next->dispatch(*this);
+        } catch (const std::exception& e) {
+            std::cerr << "Error dispatching posted event: " << e.what() << std::endl;
         }
+        next.reset();
+        ++delivered;
     }
+    return delivered;
 }
 
-void EventBus::unsubscribeInternal(const std::type_index& event_type) {
-    auto it = subscriptions_.find(event_type);
-    if (it != subscriptions_.end()) {
-        for (auto& subscription : it->second) {
-            if (subscription) {
-                subscription->deactivate();
-            }
+size_t EventBus::getDroppedPostedEventCount() const {
+    return dropped_posted_events_.load(std::memory_order_relaxed);
+}
+
+EventSubscription EventBus::addSubscription(size_t type_id, const char* type_name, const DynamicRoute& route,
+                                            SubscriptionCallback callback) {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    registerDynamicRoute(route);
+
+    if (free_records_.empty()) {
+        const auto base = static_cast<uint32_t>(slab_chunks_.size() * kSlabChunkSize);
+        auto chunk = std::make_unique<SubscriptionRecord[]>(kSlabChunkSize);
+        for (uint32_t i = 0; i < kSlabChunkSize; ++i) {
+            chunk[i].index = base + i;
+        }
+        slab_chunks_.push_back(std::move(chunk));
+        // Hand out low indices first.
+        for (uint32_t i = kSlabChunkSize; i > 0; --i) {
+            free_records_.push_back(base + i - 1);
         }
-        subscriptions_.erase(it);
     }
+    const uint32_t index = free_records_.back();
+    free_records_.pop_back();
+
+    SubscriptionRecord& record = recordAt(index);
+    record.callback = std::move(callback);
+    record.type_id = static_cast<uint32_t>(type_id);
+    record.type_name = type_name;
+    record.profile.reset();
+    record.active.store(true, std::memory_order_release);
+
+    const auto current = loadSnapshot();
+    auto table = std::make_shared<SubscriptionTable>(*current);
+    if (table->size() <= type_id) {
+        table->resize(type_id + 1);
+    }
+
+    auto list = std::make_shared<SubscriptionList>();
+    if (const SubscriptionList* existing = findList(*current, type_id)) {
+        list->reserve(existing->size() + 1);
+        *list = *existing;
+    }
+    list->push_back(&record);
+
+    (*table)[type_id] = std::move(list);
+    storeSnapshot(std::move(table));
+
+    return EventSubscription(this, index, record.generation);
+}
+
+EventBus::SubscriptionRecord* EventBus::findRecord(uint32_t index, uint32_t generation) {
+    if (index >= slab_chunks_.size() * kSlabChunkSize) {
+        return nullptr;
+    }
+    SubscriptionRecord& record = recordAt(index);
+    if (record.generation != generation || !record.active.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &record;
 }
 
-void EventBus::unsubscribeInternal(const std::type_index& event_type, size_t subscription_id) {
-    auto it = subscriptions_.find(event_type);
-    if (it == subscriptions_.end()) {
+void EventBus::retireRecord(SubscriptionRecord& record) {
+    record.active.store(false, std::memory_order_release);
+    ++record.generation;
+    retired_records_.push_back(record.index);
+}
+
+void EventBus::reclaimRetiredLocked() {
+    if (retired_records_.empty()) {
+        return;
+    }
+    has_retired_records_.store(true);
+    // A publisher that starts after this check loads a table that no longer
+    // references the retired records; one already running keeps them alive.
+    if (publishes_in_flight_.load() != 0) {
+        return;
+    }
+    for (uint32_t index : retired_records_) {
+        recordAt(index).callback.reset();
+        free_records_.push_back(index);
+    }
+    retired_records_.clear();
+    has_retired_records_.store(false);
+}
+
+void EventBus::reclaimRetired() {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    reclaimRetiredLocked();
+}
+
+void EventBus::unsubscribeInternal(size_t type_id) {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+
+    const auto current = loadSnapshot();
+    const SubscriptionList* existing = findList(*current, type_id);
+    if (!existing) {
         return;
     }
 
-    auto& subscriptions = it->second;
-    subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
-                                       [subscription_id](const auto& subscription) {
-                                           if (!subscription) {
-                                               return true;
-                                           }
-                                           if (subscription->getId() == subscription_id) {
-                                               subscription->deactivate();
-                                               return true;
-                                           }
-                                           if (!subscription->isActive()) {
-                                               return true;
-                                           }
-                                           return false;
-                                       }),
-                        subscriptions.end());
+    auto table = std::make_shared<SubscriptionTable>(*current);
+    (*table)[type_id].reset();
+    storeSnapshot(std::move(table));
 
-    if (subscriptions.empty()) {
-        subscriptions_.erase(it);
+    for (SubscriptionRecord* record : *existing) {
+        retireRecord(*record);
     }
+    reclaimRetiredLocked();
 }
 
-void EventBus::unsubscribeById(const std::type_index& event_type, size_t subscription_id) {
+void EventBus::unsubscribeHandle(uint32_t index, uint32_t generation) {
     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-    unsubscribeInternal(event_type, subscription_id);
+
+    SubscriptionRecord* record = findRecord(index, generation);
+    if (!record) {
+        return;
+    }
+
+    const auto current = loadSnapshot();
+    const SubscriptionList* existing = findList(*current, record->type_id);
+    if (existing) {
+        auto list = std::make_shared<SubscriptionList>();
+        list->reserve(existing->size());
+        for (SubscriptionRecord* other : *existing) {
+            if (other != record) {
+                list->push_back(other);
+            }
+        }
+
+        auto table = std::make_shared<SubscriptionTable>(*current);
+        if (list->empty()) {
+            (*table)[record->type_id].reset();
+        } else {
+            (*table)[record->type_id] = std::move(list);
+        }
+        storeSnapshot(std::move(table));
+    }
+
+    retireRecord(*record);
+    reclaimRetiredLocked();
+}
+
+bool EventBus::isHandleActive(uint32_t index, uint32_t generation) {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    return findRecord(index, generation) != nullptr;
 }
 
 void EventBus::clearAll() {
     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-    for (auto& [event_type, subscriptions] : subscriptions_) {
-        for (auto& subscription : subscriptions) {
-            if (subscription) {
-                subscription->deactivate();
-            }
+    const auto current = loadSnapshot();
+    storeSnapshot(std::make_shared<const SubscriptionTable>());
+    for (const auto& subscriptions : *current) {
+        if (!subscriptions) {
+            continue;
+        }
+        for (SubscriptionRecord* record : *subscriptions) {
+            retireRecord(*record);
         }
     }
-    subscriptions_.clear();
+    reclaimRetiredLocked();
 }
 
 size_t EventBus::getSubscriptionCount() const {
-    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    const auto table = loadSnapshot();
     size_t count = 0;
-    for (const auto& [event_type, subscriptions] : subscriptions_) {
-        count += std::count_if(subscriptions.begin(), subscriptions.end(),
-                             [](const auto& sub) { return sub->isActive(); });
+    for (const auto& subscriptions : *table) {
+        if (!subscriptions) {
+            continue;
+        }
+        count += std::count_if(subscriptions->begin(), subscriptions->end(),
+                             [](const SubscriptionRecord* record) {
+                                 return record->active.load(std::memory_order_acquire);
+                             });
     }
     return count;
 }
@@ -128,6 +426,113 @@ bool EventBus::isEmpty() const {
     return getSubscriptionCount() == 0;
 }
 
+void EventBus::setProfilingEnabled(bool enabled) {
+    profiling_enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool EventBus::isProfilingEnabled() const {
+    return profiling_enabled_.load(std::memory_order_relaxed);
+}
+
+EventBus::TypeProfileCounters& EventBus::typeProfile(size_t type_id, const char* type_name) {
+    std::lock_guard<std::mutex> lock(profile_mutex_);
+    if (type_profiles_.size() <= type_id) {
+        type_profiles_.resize(type_id + 1);
+    }
+    auto& profile = type_profiles_[type_id];
+    if (!profile) {
+        profile = std::make_unique<TypeProfileCounters>();
+        profile->type_name = type_name;
+    }
+    return *profile;
+}
+
+void EventBus::publishProfiled(size_t type_id, const char* type_name, const SubscriptionList* subscriptions,
+                               const void* event) {
+    TypeProfileCounters& type = typeProfile(type_id, type_name);
+    type.publishes.fetch_add(1, std::memory_order_relaxed);
+    if (!subscriptions) {
+        return;
+    }
+
+    for (SubscriptionRecord* record : *subscriptions) {
+        if (!record->active.load(std::memory_order_acquire)) {
+            continue;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        record->callback(event);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        const uint64_t elapsed_ns = elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+        record->profile.record(elapsed_ns);
+        type.handlers.record(elapsed_ns);
+    }
+}
+
+EventBusProfile EventBus::getProfileSnapshot() const {
+    std::map<size_t, EventTypeProfile> by_type;
+    {
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        for (size_t type_id = 0; type_id < type_profiles_.size(); ++type_id) {
+            const auto& counters = type_profiles_[type_id];
+            if (!counters) {
+                continue;
+            }
+            EventTypeProfile& profile = by_type[type_id];
+            profile.type_name = counters->type_name;
+            profile.publishes = counters->publishes.load(std::memory_order_relaxed);
+            profile.handlers = counters->handlers.snapshot();
+        }
+    }
+    {
+        // Records are only recycled under this mutex, so the lists stay readable.
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        const auto table = loadSnapshot();
+        for (size_t type_id = 0; type_id < table->size(); ++type_id) {
+            const SubscriptionList* subscriptions = findList(*table, type_id);
+            if (!subscriptions) {
+                continue;
+            }
+            for (const SubscriptionRecord* record : *subscriptions) {
+                EventTypeProfile& profile = by_type[type_id];
+                if (profile.type_name.empty() && record->type_name) {
+                    profile.type_name = record->type_name;
+                }
+                EventSubscriptionProfile subscription;
+                subscription.subscription_id =
+                    EventSubscription(nullptr, record->index, record->generation).getId();
+                subscription.handler = record->profile.snapshot();
+                profile.subscriptions.push_back(std::move(subscription));
+            }
+        }
+    }
+
+    EventBusProfile snapshot;
+    snapshot.event_types.reserve(by_type.size());
+    for (auto& entry : by_type) {
+        snapshot.event_types.push_back(std::move(entry.second));
+    }
+    return snapshot;
+}
+
+void EventBus::resetProfile() {
+    {
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        for (auto& counters : type_profiles_) {
+            if (counters) {
+                counters->publishes.store(0, std::memory_order_relaxed);
+                counters->handlers.reset();
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    for (auto& chunk : slab_chunks_) {
+        for (uint32_t i = 0; i < kSlabChunkSize; ++i) {
+            chunk[i].profile.reset();
+        }
+    }
+}
+
 // EventBusManager implementation
 std::unique_ptr<EventBus> EventBusManager::global_event_bus_;
 std::atomic<bool> EventBusManager::initialized_{false};
@@ -4,12 +4,20 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <typeindex>
 #include <mutex>
 #include <atomic>
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "frame_profiler.h"
 
 namespace cataclysm {
 namespace gui {
@@ -21,74 +29,368 @@ namespace gui {
 class Event {
 public:
     virtual ~Event() = default;
-    virtual std::string getEventType() const = 0;
+    virtual std::string_view getEventType() const = 0;
     virtual std::unique_ptr<Event> clone() const = 0;
 };
 
+class EventBus;
+
 /**
  * Event subscription handle for unsubscribing.
- * Created when subscribing to an event and can be used to remove the subscription.
+ * A small value type naming a slot in the bus's subscription pool plus the
+ * generation that slot had when the subscription was created, so a stale
+ * handle can never affect a later subscriber that reuses the slot. Copies
+ * refer to the same subscription. Letting a handle go out of scope does not
+ * unsubscribe, and handles must not outlive the bus that issued them.
  */
 class EventSubscription {
 public:
-    EventSubscription() : active_(false), id_(0) {}
-    explicit EventSubscription(std::function<void()> unsubscribe_func) 
-        : active_(true), id_(0), unsubscribe_func_(std::move(unsubscribe_func)) {}
-    
-    void unsubscribe() {
-        std::function<void()> unsubscribe_copy;
-        if (active_ && unsubscribe_func_) {
-            active_ = false;
-            unsubscribe_copy = std::move(unsubscribe_func_);
+    EventSubscription() = default;
+
+    /**
+     * Remove the subscription from its bus and clear this handle.
+     * Safe to call more than once, or from inside the subscriber's own callback.
+     */
+    void unsubscribe();
+
+    /**
+     * @return true while the subscription will still receive events
+     */
+    bool isActive() const;
+
+    /**
+     * Forget the subscription without unsubscribing it.
+     */
+    void reset() { bus_ = nullptr; }
+
+    /**
+     * @return Identifier unique among all subscriptions of the issuing bus
+     */
+    uint64_t getId() const { return (static_cast<uint64_t>(generation_) << 32) | index_; }
+
+    explicit operator bool() const { return bus_ != nullptr; }
+
+private:
+    friend class EventBus;
+
+    EventSubscription(EventBus* bus, uint32_t index, uint32_t generation)
+        : bus_(bus), index_(index), generation_(generation) {}
+
+    EventBus* bus_ = nullptr;
+    uint32_t index_ = 0;
+    uint32_t generation_ = 0;
+};
+
+namespace detail {
+
+/**
+ * Assigns a dense, process-wide integer ID to each event type the first time
+ * it is used, so the bus can index subscriber tables directly instead of
+ * hashing std::type_index.
+ */
+class EventTypeRegistry {
+public:
+    /**
+     * Allocate (or look up) the ID for a type.
+     * @param type Runtime type of the event
+     * @return Dense ID for the type
+     */
+    static size_t registerType(const std::type_index& type);
+};
+
+/**
+ * Dense ID for EventType. The registry is consulted once per type; afterwards
+ * this is a single guarded static load.
+ */
+template<typename EventType>
+size_t eventTypeId() {
+    static const size_t id = EventTypeRegistry::registerType(std::type_index(typeid(EventType)));
+    return id;
+}
+
+/**
+ * Move-only callable with fixed in-place storage, used for subscriber
+ * callbacks so a subscription does not need its own heap allocation.
+ * Callables larger than InlineSize (or with throwing moves) fall back to a
+ * single heap allocation rather than being rejected.
+ */
+template<typename Signature, size_t InlineSize>
+class InlineDelegate;
+
+template<typename R, typename... Args, size_t InlineSize>
+class InlineDelegate<R(Args...), InlineSize> {
+public:
+    InlineDelegate() = default;
+
+    template<typename Callable,
+             typename = std::enable_if_t<!std::is_same<std::decay_t<Callable>, InlineDelegate>::value>>
+    explicit InlineDelegate(Callable&& callable) {
+        emplace(std::forward<Callable>(callable));
+    }
+
+    InlineDelegate(InlineDelegate&& other) noexcept { moveFrom(other); }
+
+    InlineDelegate& operator=(InlineDelegate&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineDelegate(const InlineDelegate&) = delete;
+    InlineDelegate& operator=(const InlineDelegate&) = delete;
+
+    ~InlineDelegate() { reset(); }
+
+    template<typename Callable>
+    void emplace(Callable&& callable) {
+        using Fn = std::decay_t<Callable>;
+        reset();
+        if constexpr (storesInline<Fn>()) {
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<Callable>(callable));
+            ops_ = &InlineOps<Fn>::table;
+        } else {
+            ::new (static_cast<void*>(storage_)) Fn*(new Fn(std::forward<Callable>(callable)));
+            ops_ = &HeapOps<Fn>::table;
         }
-        if (unsubscribe_copy) {
-            unsubscribe_copy();
+    }
+
+    void reset() {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
         }
     }
 
-    bool isActive() const { return active_; }
-    void setId(size_t id) { id_ = id; }
-    size_t getId() const { return id_; }
+    R operator()(Args... args) const {
+        return ops_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return ops_ != nullptr; }
 
-    void deactivate() {
-        active_ = false;
-        unsubscribe_func_ = nullptr;
+    /**
+     * @return true if Fn is held in place rather than on the heap
+     */
+    template<typename Fn>
+    static constexpr bool storesInline() {
+        return sizeof(Fn) <= InlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<Fn>::value;
     }
 
 private:
-    std::atomic<bool> active_;
-    size_t id_;
-    std::function<void()> unsubscribe_func_;
+    struct Ops {
+        R (*invoke)(void* storage, Args... args);
+        void (*move)(void* destination, void* source);
+        void (*destroy)(void* storage);
+    };
+
+    template<typename Fn>
+    struct InlineOps {
+        static R invoke(void* storage, Args... args) {
+            return (*static_cast<Fn*>(storage))(std::forward<Args>(args)...);
+        }
+        static void move(void* destination, void* source) {
+            ::new (destination) Fn(std::move(*static_cast<Fn*>(source)));
+            static_cast<Fn*>(source)->~Fn();
+        }
+        static void destroy(void* storage) { static_cast<Fn*>(storage)->~Fn(); }
+        static constexpr Ops table{&invoke, &move, &destroy};
+    };
+
+    template<typename Fn>
+    struct HeapOps {
+        static Fn*& target(void* storage) { return *static_cast<Fn**>(storage); }
+        static R invoke(void* storage, Args... args) {
+            return (*target(storage))(std::forward<Args>(args)...);
+        }
+        static void move(void* destination, void* source) {
+            ::new (destination) Fn*(target(source));
+        }
+        static void destroy(void* storage) { delete target(storage); }
+        static constexpr Ops table{&invoke, &move, &destroy};
+    };
+
+    void moveFrom(InlineDelegate& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) mutable unsigned char storage_[InlineSize];
+    const Ops* ops_ = nullptr;
 };
 
 /**
- * Template for event subscriptions with type safety.
- * Manages the lifetime of event subscriptions and provides easy unsubscription.
+ * Bounded lock-free multi-producer/single-consumer ring (Vyukov-style).
+ * Any thread may push; exactly one thread may pop. Producers only contend on
+ * a CAS of the tail index and never block; a full queue rejects the push.
  */
-template<typename EventType>
-class TypedEventSubscription : public EventSubscription {
+template<typename T>
+class BoundedMpscQueue {
 public:
-    TypedEventSubscription(std::function<void(const EventType&)> callback, std::function<void()> unsubscribe_func)
-        : EventSubscription(std::move(unsubscribe_func)), callback_(std::move(callback)) {}
-    
-    void invoke(const EventType& event) {
-        if (isActive() && callback_) {
-            callback_(event);
+    explicit BoundedMpscQueue(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        mask_ = rounded - 1;
+        cells_ = std::make_unique<Cell[]>(rounded);
+        for (size_t i = 0; i < rounded; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
         }
     }
-    
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    /**
+     * Push from any thread.
+     * @return false if the queue is full
+     */
+    bool tryPush(T&& value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &cells_[position & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pop on the consumer thread.
+     * @return false if no fully published element is available
+     */
+    bool tryPop(T& out) {
+        Cell& cell = cells_[head_ & mask_];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(head_ + 1) < 0) {
+            return false;
+        }
+
+        out = std::move(cell.value);
+        cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
 private:
-    std::function<void(const EventType&)> callback_;
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * Handler timing for one subscription, or summed over one event type.
+ * Histogram bucket i counts invocations that took [2^i, 2^(i+1)) nanoseconds;
+ * bucket 0 also holds sub-nanosecond timings and the last bucket everything longer.
+ */
+struct EventHandlerProfile {
+    static constexpr size_t kLatencyBucketCount = 32;
+
+    uint64_t invocations = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    std::array<uint64_t, kLatencyBucketCount> latency_histogram{};
+};
+
+struct EventSubscriptionProfile {
+    uint64_t subscription_id = 0; // Matches EventSubscription::getId()
+    EventHandlerProfile handler;
+};
+
+struct EventTypeProfile {
+    std::string type_name;   // Implementation-defined typeid() name
+    uint64_t publishes = 0;  // Typed, dynamic and flushed publishes
+    EventHandlerProfile handlers;
+    std::vector<EventSubscriptionProfile> subscriptions;
+};
+
+/**
+ * Point-in-time copy of the bus profiling counters.
+ */
+struct EventBusProfile {
+    std::vector<EventTypeProfile> event_types;
+};
+
+namespace detail {
+
+/**
+ * Lock-free accumulator behind EventHandlerProfile. Updated with relaxed
+ * atomics so concurrent publishers never contend on a lock.
+ */
+class HandlerCounters {
+public:
+    HandlerCounters() { reset(); }
+
+    void record(uint64_t elapsed_ns);
+    void reset();
+    EventHandlerProfile snapshot() const;
+
+private:
+    std::atomic<uint64_t> invocations_;
+    std::atomic<uint64_t> total_ns_;
+    std::atomic<uint64_t> max_ns_;
+    std::array<std::atomic<uint64_t>, EventHandlerProfile::kLatencyBucketCount> histogram_;
+};
+
+} // namespace detail
+
+/**
+ * How queued events of one type are folded together before a flush.
+ * Only affects enqueue(); publish() always dispatches immediately.
+ */
+enum class CoalesceMode {
+    None,            // Deliver every queued event
+    LatestWins,      // Replace the matching queued event with the newest one
+    DedupeIdentical, // Drop a new event that is identical to one already queued
+    MergeCount       // Fold the new event into the newest queued event if it matches
 };
 
 /**
  * Core event bus implementation using observer pattern.
  * Provides thread-safe publish/subscribe mechanism for loose coupling between components.
+ * publish() never takes the bus mutex but is not lock-free either; see
+ * loadSnapshot(). enqueue() and flush() share queue_mutex_. Only post() is
+ * lock-free: it pushes onto a bounded ring that dispatchPosted() drains on
+ * the UI thread.
  */
 class EventBus {
 public:
-    EventBus();
+    /**
+     * @param posted_event_capacity Maximum number of cross-thread events held
+     *        between two dispatchPosted() calls
+     */
+    explicit EventBus(size_t posted_event_capacity = kDefaultPostedEventCapacity);
     ~EventBus();
+
+    static constexpr size_t kDefaultPostedEventCapacity = 4096;
     
     // Delete copy and move operations for safety
     EventBus(const EventBus&) = delete;
@@ -98,79 +400,154 @@ public:
     
     /**
      * Subscribe to events of type EventType.
+     * The callback is stored in a pooled subscription record; captures of up to
+     * kInlineCallbackSize bytes are held in place without allocating.
      * @param callback Function to call when event is published
      * @return EventSubscription handle for unsubscribing
      */
     template<typename EventType, typename Callable>
-    std::shared_ptr<EventSubscription> subscribe(Callable&& callback) {
-        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-
-        const std::type_index type_index(typeid(EventType));
-        const size_t subscription_id = next_subscription_id_++;
-
-        auto subscription = std::make_shared<TypedEventSubscription<EventType>>(
-            std::forward<Callable>(callback),
-            [this, type_index, subscription_id]() {
-                unsubscribeById(type_index, subscription_id);
-            }
-        );
-
-        subscription->setId(subscription_id);
-
-        auto& event_subscriptions = subscriptions_[type_index];
-        event_subscriptions.push_back(subscription);
-
-        return subscription;
+    EventSubscription subscribe(Callable&& callback) {
+        using Handler = std::decay_t<Callable>;
+        DynamicRoute route;
+        if constexpr (std::is_base_of<Event, EventType>::value) {
+            route = DynamicRoute{&typeid(EventType), &publishFromBase<EventType>};
+        }
+        return addSubscription(detail::eventTypeId<EventType>(), typeid(EventType).name(), route, SubscriptionCallback(
+            [handler = Handler(std::forward<Callable>(callback))](const void* event) mutable {
+                handler(*static_cast<const EventType*>(event));
+            }));
     }
     
     /**
      * Publish an event to all subscribers.
+     * Reads an immutable snapshot of the subscriber list, so publishing never
+     * takes the subscription mutex or copies the list. Subscribers removed
+     * while a publish is in flight are skipped via their active flag.
      * @param event Event to publish
      */
     template<typename EventType>
     void publish(const EventType& event) {
-        const std::type_index type_index(typeid(EventType));
-        std::vector<std::shared_ptr<EventSubscription>> subscriptions_copy;
-
-        {
-            std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-            auto it = subscriptions_.find(type_index);
-            if (it == subscriptions_.end()) {
-                return;
-            }
-            subscriptions_copy = it->second;
+        GUI_PROFILE_ZONE("EventBus::publish");
+        PublishScope scope(*this);
+        const size_t type_id = detail::eventTypeId<EventType>();
+        const auto table = loadSnapshot();
+        const SubscriptionList* subscriptions = findList(*table, type_id);
+        if (profiling_enabled_.load(std::memory_order_relaxed)) {
+            publishProfiled(type_id, typeid(EventType).name(), subscriptions, &event);
+            return;
+        }
+        if (!subscriptions) {
+            return;
         }
 
-        for (const auto& subscription : subscriptions_copy) {
-            if (subscription && subscription->isActive()) {
-                auto typed_subscription = std::static_pointer_cast<TypedEventSubscription<EventType>>(subscription);
-                typed_subscription->invoke(event);
+        for (SubscriptionRecord* record : *subscriptions) {
+            if (record->active.load(std::memory_order_acquire)) {
+                record->callback(&event);
             }
         }
+    }
+    
+    /**
+     * Queue an event for delivery on the next flush() instead of dispatching it
+     * immediately. Use this from frame-building code so subscribers run once per
+     * frame, after rendering, rather than in the middle of ImGui draw calls.
+     * @param event Event to queue
+     */
+    template<typename EventType>
+    void enqueue(EventType event) {
+        enqueueInternal(std::make_unique<TypedQueuedEvent<EventType>>(
+            detail::eventTypeId<EventType>(), std::move(event)));
+    }
 
-        {
-            std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-            auto it = subscriptions_.find(type_index);
-            if (it == subscriptions_.end()) {
-                return;
-            }
+    /**
+     * Set how queued events of type EventType are coalesced between flushes.
+     * @param mode Coalescing behaviour
+     * @param matches Decides whether a queued event and a new one refer to the same
+     *        thing. Required for DedupeIdentical; for the other modes an empty
+     *        predicate matches any queued event of the type.
+     * @param merge Folds the new event into the queued one. Required for MergeCount.
+     * @return false if a callback required by the mode is missing
+     */
+    template<typename EventType>
+    bool setCoalescing(CoalesceMode mode,
+                       std::function<bool(const EventType&, const EventType&)> matches = {},
+                       std::function<void(EventType&, const EventType&)> merge = {}) {
+        if ((mode == CoalesceMode::DedupeIdentical && !matches) ||
+            (mode == CoalesceMode::MergeCount && !merge)) {
+            return false;
+        }
+
+        std::unique_ptr<CoalesceRule> rule;
+        if (mode != CoalesceMode::None) {
+            rule = std::make_unique<TypedCoalesceRule<EventType>>(mode, std::move(matches), std::move(merge));
+        }
+        setCoalesceRule(detail::eventTypeId<EventType>(), std::move(rule));
+        return true;
+    }
 
-            auto& stored = it->second;
-            stored.erase(
-                std::remove_if(stored.begin(), stored.end(),
-                               [](const auto& sub) { return !sub || !sub->isActive(); }),
-                stored.end());
+    /**
+     * Deliver every event queued before this call, in enqueue order.
+     * Events queued by handlers while flushing are held for the next flush.
+     * @return Number of events delivered
+     */
+    size_t flush();
 
-            if (stored.empty()) {
-                subscriptions_.erase(it);
-            }
+    /**
+     * Drop every queued event without delivering it, e.g. input left over
+     * when the overlay closes.
+     * @return Number of events dropped
+     */
+    size_t discardQueued();
+
+    /**
+     * Get the number of events waiting for the next flush.
+     * @return Number of queued events
+     */
+    size_t getQueuedEventCount() const;
+
+    /**
+     * Hand an event from any thread to the UI thread without taking a lock.
+     * The event is delivered to subscribers by the next dispatchPosted() call,
+     * so handlers always run on the thread that owns the bus.
+     * @param event Event to post
+     * @return false if the channel is full and the event was dropped
+     */
+    template<typename EventType>
+    bool post(EventType event) {
+        std::unique_ptr<QueuedEvent> queued = std::make_unique<TypedQueuedEvent<EventType>>(
+            detail::eventTypeId<EventType>(), std::move(event));
+        if (!posted_events_.tryPush(std::move(queued))) {
+            dropped_posted_events_.fetch_add(1, std::memory_order_relaxed);
+            return false;
         }
+        return true;
     }
+
+    /**
+     * Deliver events posted from other threads. Must only be called from the
+     * UI thread, typically at the start of a frame.
+     * @return Number of events delivered
+     */
+    size_t dispatchPosted();
+
+    /**
+     * Get the number of posted events rejected because the channel was full.
+     * @return Number of dropped events
+     */
+    size_t getDroppedPostedEventCount() const;
     
     /**
-     * Publish a dynamically typed event.
+     * Publish an event whose concrete type is only known at runtime, such as
+     * one read back from a recorded stream. The runtime type is mapped to the
+     * typed publish() registered when that type was first subscribed to, so
+     * subscribers see exactly what a typed publish would deliver.
      * @param event Event to publish
      */
+    void publishDynamic(const Event& event);
+
+    /**
+     * @see publishDynamic(const Event&). A null event is ignored.
+     */
     void publishDynamic(const std::unique_ptr<Event>& event);
     
     /**
@@ -179,8 +556,7 @@ public:
      */
     template<typename EventType>
     void unsubscribe() {
-        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-        unsubscribeInternal(std::type_index(typeid(EventType)));
+        unsubscribeInternal(detail::eventTypeId<EventType>());
     }
     
     /**
@@ -201,11 +577,13 @@ public:
      */
     template<typename EventType>
     size_t getSubscriptionCount() const {
-        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
-        auto it = subscriptions_.find(std::type_index(typeid(EventType)));
-        if (it != subscriptions_.end()) {
-            return std::count_if(it->second.begin(), it->second.end(),
-                               [](const auto& sub) { return sub->isActive(); });
+        const auto table = loadSnapshot();
+        const SubscriptionList* subscriptions = findList(*table, detail::eventTypeId<EventType>());
+        if (subscriptions) {
+            return std::count_if(subscriptions->begin(), subscriptions->end(),
+                               [](const SubscriptionRecord* record) {
+                                   return record->active.load(std::memory_order_acquire);
+                               });
         }
         return 0;
     }
@@ -216,16 +594,262 @@ public:
      */
     bool isEmpty() const;
 
+    /**
+     * Start or stop recording per-type publish counts and per-subscription
+     * handler timings. While disabled, publish() pays a single relaxed load.
+     * Counters are kept when profiling is switched off.
+     */
+    void setProfilingEnabled(bool enabled);
+
+    bool isProfilingEnabled() const;
+
+    /**
+     * Copy the profiling counters. Types appear once they have been published
+     * while profiling was enabled or have live subscriptions.
+     * @return Snapshot of all counters
+     */
+    EventBusProfile getProfileSnapshot() const;
+
+    /**
+     * Zero all profiling counters.
+     */
+    void resetProfile();
+
+    /**
+     * Callables up to this size are stored inside the subscription record.
+     */
+    static constexpr size_t kInlineCallbackSize = 48;
+
 private:
-    void unsubscribeInternal(const std::type_index& event_type);
-    void unsubscribeInternal(const std::type_index& event_type, size_t subscription_id);
-    void unsubscribeById(const std::type_index& event_type, size_t subscription_id);
+    friend class EventSubscription;
+
+    using SubscriptionCallback = detail::InlineDelegate<void(const void*), kInlineCallbackSize>;
+
+    /**
+     * Pooled subscription slot. Records live in fixed-size chunks that are never
+     * freed before the bus, so snapshots can refer to them by raw pointer.
+     */
+    struct SubscriptionRecord {
+        SubscriptionCallback callback;
+        std::atomic<bool> active{false};
+        // Bumped when the slot is released; guarded by subscriptions_mutex_.
+        uint32_t generation = 0;
+        uint32_t type_id = 0;
+        uint32_t index = 0;
+        const char* type_name = nullptr;
+        detail::HandlerCounters profile;
+    };
+
+    struct TypeProfileCounters {
+        std::string type_name;
+        std::atomic<uint64_t> publishes{0};
+        detail::HandlerCounters handlers;
+    };
 
-    std::unordered_map<std::type_index, std::vector<std::shared_ptr<EventSubscription>>> subscriptions_;
+    /**
+     * Counts publishes in flight so retired records are only recycled once no
+     * publisher can still be reading them.
+     */
+    class PublishScope {
+    public:
+        explicit PublishScope(EventBus& bus) : bus_(bus) {
+            bus_.publishes_in_flight_.fetch_add(1);
+        }
+        ~PublishScope() {
+            if (bus_.publishes_in_flight_.fetch_sub(1) == 1 && bus_.has_retired_records_.load()) {
+                bus_.reclaimRetired();
+            }
+        }
+        PublishScope(const PublishScope&) = delete;
+        PublishScope& operator=(const PublishScope&) = delete;
+
+    private:
+        EventBus& bus_;
+    };
+
+    /**
+     * Type-erased event held in the deferred queue until flush().
+     */
+    class QueuedEvent {
+    public:
+        explicit QueuedEvent(size_t type_id) : type_id_(type_id) {}
+        virtual ~QueuedEvent() = default;
+        virtual void dispatch(EventBus& bus) const = 0;
+        size_t typeId() const { return type_id_; }
+
+    private:
+        size_t type_id_;
+    };
+
+    template<typename EventType>
+    class TypedQueuedEvent : public QueuedEvent {
+    public:
+        TypedQueuedEvent(size_t type_id, EventType event)
+            : QueuedEvent(type_id), event_(std::move(event)) {}
+
+        void dispatch(EventBus& bus) const override {
+            bus.publish(event_);
+        }
+
+        EventType& event() { return event_; }
+
+    private:
+        EventType event_;
+    };
+
+    /**
+     * Type-erased coalescing rule for one event type.
+     */
+    class CoalesceRule {
+    public:
+        explicit CoalesceRule(CoalesceMode mode) : mode_(mode) {}
+        virtual ~CoalesceRule() = default;
+        virtual bool matches(QueuedEvent& queued, QueuedEvent& incoming) const = 0;
+        virtual void merge(QueuedEvent& queued, QueuedEvent& incoming) const = 0;
+        CoalesceMode mode() const { return mode_; }
+
+    private:
+        CoalesceMode mode_;
+    };
+
+    template<typename EventType>
+    class TypedCoalesceRule : public CoalesceRule {
+    public:
+        TypedCoalesceRule(CoalesceMode mode,
+                          std::function<bool(const EventType&, const EventType&)> matches,
+                          std::function<void(EventType&, const EventType&)> merge)
+            : CoalesceRule(mode), matches_(std::move(matches)), merge_(std::move(merge)) {}
+
+        bool matches(QueuedEvent& queued, QueuedEvent& incoming) const override {
+            return !matches_ || matches_(typed(queued), typed(incoming));
+        }
+
+        void merge(QueuedEvent& queued, QueuedEvent& incoming) const override {
+            merge_(typed(queued), typed(incoming));
+        }
+
+    private:
+        static EventType& typed(QueuedEvent& event) {
+            return static_cast<TypedQueuedEvent<EventType>&>(event).event();
+        }
+
+        std::function<bool(const EventType&, const EventType&)> matches_;
+        std::function<void(EventType&, const EventType&)> merge_;
+    };
+
+    /**
+     * Forwards a base-class reference to the typed publish() for its concrete type.
+     */
+    using DynamicTrampoline = void (*)(EventBus& bus, const Event& event);
+
+    struct DynamicRoute {
+        const std::type_info* type = nullptr;
+        DynamicTrampoline trampoline = nullptr;
+    };
+
+    // Keyed by the concrete runtime type; entries are added on first subscribe
+    // and never removed, so publishDynamic only needs an atomic load and a lookup.
+    using DynamicRouteMap = std::unordered_map<std::type_index, DynamicTrampoline>;
+
+    template<typename EventType>
+    static void publishFromBase(EventBus& bus, const Event& event) {
+        bus.publish(static_cast<const EventType&>(event));
+    }
+
+    using SubscriptionList = std::vector<SubscriptionRecord*>;
+    // Indexed by detail::eventTypeId<T>(); empty slots are null.
+    using SubscriptionTable = std::vector<std::shared_ptr<const SubscriptionList>>;
+
+    static const SubscriptionList* findList(const SubscriptionTable& table, size_t type_id) {
+        return type_id < table.size() ? table[type_id].get() : nullptr;
+    }
+
+    /**
+     * Load the current subscriber table. The returned snapshot stays valid for
+     * as long as the caller holds it. std::atomic_load on a shared_ptr is not
+     * lock-free: standard libraries guard it with a pool of internal locks, so
+     * this can wait briefly on a concurrent storeSnapshot(), though never on
+     * subscriptions_mutex_. Sequentially consistent so it orders against
+     * publishes_in_flight_.
+     */
+    std::shared_ptr<const SubscriptionTable> loadSnapshot() const {
+        return std::atomic_load(&subscriptions_);
+    }
+
+    /**
+     * Publish a new subscriber table. Must be called with subscriptions_mutex_ held.
+     */
+    void storeSnapshot(std::shared_ptr<const SubscriptionTable> table) {
+        std::atomic_store(&subscriptions_, std::move(table));
+    }
+
+    SubscriptionRecord& recordAt(uint32_t index) {
+        return slab_chunks_[index / kSlabChunkSize][index % kSlabChunkSize];
+    }
+
+    void enqueueInternal(std::unique_ptr<QueuedEvent> event);
+    bool coalesceQueued(std::unique_ptr<QueuedEvent>& incoming);
+    void setCoalesceRule(size_t type_id, std::unique_ptr<CoalesceRule> rule);
+    EventSubscription addSubscription(size_t type_id, const char* type_name, const DynamicRoute& route,
+                                      SubscriptionCallback callback);
+    void registerDynamicRoute(const DynamicRoute& route);
+    void unsubscribeInternal(size_t type_id);
+    void unsubscribeHandle(uint32_t index, uint32_t generation);
+    bool isHandleActive(uint32_t index, uint32_t generation);
+    SubscriptionRecord* findRecord(uint32_t index, uint32_t generation);
+    void retireRecord(SubscriptionRecord& record);
+    void reclaimRetiredLocked();
+    void reclaimRetired();
+    void publishProfiled(size_t type_id, const char* type_name, const SubscriptionList* subscriptions,
+                         const void* event);
+    TypeProfileCounters& typeProfile(size_t type_id, const char* type_name);
+
+    // Copy-on-write table: writers serialize on subscriptions_mutex_, copy the
+    // affected list and swap in a new table; publishers only do an atomic load.
+    std::shared_ptr<const SubscriptionTable> subscriptions_;
     mutable std::mutex subscriptions_mutex_;
-    std::atomic<size_t> next_subscription_id_{0};
+    // Copy-on-write like subscriptions_; written with subscriptions_mutex_ held.
+    std::shared_ptr<const DynamicRouteMap> dynamic_routes_;
+
+    // Subscription pool: chunks of records, recycled through free_records_.
+    // Released records wait in retired_records_ until no publish is in flight.
+    static constexpr uint32_t kSlabChunkSize = 64;
+    std::vector<std::unique_ptr<SubscriptionRecord[]>> slab_chunks_;
+    std::vector<uint32_t> free_records_;
+    std::vector<uint32_t> retired_records_;
+    std::atomic<size_t> publishes_in_flight_{0};
+    std::atomic<bool> has_retired_records_{false};
+
+    // Profiling; entries are created on first profiled publish and never freed.
+    std::atomic<bool> profiling_enabled_{false};
+    std::vector<std::unique_ptr<TypeProfileCounters>> type_profiles_;
+    mutable std::mutex profile_mutex_;
+
+    // Deferred events, stored as a growable ring buffer (capacity is a power of two).
+    std::vector<std::unique_ptr<QueuedEvent>> queue_slots_;
+    size_t queue_head_ = 0;
+    size_t queue_size_ = 0;
+    // Indexed by detail::eventTypeId<T>(); null means no coalescing.
+    std::vector<std::unique_ptr<CoalesceRule>> coalesce_rules_;
+    mutable std::mutex queue_mutex_;
+
+    // Cross-thread channel; producers push lock-free, the UI thread drains it.
+    detail::BoundedMpscQueue<std::unique_ptr<QueuedEvent>> posted_events_;
+    std::atomic<size_t> dropped_posted_events_{0};
 };
 
+inline void EventSubscription::unsubscribe() {
+    if (bus_) {
+        EventBus* bus = bus_;
+        bus_ = nullptr;
+        bus->unsubscribeHandle(index_, generation_);
+    }
+}
+
+inline bool EventSubscription::isActive() const {
+    return bus_ && bus_->isHandleActive(index_, generation_);
+}
+
 /**
  * Global event bus instance.
  * Provides a centralized event communication system for the entire GUI system.
@@ -27,6 +27,7 @@ void EventBusAdapter::initialize() {
     
     initialized_.store(true);
     setupDefaultSubscriptions();
+    setupDefaultCoalescing();
     
     std::cout << "EventBusAdapter initialized with " << getSubscriptionCount() 
               << " active subscriptions" << std::endl;
@@ -49,7 +50,7 @@ void EventBusAdapter::shutdown() {
 }
 
 void EventBusAdapter::publishOverlayOpen(const std::string& overlay_id, bool is_modal) {
-    UiOverlayOpenEvent event(overlay_id);
+    UiOverlayOpenEvent event{Symbol(overlay_id)};
     event.setModal(is_modal);
     
     event_bus_.publish(event);
@@ -60,7 +61,7 @@ void EventBusAdapter::publishOverlayOpen(const std::string& overlay_id, bool is_
 }
 
 void EventBusAdapter::publishOverlayClose(const std::string& overlay_id, bool was_cancelled) {
-    UiOverlayCloseEvent event(overlay_id);
+    UiOverlayCloseEvent event{Symbol(overlay_id)};
     event.setCancelled(was_cancelled);
     
     event_bus_.publish(event);
@@ -73,7 +74,7 @@ void EventBusAdapter::publishOverlayClose(const std::string& overlay_id, bool wa
 void EventBusAdapter::publishFilterApplied(const std::string& filter_text, 
                                           const std::string& target_component,
                                           bool case_sensitive) {
-    UiFilterAppliedEvent event(filter_text, target_component);
+    UiFilterAppliedEvent event(filter_text, Symbol(target_component));
     event.setCaseSensitive(case_sensitive);
     
     event_bus_.publish(event);
@@ -87,7 +88,7 @@ void EventBusAdapter::publishItemSelected(const std::string& item_id,
                                          const std::string& source_component,
                                          bool is_double_click,
                                          int item_count) {
-    UiItemSelectedEvent event(item_id, source_component);
+    UiItemSelectedEvent event(item_id, Symbol(source_component));
     event.setDoubleClick(is_double_click);
     event.setItemCount(item_count);
     
@@ -103,7 +104,7 @@ void EventBusAdapter::publishItemSelected(const std::string& item_id,
 void EventBusAdapter::publishDataBindingUpdate(const std::string& binding_id,
                                               const std::string& data_source,
                                               bool forced) {
-    UiDataBindingUpdateEvent event(binding_id, data_source);
+    UiDataBindingUpdateEvent event{Symbol(binding_id), Symbol(data_source)};
     event.setForced(forced);
     
     event_bus_.publish(event);
@@ -126,7 +127,7 @@ void EventBusAdapter::publishMapTileClicked(int x, int y) {
     events_published_.fetch_add(1);
 }
 
-std::shared_ptr<EventSubscription> EventBusAdapter::subscribeToStatusChange(
+EventSubscription EventBusAdapter::subscribeToStatusChange(
     std::function<void(const GameplayStatusChangeEvent&)> callback) {
     
     auto subscription = event_bus_.subscribe<GameplayStatusChangeEvent>(
@@ -143,7 +144,7 @@ std::shared_ptr<EventSubscription> EventBusAdapter::subscribeToStatusChange(
     return subscription;
 }
 
-std::shared_ptr<EventSubscription> EventBusAdapter::subscribeToInventoryChange(
+EventSubscription EventBusAdapter::subscribeToInventoryChange(
     std::function<void(const GameplayInventoryChangeEvent&)> callback) {
     
     auto subscription = event_bus_.subscribe<GameplayInventoryChangeEvent>(
@@ -160,7 +161,7 @@ std::shared_ptr<EventSubscription> EventBusAdapter::subscribeToInventoryChange(
     return subscription;
 }
 
-std::shared_ptr<EventSubscription> EventBusAdapter::subscribeToGameplayNotice(
+EventSubscription EventBusAdapter::subscribeToGameplayNotice(
     std::function<void(const GameplayNoticeEvent&)> callback) {
     
     auto subscription = event_bus_.subscribe<GameplayNoticeEvent>(
@@ -177,10 +178,22 @@ std::shared_ptr<EventSubscription> EventBusAdapter::subscribeToGameplayNotice(
     return subscription;
 }
 
+size_t EventBusAdapter::dispatchPosted() {
+    return event_bus_.dispatchPosted();
+}
+
+size_t EventBusAdapter::flush() {
+    return event_bus_.flush();
+}
+
+size_t EventBusAdapter::discardQueued() {
+    return event_bus_.discardQueued();
+}
+
 size_t EventBusAdapter::getSubscriptionCount() const {
     size_t count = 0;
     for (const auto& subscription : managed_subscriptions_) {
-        if (subscription && subscription->isActive()) {
+        if (subscription.isActive()) {
             count++;
         }
     }
@@ -193,9 +206,7 @@ bool EventBusAdapter::isEmpty() const {
 
 void EventBusAdapter::clearAllSubscriptions() {
     for (auto& subscription : managed_subscriptions_) {
-        if (subscription) {
-            subscription->unsubscribe();
-        }
+        subscription.unsubscribe();
     }
     managed_subscriptions_.clear();
 }
@@ -207,6 +218,7 @@ std::unordered_map<std::string, int> EventBusAdapter::getStatistics() const {
     stats["events_published"] = static_cast<int>(events_published_.load());
     stats["events_received"] = static_cast<int>(events_received_.load());
     stats["managed_subscriptions"] = static_cast<int>(managed_subscriptions_.size());
+    stats["profiling_enabled"] = event_bus_.isProfilingEnabled() ? 1 : 0;
     
     // Count subscriptions by type
     stats["status_change_subscriptions"] = static_cast<int>(getSubscriptionCount<GameplayStatusChangeEvent>());
@@ -218,6 +230,18 @@ std::unordered_map<std::string, int> EventBusAdapter::getStatistics() const {
     return stats;
 }
 
+void EventBusAdapter::setProfilingEnabled(bool enabled) {
+    event_bus_.setProfilingEnabled(enabled);
+}
+
+EventBusProfile EventBusAdapter::getProfileSnapshot() const {
+    return event_bus_.getProfileSnapshot();
+}
+
+void EventBusAdapter::resetProfile() {
+    event_bus_.resetProfile();
+}
+
 void EventBusAdapter::setupDefaultSubscriptions() {
     // Set up default gameplay event subscriptions
     // These will be overridden by specific GUI components as needed
@@ -241,12 +265,29 @@ void EventBusAdapter::setupDefaultSubscriptions() {
     });
 }
 
+void EventBusAdapter::setupDefaultCoalescing() {
+    // Only the most recent hover in a frame matters to gameplay.
+    event_bus_.setCoalescing<MapTileHoveredEvent>(CoalesceMode::LatestWins);
+
+    // Wheel steps and held keys arrive as runs of identical key presses;
+    // deliver each run as one event carrying a repeat count.
+    event_bus_.setCoalescing<InventoryKeyInputEvent>(
+        CoalesceMode::MergeCount,
+        [](const InventoryKeyInputEvent& queued, const InventoryKeyInputEvent& incoming) {
+            const SDL_KeyboardEvent& a = queued.getKeyEvent();
+            const SDL_KeyboardEvent& b = incoming.getKeyEvent();
+            return a.type == b.type && a.keysym.sym == b.keysym.sym &&
+                   a.keysym.scancode == b.keysym.scancode && a.keysym.mod == b.keysym.mod;
+        },
+        [](InventoryKeyInputEvent& queued, const InventoryKeyInputEvent& incoming) {
+            queued.setRepeatCount(queued.getRepeatCount() + incoming.getRepeatCount());
+        });
+}
+
 void EventBusAdapter::cleanupSubscriptions() {
     // Clean up all managed subscriptions
     for (auto& subscription : managed_subscriptions_) {
-        if (subscription) {
-            subscription->unsubscribe();
-        }
+        subscription.unsubscribe();
     }
 }
 
@@ -124,7 +124,7 @@ public:
      * @param callback Function to call when status changes occur
      * @return Subscription handle for unsubscribing
      */
-    std::shared_ptr<EventSubscription> subscribeToStatusChange(
+    EventSubscription subscribeToStatusChange(
         std::function<void(const GameplayStatusChangeEvent&)> callback);
     
     /**
@@ -132,7 +132,7 @@ public:
      * @param callback Function to call when inventory changes occur
      * @return Subscription handle for unsubscribing
      */
-    std::shared_ptr<EventSubscription> subscribeToInventoryChange(
+    EventSubscription subscribeToInventoryChange(
         std::function<void(const GameplayInventoryChangeEvent&)> callback);
     
     /**
@@ -140,7 +140,7 @@ public:
      * @param callback Function to call when notices are published
      * @return Subscription handle for unsubscribing
      */
-    std::shared_ptr<EventSubscription> subscribeToGameplayNotice(
+    EventSubscription subscribeToGameplayNotice(
         std::function<void(const GameplayNoticeEvent&)> callback);
     
     // =============================================================================
@@ -154,7 +154,7 @@ public:
      * @return Subscription handle for unsubscribing
      */
     template<typename EventType>
-    std::shared_ptr<EventSubscription> subscribe(
+    EventSubscription subscribe(
         std::function<void(const EventType&)> callback) {
         return event_bus_.subscribe<EventType>(std::move(callback));
     }
@@ -169,6 +169,57 @@ public:
         event_bus_.publish(event);
     }
     
+    /**
+     * Queue any event type for delivery on the next flush().
+     * Preferred over publish() from inside widget Draw() code.
+     * @tparam EventType The type of event to queue
+     * @param event The event to queue
+     */
+    template<typename EventType>
+    void enqueue(const EventType& event) {
+        event_bus_.enqueue(event);
+    }
+
+    /**
+     * Post an event from a worker thread for delivery on the UI thread.
+     * @see EventBus::post
+     * @return false if the cross-thread channel is full
+     */
+    template<typename EventType>
+    bool post(const EventType& event) {
+        return event_bus_.post(event);
+    }
+
+    /**
+     * Deliver events posted from worker threads. Call on the UI thread.
+     * @return Number of events delivered
+     */
+    size_t dispatchPosted();
+
+    /**
+     * Set the coalescing policy for queued events of one type.
+     * @see EventBus::setCoalescing
+     */
+    template<typename EventType>
+    bool setCoalescing(CoalesceMode mode,
+                       std::function<bool(const EventType&, const EventType&)> matches = {},
+                       std::function<void(EventType&, const EventType&)> merge = {}) {
+        return event_bus_.setCoalescing<EventType>(mode, std::move(matches), std::move(merge));
+    }
+
+    /**
+     * Deliver all events queued on the underlying bus.
+     * Called once per frame after the overlay has been rendered.
+     * @return Number of events delivered
+     */
+    size_t flush();
+
+    /**
+     * Drop the events queued on the underlying bus without delivering them.
+     * @return Number of events dropped
+     */
+    size_t discardQueued();
+    
     // =============================================================================
     // Utility Methods
     // =============================================================================
@@ -207,12 +258,30 @@ public:
      */
     std::unordered_map<std::string, int> getStatistics() const;
 
+    /**
+     * Enable or disable per-type and per-subscription timing on the bus.
+     * @see EventBus::setProfilingEnabled
+     */
+    void setProfilingEnabled(bool enabled);
+
+    /**
+     * Copy the bus profiling counters.
+     * @return Per event type publish counts and handler latency histograms
+     */
+    EventBusProfile getProfileSnapshot() const;
+
+    /**
+     * Zero the bus profiling counters.
+     */
+    void resetProfile();
+
 private:
     void setupDefaultSubscriptions();
+    void setupDefaultCoalescing();
     void cleanupSubscriptions();
     
     EventBus& event_bus_;
-    std::vector<std::shared_ptr<EventSubscription>> managed_subscriptions_;
+    std::vector<EventSubscription> managed_subscriptions_;
     std::atomic<bool> initialized_;
     std::atomic<bool> shutdown_requested_;
     
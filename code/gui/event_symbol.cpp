@@ -0,0 +1,67 @@
+#include "event_symbol.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace cataclysm {
+namespace gui {
+
+namespace {
+
+struct SymbolTable {
+    std::shared_mutex mutex;
+    // Keys view the owned strings, which never move or go away
+    std::unordered_map<std::string_view, std::unique_ptr<const std::string>> strings;
+};
+
+SymbolTable& symbolTable() {
+    static SymbolTable table;
+    return table;
+}
+
+} // namespace
+
+const std::string& Symbol::emptyString() {
+    static const std::string empty;
+    return empty;
+}
+
+const std::string* Symbol::intern(std::string_view text) {
+    if (text.empty()) {
+        return &emptyString();
+    }
+
+    SymbolTable& table = symbolTable();
+    {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto it = table.strings.find(text);
+        if (it != table.strings.end()) {
+            return it->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    auto it = table.strings.find(text);
+    if (it != table.strings.end()) {
+        return it->second.get();
+    }
+    auto owned = std::make_unique<const std::string>(text);
+    const std::string* interned = owned.get();
+    table.strings.emplace(std::string_view(*interned), std::move(owned));
+    return interned;
+}
+
+size_t Symbol::getInternedCount() {
+    SymbolTable& table = symbolTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    return table.strings.size();
+}
+
+const std::string& SharedText::emptyString() {
+    static const std::string empty;
+    return empty;
+}
+
+} // namespace gui
+} // namespace cataclysm
@@ -0,0 +1,84 @@
+#ifndef GUI_EVENT_SYMBOL_H
+#define GUI_EVENT_SYMBOL_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace cataclysm {
+namespace gui {
+
+/**
+ * Interned identifier for event payloads (component ids, status types, ...).
+ * Each distinct string is stored once for the lifetime of the process, so a
+ * Symbol is a single pointer: copying and comparing never allocates.
+ * Interning a string seen before only takes a shared lock; hot paths can
+ * intern once into a static and reuse it.
+ *
+ * The table is never freed, so only names from a small fixed set should be
+ * interned. Runtime values such as item ids or stat values belong in a
+ * SharedText.
+ */
+class Symbol {
+public:
+    Symbol() : str_(&emptyString()) {}
+    explicit Symbol(std::string_view text) : str_(intern(text)) {}
+    explicit Symbol(const std::string& text) : Symbol(std::string_view(text)) {}
+    explicit Symbol(const char* text) : Symbol(std::string_view(text ? text : "")) {}
+
+    const std::string& str() const { return *str_; }
+    std::string_view view() const { return *str_; }
+    bool empty() const { return str_->empty(); }
+
+    bool operator==(const Symbol& other) const { return str_ == other.str_; }
+    bool operator!=(const Symbol& other) const { return str_ != other.str_; }
+
+    /**
+     * @return Number of distinct strings interned so far
+     */
+    static size_t getInternedCount();
+
+private:
+    static const std::string& emptyString();
+    static const std::string* intern(std::string_view text);
+
+    const std::string* str_;
+};
+
+/**
+ * Immutable text shared between an event and its clones. Building one from a
+ * std::string moves it into a single shared buffer; copies (cloned or posted
+ * events) only bump a reference count.
+ */
+class SharedText {
+public:
+    SharedText() = default;
+    SharedText(std::string text)
+        : text_(text.empty() ? nullptr : std::make_shared<const std::string>(std::move(text))) {}
+    SharedText(const char* text) : SharedText(std::string(text ? text : "")) {}
+    explicit SharedText(std::shared_ptr<const std::string> buffer) : text_(std::move(buffer)) {}
+
+    const std::string& str() const { return text_ ? *text_ : emptyString(); }
+    std::string_view view() const { return str(); }
+    bool empty() const { return str().empty(); }
+
+private:
+    static const std::string& emptyString();
+
+    std::shared_ptr<const std::string> text_;
+};
+
+} // namespace gui
+} // namespace cataclysm
+
+namespace std {
+template <>
+struct hash<cataclysm::gui::Symbol> {
+    size_t operator()(const cataclysm::gui::Symbol& symbol) const {
+        return std::hash<const void*>()(&symbol.str());
+    }
+};
+} // namespace std
+
+#endif // GUI_EVENT_SYMBOL_H
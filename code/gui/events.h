@@ -2,8 +2,10 @@
 #define GUI_EVENTS_H
 
 #include "event_bus.h"
+#include "event_symbol.h"
 #include "InventoryOverlayState.h"
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <functional>
@@ -13,27 +15,81 @@
 namespace cataclysm {
 namespace gui {
 
+/**
+ * Source names of the events below. Each is interned once, on first use, so
+ * constructing an event does not look it up in the symbol table.
+ */
+namespace event_sources {
+
+inline Symbol overlayUi() {
+    static const Symbol source("overlay_ui");
+    return source;
+}
+
+inline Symbol gameplay() {
+    static const Symbol source("gameplay");
+    return source;
+}
+
+inline Symbol performanceMonitor() {
+    static const Symbol source("performance_monitor");
+    return source;
+}
+
+inline Symbol mapWidget() {
+    static const Symbol source("map_widget");
+    return source;
+}
+
+inline Symbol inventoryWidget() {
+    static const Symbol source("inventory_widget");
+    return source;
+}
+
+inline Symbol characterWidget() {
+    static const Symbol source("character_widget");
+    return source;
+}
+
+inline Symbol toggleManager() {
+    static const Symbol source("toggle_manager");
+    return source;
+}
+
+} // namespace event_sources
+
 /**
  * Base class for all GUI events.
  * Provides common functionality for all event types.
+ *
+ * Payloads are built so that creating, cloning and delivering an event does
+ * not allocate once its strings are known: type names are compile-time
+ * constants, identifiers from a fixed set are interned Symbols, and runtime
+ * values and free-form text are held in a SharedText buffer that clones share.
  */
 class GuiEvent : public Event {
 public:
     virtual ~GuiEvent() = default;
-    std::string getEventType() const override { return getEventTypeName(); }
-    virtual std::string getEventTypeName() const = 0;
+    std::string_view getEventType() const override { return getEventTypeName(); }
+    virtual std::string_view getEventTypeName() const = 0;
     
     /**
      * Get the source component that created this event.
      * @return String identifier of the source component
      */
-    std::string getSource() const { return source_; }
+    const std::string& getSource() const { return source_.str(); }
+
+    /**
+     * Get the interned source identifier, for copying without a lookup.
+     * @return Source component symbol
+     */
+    Symbol getSourceSymbol() const { return source_; }
     
     /**
      * Set the source component that created this event.
      * @param source String identifier of the source component
      */
-    void setSource(const std::string& source) { source_ = source; }
+    void setSource(Symbol source) { source_ = source; }
     
     /**
      * Get the timestamp when this event was created.
@@ -43,7 +99,7 @@ public:
 
 protected:
     GuiEvent() : timestamp_(getCurrentTimestamp()) {}
-    GuiEvent(const std::string& source) : source_(source), timestamp_(getCurrentTimestamp()) {}
+    GuiEvent(Symbol source) : source_(source), timestamp_(getCurrentTimestamp()) {}
     
     static std::uint64_t getCurrentTimestamp() {
         return std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -52,7 +108,7 @@ protected:
     }
 
 private:
-    std::string source_;
+    Symbol source_;
     std::uint64_t timestamp_;
 };
 
@@ -63,25 +119,26 @@ private:
  */
 class UiOverlayOpenEvent : public GuiEvent {
 public:
-    UiOverlayOpenEvent() : GuiEvent("overlay_ui") {}
-    explicit UiOverlayOpenEvent(const std::string& overlay_id) 
-        : GuiEvent("overlay_ui"), overlay_id_(overlay_id) {}
+    UiOverlayOpenEvent() : GuiEvent(event_sources::overlayUi()) {}
+    explicit UiOverlayOpenEvent(Symbol overlay_id) 
+        : GuiEvent(event_sources::overlayUi()), overlay_id_(overlay_id) {}
     
-    std::string getEventTypeName() const override { return "ui_overlay_open"; }
+    static constexpr std::string_view kTypeName = "ui_overlay_open";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<UiOverlayOpenEvent>(overlay_id_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
     
-    const std::string& getOverlayId() const { return overlay_id_; }
-    void setOverlayId(const std::string& id) { overlay_id_ = id; }
+    const std::string& getOverlayId() const { return overlay_id_.str(); }
+    void setOverlayId(Symbol id) { overlay_id_ = id; }
     
     bool isModal() const { return is_modal_; }
     void setModal(bool modal) { is_modal_ = modal; }
 
 private:
-    std::string overlay_id_;
+    Symbol overlay_id_;
     bool is_modal_ = false;
 };
 
@@ -92,28 +149,42 @@ private:
  */
 class UiOverlayCloseEvent : public GuiEvent {
 public:
-    UiOverlayCloseEvent() : GuiEvent("overlay_ui") {}
-    explicit UiOverlayCloseEvent(const std::string& overlay_id) 
-        : GuiEvent("overlay_ui"), overlay_id_(overlay_id) {}
+    UiOverlayCloseEvent() : GuiEvent(event_sources::overlayUi()) {}
+    explicit UiOverlayCloseEvent(Symbol overlay_id) 
+        : GuiEvent(event_sources::overlayUi()), overlay_id_(overlay_id) {}
     
-    std::string getEventTypeName() const override { return "ui_overlay_close"; }
+    static constexpr std::string_view kTypeName = "ui_overlay_close";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<UiOverlayCloseEvent>(overlay_id_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
     
-    const std::string& getOverlayId() const { return overlay_id_; }
-    void setOverlayId(const std::string& id) { overlay_id_ = id; }
+    const std::string& getOverlayId() const { return overlay_id_.str(); }
+    void setOverlayId(Symbol id) { overlay_id_ = id; }
     
     bool wasCancelled() const { return was_cancelled_; }
     void setCancelled(bool cancelled) { was_cancelled_ = cancelled; }
 
 private:
-    std::string overlay_id_;
+    Symbol overlay_id_;
     bool was_cancelled_ = false;
 };
 
+/**
+ * Position of an entry that matched a filter, by column and row in the
+ * filtered component's state.
+ */
+struct FilterMatch {
+    int column_index = 0;
+    int row_index = 0;
+
+    bool operator==(const FilterMatch& other) const {
+        return column_index == other.column_index && row_index == other.row_index;
+    }
+};
+
 /**
  * Event: UI Filter Applied
  * Published when a filter is applied to a UI component (e.g., inventory filter).
@@ -121,30 +192,46 @@ private:
  */
 class UiFilterAppliedEvent : public GuiEvent {
 public:
-    UiFilterAppliedEvent() : GuiEvent("overlay_ui") {}
-    UiFilterAppliedEvent(const std::string& filter_text, const std::string& target_component)
-        : GuiEvent("overlay_ui"), filter_text_(filter_text), target_component_(target_component) {}
+    UiFilterAppliedEvent() : GuiEvent(event_sources::overlayUi()) {}
+    UiFilterAppliedEvent(SharedText filter_text, Symbol target_component)
+        : GuiEvent(event_sources::overlayUi()), filter_text_(filter_text), target_component_(target_component) {}
     
-    std::string getEventTypeName() const override { return "ui_filter_applied"; }
+    static constexpr std::string_view kTypeName = "ui_filter_applied";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<UiFilterAppliedEvent>(filter_text_, target_component_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
+        cloned->setCaseSensitive(case_sensitive_);
+        cloned->setMatches(matches_);
         return cloned;
     }
     
-    const std::string& getFilterText() const { return filter_text_; }
-    void setFilterText(const std::string& text) { filter_text_ = text; }
+    const std::string& getFilterText() const { return filter_text_.str(); }
+    void setFilterText(SharedText text) { filter_text_ = text; }
     
-    const std::string& getTargetComponent() const { return target_component_; }
-    void setTargetComponent(const std::string& component) { target_component_ = component; }
+    const std::string& getTargetComponent() const { return target_component_.str(); }
+    void setTargetComponent(Symbol component) { target_component_ = component; }
     
     bool isCaseSensitive() const { return case_sensitive_; }
     void setCaseSensitive(bool sensitive) { case_sensitive_ = sensitive; }
 
+    /**
+     * Entries left by the filter, in column then row order. Shared with
+     * clones and with the component that ran the filter.
+     * @return The matching entries; empty if none were attached
+     */
+    const std::vector<FilterMatch>& getMatches() const {
+        static const std::vector<FilterMatch> empty;
+        return matches_ ? *matches_ : empty;
+    }
+    bool hasMatches() const { return matches_ != nullptr; }
+    void setMatches(std::shared_ptr<const std::vector<FilterMatch>> matches) { matches_ = std::move(matches); }
+
 private:
-    std::string filter_text_;
-    std::string target_component_;
+    SharedText filter_text_;
+    Symbol target_component_;
     bool case_sensitive_ = false;
+    std::shared_ptr<const std::vector<FilterMatch>> matches_;
 };
 
 /**
@@ -154,22 +241,23 @@ private:
  */
 class UiItemSelectedEvent : public GuiEvent {
 public:
-    UiItemSelectedEvent() : GuiEvent("overlay_ui") {}
-    UiItemSelectedEvent(const std::string& item_id, const std::string& source_component)
-        : GuiEvent("overlay_ui"), item_id_(item_id), source_component_(source_component) {}
+    UiItemSelectedEvent() : GuiEvent(event_sources::overlayUi()) {}
+    UiItemSelectedEvent(SharedText item_id, Symbol source_component)
+        : GuiEvent(event_sources::overlayUi()), item_id_(item_id), source_component_(source_component) {}
     
-    std::string getEventTypeName() const override { return "ui_item_selected"; }
+    static constexpr std::string_view kTypeName = "ui_item_selected";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<UiItemSelectedEvent>(item_id_, source_component_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
     
-    const std::string& getItemId() const { return item_id_; }
-    void setItemId(const std::string& id) { item_id_ = id; }
+    const std::string& getItemId() const { return item_id_.str(); }
+    void setItemId(SharedText id) { item_id_ = id; }
     
-    const std::string& getSourceComponent() const { return source_component_; }
-    void setSourceComponent(const std::string& component) { source_component_ = component; }
+    const std::string& getSourceComponent() const { return source_component_.str(); }
+    void setSourceComponent(Symbol component) { source_component_ = component; }
     
     bool isDoubleClick() const { return is_double_click_; }
     void setDoubleClick(bool double_click) { is_double_click_ = double_click; }
@@ -178,12 +266,47 @@ public:
     void setItemCount(int count) { item_count_ = count; }
 
 private:
-    std::string item_id_;
-    std::string source_component_;
+    SharedText item_id_;
+    Symbol source_component_;
     bool is_double_click_ = false;
     int item_count_ = 1;
 };
 
+/**
+ * Event: UI Component Toggled
+ * Published when a ToggleManager component changes visibility or enabled state.
+ * Subscribers: OverlayManager (frame profiler panel), host UI
+ */
+class UiComponentToggledEvent : public GuiEvent {
+public:
+    UiComponentToggledEvent() : GuiEvent(event_sources::toggleManager()) {}
+    UiComponentToggledEvent(Symbol component_id, bool visible, bool enabled)
+        : GuiEvent(event_sources::toggleManager()), component_id_(component_id), visible_(visible),
+          enabled_(enabled) {}
+    
+    static constexpr std::string_view kTypeName = "ui_component_toggled";
+    std::string_view getEventTypeName() const override { return kTypeName; }
+    std::unique_ptr<Event> clone() const override {
+        auto cloned = std::make_unique<UiComponentToggledEvent>(component_id_, visible_, enabled_);
+        cloned->setSource(getSourceSymbol());
+        return cloned;
+    }
+    
+    const std::string& getComponentId() const { return component_id_.str(); }
+    void setComponentId(Symbol id) { component_id_ = id; }
+    
+    bool isVisible() const { return visible_; }
+    void setVisible(bool visible) { visible_ = visible; }
+    
+    bool isEnabled() const { return enabled_; }
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+
+private:
+    Symbol component_id_;
+    bool visible_ = false;
+    bool enabled_ = false;
+};
+
 /**
  * Event: Gameplay Status Change
  * Published when character or game status effects change.
@@ -191,33 +314,34 @@ private:
  */
 class GameplayStatusChangeEvent : public GuiEvent {
 public:
-    GameplayStatusChangeEvent() : GuiEvent("gameplay") {}
-    GameplayStatusChangeEvent(const std::string& status_type, const std::string& new_value)
-        : GuiEvent("gameplay"), status_type_(status_type), new_value_(new_value) {}
+    GameplayStatusChangeEvent() : GuiEvent(event_sources::gameplay()) {}
+    GameplayStatusChangeEvent(Symbol status_type, SharedText new_value)
+        : GuiEvent(event_sources::gameplay()), status_type_(status_type), new_value_(new_value) {}
     
-    std::string getEventTypeName() const override { return "gameplay_status_change"; }
+    static constexpr std::string_view kTypeName = "gameplay_status_change";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<GameplayStatusChangeEvent>(status_type_, new_value_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
     
-    const std::string& getStatusType() const { return status_type_; }
-    void setStatusType(const std::string& type) { status_type_ = type; }
+    const std::string& getStatusType() const { return status_type_.str(); }
+    void setStatusType(Symbol type) { status_type_ = type; }
     
-    const std::string& getNewValue() const { return new_value_; }
-    void setNewValue(const std::string& value) { new_value_ = value; }
+    const std::string& getNewValue() const { return new_value_.str(); }
+    void setNewValue(SharedText value) { new_value_ = value; }
     
-    const std::string& getOldValue() const { return old_value_; }
-    void setOldValue(const std::string& value) { old_value_ = value; }
+    const std::string& getOldValue() const { return old_value_.str(); }
+    void setOldValue(SharedText value) { old_value_ = value; }
     
     bool isPositiveChange() const { return is_positive_change_; }
     void setPositiveChange(bool positive) { is_positive_change_ = positive; }
 
 private:
-    std::string status_type_;
-    std::string new_value_;
-    std::string old_value_;
+    Symbol status_type_;
+    SharedText new_value_;
+    SharedText old_value_;
     bool is_positive_change_ = false;
 };
 
@@ -228,34 +352,35 @@ private:
  */
 class GameplayInventoryChangeEvent : public GuiEvent {
 public:
-    GameplayInventoryChangeEvent() : GuiEvent("gameplay") {}
-    explicit GameplayInventoryChangeEvent(const std::string& change_type)
-        : GuiEvent("gameplay"), change_type_(change_type) {}
+    GameplayInventoryChangeEvent() : GuiEvent(event_sources::gameplay()) {}
+    explicit GameplayInventoryChangeEvent(Symbol change_type)
+        : GuiEvent(event_sources::gameplay()), change_type_(change_type) {}
     
-    std::string getEventTypeName() const override { return "gameplay_inventory_change"; }
+    static constexpr std::string_view kTypeName = "gameplay_inventory_change";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<GameplayInventoryChangeEvent>(change_type_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
     
-    const std::string& getChangeType() const { return change_type_; }
-    void setChangeType(const std::string& type) { change_type_ = type; }
+    const std::string& getChangeType() const { return change_type_.str(); }
+    void setChangeType(Symbol type) { change_type_ = type; }
     
-    const std::string& getItemId() const { return item_id_; }
-    void setItemId(const std::string& id) { item_id_ = id; }
+    const std::string& getItemId() const { return item_id_.str(); }
+    void setItemId(SharedText id) { item_id_ = id; }
     
     int getItemCount() const { return item_count_; }
     void setItemCount(int count) { item_count_ = count; }
     
-    const std::string& getItemName() const { return item_name_; }
-    void setItemName(const std::string& name) { item_name_ = name; }
+    const std::string& getItemName() const { return item_name_.str(); }
+    void setItemName(SharedText name) { item_name_ = name; }
 
 private:
-    std::string change_type_;  // "added", "removed", "modified"
-    std::string item_id_;
+    Symbol change_type_;  // "added", "removed", "modified"
+    SharedText item_id_;
     int item_count_ = 0;
-    std::string item_name_;
+    SharedText item_name_;
 };
 
 /**
@@ -265,22 +390,23 @@ private:
  */
 class GameplayNoticeEvent : public GuiEvent {
 public:
-    GameplayNoticeEvent() : GuiEvent("gameplay") {}
-    GameplayNoticeEvent(const std::string& message, const std::string& notice_type)
-        : GuiEvent("gameplay"), message_(message), notice_type_(notice_type) {}
+    GameplayNoticeEvent() : GuiEvent(event_sources::gameplay()) {}
+    GameplayNoticeEvent(SharedText message, Symbol notice_type)
+        : GuiEvent(event_sources::gameplay()), message_(message), notice_type_(notice_type) {}
     
-    std::string getEventTypeName() const override { return "gameplay_notice"; }
+    static constexpr std::string_view kTypeName = "gameplay_notice";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<GameplayNoticeEvent>(message_, notice_type_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
     
-    const std::string& getMessage() const { return message_; }
-    void setMessage(const std::string& message) { message_ = message; }
+    const std::string& getMessage() const { return message_.str(); }
+    void setMessage(SharedText message) { message_ = message; }
     
-    const std::string& getNoticeType() const { return notice_type_; }
-    void setNoticeType(const std::string& type) { notice_type_ = type; }
+    const std::string& getNoticeType() const { return notice_type_.str(); }
+    void setNoticeType(Symbol type) { notice_type_ = type; }
     
     int getDuration() const { return duration_ms_; }
     void setDuration(int duration_ms) { duration_ms_ = duration_ms; }
@@ -289,8 +415,8 @@ public:
     void setPersistent(bool persistent) { is_persistent_ = persistent; }
 
 private:
-    std::string message_;
-    std::string notice_type_;  // "info", "warning", "error", "success"
+    SharedText message_;
+    Symbol notice_type_;  // "info", "warning", "error", "success"
     int duration_ms_ = 3000;
     bool is_persistent_ = false;
 };
@@ -302,29 +428,30 @@ private:
  */
 class UiDataBindingUpdateEvent : public GuiEvent {
 public:
-    UiDataBindingUpdateEvent() : GuiEvent("overlay_ui") {}
-    UiDataBindingUpdateEvent(const std::string& binding_id, const std::string& data_source)
-        : GuiEvent("overlay_ui"), binding_id_(binding_id), data_source_(data_source) {}
+    UiDataBindingUpdateEvent() : GuiEvent(event_sources::overlayUi()) {}
+    UiDataBindingUpdateEvent(Symbol binding_id, Symbol data_source)
+        : GuiEvent(event_sources::overlayUi()), binding_id_(binding_id), data_source_(data_source) {}
     
-    std::string getEventTypeName() const override { return "ui_data_binding_update"; }
+    static constexpr std::string_view kTypeName = "ui_data_binding_update";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<UiDataBindingUpdateEvent>(binding_id_, data_source_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
     
-    const std::string& getBindingId() const { return binding_id_; }
-    void setBindingId(const std::string& id) { binding_id_ = id; }
+    const std::string& getBindingId() const { return binding_id_.str(); }
+    void setBindingId(Symbol id) { binding_id_ = id; }
     
-    const std::string& getDataSource() const { return data_source_; }
-    void setDataSource(const std::string& source) { data_source_ = source; }
+    const std::string& getDataSource() const { return data_source_.str(); }
+    void setDataSource(Symbol source) { data_source_ = source; }
     
     bool isForced() const { return is_forced_; }
     void setForced(bool forced) { is_forced_ = forced; }
 
 private:
-    std::string binding_id_;
-    std::string data_source_;
+    Symbol binding_id_;
+    Symbol data_source_;
     bool is_forced_ = false;
 };
 
@@ -335,12 +462,13 @@ private:
  */
 class PerformanceMetricsUpdateEvent : public GuiEvent {
 public:
-    PerformanceMetricsUpdateEvent() : GuiEvent("performance_monitor") {}
+    PerformanceMetricsUpdateEvent() : GuiEvent(event_sources::performanceMonitor()) {}
     
-    std::string getEventTypeName() const override { return "performance_metrics_update"; }
+    static constexpr std::string_view kTypeName = "performance_metrics_update";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<PerformanceMetricsUpdateEvent>();
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         cloned->frame_time_ms_ = frame_time_ms_;
         cloned->draw_calls_ = draw_calls_;
         cloned->vertex_count_ = vertex_count_;
@@ -375,12 +503,13 @@ private:
 class MapTileHoveredEvent : public GuiEvent {
 public:
     MapTileHoveredEvent(int x, int y)
-        : GuiEvent("map_widget"), x_(x), y_(y) {}
+        : GuiEvent(event_sources::mapWidget()), x_(x), y_(y) {}
 
-    std::string getEventTypeName() const override { return "map_tile_hovered"; }
+    static constexpr std::string_view kTypeName = "map_tile_hovered";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<MapTileHoveredEvent>(x_, y_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
 
@@ -403,12 +532,13 @@ private:
 class MapTileClickedEvent : public GuiEvent {
 public:
     MapTileClickedEvent(int x, int y)
-        : GuiEvent("map_widget"), x_(x), y_(y) {}
+        : GuiEvent(event_sources::mapWidget()), x_(x), y_(y) {}
 
-    std::string getEventTypeName() const override { return "map_tile_clicked"; }
+    static constexpr std::string_view kTypeName = "map_tile_clicked";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<MapTileClickedEvent>(x_, y_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
 
@@ -431,12 +561,13 @@ private:
 class InventoryItemClickedEvent : public GuiEvent {
 public:
     InventoryItemClickedEvent(const inventory_entry& entry)
-        : GuiEvent("inventory_widget"), entry_(entry) {}
+        : GuiEvent(event_sources::inventoryWidget()), entry_(entry) {}
 
-    std::string getEventTypeName() const override { return "inventory_item_clicked"; }
+    static constexpr std::string_view kTypeName = "inventory_item_clicked";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<InventoryItemClickedEvent>(entry_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
 
@@ -455,56 +586,65 @@ private:
 class InventoryKeyInputEvent : public GuiEvent {
 public:
     explicit InventoryKeyInputEvent(const SDL_KeyboardEvent& key_event)
-        : GuiEvent("inventory_widget"), key_event_(key_event) {}
+        : GuiEvent(event_sources::inventoryWidget()), key_event_(key_event) {}
 
-    std::string getEventTypeName() const override { return "inventory_key_input"; }
+    static constexpr std::string_view kTypeName = "inventory_key_input";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<InventoryKeyInputEvent>(key_event_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
+        cloned->setRepeatCount(repeat_count_);
         return cloned;
     }
 
     const SDL_KeyboardEvent& getKeyEvent() const { return key_event_; }
 
+    // Number of identical key presses in a row this event stands for, e.g. coalesced wheel steps.
+    int getRepeatCount() const { return repeat_count_; }
+    void setRepeatCount(int count) { repeat_count_ = count; }
+
 private:
     SDL_KeyboardEvent key_event_{};
+    int repeat_count_ = 1;
 };
 
 class CharacterTabRequestedEvent : public GuiEvent {
 public:
-    CharacterTabRequestedEvent(const std::string& tab_id)
-        : GuiEvent("character_widget"), tab_id_(tab_id) {}
+    CharacterTabRequestedEvent(Symbol tab_id)
+        : GuiEvent(event_sources::characterWidget()), tab_id_(tab_id) {}
 
-    std::string getEventTypeName() const override { return "character_tab_requested"; }
+    static constexpr std::string_view kTypeName = "character_tab_requested";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<CharacterTabRequestedEvent>(tab_id_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
 
-    const std::string& getTabId() const { return tab_id_; }
+    const std::string& getTabId() const { return tab_id_.str(); }
 
 private:
-    std::string tab_id_;
+    Symbol tab_id_;
 };
 
 class CharacterRowActivatedEvent : public GuiEvent {
 public:
-    CharacterRowActivatedEvent(const std::string& tab_id, int row_index)
-        : GuiEvent("character_widget"), tab_id_(tab_id), row_index_(row_index) {}
+    CharacterRowActivatedEvent(Symbol tab_id, int row_index)
+        : GuiEvent(event_sources::characterWidget()), tab_id_(tab_id), row_index_(row_index) {}
 
-    std::string getEventTypeName() const override { return "character_row_activated"; }
+    static constexpr std::string_view kTypeName = "character_row_activated";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<CharacterRowActivatedEvent>(tab_id_, row_index_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
 
-    const std::string& getTabId() const { return tab_id_; }
+    const std::string& getTabId() const { return tab_id_.str(); }
     int getRowIndex() const { return row_index_; }
 
 private:
-    std::string tab_id_;
+    Symbol tab_id_;
     int row_index_;
 };
 
@@ -518,12 +658,13 @@ enum class CharacterCommand {
 class CharacterCommandEvent : public GuiEvent {
 public:
     CharacterCommandEvent(CharacterCommand command)
-        : GuiEvent("character_widget"), command_(command) {}
+        : GuiEvent(event_sources::characterWidget()), command_(command) {}
 
-    std::string getEventTypeName() const override { return "character_command"; }
+    static constexpr std::string_view kTypeName = "character_command";
+    std::string_view getEventTypeName() const override { return kTypeName; }
     std::unique_ptr<Event> clone() const override {
         auto cloned = std::make_unique<CharacterCommandEvent>(command_);
-        cloned->setSource(getSource());
+        cloned->setSource(getSourceSymbol());
         return cloned;
     }
 
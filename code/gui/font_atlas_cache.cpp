@@ -0,0 +1,426 @@
+#include "font_atlas_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+#include "debug.h"
+
+namespace gui {
+
+namespace resource_manager {
+
+namespace {
+
+constexpr uint32_t kCacheMagic = 0x464E4243; // "CBNF"
+constexpr uint32_t kCacheFormatVersion = 1;
+
+// Latin-1, matching ImFontAtlas::GetGlyphRangesDefault()
+const ImWchar kDefaultRanges[] = {0x0020, 0x00FF, 0};
+
+// Corrupt files must not turn into huge allocations
+constexpr int kMaxTextureSize = 16384;
+constexpr uint32_t kMaxFonts = 64;
+constexpr uint32_t kMaxGlyphs = 1u << 20;
+constexpr uint32_t kMaxKeyLength = 1u << 16;
+
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Size and modification time of the font file, so a font replaced at the
+// same path is rasterized again instead of restoring its old glyphs
+std::string font_file_stamp(const std::string& family) {
+    if (family.empty()) return std::string();
+
+    std::error_code error;
+    const auto size = std::filesystem::file_size(family, error);
+    if (error) return std::string();
+    const auto modified = std::filesystem::last_write_time(family, error);
+    if (error) return std::string();
+
+    std::ostringstream out;
+    out << size << ':' << modified.time_since_epoch().count();
+    return out.str();
+}
+
+template<typename T>
+void write_pod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_pod(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+std::string FontAtlasKey::to_string() const {
+    std::ostringstream out;
+    out << family << '|' << std::fixed << std::setprecision(3) << size_pixels << '|' << scale << '|' << std::hex;
+    for (ImWchar c : ranges) {
+        if (c == 0) break;
+        out << static_cast<uint32_t>(c) << ',';
+    }
+    return out.str();
+}
+
+std::string FontAtlasCache::get_cache_id(const FontAtlasKey& key) {
+    return key.to_string() + '|' + font_file_stamp(key.family);
+}
+
+FontAtlasCache::FontAtlasCache(size_t max_entries)
+    : max_entries_(std::max<size_t>(max_entries, 1)) {
+}
+
+bool FontAtlasCache::load(const FontAtlasKey& key, ImFontAtlas& atlas) {
+    if (key.family != loaded_family_) {
+        // Codepoints another font lacked may exist in this one
+        requested_glyphs_.clear();
+        missing_.clear();
+    }
+
+    const std::string id = get_cache_id(key);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->key == id) {
+            entries_.splice(entries_.begin(), entries_, it);
+            restore(entries_.front(), atlas);
+            memory_hits_++;
+            on_loaded(key, atlas);
+            return true;
+        }
+    }
+
+    CachedAtlas entry;
+    if (!directory_.empty() && read_file(id, entry)) {
+        // Marks the file as recently used for prune_directory()
+        std::error_code error;
+        std::filesystem::last_write_time(path_for(id), std::filesystem::file_time_type::clock::now(), error);
+        restore(entry, atlas);
+        disk_hits_++;
+        remember(std::move(entry));
+        on_loaded(key, atlas);
+        return true;
+    }
+
+    if (!rasterize(key, atlas)) {
+        return false;
+    }
+    rasterizations_++;
+
+    entry.key = id;
+    if (capture(atlas, entry)) {
+        if (!directory_.empty()) {
+            if (write_file(entry)) {
+                prune_directory();
+            } else {
+                debuglog(DebugLevel::Warning, "FontAtlasCache: could not write ", path_for(id));
+            }
+        }
+        remember(std::move(entry));
+    }
+    on_loaded(key, atlas);
+    return true;
+}
+
+void FontAtlasCache::request_glyphs(const std::string& text) {
+    for (size_t offset = 0; offset < text.size();) {
+        const uint32_t codepoint = utilities::next_codepoint(text, offset);
+        if (codepoint < 0x20 || codepoint > IM_UNICODE_CODEPOINT_MAX) continue;
+        if (loaded_glyphs_.contains(codepoint) || requested_glyphs_.contains(codepoint)) continue;
+
+        // Requested once per font, so glyphs the font lacks are not retried every frame
+        requested_glyphs_.insert(codepoint);
+        missing_.push_back(static_cast<ImWchar>(codepoint));
+    }
+}
+
+bool FontAtlasCache::merge_missing_glyphs(FontAtlasKey& key) {
+    if (missing_.empty()) return false;
+
+    ImFontGlyphRangesBuilder builder;
+    builder.AddRanges(key.ranges.empty() ? kDefaultRanges : key.ranges.data());
+    for (ImWchar c : missing_) {
+        builder.AddChar(c);
+    }
+    missing_.clear();
+
+    ImVector<ImWchar> ranges;
+    builder.BuildRanges(&ranges);
+    key.ranges.assign(ranges.begin(), ranges.end());
+    return true;
+}
+
+bool FontAtlasCache::rasterize(const FontAtlasKey& key, ImFontAtlas& atlas) {
+    if (!key.family.empty() && !std::ifstream(key.family, std::ios::binary).good()) {
+        debuglog(DebugLevel::Warning, "FontAtlasCache: cannot open font ", key.family);
+        return false;
+    }
+
+    atlas.Clear();
+    atlas.Flags &= ~ImFontAtlasFlags_NoMouseCursors;
+
+    build_ranges_ = key.ranges;
+    ImFontConfig config;
+    config.SizePixels = key.size_pixels * key.scale;
+    config.GlyphRanges = build_ranges_.empty() ? nullptr : build_ranges_.data();
+
+    ImFont* font = nullptr;
+    if (key.family.empty()) {
+        // Same settings AddFontDefault() uses without a template
+        config.OversampleH = 1;
+        config.OversampleV = 1;
+        config.PixelSnapH = true;
+        font = atlas.AddFontDefault(&config);
+    } else {
+        font = atlas.AddFontFromFileTTF(key.family.c_str(), config.SizePixels, &config, config.GlyphRanges);
+    }
+
+    if (!font || !atlas.Build()) {
+        atlas.Clear();
+        return false;
+    }
+    return true;
+}
+
+bool FontAtlasCache::capture(const ImFontAtlas& atlas, CachedAtlas& entry) const {
+    if (!atlas.TexPixelsAlpha8 || atlas.TexWidth <= 0 || atlas.TexHeight <= 0) {
+        return false;
+    }
+
+    entry.width = atlas.TexWidth;
+    entry.height = atlas.TexHeight;
+    entry.flags = atlas.Flags;
+    entry.uv_scale = atlas.TexUvScale;
+    entry.uv_white_pixel = atlas.TexUvWhitePixel;
+    entry.uv_lines.assign(std::begin(atlas.TexUvLines), std::end(atlas.TexUvLines));
+    entry.alpha8.assign(atlas.TexPixelsAlpha8,
+                        atlas.TexPixelsAlpha8 + static_cast<size_t>(atlas.TexWidth) * atlas.TexHeight);
+
+    entry.fonts.clear();
+    for (const ImFont* font : atlas.Fonts) {
+        CachedFont cached;
+        cached.font_size = font->FontSize;
+        cached.ascent = font->Ascent;
+        cached.descent = font->Descent;
+        cached.glyphs.reserve(static_cast<size_t>(font->Glyphs.Size));
+        for (const ImFontGlyph& glyph : font->Glyphs) {
+            cached.glyphs.push_back({glyph.Codepoint, glyph.AdvanceX, glyph.X0, glyph.Y0, glyph.X1, glyph.Y1,
+                                     glyph.U0, glyph.V0, glyph.U1, glyph.V1});
+        }
+        entry.fonts.push_back(std::move(cached));
+    }
+    return true;
+}
+
+void FontAtlasCache::restore(const CachedAtlas& entry, ImFontAtlas& atlas) const {
+    atlas.Clear();
+
+    // Cursor shapes are not cached; ImGui then leaves cursors to the platform
+    atlas.Flags = entry.flags | ImFontAtlasFlags_NoMouseCursors;
+    atlas.TexWidth = entry.width;
+    atlas.TexHeight = entry.height;
+    atlas.TexUvScale = entry.uv_scale;
+    atlas.TexUvWhitePixel = entry.uv_white_pixel;
+    std::copy_n(entry.uv_lines.begin(), std::min<size_t>(entry.uv_lines.size(), IM_ARRAYSIZE(atlas.TexUvLines)),
+                atlas.TexUvLines);
+
+    atlas.TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(entry.alpha8.size()));
+    std::memcpy(atlas.TexPixelsAlpha8, entry.alpha8.data(), entry.alpha8.size());
+
+    // Each font gets a config like the one it was built from, which ImGui
+    // reads when building lookup tables and in its debug tools. The font data
+    // itself is not kept, so a restored atlas cannot be rebuilt in place.
+    const std::string family = entry.key.substr(0, entry.key.find('|'));
+    const std::string name = family.empty() ? "ProggyClean.ttf" : std::filesystem::path(family).filename().string();
+    for (const CachedFont& cached : entry.fonts) {
+        ImFontConfig config;
+        config.SizePixels = cached.font_size;
+        config.FontDataOwnedByAtlas = false;
+        std::snprintf(config.Name, IM_ARRAYSIZE(config.Name), "%s, %.0fpx", name.c_str(), cached.font_size);
+        atlas.ConfigData.push_back(config);
+    }
+
+    for (int i = 0; i < atlas.ConfigData.Size; ++i) {
+        const CachedFont& cached = entry.fonts[static_cast<size_t>(i)];
+        ImFontConfig& config = atlas.ConfigData[i];
+        ImFont* font = IM_NEW(ImFont);
+        config.DstFont = font;
+        font->ConfigData = &config;
+        font->ConfigDataCount = 1;
+        // As AddFont() does; BuildLookupTable() then picks the ellipsis from
+        // the restored glyphs the same way Build() did
+        font->EllipsisChar = config.EllipsisChar;
+        font->ContainerAtlas = &atlas;
+        font->FontSize = cached.font_size;
+        font->Ascent = cached.ascent;
+        font->Descent = cached.descent;
+        for (const CachedGlyph& glyph : cached.glyphs) {
+            font->AddGlyph(nullptr, static_cast<ImWchar>(glyph.codepoint), glyph.x0, glyph.y0, glyph.x1, glyph.y1,
+                           glyph.u0, glyph.v0, glyph.u1, glyph.v1, glyph.advance_x);
+        }
+        font->BuildLookupTable();
+        atlas.Fonts.push_back(font);
+    }
+    atlas.TexReady = true;
+}
+
+void FontAtlasCache::remember(CachedAtlas&& entry) {
+    entries_.push_front(std::move(entry));
+    while (entries_.size() > max_entries_) {
+        entries_.pop_back();
+    }
+}
+
+void FontAtlasCache::on_loaded(const FontAtlasKey& key, const ImFontAtlas& atlas) {
+    loaded_family_ = key.family;
+    loaded_glyphs_ = GlyphSet(atlas.Fonts.Size > 0 ? atlas.Fonts[0] : nullptr);
+}
+
+std::string FontAtlasCache::path_for(const std::string& key) const {
+    std::ostringstream name;
+    name << "font_atlas_" << std::hex << std::setw(16) << std::setfill('0') << fnv1a(key) << ".bin";
+    return (std::filesystem::path(directory_) / name.str()).string();
+}
+
+bool FontAtlasCache::read_file(const std::string& key, CachedAtlas& entry) const {
+    std::ifstream in(path_for(key), std::ios::binary);
+    if (!in) return false;
+
+    // Glyph layout and atlas fields follow ImGui's version, so any mismatch
+    // is a miss and the atlas is rasterized again
+    uint32_t magic = 0, format = 0, imgui_version = 0, wchar_size = 0, key_length = 0;
+    if (!read_pod(in, magic) || !read_pod(in, format) || !read_pod(in, imgui_version) ||
+        !read_pod(in, wchar_size) || !read_pod(in, key_length)) {
+        return false;
+    }
+    if (magic != kCacheMagic || format != kCacheFormatVersion || imgui_version != IMGUI_VERSION_NUM ||
+        wchar_size != sizeof(ImWchar) || key_length != key.size() || key_length > kMaxKeyLength) {
+        return false;
+    }
+
+    std::string stored_key(key_length, '\0');
+    if (!in.read(&stored_key[0], key_length) || stored_key != key) {
+        return false;
+    }
+
+    uint32_t line_count = 0, font_count = 0;
+    if (!read_pod(in, entry.width) || !read_pod(in, entry.height) || !read_pod(in, entry.flags) ||
+        !read_pod(in, entry.uv_scale) || !read_pod(in, entry.uv_white_pixel) || !read_pod(in, line_count)) {
+        return false;
+    }
+    if (entry.width <= 0 || entry.height <= 0 || entry.width > kMaxTextureSize || entry.height > kMaxTextureSize ||
+        line_count != static_cast<uint32_t>(IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1)) {
+        return false;
+    }
+
+    entry.uv_lines.resize(line_count);
+    if (!in.read(reinterpret_cast<char*>(entry.uv_lines.data()), line_count * sizeof(ImVec4)) ||
+        !read_pod(in, font_count) || font_count == 0 || font_count > kMaxFonts) {
+        return false;
+    }
+
+    entry.fonts.resize(font_count);
+    for (CachedFont& font : entry.fonts) {
+        uint32_t glyph_count = 0;
+        if (!read_pod(in, font.font_size) || !read_pod(in, font.ascent) || !read_pod(in, font.descent) ||
+            !read_pod(in, glyph_count) || glyph_count > kMaxGlyphs) {
+            return false;
+        }
+        font.glyphs.resize(glyph_count);
+        if (!in.read(reinterpret_cast<char*>(font.glyphs.data()), glyph_count * sizeof(CachedGlyph))) {
+            return false;
+        }
+    }
+
+    entry.alpha8.resize(static_cast<size_t>(entry.width) * entry.height);
+    if (!in.read(reinterpret_cast<char*>(entry.alpha8.data()), static_cast<std::streamsize>(entry.alpha8.size()))) {
+        return false;
+    }
+
+    entry.key = key;
+    return true;
+}
+
+bool FontAtlasCache::write_file(const CachedAtlas& entry) const {
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+
+    // Written beside the target and renamed, so a crash never leaves a torn file
+    const std::string path = path_for(entry.key);
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        write_pod(out, kCacheMagic);
+        write_pod(out, kCacheFormatVersion);
+        write_pod(out, static_cast<uint32_t>(IMGUI_VERSION_NUM));
+        write_pod(out, static_cast<uint32_t>(sizeof(ImWchar)));
+        write_pod(out, static_cast<uint32_t>(entry.key.size()));
+        out.write(entry.key.data(), static_cast<std::streamsize>(entry.key.size()));
+
+        write_pod(out, entry.width);
+        write_pod(out, entry.height);
+        write_pod(out, entry.flags);
+        write_pod(out, entry.uv_scale);
+        write_pod(out, entry.uv_white_pixel);
+        write_pod(out, static_cast<uint32_t>(entry.uv_lines.size()));
+        out.write(reinterpret_cast<const char*>(entry.uv_lines.data()),
+                  static_cast<std::streamsize>(entry.uv_lines.size() * sizeof(ImVec4)));
+
+        write_pod(out, static_cast<uint32_t>(entry.fonts.size()));
+        for (const CachedFont& font : entry.fonts) {
+            write_pod(out, font.font_size);
+            write_pod(out, font.ascent);
+            write_pod(out, font.descent);
+            write_pod(out, static_cast<uint32_t>(font.glyphs.size()));
+            out.write(reinterpret_cast<const char*>(font.glyphs.data()),
+                      static_cast<std::streamsize>(font.glyphs.size() * sizeof(CachedGlyph)));
+        }
+
+        out.write(reinterpret_cast<const char*>(entry.alpha8.data()), static_cast<std::streamsize>(entry.alpha8.size()));
+        if (!out) return false;
+    }
+
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void FontAtlasCache::prune_directory() const {
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> files;
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(directory_, error)) {
+        const std::string name = item.path().filename().string();
+        if (name.rfind("font_atlas_", 0) != 0 || item.path().extension() != ".bin") continue;
+        const auto modified = item.last_write_time(error);
+        if (!error) {
+            files.emplace_back(modified, item.path());
+        }
+    }
+    if (files.size() <= max_disk_entries_) return;
+
+    // Oldest first; loads refresh the time of files they restore
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i + max_disk_entries_ < files.size(); ++i) {
+        std::filesystem::remove(files[i].second, error);
+    }
+}
+
+} // namespace resource_manager
+
+} // namespace gui
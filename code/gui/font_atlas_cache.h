@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+#include "resource_manager.h"
+
+namespace gui {
+
+namespace resource_manager {
+
+// Everything that decides what a rasterized atlas looks like
+struct FontAtlasKey {
+    std::string family;           // TTF path; empty selects ImGui's built-in font
+    float size_pixels{13.0f};     // Unscaled size
+    float scale{1.0f};            // DPI / window scale, baked into the glyphs
+    std::vector<ImWchar> ranges;  // Zero-terminated pairs as ImGui takes them; empty = Latin-1
+
+    std::string to_string() const;
+};
+
+// Keeps rasterized font atlases so a settings or DPI change back to a known
+// configuration, or the next startup, restores glyphs instead of rebuilding.
+// Entries live in memory (most recent first) and, when a directory is set, on
+// disk. Large scripts are loaded on demand: text queued through
+// request_glyphs() collects codepoints the atlas lacks, and the owner merges
+// them into its key and reloads between frames.
+class FontAtlasCache {
+public:
+    explicit FontAtlasCache(size_t max_entries = 4);
+
+    // Directory for cache files; empty keeps the cache in memory only
+    void set_directory(const std::string& directory) { directory_ = directory; }
+    const std::string& get_directory() const { return directory_; }
+    
+    // Atlas files kept in the directory; each glyph merge writes a new one, so
+    // the least recently used are deleted past this count
+    void set_max_disk_entries(size_t count) { max_disk_entries_ = std::max<size_t>(count, 1); }
+
+    // Fill the atlas for key: from memory, then disk, then by rasterizing and
+    // storing the result. Returns false if the font cannot be built.
+    bool load(const FontAtlasKey& key, ImFontAtlas& atlas);
+
+    // Queue the codepoints of UTF-8 text that the last loaded atlas lacks
+    void request_glyphs(const std::string& text);
+    bool has_missing_glyphs() const { return !missing_.empty(); }
+
+    // Add the queued codepoints to key's ranges; returns false if none were queued
+    bool merge_missing_glyphs(FontAtlasKey& key);
+
+    // Identifies key's atlas in memory and on disk: the key plus the font
+    // file's size and modification time
+    static std::string get_cache_id(const FontAtlasKey& key);
+
+    size_t get_memory_hits() const { return memory_hits_; }
+    size_t get_disk_hits() const { return disk_hits_; }
+    size_t get_rasterizations() const { return rasterizations_; }
+
+private:
+    struct CachedGlyph {
+        uint32_t codepoint{0};
+        float advance_x{0.0f};
+        float x0{0.0f}, y0{0.0f}, x1{0.0f}, y1{0.0f};
+        float u0{0.0f}, v0{0.0f}, u1{0.0f}, v1{0.0f};
+    };
+
+    struct CachedFont {
+        float font_size{0.0f};
+        float ascent{0.0f};
+        float descent{0.0f};
+        std::vector<CachedGlyph> glyphs;
+    };
+
+    struct CachedAtlas {
+        std::string key;
+        int width{0};
+        int height{0};
+        int flags{0};
+        ImVec2 uv_scale;
+        ImVec2 uv_white_pixel;
+        std::vector<ImVec4> uv_lines;
+        std::vector<CachedFont> fonts;
+        std::vector<uint8_t> alpha8;
+    };
+
+    bool rasterize(const FontAtlasKey& key, ImFontAtlas& atlas);
+    bool capture(const ImFontAtlas& atlas, CachedAtlas& entry) const;
+    void restore(const CachedAtlas& entry, ImFontAtlas& atlas) const;
+    void remember(CachedAtlas&& entry);
+    void on_loaded(const FontAtlasKey& key, const ImFontAtlas& atlas);
+
+    std::string path_for(const std::string& key) const;
+    bool read_file(const std::string& key, CachedAtlas& entry) const;
+    bool write_file(const CachedAtlas& entry) const;
+    void prune_directory() const;
+
+    size_t max_entries_;
+    size_t max_disk_entries_{16};
+    std::string directory_;
+    std::list<CachedAtlas> entries_;
+
+    // ImGui reads glyph ranges during Build(), so the last ranges stay alive here
+    std::vector<ImWchar> build_ranges_;
+
+    std::string loaded_family_;
+    GlyphSet loaded_glyphs_;
+    GlyphSet requested_glyphs_;
+    std::vector<ImWchar> missing_;
+
+    size_t memory_hits_{0};
+    size_t disk_hits_{0};
+    size_t rasterizations_{0};
+};
+
+} // namespace resource_manager
+
+} // namespace gui
@@ -0,0 +1,72 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+thread_local FrameArena* g_current_arena = nullptr;
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+FrameArena::FrameArena(size_t block_size) : block_size_(std::max<size_t>(block_size, 256)) {}
+
+FrameArena::~FrameArena() = default;
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+    alignment = std::max<size_t>(alignment, 1);
+    size = std::max<size_t>(size, 1);
+
+    while (block_index_ < blocks_.size()) {
+        Block& block = blocks_[block_index_];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const size_t aligned = AlignUp(base + offset_, alignment) - base;
+        if (aligned + size <= block.size) {
+            offset_ = aligned + size;
+            bytes_used_ += size;
+            peak_bytes_used_ = std::max(peak_bytes_used_, bytes_used_);
+            return block.data.get() + aligned;
+        }
+        // Blocks kept from earlier frames are tried in order before growing
+        ++block_index_;
+        offset_ = 0;
+    }
+
+    Block block;
+    block.size = std::max(block_size_, size + alignment);
+    block.data = std::make_unique<uint8_t[]>(block.size);
+    capacity_ += block.size;
+    blocks_.push_back(std::move(block));
+    block_index_ = blocks_.size() - 1;
+    offset_ = 0;
+    return Allocate(size, alignment);
+}
+
+std::string_view FrameArena::CopyString(std::string_view text) {
+    char* copy = static_cast<char*>(Allocate(text.size() + 1, alignof(char)));
+    std::memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    return std::string_view(copy, text.size());
+}
+
+void FrameArena::Reset() {
+    block_index_ = 0;
+    offset_ = 0;
+    bytes_used_ = 0;
+}
+
+FrameArena* FrameArena::Current() {
+    return g_current_arena;
+}
+
+FrameArena::Scope::Scope(FrameArena* arena) : previous_(g_current_arena) {
+    g_current_arena = arena;
+}
+
+FrameArena::Scope::~Scope() {
+    g_current_arena = previous_;
+}
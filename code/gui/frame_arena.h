@@ -0,0 +1,154 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Bump allocator for data that only lives while one frame is built.
+ *
+ * Allocate() hands out memory from a list of blocks by advancing an offset;
+ * individual allocations are never freed. Reset() rewinds to the first block
+ * but keeps every block, so once a frame's peak usage has been seen, later
+ * frames no longer touch the global allocator.
+ *
+ * The overlay resets its arena after each rendered frame. Nothing allocated
+ * from it may be kept past that point: rects a widget hit-tests between
+ * frames stay in the widget's own containers.
+ */
+class FrameArena {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit FrameArena(size_t block_size = kDefaultBlockSize);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @param size Bytes to allocate
+     * @param alignment Power of two the result is aligned to
+     * @return Memory valid until the next Reset()
+     */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Copy text into the arena.
+     * @return View of the copy, followed by a terminating NUL
+     */
+    std::string_view CopyString(std::string_view text);
+
+    /**
+     * Release every allocation at once, keeping the blocks for the next frame.
+     */
+    void Reset();
+
+    /**
+     * @return Bytes allocated since the last Reset()
+     */
+    [[nodiscard]] size_t GetBytesUsed() const { return bytes_used_; }
+
+    /**
+     * @return Most bytes allocated between two resets
+     */
+    [[nodiscard]] size_t GetPeakBytesUsed() const { return peak_bytes_used_; }
+
+    /**
+     * @return Total size of the blocks the arena holds
+     */
+    [[nodiscard]] size_t GetCapacity() const { return capacity_; }
+
+    [[nodiscard]] size_t GetBlockCount() const { return blocks_.size(); }
+
+    /**
+     * @return The arena installed on this thread by a Scope, or nullptr
+     */
+    static FrameArena* Current();
+
+    /**
+     * Installs an arena as the current one for this thread until destroyed.
+     * Scopes nest; the previous arena is restored on exit.
+     */
+    class Scope {
+    public:
+        explicit Scope(FrameArena* arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameArena* previous_;
+    };
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size = 0;
+    };
+
+    size_t block_size_;
+    std::vector<Block> blocks_;
+    size_t block_index_ = 0;
+    size_t offset_ = 0;
+    size_t bytes_used_ = 0;
+    size_t peak_bytes_used_ = 0;
+    size_t capacity_ = 0;
+};
+
+/**
+ * Standard allocator drawing from a FrameArena. A default-constructed
+ * allocator binds to FrameArena::Current(); with no arena installed it falls
+ * back to the global heap, so the same widget code works outside the overlay.
+ */
+template <typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    FrameAllocator() noexcept : arena_(FrameArena::Current()) {}
+    explicit FrameAllocator(FrameArena* arena) noexcept : arena_(arena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) noexcept : arena_(other.GetArena()) {}
+
+    T* allocate(size_t count) {
+        if (arena_) {
+            return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t) noexcept {
+        // Arena memory is released all at once by FrameArena::Reset()
+        if (!arena_) {
+            ::operator delete(pointer);
+        }
+    }
+
+    [[nodiscard]] FrameArena* GetArena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>& other) const noexcept {
+        return arena_ == other.GetArena();
+    }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U>& other) const noexcept {
+        return arena_ != other.GetArena();
+    }
+
+private:
+    FrameArena* arena_;
+};
+
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,471 @@
+#include "frame_profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include "imgui.h"
+
+namespace {
+
+// One ring buffer entry. sequence holds the zone's index + 1 once the entry
+// is complete and 0 while it is being rewritten, so readers on another thread
+// can tell a consistent copy from one the owner overwrote mid-read.
+struct ZoneSlot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> end_ns{0};
+    std::atomic<uint32_t> depth{0};
+};
+
+struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t thread_index) : index(thread_index), slots(FrameProfiler::kZonesPerThread) {}
+
+    const uint32_t index;
+    std::vector<ZoneSlot> slots;
+    // Zones written so far; only the owning thread stores it
+    std::atomic<uint64_t> written{0};
+
+    // Guarded by Registry::mutex
+    uint64_t frame_cursor = 0;
+    std::string name;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+// Never destroyed: threads may still record while statics are torn down
+Registry& GetRegistry() {
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer& LocalBuffer() {
+    if (!t_buffer) {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(registry.buffers.size())));
+        t_buffer = registry.buffers.back().get();
+    }
+    return *t_buffer;
+}
+
+bool ReadSlot(const ThreadBuffer& buffer, uint64_t index, ProfileZoneRecord* record) {
+    const ZoneSlot& slot = buffer.slots[index % FrameProfiler::kZonesPerThread];
+    if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+        return false;
+    }
+    record->name = slot.name.load(std::memory_order_relaxed);
+    record->start_ns = slot.start_ns.load(std::memory_order_relaxed);
+    record->end_ns = slot.end_ns.load(std::memory_order_relaxed);
+    record->depth = slot.depth.load(std::memory_order_relaxed);
+    record->thread_index = buffer.index;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+}
+
+// Append the zones buffer recorded in [from, written) that are still intact
+uint64_t ReadZones(const ThreadBuffer& buffer, uint64_t from, std::vector<ProfileZoneRecord>* zones) {
+    const uint64_t written = buffer.written.load(std::memory_order_acquire);
+    const uint64_t oldest = written > FrameProfiler::kZonesPerThread ? written - FrameProfiler::kZonesPerThread : 0;
+    for (uint64_t index = std::max(from, oldest); index < written; ++index) {
+        ProfileZoneRecord record;
+        if (ReadSlot(buffer, index, &record)) {
+            zones->push_back(record);
+        }
+    }
+    return written;
+}
+
+std::string DefaultThreadName(uint32_t thread_index) {
+    return "Thread " + std::to_string(thread_index);
+}
+
+void WriteJsonString(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+#if GUI_PROFILER_ENABLED
+ImU32 ZoneColor(const char* name) {
+    const size_t hash = std::hash<std::string_view>{}(name ? std::string_view(name) : std::string_view());
+    const float hue = static_cast<float>(hash % 360) / 360.0f;
+    return ImColor::HSV(hue, 0.55f, 0.75f);
+}
+#endif
+
+} // namespace
+
+namespace frame_profiler_detail {
+
+uint64_t Now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+void Record(const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t depth) {
+    ThreadBuffer& buffer = LocalBuffer();
+    const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    ZoneSlot& slot = buffer.slots[index % FrameProfiler::kZonesPerThread];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.end_ns.store(end_ns, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+} // namespace frame_profiler_detail
+
+struct FrameProfiler::Impl {
+    mutable std::mutex mutex;
+    bool paused = false;
+    uint64_t frame_index = 0;
+    uint64_t frame_start_ns = 0; // 0 until a frame has begun since enabling
+    ProfileFrame last_frame;
+    std::array<float, kFrameHistory> frame_times{};
+    size_t frame_time_count = 0;
+    size_t frame_time_head = 0;
+
+    // Panel state
+    std::array<char, 256> export_path{};
+    std::string export_status;
+};
+
+FrameProfiler& FrameProfiler::Get() {
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+FrameProfiler::FrameProfiler() : impl_(std::make_unique<Impl>()) {
+    std::snprintf(impl_->export_path.data(), impl_->export_path.size(), "%s", "gui_profile.json");
+}
+
+FrameProfiler::~FrameProfiler() = default;
+
+void FrameProfiler::SetEnabled(bool enabled) {
+    if (frame_profiler_detail::enabled.exchange(enabled, std::memory_order_relaxed) == enabled) {
+        return;
+    }
+    // The frame that was open when recording stopped never completes
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->frame_start_ns = 0;
+}
+
+void FrameProfiler::SetPaused(bool paused) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->paused = paused;
+}
+
+bool FrameProfiler::IsPaused() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->paused;
+}
+
+void FrameProfiler::BeginFrame() {
+    if (!IsEnabled()) {
+        return;
+    }
+
+    const uint64_t now = Now();
+    ThreadBuffer& local = LocalBuffer();
+
+    // Gather the zones every thread finished since the last frame, even when
+    // paused, so resuming does not show a frame spanning the pause
+    std::vector<ProfileZoneRecord> zones;
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (local.name.empty()) {
+            local.name = "UI";
+        }
+        for (const auto& buffer : registry.buffers) {
+            buffer->frame_cursor = ReadZones(*buffer, buffer->frame_cursor, &zones);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const uint64_t frame_start = impl_->frame_start_ns;
+    impl_->frame_start_ns = now;
+    if (frame_start == 0 || impl_->paused) {
+        return;
+    }
+
+    ProfileFrame& frame = impl_->last_frame;
+    frame.index = impl_->frame_index++;
+    frame.start_ns = frame_start;
+    frame.end_ns = now;
+    frame.zones = std::move(zones);
+    std::sort(frame.zones.begin(), frame.zones.end(), [](const ProfileZoneRecord& a, const ProfileZoneRecord& b) {
+        return a.start_ns < b.start_ns;
+    });
+
+    impl_->frame_times[impl_->frame_time_head] = static_cast<float>(now - frame_start) / 1.0e6f;
+    impl_->frame_time_head = (impl_->frame_time_head + 1) % kFrameHistory;
+    impl_->frame_time_count = std::min(impl_->frame_time_count + 1, kFrameHistory);
+}
+
+ProfileFrame FrameProfiler::GetLastFrame() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->last_frame;
+}
+
+std::vector<float> FrameProfiler::GetFrameTimes() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<float> times;
+    times.reserve(impl_->frame_time_count);
+    const size_t first = (impl_->frame_time_head + kFrameHistory - impl_->frame_time_count) % kFrameHistory;
+    for (size_t i = 0; i < impl_->frame_time_count; ++i) {
+        times.push_back(impl_->frame_times[(first + i) % kFrameHistory]);
+    }
+    return times;
+}
+
+void FrameProfiler::SetThreadName(const std::string& name) {
+    ThreadBuffer& local = LocalBuffer();
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    local.name = name;
+}
+
+std::string FrameProfiler::GetThreadName(uint32_t thread_index) const {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (thread_index < registry.buffers.size() && !registry.buffers[thread_index]->name.empty()) {
+        return registry.buffers[thread_index]->name;
+    }
+    return DefaultThreadName(thread_index);
+}
+
+bool FrameProfiler::WriteChromeTrace(std::ostream& out) const {
+    std::vector<ProfileZoneRecord> zones;
+    std::vector<std::string> thread_names;
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& buffer : registry.buffers) {
+            ReadZones(*buffer, 0, &zones);
+            thread_names.push_back(buffer->name.empty() ? DefaultThreadName(buffer->index) : buffer->name);
+        }
+    }
+
+    uint64_t origin = UINT64_MAX;
+    for (const ProfileZoneRecord& zone : zones) {
+        origin = std::min(origin, zone.start_ns);
+    }
+
+    // Complete ("X") events with times in microseconds from the oldest zone
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t i = 0; i < thread_names.size(); ++i) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":";
+        WriteJsonString(out, thread_names[i]);
+        out << "}}";
+    }
+    char times[64];
+    for (const ProfileZoneRecord& zone : zones) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":";
+        WriteJsonString(out, zone.name ? zone.name : "");
+        std::snprintf(times, sizeof(times), "%.3f,\"dur\":%.3f", static_cast<double>(zone.start_ns - origin) / 1000.0,
+                      static_cast<double>(zone.end_ns - zone.start_ns) / 1000.0);
+        out << ",\"cat\":\"gui\",\"ph\":\"X\",\"ts\":" << times << ",\"pid\":1,\"tid\":" << zone.thread_index << "}";
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+bool FrameProfiler::ExportChromeTrace(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    return WriteChromeTrace(out);
+}
+
+void FrameProfiler::Clear() {
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& buffer : registry.buffers) {
+            // Zones already in the ring stay readable; Clear() only hides them
+            buffer->frame_cursor = buffer->written.load(std::memory_order_acquire);
+        }
+    }
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->last_frame = ProfileFrame{};
+    impl_->frame_time_count = 0;
+    impl_->frame_time_head = 0;
+}
+
+void FrameProfiler::DrawPanel(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(720.0f, 420.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Frame Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+
+#if !GUI_PROFILER_ENABLED
+    ImGui::TextUnformatted("Profiling zones were compiled out (GUI_ENABLE_PROFILER=OFF).");
+    ImGui::End();
+    return;
+#else
+    bool enabled = IsEnabled();
+    if (ImGui::Checkbox("Record", &enabled)) {
+        SetEnabled(enabled);
+    }
+    ImGui::SameLine();
+    bool paused = IsPaused();
+    if (ImGui::Checkbox("Pause", &paused)) {
+        SetPaused(paused);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear")) {
+        Clear();
+    }
+
+    ImGui::SetNextItemWidth(260.0f);
+    ImGui::InputText("##export_path", impl_->export_path.data(), impl_->export_path.size());
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace")) {
+        const std::string path = impl_->export_path.data();
+        impl_->export_status = ExportChromeTrace(path) ? "Wrote " + path : "Could not write " + path;
+    }
+    if (!impl_->export_status.empty()) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", impl_->export_status.c_str());
+    }
+
+    const std::vector<float> frame_times = GetFrameTimes();
+    const ProfileFrame frame = GetLastFrame();
+    const double frame_ms = static_cast<double>(frame.end_ns - frame.start_ns) / 1.0e6;
+    ImGui::Text("Frame %" PRIu64 ": %.2f ms, %zu zones", frame.index, frame_ms, frame.zones.size());
+    if (!frame_times.empty()) {
+        const float max_time = *std::max_element(frame_times.begin(), frame_times.end());
+        ImGui::PlotLines("##frame_times", frame_times.data(), static_cast<int>(frame_times.size()), 0, nullptr, 0.0f,
+                         std::max(max_time, 1.0f), ImVec2(-1.0f, 60.0f));
+    }
+    ImGui::Separator();
+
+    // Timeline: one band per thread, one row per zone depth
+    std::vector<uint32_t> thread_depths;
+    for (const ProfileZoneRecord& zone : frame.zones) {
+        if (zone.thread_index >= thread_depths.size()) {
+            thread_depths.resize(zone.thread_index + 1, 0);
+        }
+        thread_depths[zone.thread_index] = std::max(thread_depths[zone.thread_index], zone.depth + 1);
+    }
+
+    const float row_height = ImGui::GetTextLineHeight() + 4.0f;
+    const float span = frame.end_ns > frame.start_ns ? static_cast<float>(frame.end_ns - frame.start_ns) : 1.0f;
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+    for (uint32_t thread = 0; thread < thread_depths.size(); ++thread) {
+        if (thread_depths[thread] == 0) {
+            continue;
+        }
+        ImGui::TextDisabled("%s", GetThreadName(thread).c_str());
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        for (const ProfileZoneRecord& zone : frame.zones) {
+            if (zone.thread_index != thread) {
+                continue;
+            }
+            // Zones from other threads may straddle the frame's edges
+            const uint64_t start_ns = std::clamp(zone.start_ns, frame.start_ns, frame.end_ns);
+            const uint64_t end_ns = std::clamp(zone.end_ns, frame.start_ns, frame.end_ns);
+            const float start = static_cast<float>(start_ns - frame.start_ns);
+            const float end = static_cast<float>(end_ns - frame.start_ns);
+            const ImVec2 min(origin.x + start / span * width, origin.y + static_cast<float>(zone.depth) * row_height);
+            const ImVec2 max(std::max(origin.x + end / span * width, min.x + 1.0f), min.y + row_height - 1.0f);
+            draw_list->AddRectFilled(min, max, ZoneColor(zone.name));
+            if (max.x - min.x > 24.0f) {
+                draw_list->PushClipRect(min, max, true);
+                draw_list->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(255, 255, 255, 255), zone.name);
+                draw_list->PopClipRect();
+            }
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s\n%.3f ms", zone.name, static_cast<double>(zone.end_ns - zone.start_ns) / 1.0e6);
+            }
+        }
+        ImGui::Dummy(ImVec2(width, static_cast<float>(thread_depths[thread]) * row_height));
+    }
+    ImGui::Separator();
+
+    // Inclusive totals per zone name; nested zones also count in their parents
+    struct ZoneTotal {
+        const char* name = nullptr;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        int calls = 0;
+    };
+    std::unordered_map<std::string_view, ZoneTotal> totals;
+    for (const ProfileZoneRecord& zone : frame.zones) {
+        ZoneTotal& total = totals[zone.name ? std::string_view(zone.name) : std::string_view()];
+        const uint64_t duration = zone.end_ns - zone.start_ns;
+        total.name = zone.name;
+        total.total_ns += duration;
+        total.max_ns = std::max(total.max_ns, duration);
+        ++total.calls;
+    }
+    std::vector<ZoneTotal> sorted;
+    sorted.reserve(totals.size());
+    for (const auto& entry : totals) {
+        sorted.push_back(entry.second);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const ZoneTotal& a, const ZoneTotal& b) {
+        return a.total_ns > b.total_ns;
+    });
+
+    constexpr ImGuiTableFlags kTableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV;
+    if (ImGui::BeginTable("##zone_totals", 4, kTableFlags)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Total ms");
+        ImGui::TableSetupColumn("Max ms");
+        ImGui::TableHeadersRow();
+        for (const ZoneTotal& total : sorted) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(total.name ? total.name : "");
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", total.calls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<double>(total.total_ns) / 1.0e6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<double>(total.max_ns) / 1.0e6);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+#endif
+}
@@ -0,0 +1,195 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Zones are compiled out unless this is 1. Set through the GUI_ENABLE_PROFILER
+// option in CMake.
+#ifndef GUI_PROFILER_ENABLED
+#define GUI_PROFILER_ENABLED 1
+#endif
+
+#define GUI_PROFILE_CONCAT_INNER(a, b) a##b
+#define GUI_PROFILE_CONCAT(a, b) GUI_PROFILE_CONCAT_INNER(a, b)
+
+#if GUI_PROFILER_ENABLED
+/**
+ * Time the rest of the enclosing scope. name must be a string literal or
+ * otherwise outlive the profiler; only the pointer is stored.
+ */
+#define GUI_PROFILE_ZONE(name) ProfileZone GUI_PROFILE_CONCAT(gui_profile_zone_, __LINE__)(name)
+/**
+ * Mark the start of a frame on the UI thread.
+ */
+#define GUI_PROFILE_FRAME() FrameProfiler::Get().BeginFrame()
+#else
+#define GUI_PROFILE_ZONE(name) ((void)0)
+#define GUI_PROFILE_FRAME() ((void)0)
+#endif
+
+/**
+ * One timed scope, in nanoseconds on FrameProfiler::Now()'s clock.
+ */
+struct ProfileZoneRecord {
+    const char* name = nullptr;
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;
+    uint32_t depth = 0;        // Zones open on the same thread when this one began
+    uint32_t thread_index = 0; // Order in which threads first recorded a zone
+};
+
+/**
+ * The zones that ended between two BeginFrame() calls.
+ */
+struct ProfileFrame {
+    uint64_t index = 0;
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;
+    std::vector<ProfileZoneRecord> zones;
+};
+
+namespace frame_profiler_detail {
+
+inline std::atomic<bool> enabled{false};
+inline thread_local uint32_t zone_depth = 0;
+
+uint64_t Now();
+
+/**
+ * Append a zone to the calling thread's ring buffer. Never blocks once the
+ * thread has recorded its first zone.
+ */
+void Record(const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t depth);
+
+} // namespace frame_profiler_detail
+
+/**
+ * RAII timer behind GUI_PROFILE_ZONE. While the profiler is disabled a zone
+ * costs one relaxed load.
+ */
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) {
+        if (frame_profiler_detail::enabled.load(std::memory_order_relaxed)) {
+            name_ = name;
+            depth_ = frame_profiler_detail::zone_depth++;
+            start_ns_ = frame_profiler_detail::Now();
+        }
+    }
+
+    ~ProfileZone() {
+        if (name_) {
+            const uint64_t end_ns = frame_profiler_detail::Now();
+            --frame_profiler_detail::zone_depth;
+            frame_profiler_detail::Record(name_, start_ns_, end_ns, depth_);
+        }
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name_ = nullptr;
+    uint64_t start_ns_ = 0;
+    uint32_t depth_ = 0;
+};
+
+/**
+ * Collects GUI_PROFILE_ZONE timings from every thread into frames.
+ *
+ * Each thread writes its zones into its own fixed-size ring buffer, so
+ * recording takes no locks and old zones are overwritten rather than
+ * growing memory. BeginFrame(), called by the overlay at the top of each
+ * Render(), gathers the zones that ended since the previous call into the
+ * last frame, which the panel shows until the next one replaces it.
+ *
+ * The profiler starts disabled; showing the overlay's profiler panel enables
+ * it. ExportChromeTrace() writes everything still held in the ring buffers
+ * in the Trace Event format read by chrome://tracing and Perfetto.
+ */
+class FrameProfiler {
+public:
+    static constexpr size_t kZonesPerThread = 8192;
+    static constexpr size_t kFrameHistory = 240;
+
+    static FrameProfiler& Get();
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    void SetEnabled(bool enabled);
+    [[nodiscard]] bool IsEnabled() const { return frame_profiler_detail::enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Keep showing the current last frame; zones are still recorded.
+     */
+    void SetPaused(bool paused);
+    [[nodiscard]] bool IsPaused() const;
+
+    /**
+     * Close the frame begun by the previous call and start a new one.
+     * Call once per frame from the UI thread.
+     */
+    void BeginFrame();
+
+    /**
+     * @return Copy of the last completed frame
+     */
+    [[nodiscard]] ProfileFrame GetLastFrame() const;
+
+    /**
+     * @return Durations of recent frames in milliseconds, oldest first
+     */
+    [[nodiscard]] std::vector<float> GetFrameTimes() const;
+
+    /**
+     * Name the calling thread in the panel and in exported traces.
+     */
+    void SetThreadName(const std::string& name);
+
+    /**
+     * @return Name given to the thread with this index, or "Thread <index>"
+     */
+    [[nodiscard]] std::string GetThreadName(uint32_t thread_index) const;
+
+    /**
+     * Write every zone still held in the ring buffers as Chrome trace JSON.
+     * @return false if the stream failed
+     */
+    bool WriteChromeTrace(std::ostream& out) const;
+    bool ExportChromeTrace(const std::string& path) const;
+
+    /**
+     * Drop recorded zones and frames.
+     */
+    void Clear();
+
+    /**
+     * Draw the profiler window inside the current ImGui frame: a frame time
+     * graph, a timeline of the last frame's zones per thread and depth, and
+     * the frame's zones totalled by name.
+     * @param open Cleared when the window's close button is pressed
+     */
+    void DrawPanel(bool* open);
+
+    /**
+     * @return Nanoseconds on the clock zones are timed with
+     */
+    static uint64_t Now() { return frame_profiler_detail::Now(); }
+
+private:
+    struct Impl;
+
+    FrameProfiler();
+    ~FrameProfiler();
+
+    std::unique_ptr<Impl> impl_;
+};
+
+#endif // FRAME_PROFILER_H
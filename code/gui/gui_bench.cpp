@@ -0,0 +1,588 @@
+// Microbenchmarks for the GUI library's per-frame hot paths.
+//
+// Results are written as JSON in the layout Google Benchmark uses, so the
+// usual compare tooling works on them:
+//
+//   gui_bench [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]
+//             [--benchmark_out=<file>]
+//
+// Without --benchmark_out the JSON goes to stdout; progress goes to stderr.
+// A benchmark added with a budget fails the run (exit status 1) when one
+// iteration takes longer than that on average.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <SDL.h>
+
+#include "imgui.h"
+
+#include "InventoryOverlayState.h"
+#include "InventoryWidget.h"
+#include "bench_fixtures.h"
+#include "data_binding_manager.h"
+#include "debug.h"
+#include "event_bus.h"
+#include "event_bus_adapter.h"
+#include "events.h"
+#include "frame_profiler.h"
+#include "input_manager.h"
+#include "inventory_filter.h"
+#if GUI_BENCH_TOGGLE_MANAGER
+#include "toggle_manager.h"
+#endif
+
+namespace {
+
+// Keeps the optimizer from discarding a benchmark's result
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double real_time_ns = 0.0;
+    double cpu_time_ns = 0.0;
+    // Real time per iteration the benchmark must stay under; 0 for none
+    double budget_ns = 0.0;
+};
+
+// Times the loop of a benchmark body; setup before the first KeepRunning()
+// call and teardown after the last one are not measured:
+//
+//   while (state.KeepRunning()) { ... }
+class BenchmarkState {
+public:
+    explicit BenchmarkState(uint64_t iterations) : iterations_(iterations), remaining_(iterations) {}
+
+    bool KeepRunning() {
+        if (!started_) {
+            started_ = true;
+            cpu_start_ = std::clock();
+            real_start_ = std::chrono::steady_clock::now();
+        }
+        if (remaining_ == 0) {
+            if (!stopped_) {
+                real_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start_).count();
+                cpu_seconds_ = static_cast<double>(std::clock() - cpu_start_) / CLOCKS_PER_SEC;
+                stopped_ = true;
+            }
+            return false;
+        }
+        --remaining_;
+        return true;
+    }
+
+    // Index of the current iteration, counting from zero
+    uint64_t GetIteration() const { return iterations_ - remaining_ - 1; }
+
+    bool IsComplete() const { return stopped_; }
+    double GetRealSeconds() const { return real_seconds_; }
+    double GetCpuSeconds() const { return cpu_seconds_; }
+
+private:
+    uint64_t iterations_;
+    uint64_t remaining_;
+    bool started_ = false;
+    bool stopped_ = false;
+    std::clock_t cpu_start_ = 0;
+    std::chrono::steady_clock::time_point real_start_;
+    double real_seconds_ = 0.0;
+    double cpu_seconds_ = 0.0;
+};
+
+using BenchmarkBody = std::function<void(BenchmarkState& state)>;
+
+struct Benchmark {
+    std::string name;
+    BenchmarkBody body;
+    double budget_ns = 0.0;
+};
+
+class BenchmarkRunner {
+public:
+    void Add(std::string name, BenchmarkBody body, double budget_ns = 0.0) {
+        benchmarks_.push_back(Benchmark{std::move(name), std::move(body), budget_ns});
+    }
+
+    // Grow the iteration count until one batch takes at least min_time seconds
+    std::vector<BenchmarkResult> Run(const std::regex& filter, double min_time) const {
+        std::vector<BenchmarkResult> results;
+        for (const Benchmark& benchmark : benchmarks_) {
+            if (!std::regex_search(benchmark.name, filter)) {
+                continue;
+            }
+
+            uint64_t iterations = 1;
+            BenchmarkResult result;
+            result.name = benchmark.name;
+            result.budget_ns = benchmark.budget_ns;
+            bool skipped = false;
+            for (;;) {
+                BenchmarkState state(iterations);
+                benchmark.body(state);
+                if (!state.IsComplete()) {
+                    // The body bailed out during setup
+                    skipped = true;
+                    break;
+                }
+
+                const double real_seconds = state.GetRealSeconds();
+                if (real_seconds >= min_time || iterations >= kMaxIterations) {
+                    result.iterations = iterations;
+                    result.real_time_ns = real_seconds * 1e9 / static_cast<double>(iterations);
+                    result.cpu_time_ns = state.GetCpuSeconds() * 1e9 / static_cast<double>(iterations);
+                    break;
+                }
+
+                // Aim 40% past the target so the next batch usually suffices
+                const double scale = real_seconds > 0.0 ? (min_time * 1.4) / real_seconds : 10.0;
+                const double next = static_cast<double>(iterations) * std::clamp(scale, 2.0, 10.0);
+                iterations = std::min<uint64_t>(static_cast<uint64_t>(next), kMaxIterations);
+            }
+
+            if (skipped) {
+                std::cerr << result.name << ": skipped\n";
+                continue;
+            }
+            std::cerr << result.name << ": " << result.real_time_ns << " ns (" << result.iterations
+                      << " iterations)\n";
+            results.push_back(result);
+        }
+        return results;
+    }
+
+private:
+    static constexpr uint64_t kMaxIterations = 1000000000;
+
+    std::vector<Benchmark> benchmarks_;
+};
+
+std::string EscapeJson(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped.push_back('\\');
+            escaped.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+            escaped += buffer;
+        } else {
+            escaped.push_back(c);
+        }
+    }
+    return escaped;
+}
+
+void WriteJson(std::ostream& out, const char* executable, const std::vector<BenchmarkResult>& results) {
+    char date[64] = "";
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"executable\": \"" << EscapeJson(executable) << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << EscapeJson(result.name) << "\",\n";
+        out << "      \"run_name\": \"" << EscapeJson(result.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"real_time\": " << result.real_time_ns << ",\n";
+        out << "      \"cpu_time\": " << result.cpu_time_ns << ",\n";
+        out << "      \"time_unit\": \"ns\"\n";
+        out << "    }";
+    }
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+// --- EventBus ----------------------------------------------------------------
+
+void AddEventBusBenchmarks(BenchmarkRunner& runner) {
+    for (int subscribers : {1, 10, 100}) {
+        runner.Add("EventBus/Publish/" + std::to_string(subscribers), [subscribers](BenchmarkState& state) {
+            cataclysm::gui::EventBus bus;
+            uint64_t deliveries = 0;
+            std::vector<cataclysm::gui::EventSubscription> subscriptions;
+            for (int i = 0; i < subscribers; ++i) {
+                subscriptions.push_back(bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+                    [&deliveries](const cataclysm::gui::MapTileHoveredEvent& event) {
+                        deliveries += static_cast<uint64_t>(event.getX());
+                    }));
+            }
+
+            const cataclysm::gui::MapTileHoveredEvent event(1, 2);
+            while (state.KeepRunning()) {
+                bus.publish(event);
+            }
+            DoNotOptimize(deliveries);
+        });
+    }
+
+    // Subscribing and unsubscribing while other subscribers stay registered,
+    // as widgets do when they open and close
+    runner.Add("EventBus/SubscribeUnsubscribe", [](BenchmarkState& state) {
+        cataclysm::gui::EventBus bus;
+        std::vector<cataclysm::gui::EventSubscription> resident;
+        for (int i = 0; i < 100; ++i) {
+            resident.push_back(bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+                [](const cataclysm::gui::MapTileHoveredEvent&) {}));
+        }
+
+        while (state.KeepRunning()) {
+            cataclysm::gui::EventSubscription subscription = bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+                [](const cataclysm::gui::MapTileHoveredEvent&) {});
+            subscription.unsubscribe();
+        }
+    });
+}
+
+// --- FrameProfiler -----------------------------------------------------------
+
+void AddFrameProfilerBenchmarks(BenchmarkRunner& runner) {
+    for (bool enabled : {false, true}) {
+        const std::string name = std::string("FrameProfiler/Zone/") + (enabled ? "Enabled" : "Disabled");
+        runner.Add(name, [enabled](BenchmarkState& state) {
+            FrameProfiler& profiler = FrameProfiler::Get();
+            profiler.SetEnabled(enabled);
+            while (state.KeepRunning()) {
+                GUI_PROFILE_ZONE("bench.zone");
+            }
+            profiler.SetEnabled(false);
+            profiler.Clear();
+        });
+    }
+}
+
+// --- InputManager ------------------------------------------------------------
+
+void AddInputManagerBenchmarks(BenchmarkRunner& runner) {
+    for (int handlers : {1, 10, 100}) {
+        runner.Add("InputManager/ProcessEvent/" + std::to_string(handlers), [handlers](BenchmarkState& state) {
+            BN::GUI::InputManager::InputSettings settings;
+            settings.pass_through_enabled = true;
+            settings.prevent_game_input_when_gui_focused = true;
+
+            BN::GUI::InputManager manager(settings);
+            if (!manager.Initialize()) {
+                return;
+            }
+            manager.SetGUIAreaBounds(0, 0, 256, 256);
+            manager.SetFocusState(BN::GUI::InputManager::FocusState::GUI, "bench");
+
+            // Handlers decline the event so every one of them is visited
+            uint64_t calls = 0;
+            for (int i = 0; i < handlers; ++i) {
+                manager.RegisterHandler(
+                    BN::GUI::InputManager::EventType::KEYBOARD_PRESS,
+                    [&calls](const BN::GUI::GUIEvent&) {
+                        ++calls;
+                        return false;
+                    },
+                    BN::GUI::InputManager::Priority::NORMAL);
+            }
+
+            SDL_Event key_down{};
+            key_down.type = SDL_KEYDOWN;
+            key_down.key.type = SDL_KEYDOWN;
+            key_down.key.state = SDL_PRESSED;
+            key_down.key.keysym.sym = SDLK_a;
+            key_down.key.keysym.scancode = SDL_SCANCODE_A;
+            key_down.key.keysym.mod = KMOD_NONE;
+
+            while (state.KeepRunning()) {
+                DoNotOptimize(manager.ProcessEvent(key_down));
+            }
+            DoNotOptimize(calls);
+        });
+    }
+}
+
+// --- DataBindingManager ------------------------------------------------------
+
+void AddDataBindingBenchmarks(BenchmarkRunner& runner) {
+    for (int bindings : {10, 100, 1000}) {
+        const std::string name = "DataBindingManager/UpdateDirtyBindings/" + std::to_string(bindings);
+        runner.Add(name, [bindings](BenchmarkState& state) {
+            cataclysm::gui::EventBus bus;
+            cataclysm::gui::EventBusAdapter adapter(bus);
+            cataclysm::gui::DataBindingManager manager(adapter);
+            manager.setUpdateRateLimit(0);
+            manager.initialize();
+
+            int value = 0;
+            uint64_t updates = 0;
+            std::vector<std::shared_ptr<cataclysm::gui::IDataSource>> sources;
+            for (int i = 0; i < bindings; ++i) {
+                auto source = cataclysm::gui::DataSourceBuilder::create<int>(
+                    "source_" + std::to_string(i), std::function<int()>([&value]() { return value; }));
+                manager.createBinding<int>("binding_" + std::to_string(i), source,
+                                           [&updates](const int&) { ++updates; });
+                sources.push_back(std::move(source));
+            }
+            manager.updateDirtyBindings();
+
+            // Every source changes each frame, the worst case for a refresh
+            while (state.KeepRunning()) {
+                ++value;
+                for (const auto& source : sources) {
+                    source->markChanged();
+                }
+                manager.updateDirtyBindings();
+            }
+            DoNotOptimize(updates);
+            manager.shutdown();
+        });
+    }
+}
+
+// --- InventoryWidget ---------------------------------------------------------
+
+void AddInventoryWidgetBenchmarks(BenchmarkRunner& runner) {
+    for (int entries : {10, 500, 5000}) {
+        runner.Add("InventoryWidget/Draw/" + std::to_string(entries), [entries](BenchmarkState& state) {
+            ImGuiContext* context = ImGui::CreateContext();
+            ImGuiIO& io = ImGui::GetIO();
+            io.IniFilename = nullptr;
+            io.DisplaySize = ImVec2(1024.0f, 768.0f);
+            io.DeltaTime = 1.0f / 60.0f;
+            io.Fonts->AddFontDefault();
+            io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+            unsigned char* font_pixels = nullptr;
+            int font_width = 0;
+            int font_height = 0;
+            io.Fonts->GetTexDataAsRGBA32(&font_pixels, &font_width, &font_height);
+
+            {
+                cataclysm::gui::EventBus bus;
+                cataclysm::gui::EventBusAdapter adapter(bus);
+                adapter.initialize();
+                InventoryWidget widget(adapter);
+                const inventory_overlay_state inventory = bench_fixtures::BuildInventoryState(entries);
+
+                auto draw_frame = [&]() {
+                    ImGui::NewFrame();
+                    ImGui::SetNextWindowPos(ImVec2(20.0f, 20.0f), ImGuiCond_Always);
+                    ImGui::SetNextWindowSize(ImVec2(900.0f, 700.0f), ImGuiCond_Always);
+                    widget.Draw(inventory);
+                    ImGui::Render();
+                    adapter.flush();
+                };
+
+                // The first frames create windows and lay out child regions
+                draw_frame();
+                draw_frame();
+                while (state.KeepRunning()) {
+                    draw_frame();
+                }
+                DoNotOptimize(ImGui::GetDrawData()->TotalVtxCount);
+                adapter.shutdown();
+            }
+            ImGui::DestroyContext(context);
+        });
+    }
+}
+
+// --- InventoryFilter ---------------------------------------------------------
+
+void AddInventoryFilterBenchmarks(BenchmarkRunner& runner) {
+    // One keystroke of a query typed into a large loot pile; it has to fit
+    // well within a frame
+    runner.Add(
+        "InventoryFilter/Keystroke/2000",
+        [](BenchmarkState& state) {
+            static const char* const kWords[] = {"bottle", "water", "rag", "nail", "pipe", "canned",
+                                                 "beans", "plank", "steel", "wire", "battery", "jacket",
+                                                 "boots", "scrap", "glass"};
+            inventory_overlay_state pile{};
+            for (int i = 0; i < 2000; ++i) {
+                std::string label = kWords[i % 15];
+                label += ' ';
+                label += kWords[(i * 7 + 3) % 15];
+                label += " #" + std::to_string(i);
+                pile.columns[1].entries.push_back({label, "", false, false, false, false, false, ""});
+            }
+            InventoryFilter filter;
+            filter.Index(pile);
+
+            // Wrapping back to one character costs a full search, like a new query
+            const std::string typed = "steel glass #1";
+            size_t matches = 0;
+            while (state.KeepRunning()) {
+                const size_t length = state.GetIteration() % typed.size() + 1;
+                matches += filter.Apply(std::string_view(typed).substr(0, length))->size();
+            }
+            DoNotOptimize(matches);
+        },
+        1e6);
+}
+
+// --- ToggleManager -----------------------------------------------------------
+
+#if GUI_BENCH_TOGGLE_MANAGER
+void AddToggleManagerBenchmarks(BenchmarkRunner& runner) {
+    using CataclysmBN::GUI::ToggleManager;
+
+    runner.Add("ToggleManager/IsVisibleById", [](BenchmarkState& state) {
+        ToggleManager& manager = ToggleManager::getInstance();
+        const std::vector<std::string> ids = manager.getAllComponentIds();
+        if (ids.empty()) {
+            return;
+        }
+        size_t visible = 0;
+        while (state.KeepRunning()) {
+            visible += manager.isComponentVisible(ids[state.GetIteration() % ids.size()]) ? 1 : 0;
+        }
+        DoNotOptimize(visible);
+    });
+
+    runner.Add("ToggleManager/IsVisibleByHandle", [](BenchmarkState& state) {
+        ToggleManager& manager = ToggleManager::getInstance();
+        std::vector<ToggleManager::ComponentHandle> handles;
+        for (const std::string& id : manager.getAllComponentIds()) {
+            handles.push_back(manager.getComponentHandle(id));
+        }
+        if (handles.empty()) {
+            return;
+        }
+        size_t visible = 0;
+        while (state.KeepRunning()) {
+            visible += manager.isComponentVisible(handles[state.GetIteration() % handles.size()]) ? 1 : 0;
+        }
+        DoNotOptimize(visible);
+    });
+
+    runner.Add("ToggleManager/GetComponentHandle", [](BenchmarkState& state) {
+        ToggleManager& manager = ToggleManager::getInstance();
+        const std::vector<std::string> ids = manager.getAllComponentIds();
+        if (ids.empty()) {
+            return;
+        }
+        while (state.KeepRunning()) {
+            DoNotOptimize(manager.getComponentHandle(ids[state.GetIteration() % ids.size()]));
+        }
+    });
+}
+#endif
+
+bool ParseFlag(const std::string& argument, const std::string& flag, std::string* value) {
+    const std::string prefix = "--" + flag + "=";
+    if (argument.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    *value = argument.substr(prefix.size());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter = ".";
+    std::string output_path;
+    double min_time = 0.5;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        std::string value;
+        if (ParseFlag(argument, "benchmark_filter", &value)) {
+            filter = value;
+        } else if (ParseFlag(argument, "benchmark_out", &value)) {
+            output_path = value;
+        } else if (ParseFlag(argument, "benchmark_min_time", &value)) {
+            min_time = std::max(std::atof(value.c_str()), 0.0);
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]"
+                         " [--benchmark_out=<file>]\n";
+            return 1;
+        }
+    }
+
+    std::regex filter_regex;
+    try {
+        filter_regex = std::regex(filter);
+    } catch (const std::regex_error& error) {
+        std::cerr << "invalid --benchmark_filter: " << error.what() << "\n";
+        return 1;
+    }
+
+    // InputManager reads the mouse state; the dummy driver needs no display
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "SDL_InitSubSystem(SDL_INIT_VIDEO) failed: " << SDL_GetError() << "\n";
+        return 1;
+    }
+
+    // Managers log their setup at Info level on every batch
+    setDebugLogLevel(DebugLevel::Warning);
+
+    BenchmarkRunner runner;
+    AddEventBusBenchmarks(runner);
+    AddFrameProfilerBenchmarks(runner);
+    AddInputManagerBenchmarks(runner);
+    AddDataBindingBenchmarks(runner);
+    AddInventoryWidgetBenchmarks(runner);
+    AddInventoryFilterBenchmarks(runner);
+#if GUI_BENCH_TOGGLE_MANAGER
+    AddToggleManagerBenchmarks(runner);
+#endif
+
+    const std::vector<BenchmarkResult> results = runner.Run(filter_regex, min_time);
+
+    int status = 0;
+    for (const BenchmarkResult& result : results) {
+        if (result.budget_ns > 0.0 && result.real_time_ns > result.budget_ns) {
+            std::cerr << result.name << ": over budget (" << result.real_time_ns << " ns > " << result.budget_ns
+                      << " ns)\n";
+            status = 1;
+        }
+    }
+
+    if (output_path.empty()) {
+        WriteJson(std::cout, argv[0], results);
+    } else {
+        std::ofstream out(output_path);
+        WriteJson(out, argv[0], results);
+        if (!out) {
+            std::cerr << "failed to write " << output_path << "\n";
+            status = 1;
+        }
+    }
+
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+    return status;
+}
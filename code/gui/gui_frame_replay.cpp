@@ -0,0 +1,829 @@
+// Headless end-to-end frame timing for OverlayManager.
+//
+// Creates the overlay against a hidden window and a software SDL_Renderer on
+// the dummy video driver, replays a trace of SDL events and state updates,
+// and reports frame-time percentiles, heap allocations per frame and ImGui
+// draw calls per frame as JSON.
+//
+//   gui_frame_replay [--trace=<file>] [--loops=<n>] [--warmup=<frames>]
+//                    [--skip-idle] [--out=<file>] [--budget-p99-ms=<ms>]
+//
+// Without --trace the built-in trace below is replayed. With --budget-p99-ms
+// the exit status is 2 when the p99 frame time is over budget.
+//
+// Trace format, one command per line; '#' starts a comment:
+//
+//   frame [count]                        Render count frames (default 1)
+//   key down|up <key name>               Key event, SDL key names ("Down", "Return", "a")
+//   text <characters>                    SDL_TEXTINPUT event
+//   mouse_move <x> <y>                   Absolute mouse motion
+//   mouse_move_by <dx> <dy>              Motion relative to the last position
+//   mouse_button down|up [left|middle|right]
+//   wheel <dx> <dy>
+//   focus on|off
+//   resize <width> <height>
+//   inventory <entries> [selected_row]   UpdateInventory with a generated state
+//   filter [text]                        SetInventoryFilter; no text clears it
+//   character <tabs> <rows> [active_tab] UpdateCharacter with a generated state
+//   map <width> <height> <tiles_w> <tiles_h>
+//                                        UpdateMapTexture with a fresh texture
+//   show|hide inventory|character
+//   repeat <count> ... end               Repeat the enclosed commands
+//
+// Events are handed to OverlayManager::HandleEvent as they are replayed. A
+// frame's time and allocations cover everything replayed since the previous
+// frame plus Render() and the present; generated states are built up front so
+// only the overlay's own work is measured.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+
+#include "imgui.h"
+
+#include "CharacterOverlayState.h"
+#include "InventoryOverlayState.h"
+#include "bench_fixtures.h"
+#include "debug.h"
+#include "overlay_manager.h"
+
+// Counts heap allocations while a frame is being replayed
+static std::atomic<bool> g_count_allocations{false};
+static std::atomic<size_t> g_allocation_count{0};
+
+static void* CountedAllocate(std::size_t size) {
+    if (g_count_allocations.load(std::memory_order_relaxed)) {
+        g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return CountedAllocate(size); }
+void* operator new[](std::size_t size) { return CountedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+constexpr int kWindowWidth = 1280;
+constexpr int kWindowHeight = 720;
+
+// Guards against a typo like "repeat 1000000" nesting into billions of steps
+constexpr size_t kMaxSteps = 10000000;
+
+// Browses the overlay the way the UI tests do: open it over a map, walk and
+// scroll the inventory, filter it, hover the map and page through the
+// character sheet, with a state update every few frames as the game sends.
+constexpr const char* kDefaultTrace = R"(
+map 480 480 24 24
+inventory 600
+character 6 40
+show inventory
+show character
+focus on
+frame 10
+
+# Walk the active inventory column
+repeat 40
+    key down Down
+    key up Down
+    inventory 600 4
+    frame
+end
+key down Right
+key up Right
+frame 2
+
+# Scroll the inventory
+mouse_move 700 300
+repeat 30
+    wheel 0 -1
+    frame
+end
+
+# Type a filter, then clear it
+repeat 3
+    text s
+    filter s
+    frame
+    text t
+    filter st
+    frame
+    text e
+    filter ste
+    frame
+    filter
+    frame
+end
+
+# Hover across the map
+mouse_move 40 40
+repeat 60
+    mouse_move_by 6 5
+    frame
+end
+
+# Page through the character tabs
+repeat 12
+    key down Tab
+    key up Tab
+    character 6 40 1
+    frame 2
+end
+
+# Idle frames with the overlay on screen
+frame 60
+)";
+
+struct ReplayStep {
+    enum class Op { Event, Frame, Inventory, Filter, Character, Map, Show, Hide, Focus, Resize };
+
+    Op op = Op::Frame;
+    SDL_Event event{};
+    int count = 1;
+    int width = 0;
+    int height = 0;
+    int tiles_w = 0;
+    int tiles_h = 0;
+    std::string text;
+    // Built while parsing so replay measures only the overlay's work
+    std::shared_ptr<const inventory_overlay_state> inventory;
+    std::shared_ptr<const character_overlay_state> character;
+    // Created once the renderer exists; owned by the replayer
+    SDL_Texture* texture = nullptr;
+};
+
+struct ParseError {
+    int line = 0;
+    std::string message;
+};
+
+bool ParseInt(const std::string& token, int* value) {
+    char* end = nullptr;
+    const long parsed = std::strtol(token.c_str(), &end, 10);
+    if (token.empty() || *end != '\0') {
+        return false;
+    }
+    *value = static_cast<int>(parsed);
+    return true;
+}
+
+// Parses a trace into a flat list of steps with repeat blocks unrolled
+class TraceParser {
+public:
+    bool Parse(std::istream& in, std::vector<ReplayStep>* steps, ParseError* error) {
+        // Each open repeat block collects its steps until the matching end
+        struct Block {
+            int count = 1;
+            int line = 0;
+            std::vector<ReplayStep> steps;
+        };
+        std::vector<Block> blocks(1);
+
+        std::string line;
+        int line_number = 0;
+        while (std::getline(in, line)) {
+            ++line_number;
+            error->line = line_number;
+            const size_t comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+            std::istringstream tokens(line);
+            std::vector<std::string> args;
+            for (std::string token; tokens >> token;) {
+                args.push_back(token);
+            }
+            if (args.empty()) {
+                continue;
+            }
+
+            const std::string command = args.front();
+            args.erase(args.begin());
+            if (command == "repeat") {
+                Block block;
+                block.line = line_number;
+                if (args.size() != 1 || !ParseInt(args[0], &block.count) || block.count < 0) {
+                    error->message = "repeat takes a non-negative count";
+                    return false;
+                }
+                blocks.push_back(std::move(block));
+                continue;
+            }
+            if (command == "end") {
+                if (blocks.size() == 1) {
+                    error->message = "end without repeat";
+                    return false;
+                }
+                Block block = std::move(blocks.back());
+                blocks.pop_back();
+                std::vector<ReplayStep>& outer = blocks.back().steps;
+                if (outer.size() + block.steps.size() * static_cast<size_t>(block.count) > kMaxSteps) {
+                    error->message = "trace expands to too many steps";
+                    return false;
+                }
+                for (int i = 0; i < block.count; ++i) {
+                    outer.insert(outer.end(), block.steps.begin(), block.steps.end());
+                }
+                continue;
+            }
+
+            ReplayStep step;
+            if (command == "text") {
+                // Keep the rest of the line, spaces included
+                const size_t start = line.find("text") + 4;
+                const size_t first = line.find_first_not_of(" \t", start);
+                const size_t last = line.find_last_not_of(" \t\r");
+                step.text = first == std::string::npos ? std::string() : line.substr(first, last - first + 1);
+                args.clear();
+            }
+            if (!ParseCommand(command, args, &step, &error->message)) {
+                return false;
+            }
+            blocks.back().steps.push_back(std::move(step));
+        }
+
+        if (blocks.size() != 1) {
+            error->line = blocks.back().line;
+            error->message = "repeat without end";
+            return false;
+        }
+        *steps = std::move(blocks.front().steps);
+        return true;
+    }
+
+private:
+    bool ParseCommand(const std::string& command,
+                      const std::vector<std::string>& args,
+                      ReplayStep* step,
+                      std::string* error) {
+        auto fail = [error](const std::string& message) {
+            *error = message;
+            return false;
+        };
+
+        if (command == "frame") {
+            step->op = ReplayStep::Op::Frame;
+            if (args.size() > 1 || (args.size() == 1 && (!ParseInt(args[0], &step->count) || step->count < 0))) {
+                return fail("frame takes an optional non-negative count");
+            }
+            return true;
+        }
+        if (command == "key") {
+            if (args.size() != 2 || (args[0] != "down" && args[0] != "up")) {
+                return fail("key takes down|up and a key name");
+            }
+            const SDL_Keycode key = SDL_GetKeyFromName(args[1].c_str());
+            if (key == SDLK_UNKNOWN) {
+                return fail("unknown key name '" + args[1] + "'");
+            }
+            const bool down = args[0] == "down";
+            step->op = ReplayStep::Op::Event;
+            step->event.type = down ? SDL_KEYDOWN : SDL_KEYUP;
+            step->event.key.type = step->event.type;
+            step->event.key.state = down ? SDL_PRESSED : SDL_RELEASED;
+            step->event.key.repeat = 0;
+            step->event.key.keysym.sym = key;
+            step->event.key.keysym.scancode = SDL_GetScancodeFromKey(key);
+            step->event.key.keysym.mod = KMOD_NONE;
+            return true;
+        }
+        if (command == "text") {
+            if (step->text.empty() || step->text.size() >= sizeof(step->event.text.text)) {
+                return fail("text takes 1 to 31 bytes of text");
+            }
+            step->op = ReplayStep::Op::Event;
+            step->event.type = SDL_TEXTINPUT;
+            step->event.text.type = SDL_TEXTINPUT;
+            std::memcpy(step->event.text.text, step->text.c_str(), step->text.size() + 1);
+            return true;
+        }
+        if (command == "mouse_move" || command == "mouse_move_by") {
+            int x = 0;
+            int y = 0;
+            if (args.size() != 2 || !ParseInt(args[0], &x) || !ParseInt(args[1], &y)) {
+                return fail(command + " takes two integers");
+            }
+            const bool relative = command == "mouse_move_by";
+            if (!relative) {
+                mouse_x_ = x;
+                mouse_y_ = y;
+            } else {
+                mouse_x_ += x;
+                mouse_y_ += y;
+            }
+            step->op = ReplayStep::Op::Event;
+            step->event.type = SDL_MOUSEMOTION;
+            step->event.motion.type = SDL_MOUSEMOTION;
+            step->event.motion.x = mouse_x_;
+            step->event.motion.y = mouse_y_;
+            step->event.motion.xrel = relative ? x : 0;
+            step->event.motion.yrel = relative ? y : 0;
+            step->event.motion.state = mouse_buttons_;
+            return true;
+        }
+        if (command == "mouse_button") {
+            if (args.empty() || args.size() > 2 || (args[0] != "down" && args[0] != "up")) {
+                return fail("mouse_button takes down|up and an optional button");
+            }
+            Uint8 button = SDL_BUTTON_LEFT;
+            if (args.size() == 2) {
+                if (args[1] == "middle") {
+                    button = SDL_BUTTON_MIDDLE;
+                } else if (args[1] == "right") {
+                    button = SDL_BUTTON_RIGHT;
+                } else if (args[1] != "left") {
+                    return fail("unknown mouse button '" + args[1] + "'");
+                }
+            }
+            const bool down = args[0] == "down";
+            if (down) {
+                mouse_buttons_ |= SDL_BUTTON(button);
+            } else {
+                mouse_buttons_ &= ~SDL_BUTTON(button);
+            }
+            step->op = ReplayStep::Op::Event;
+            step->event.type = down ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+            step->event.button.type = step->event.type;
+            step->event.button.button = button;
+            step->event.button.state = down ? SDL_PRESSED : SDL_RELEASED;
+            step->event.button.clicks = 1;
+            step->event.button.x = mouse_x_;
+            step->event.button.y = mouse_y_;
+            return true;
+        }
+        if (command == "wheel") {
+            int dx = 0;
+            int dy = 0;
+            if (args.size() != 2 || !ParseInt(args[0], &dx) || !ParseInt(args[1], &dy)) {
+                return fail("wheel takes two integers");
+            }
+            step->op = ReplayStep::Op::Event;
+            step->event.type = SDL_MOUSEWHEEL;
+            step->event.wheel.type = SDL_MOUSEWHEEL;
+            step->event.wheel.x = dx;
+            step->event.wheel.y = dy;
+            step->event.wheel.direction = SDL_MOUSEWHEEL_NORMAL;
+            return true;
+        }
+        if (command == "focus") {
+            if (args.size() != 1 || (args[0] != "on" && args[0] != "off")) {
+                return fail("focus takes on|off");
+            }
+            step->op = ReplayStep::Op::Focus;
+            step->count = args[0] == "on" ? 1 : 0;
+            return true;
+        }
+        if (command == "resize") {
+            if (args.size() != 2 || !ParseInt(args[0], &step->width) || !ParseInt(args[1], &step->height) ||
+                step->width <= 0 || step->height <= 0) {
+                return fail("resize takes a positive width and height");
+            }
+            step->op = ReplayStep::Op::Resize;
+            return true;
+        }
+        if (command == "inventory") {
+            int entries = 0;
+            int selected_row = 3;
+            if (args.empty() || args.size() > 2 || !ParseInt(args[0], &entries) || entries < 0 ||
+                (args.size() == 2 && !ParseInt(args[1], &selected_row))) {
+                return fail("inventory takes an entry count and an optional selected row");
+            }
+            step->op = ReplayStep::Op::Inventory;
+            step->inventory = std::make_shared<const inventory_overlay_state>(
+                bench_fixtures::BuildInventoryState(entries, selected_row));
+            return true;
+        }
+        if (command == "filter") {
+            step->op = ReplayStep::Op::Filter;
+            for (const std::string& arg : args) {
+                step->text += step->text.empty() ? arg : " " + arg;
+            }
+            return true;
+        }
+        if (command == "character") {
+            int tabs = 0;
+            int rows = 0;
+            int active_tab = 0;
+            if (args.size() < 2 || args.size() > 3 || !ParseInt(args[0], &tabs) || !ParseInt(args[1], &rows) ||
+                tabs < 0 || rows < 0 || (args.size() == 3 && !ParseInt(args[2], &active_tab))) {
+                return fail("character takes tab and row counts and an optional active tab");
+            }
+            step->op = ReplayStep::Op::Character;
+            step->character = std::make_shared<const character_overlay_state>(
+                bench_fixtures::BuildCharacterState(tabs, rows, active_tab));
+            return true;
+        }
+        if (command == "map") {
+            if (args.size() != 4 || !ParseInt(args[0], &step->width) || !ParseInt(args[1], &step->height) ||
+                !ParseInt(args[2], &step->tiles_w) || !ParseInt(args[3], &step->tiles_h) || step->width <= 0 ||
+                step->height <= 0) {
+                return fail("map takes a positive width and height and tile counts");
+            }
+            step->op = ReplayStep::Op::Map;
+            return true;
+        }
+        if (command == "show" || command == "hide") {
+            if (args.size() != 1 || (args[0] != "inventory" && args[0] != "character")) {
+                return fail(command + " takes inventory|character");
+            }
+            step->op = command == "show" ? ReplayStep::Op::Show : ReplayStep::Op::Hide;
+            step->text = args[0];
+            return true;
+        }
+        return fail("unknown command '" + command + "'");
+    }
+
+    int mouse_x_ = 0;
+    int mouse_y_ = 0;
+    Uint32 mouse_buttons_ = 0;
+};
+
+struct FrameSample {
+    double frame_ms = 0.0;
+    double render_ms = 0.0;
+    size_t allocations = 0;
+    int draw_calls = 0;
+    int vertices = 0;
+    bool skipped = false;
+};
+
+class Replayer {
+public:
+    Replayer(SDL_Renderer* renderer, OverlayManager& overlay) : renderer_(renderer), overlay_(overlay) {}
+
+    ~Replayer() {
+        for (SDL_Texture* texture : textures_) {
+            SDL_DestroyTexture(texture);
+        }
+    }
+
+    Replayer(const Replayer&) = delete;
+    Replayer& operator=(const Replayer&) = delete;
+
+    // Create the map textures the steps upload, filled with a checkerboard
+    bool Prepare(std::vector<ReplayStep>& steps) {
+        for (ReplayStep& step : steps) {
+            if (step.op != ReplayStep::Op::Map) {
+                continue;
+            }
+            SDL_Texture* texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                                     step.width, step.height);
+            if (!texture) {
+                std::cerr << "failed to create a " << step.width << "x" << step.height
+                          << " map texture: " << SDL_GetError() << "\n";
+                return false;
+            }
+            std::vector<Uint32> pixels(static_cast<size_t>(step.width) * static_cast<size_t>(step.height));
+            for (int y = 0; y < step.height; ++y) {
+                for (int x = 0; x < step.width; ++x) {
+                    const bool dark = ((x / 20) + (y / 20)) % 2 == 0;
+                    pixels[static_cast<size_t>(y) * step.width + x] = dark ? 0xff203020u : 0xff406040u;
+                }
+            }
+            SDL_UpdateTexture(texture, nullptr, pixels.data(), step.width * 4);
+            textures_.push_back(texture);
+            step.texture = texture;
+        }
+        return true;
+    }
+
+    void Run(const std::vector<ReplayStep>& steps) {
+        BeginFrame();
+        for (const ReplayStep& step : steps) {
+            g_count_allocations.store(true, std::memory_order_relaxed);
+            switch (step.op) {
+                case ReplayStep::Op::Event:
+                    overlay_.HandleEvent(step.event);
+                    break;
+                case ReplayStep::Op::Frame:
+                    for (int i = 0; i < step.count; ++i) {
+                        RenderFrame();
+                    }
+                    break;
+                case ReplayStep::Op::Inventory:
+                    overlay_.UpdateInventory(*step.inventory);
+                    break;
+                case ReplayStep::Op::Filter:
+                    overlay_.SetInventoryFilter(step.text);
+                    break;
+                case ReplayStep::Op::Character:
+                    overlay_.UpdateCharacter(*step.character);
+                    break;
+                case ReplayStep::Op::Map:
+                    overlay_.UpdateMapTexture(step.texture, step.width, step.height, step.tiles_w, step.tiles_h);
+                    break;
+                case ReplayStep::Op::Show:
+                case ReplayStep::Op::Hide:
+                    ShowOrHide(step);
+                    break;
+                case ReplayStep::Op::Focus:
+                    overlay_.SetFocused(step.count != 0);
+                    break;
+                case ReplayStep::Op::Resize:
+                    overlay_.OnWindowResized(step.width, step.height);
+                    break;
+            }
+            g_count_allocations.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    const std::vector<FrameSample>& GetSamples() const { return samples_; }
+
+private:
+    void ShowOrHide(const ReplayStep& step) {
+        const bool show = step.op == ReplayStep::Op::Show;
+        if (step.text == "inventory") {
+            show ? overlay_.ShowInventory() : overlay_.HideInventory();
+        } else {
+            show ? overlay_.ShowCharacter() : overlay_.HideCharacter();
+        }
+    }
+
+    void BeginFrame() {
+        g_allocation_count.store(0, std::memory_order_relaxed);
+        frame_start_ = std::chrono::steady_clock::now();
+    }
+
+    void RenderFrame() {
+        const uint64_t skipped_before = overlay_.GetSkippedFrameCount();
+        SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
+        SDL_RenderClear(renderer_);
+
+        const auto render_start = std::chrono::steady_clock::now();
+        overlay_.Render();
+        SDL_RenderPresent(renderer_);
+        const auto frame_end = std::chrono::steady_clock::now();
+
+        FrameSample sample;
+        sample.frame_ms = std::chrono::duration<double, std::milli>(frame_end - frame_start_).count();
+        sample.render_ms = std::chrono::duration<double, std::milli>(frame_end - render_start).count();
+        sample.allocations = g_allocation_count.load(std::memory_order_relaxed);
+        sample.skipped = overlay_.GetSkippedFrameCount() != skipped_before;
+
+        // A skipped frame re-composites the cached one without drawing ImGui
+        const ImDrawData* draw_data = ImGui::GetCurrentContext() ? ImGui::GetDrawData() : nullptr;
+        if (!sample.skipped && draw_data && draw_data->Valid) {
+            for (int i = 0; i < draw_data->CmdListsCount; ++i) {
+                sample.draw_calls += draw_data->CmdLists[i]->CmdBuffer.Size;
+            }
+            sample.vertices = draw_data->TotalVtxCount;
+        }
+        samples_.push_back(sample);
+
+        BeginFrame();
+    }
+
+    SDL_Renderer* renderer_;
+    OverlayManager& overlay_;
+    std::vector<SDL_Texture*> textures_;
+    std::vector<FrameSample> samples_;
+    std::chrono::steady_clock::time_point frame_start_;
+};
+
+// Nearest-rank percentile of an ascending list
+template <typename T>
+T Percentile(const std::vector<T>& sorted, double percent) {
+    if (sorted.empty()) {
+        return T{};
+    }
+    const double rank = percent / 100.0 * static_cast<double>(sorted.size());
+    const size_t index = rank <= 1.0 ? 0 : static_cast<size_t>(rank + 0.999999) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+template <typename T, typename Fn>
+std::vector<T> SortedField(const std::vector<FrameSample>& samples, Fn field) {
+    std::vector<T> values;
+    values.reserve(samples.size());
+    for (const FrameSample& sample : samples) {
+        values.push_back(field(sample));
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+template <typename T>
+void WriteDistribution(std::ostream& out, const char* name, const std::vector<T>& sorted, bool last = false) {
+    double sum = 0.0;
+    for (const T& value : sorted) {
+        sum += static_cast<double>(value);
+    }
+    const double mean = sorted.empty() ? 0.0 : sum / static_cast<double>(sorted.size());
+    out << "  \"" << name << "\": {";
+    out << "\"mean\": " << mean;
+    out << ", \"p50\": " << Percentile(sorted, 50.0);
+    out << ", \"p95\": " << Percentile(sorted, 95.0);
+    out << ", \"p99\": " << Percentile(sorted, 99.0);
+    out << ", \"max\": " << (sorted.empty() ? T{} : sorted.back());
+    out << (last ? "}\n" : "},\n");
+}
+
+void WriteReport(std::ostream& out, const std::string& trace_name, size_t steps, int loops,
+                 const std::vector<FrameSample>& samples) {
+    size_t skipped = 0;
+    for (const FrameSample& sample : samples) {
+        skipped += sample.skipped ? 1 : 0;
+    }
+
+    out << "{\n";
+    std::string escaped_name;
+    for (char c : trace_name) {
+        if (c == '"' || c == '\\') {
+            escaped_name.push_back('\\');
+        }
+        escaped_name.push_back(c);
+    }
+    out << "  \"trace\": \"" << escaped_name << "\",\n";
+    out << "  \"steps\": " << steps << ",\n";
+    out << "  \"loops\": " << loops << ",\n";
+    out << "  \"frames\": " << samples.size() << ",\n";
+    out << "  \"skipped_frames\": " << skipped << ",\n";
+    WriteDistribution(out, "frame_time_ms", SortedField<double>(samples, [](const FrameSample& s) {
+                          return s.frame_ms;
+                      }));
+    WriteDistribution(out, "render_time_ms", SortedField<double>(samples, [](const FrameSample& s) {
+                          return s.render_ms;
+                      }));
+    WriteDistribution(out, "allocations_per_frame", SortedField<size_t>(samples, [](const FrameSample& s) {
+                          return s.allocations;
+                      }));
+    WriteDistribution(out, "draw_calls_per_frame", SortedField<int>(samples, [](const FrameSample& s) {
+                          return s.draw_calls;
+                      }));
+    WriteDistribution(out, "vertices_per_frame", SortedField<int>(samples, [](const FrameSample& s) {
+                          return s.vertices;
+                      }), true);
+    out << "}\n";
+}
+
+bool ParseFlag(const std::string& argument, const std::string& flag, std::string* value) {
+    const std::string prefix = "--" + flag + "=";
+    if (argument.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    *value = argument.substr(prefix.size());
+    return true;
+}
+
+int PrintUsage(const char* executable) {
+    std::cerr << "usage: " << executable
+              << " [--trace=<file>] [--loops=<n>] [--warmup=<frames>] [--skip-idle]"
+                 " [--out=<file>] [--budget-p99-ms=<ms>]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string trace_path;
+    std::string output_path;
+    int loops = 1;
+    int warmup = 2;
+    bool skip_idle = false;
+    double budget_p99_ms = 0.0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        std::string value;
+        if (ParseFlag(argument, "trace", &value)) {
+            trace_path = value;
+        } else if (ParseFlag(argument, "out", &value)) {
+            output_path = value;
+        } else if (ParseFlag(argument, "loops", &value)) {
+            if (!ParseInt(value, &loops) || loops < 1) {
+                return PrintUsage(argv[0]);
+            }
+        } else if (ParseFlag(argument, "warmup", &value)) {
+            if (!ParseInt(value, &warmup) || warmup < 0) {
+                return PrintUsage(argv[0]);
+            }
+        } else if (ParseFlag(argument, "budget-p99-ms", &value)) {
+            budget_p99_ms = std::atof(value.c_str());
+        } else if (argument == "--skip-idle") {
+            skip_idle = true;
+        } else {
+            return PrintUsage(argv[0]);
+        }
+    }
+
+    // Key names resolve through SDL, so video has to come up before parsing
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "SDL_InitSubSystem(SDL_INIT_VIDEO) failed: " << SDL_GetError() << "\n";
+        return 1;
+    }
+
+    std::vector<ReplayStep> steps;
+    ParseError error;
+    TraceParser parser;
+    bool parsed = false;
+    if (trace_path.empty()) {
+        std::istringstream in(kDefaultTrace);
+        parsed = parser.Parse(in, &steps, &error);
+    } else {
+        std::ifstream in(trace_path);
+        if (!in) {
+            std::cerr << "cannot open trace " << trace_path << "\n";
+            SDL_QuitSubSystem(SDL_INIT_VIDEO);
+            return 1;
+        }
+        parsed = parser.Parse(in, &steps, &error);
+    }
+    if (!parsed) {
+        std::cerr << (trace_path.empty() ? "built-in trace" : trace_path) << ":" << error.line << ": "
+                  << error.message << "\n";
+        SDL_QuitSubSystem(SDL_INIT_VIDEO);
+        return 1;
+    }
+
+    setDebugLogLevel(DebugLevel::Warning);
+
+    SDL_Window* window = SDL_CreateWindow("gui_frame_replay", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                          kWindowWidth, kWindowHeight, SDL_WINDOW_HIDDEN);
+    SDL_Renderer* renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE) : nullptr;
+    if (!renderer) {
+        std::cerr << "failed to create a software renderer: " << SDL_GetError() << "\n";
+        if (window) {
+            SDL_DestroyWindow(window);
+        }
+        SDL_QuitSubSystem(SDL_INIT_VIDEO);
+        return 1;
+    }
+
+    int status = 0;
+    {
+        OverlayManager overlay;
+        OverlayManager::Config config;
+        config.pass_through_input = false;
+        config.skip_idle_frames = skip_idle;
+        if (!overlay.Initialize(window, renderer, config)) {
+            std::cerr << "OverlayManager::Initialize failed: " << overlay.GetLastError() << "\n";
+            status = 1;
+        } else {
+            overlay.Open();
+
+            Replayer replayer(renderer, overlay);
+            if (!replayer.Prepare(steps)) {
+                status = 1;
+            } else {
+                for (int loop = 0; loop < loops; ++loop) {
+                    replayer.Run(steps);
+                }
+
+                // The first frames build fonts and window layout
+                std::vector<FrameSample> samples = replayer.GetSamples();
+                samples.erase(samples.begin(),
+                              samples.begin() + std::min(samples.size(), static_cast<size_t>(warmup)));
+
+                const std::string trace_name = trace_path.empty() ? "built-in" : trace_path;
+                if (output_path.empty()) {
+                    WriteReport(std::cout, trace_name, steps.size(), loops, samples);
+                } else {
+                    std::ofstream out(output_path);
+                    WriteReport(out, trace_name, steps.size(), loops, samples);
+                    if (!out) {
+                        std::cerr << "failed to write " << output_path << "\n";
+                        status = 1;
+                    }
+                }
+
+                const double p99 = Percentile(SortedField<double>(samples, [](const FrameSample& s) {
+                                                  return s.frame_ms;
+                                              }),
+                                              99.0);
+                if (status == 0 && budget_p99_ms > 0.0 && p99 > budget_p99_ms) {
+                    std::cerr << "p99 frame time " << p99 << " ms is over the " << budget_p99_ms
+                              << " ms budget\n";
+                    status = 2;
+                }
+            }
+            overlay.Close();
+        }
+        overlay.Shutdown();
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+    return status;
+}
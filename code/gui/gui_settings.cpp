@@ -1,10 +1,16 @@
 #include "gui_settings.h"
+#include "settings_snapshot.h"
+#include "settings_writer.h"
+#include "toggle_manager.h"
+#include "theme_palette.h"
+#include "debug.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <filesystem>
 #include <stdexcept>
+#include <utility>
 
 namespace CataclysmBN {
 namespace GUI {
@@ -33,7 +39,10 @@ namespace FileOps {
     }
 }
 
-GUISettings::GUISettings() {
+GUISettings::GUISettings()
+    : m_transactionDepth(0)
+    , m_changedInTransaction(false)
+    , m_autoSave(false) {
     setDefaultValues();
     m_configPath = getDefaultConfigPath();
 }
@@ -70,7 +79,7 @@ bool GUISettings::loadFromFile(const std::string& configPath) {
         Json::Value root = loadJSONFromFile(path);
         if (root.isNull()) {
             // File doesn't exist or is invalid, keep defaults
-            std::cout << "GUI settings file not found or invalid, using defaults: " << path << std::endl;
+            debuglog(DebugLevel::Info, "GUI settings file not found or invalid, using defaults: ", path);
             return false;
         }
 
@@ -79,7 +88,7 @@ bool GUISettings::loadFromFile(const std::string& configPath) {
             return false;
         }
 
-        std::cout << "GUI settings loaded successfully from: " << path << std::endl;
+        debuglog(DebugLevel::Info, "GUI settings loaded successfully from: ", path);
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error loading GUI settings: " << e.what() << std::endl;
@@ -106,7 +115,7 @@ bool GUISettings::saveToFile(const std::string& configPath) {
             return false;
         }
 
-        std::cout << "GUI settings saved successfully to: " << path << std::endl;
+        debuglog(DebugLevel::Info, "GUI settings saved successfully to: ", path);
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error saving GUI settings: " << e.what() << std::endl;
@@ -114,8 +123,18 @@ bool GUISettings::saveToFile(const std::string& configPath) {
     }
 }
 
+void GUISettings::saveToFileAsync(const std::string& configPath) {
+    std::string path = configPath.empty() ? m_configPath : configPath;
+    
+    if (path.empty()) {
+        path = getDefaultConfigPath();
+    }
+
+    SettingsWriter::getInstance().schedule(path, serializeToString());
+}
+
 void GUISettings::resetToDefaults() {
-    std::cout << "Resetting GUI settings to defaults" << std::endl;
+    debuglog(DebugLevel::Info, "Resetting GUI settings to defaults");
     setDefaultValues();
     applySettings();
 }
@@ -148,28 +167,191 @@ std::string GUISettings::getDefaultConfigPath() {
     return configDir + "/gui_settings.json";
 }
 
+std::string GUISettings::getDefaultSnapshotPath() {
+    std::string path = getDefaultConfigPath();
+    size_t lastSlash = path.find_last_of("/\\");
+    std::string dir = lastSlash == std::string::npos ? std::string(".") : path.substr(0, lastSlash + 1);
+    return dir + "gui_snapshot.bin";
+}
+
+void GUISettings::writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeInt(static_cast<int>(m_uiDensity));
+    writer.writeInt(static_cast<int>(m_uiTheme));
+    writer.writeInt(m_fontSize);
+    writer.writeString(m_fontFamily);
+    writer.writeInt(m_windowScale);
+    writer.writeInt(m_sidebarWidth);
+    writer.writeInt(m_buttonHeight);
+    writer.writeBool(m_animationsEnabled);
+    writer.writeInt(m_animationSpeed);
+    writer.writeBool(m_highContrast);
+    writer.writeBool(m_reducedMotion);
+}
+
+bool GUISettings::readSnapshot(SnapshotReader& reader) {
+    const int density = reader.readInt();
+    const int theme = reader.readInt();
+    const int fontSize = reader.readInt();
+    std::string fontFamily = reader.readString();
+    const int windowScale = reader.readInt();
+    const int sidebarWidth = reader.readInt();
+    const int buttonHeight = reader.readInt();
+    const bool animationsEnabled = reader.readBool();
+    const int animationSpeed = reader.readInt();
+    const bool highContrast = reader.readBool();
+    const bool reducedMotion = reader.readBool();
+
+    if (!reader.ok() || !isValidUIDensity(density) || !isValidUITheme(theme)) {
+        return false;
+    }
+
+    m_uiDensity = static_cast<UIDensity>(density);
+    m_uiTheme = static_cast<UITheme>(theme);
+    m_fontSize = fontSize;
+    m_fontFamily = std::move(fontFamily);
+    m_windowScale = windowScale;
+    m_sidebarWidth = sidebarWidth;
+    m_buttonHeight = buttonHeight;
+    m_animationsEnabled = animationsEnabled;
+    m_animationSpeed = animationSpeed;
+    m_highContrast = highContrast;
+    m_reducedMotion = reducedMotion;
+    return validateSettings();
+}
+
+bool GUISettings::saveStartupSnapshot(const std::string& snapshotPath, const ToggleManager* toggles,
+                                      const std::string& layoutPath) {
+    SettingsWriter& fileWriter = SettingsWriter::getInstance();
+    SnapshotWriter writer;
+
+    // The JSON written alongside is exactly what the snapshot's source hash covers
+    const std::string settingsPath = m_configPath.empty() ? getDefaultConfigPath() : m_configPath;
+    const std::string settingsJson = serializeToString();
+    uint64_t sourceHash = SettingsSnapshot::combineHashes(0, SettingsSnapshot::hashContents(settingsJson));
+    writer.beginSection(SnapshotSection::Settings);
+    writeSnapshot(writer);
+    writer.endSection();
+    fileWriter.schedule(settingsPath, settingsJson);
+
+    if (toggles) {
+        const std::string togglesPath = toggles->getConfigPath().empty() ? ToggleManager::getDefaultConfigPath()
+                                                                          : toggles->getConfigPath();
+        const std::string togglesJson = toggles->serializeToString();
+        sourceHash = SettingsSnapshot::combineHashes(sourceHash, SettingsSnapshot::hashContents(togglesJson));
+        writer.beginSection(SnapshotSection::Toggles);
+        toggles->writeSnapshot(writer);
+        writer.endSection();
+        fileWriter.schedule(togglesPath, togglesJson);
+    }
+
+    if (!layoutPath.empty()) {
+        // ImGui owns the ini file; the snapshot carries a copy of what is on disk now
+        MappedFile layout;
+        std::string layoutIni;
+        if (layout.open(layoutPath)) {
+            layoutIni.assign(reinterpret_cast<const char*>(layout.data()), layout.size());
+        }
+        sourceHash = SettingsSnapshot::combineHashes(sourceHash, SettingsSnapshot::hashFile(layoutPath));
+        writer.beginSection(SnapshotSection::Layout);
+        writer.writeString(layoutIni);
+        writer.endSection();
+    }
+
+    fileWriter.schedule(snapshotPath.empty() ? getDefaultSnapshotPath() : snapshotPath, writer.finish(sourceHash));
+    return true;
+}
+
+bool GUISettings::loadStartupSnapshot(const std::string& snapshotPath, ToggleManager* toggles,
+                                      const std::string& layoutPath, std::string* layoutIni) {
+    std::vector<std::string> sources;
+    sources.push_back(m_configPath.empty() ? getDefaultConfigPath() : m_configPath);
+    if (toggles) {
+        sources.push_back(toggles->getConfigPath().empty() ? ToggleManager::getDefaultConfigPath()
+                                                           : toggles->getConfigPath());
+    }
+    if (!layoutPath.empty()) {
+        sources.push_back(layoutPath);
+    }
+
+    SettingsSnapshot snapshot;
+    if (!snapshot.open(snapshotPath.empty() ? getDefaultSnapshotPath() : snapshotPath,
+                       SettingsSnapshot::hashSources(sources))) {
+        return false;
+    }
+
+    if (!snapshot.hasSection(SnapshotSection::Settings) ||
+        (toggles && !snapshot.hasSection(SnapshotSection::Toggles)) ||
+        (!layoutPath.empty() && !snapshot.hasSection(SnapshotSection::Layout))) {
+        return false;
+    }
+
+    SnapshotReader settingsReader = snapshot.getSection(SnapshotSection::Settings);
+    if (!readSnapshot(settingsReader)) {
+        debuglog(DebugLevel::Warning, "Settings snapshot has invalid GUI settings, falling back to JSON");
+        return false;
+    }
+
+    if (toggles) {
+        SnapshotReader togglesReader = snapshot.getSection(SnapshotSection::Toggles);
+        if (!toggles->readSnapshot(togglesReader)) {
+            debuglog(DebugLevel::Warning, "Settings snapshot has invalid toggle state, falling back to JSON");
+            return false;
+        }
+    }
+
+    if (!layoutPath.empty() && layoutIni) {
+        SnapshotReader layoutReader = snapshot.getSection(SnapshotSection::Layout);
+        *layoutIni = layoutReader.readString();
+    }
+
+    debuglog(DebugLevel::Info, "GUI settings loaded from snapshot: ", snapshotPath);
+    return true;
+}
+
 void GUISettings::onUISettingsChanged() {
-    std::cout << "UI settings changed, applying changes..." << std::endl;
+    if (m_transactionDepth > 0) {
+        m_changedInTransaction = true;
+        return;
+    }
+
+    debuglog(DebugLevel::Debug, "UI settings changed, applying changes...");
     applySettings();
+
+    if (m_autoSave) {
+        saveToFileAsync();
+    }
+}
+
+void GUISettings::beginTransaction() {
+    ++m_transactionDepth;
+}
+
+void GUISettings::commitTransaction() {
+    if (m_transactionDepth == 0) {
+        debuglog(DebugLevel::Warning, "commitTransaction called without a matching beginTransaction");
+        return;
+    }
+
+    if (--m_transactionDepth == 0 && m_changedInTransaction) {
+        m_changedInTransaction = false;
+        onUISettingsChanged();
+    }
 }
 
 void GUISettings::applySettings() {
     // Apply settings to the UI system
     // This would integrate with the actual Cataclysm-BN UI system
+
+    // Widgets read their colors from the palette; it is only rebuilt here.
+    ThemePalette::Get().Configure(static_cast<PaletteTheme>(m_uiTheme), m_highContrast);
     
     // For demonstration, just output what would be applied
-    std::cout << "Applying GUI settings:" << std::endl;
-    std::cout << "  UI Density: " << static_cast<int>(m_uiDensity) << std::endl;
-    std::cout << "  UI Theme: " << static_cast<int>(m_uiTheme) << std::endl;
-    std::cout << "  Font Size: " << m_fontSize << std::endl;
-    std::cout << "  Font Family: " << m_fontFamily << std::endl;
-    std::cout << "  Window Scale: " << m_windowScale << "%" << std::endl;
-    std::cout << "  Sidebar Width: " << m_sidebarWidth << std::endl;
-    std::cout << "  Button Height: " << m_buttonHeight << std::endl;
-    std::cout << "  Animations: " << (m_animationsEnabled ? "Enabled" : "Disabled") << std::endl;
-    std::cout << "  Animation Speed: " << m_animationSpeed << std::endl;
-    std::cout << "  High Contrast: " << (m_highContrast ? "Enabled" : "Disabled") << std::endl;
-    std::cout << "  Reduced Motion: " << (m_reducedMotion ? "Enabled" : "Disabled") << std::endl;
+    debuglog(DebugLevel::Debug, "Applying GUI settings: density=", static_cast<int>(m_uiDensity),
+             " theme=", static_cast<int>(m_uiTheme), " font=", m_fontFamily, " ", m_fontSize,
+             " scale=", m_windowScale, "% sidebar=", m_sidebarWidth, " button=", m_buttonHeight,
+             " animations=", (m_animationsEnabled ? "on" : "off"), " speed=", m_animationSpeed,
+             " high_contrast=", (m_highContrast ? "on" : "off"),
+             " reduced_motion=", (m_reducedMotion ? "on" : "off"));
 }
 
 Json::Value GUISettings::serialize() const {
@@ -383,18 +565,13 @@ Json::Value GUISettings::loadJSONFromFile(const std::string& filePath) {
 
 bool GUISettings::saveJSONToFile(const Json::Value& json, const std::string& filePath) {
     try {
-        std::ofstream file(filePath);
-        if (!file.is_open()) {
-            return false;
-        }
-        
         Json::StreamWriterBuilder writer;
+        std::ostringstream oss;
         std::unique_ptr<Json::StreamWriter> jsonWriter(writer.newStreamWriter());
-        jsonWriter->write(json, &file);
+        jsonWriter->write(json, &oss);
         jsonWriter->releaseStream();
         
-        file.close();
-        return true;
+        return SettingsWriter::getInstance().write(filePath, oss.str());
     } catch (const std::exception& e) {
         std::cerr << "Error saving JSON file: " << e.what() << std::endl;
         return false;
@@ -12,6 +12,8 @@ namespace GUI {
 
 // Forward declarations
 class ToggleManager;
+class SnapshotWriter;
+class SnapshotReader;
 
 /**
  * GUI Settings class that manages all GUI configuration options
@@ -33,6 +35,8 @@ public:
     // Initialization and management
     bool loadFromFile(const std::string& configPath = "");
     bool saveToFile(const std::string& configPath = "");
+    // Serialize now and hand the write to the background SettingsWriter
+    void saveToFileAsync(const std::string& configPath = "");
     void resetToDefaults();
     void setConfigPath(const std::string& path) { m_configPath = path; }
     std::string getConfigPath() const { return m_configPath; }
@@ -92,6 +96,27 @@ public:
     // Event handling
     void onUISettingsChanged(); // Called when any UI setting changes
 
+    // Batched changes: setters inside a transaction apply once, on the outermost commit
+    void beginTransaction();
+    void commitTransaction();
+    bool inTransaction() const { return m_transactionDepth > 0; }
+
+    class ScopedTransaction {
+    public:
+        explicit ScopedTransaction(GUISettings& settings) : m_settings(settings) { m_settings.beginTransaction(); }
+        ~ScopedTransaction() { m_settings.commitTransaction(); }
+
+        ScopedTransaction(const ScopedTransaction&) = delete;
+        ScopedTransaction& operator=(const ScopedTransaction&) = delete;
+
+    private:
+        GUISettings& m_settings;
+    };
+
+    // Save in the background after every applied change
+    void setAutoSave(bool enabled) { m_autoSave = enabled; }
+    bool getAutoSave() const { return m_autoSave; }
+
     // Serialization
     Json::Value serialize() const;
     bool deserialize(const Json::Value& data);
@@ -101,6 +126,19 @@ public:
     // Default configuration path
     static std::string getDefaultConfigPath();
 
+    // Binary snapshot section holding these settings
+    void writeSnapshot(SnapshotWriter& writer) const;
+    bool readSnapshot(SnapshotReader& reader);
+
+    // Startup snapshot of settings, toggle state and window layout. Saving queues the
+    // JSON sources and the snapshot on the background writer; loading succeeds only if
+    // none of the sources changed since, otherwise load the JSON/ini files as before.
+    bool saveStartupSnapshot(const std::string& snapshotPath, const ToggleManager* toggles,
+                             const std::string& layoutPath);
+    bool loadStartupSnapshot(const std::string& snapshotPath, ToggleManager* toggles,
+                             const std::string& layoutPath, std::string* layoutIni);
+    static std::string getDefaultSnapshotPath();
+
     // Validation
     bool validateSettings() const;
     void applySettings(); // Apply settings to the current UI system
@@ -120,6 +158,11 @@ private:
     bool m_highContrast;
     bool m_reducedMotion;
 
+    // Transaction and autosave state
+    int m_transactionDepth;
+    bool m_changedInTransaction;
+    bool m_autoSave;
+
     // Default values
     void setDefaultValues();
     
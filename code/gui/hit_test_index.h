@@ -0,0 +1,231 @@
+#ifndef HIT_TEST_INDEX_H
+#define HIT_TEST_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "imgui.h"
+
+/**
+ * Inclusive point-in-rect test matching the bounds checks used by the widgets.
+ */
+inline bool RectContains(const ImVec2& min, const ImVec2& max, const ImVec2& point) {
+    return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+}
+
+/**
+ * Hit-test index over the interactive rects a widget lays out each frame.
+ *
+ * Widgets re-record their rects every frame between BeginLayout() and
+ * EndLayout(). Each rect is compared against the one recorded in the same slot
+ * on the previous frame, so the lookup structures are only rebuilt when the
+ * layout actually moves, and then lazily on the next query.
+ *
+ * Positional lookups bucket the rects into horizontal bands one typical rect
+ * tall. Rows of uniform height therefore land in one or two bands each and a
+ * query only tests the handful of rects sharing its band.
+ */
+class HitTestIndex {
+public:
+    static constexpr int kNoSlot = -1;
+
+    /**
+     * Starts recording a new layout. Slots are assigned in Add() order.
+     */
+    void BeginLayout() {
+        next_slot_ = 0;
+    }
+
+    /**
+     * Records the next rect of the layout.
+     * @param min Top-left corner in screen space.
+     * @param max Bottom-right corner in screen space.
+     * @param id Optional key for FindId(); empty rects are not keyed.
+     * @return The slot the rect was stored in.
+     */
+    int Add(const ImVec2& min, const ImVec2& max, std::string_view id = std::string_view()) {
+        const size_t slot = next_slot_++;
+        if (slot == slots_.size()) {
+            slots_.push_back({min, max, std::string(id)});
+            geometry_dirty_ = true;
+            ids_dirty_ = ids_dirty_ || !id.empty();
+            return static_cast<int>(slot);
+        }
+
+        Slot& existing = slots_[slot];
+        if (existing.min.x != min.x || existing.min.y != min.y ||
+            existing.max.x != max.x || existing.max.y != max.y) {
+            existing.min = min;
+            existing.max = max;
+            geometry_dirty_ = true;
+        }
+        // Unchanged ids are compared in place, so keys built per frame need not allocate
+        if (existing.id != id) {
+            existing.id.assign(id.data(), id.size());
+            ids_dirty_ = true;
+        }
+        return static_cast<int>(slot);
+    }
+
+    /**
+     * Finishes the layout, dropping any slots the previous frame had beyond
+     * the ones recorded this frame.
+     */
+    void EndLayout() {
+        if (next_slot_ < slots_.size()) {
+            slots_.resize(next_slot_);
+            geometry_dirty_ = true;
+            ids_dirty_ = true;
+        }
+    }
+
+    /**
+     * Finds the first rect, in recording order, containing a point.
+     * @param point Screen-space position.
+     * @return The matching slot, or kNoSlot.
+     */
+    int Find(const ImVec2& point) const {
+        if (geometry_dirty_) {
+            RebuildBands();
+        }
+        if (band_offsets_.empty() || point.y < origin_y_ || point.y > extent_y_) {
+            return kNoSlot;
+        }
+
+        const size_t band_index = std::min(static_cast<size_t>((point.y - origin_y_) / band_height_),
+                                           band_offsets_.size() - 2);
+        for (uint32_t i = band_offsets_[band_index]; i < band_offsets_[band_index + 1]; ++i) {
+            const uint32_t slot = band_slots_[i];
+            if (RectContains(slots_[slot].min, slots_[slot].max, point)) {
+                return static_cast<int>(slot);
+            }
+        }
+        return kNoSlot;
+    }
+
+    /**
+     * Finds the first rect recorded with a given id.
+     * @param id Key passed to Add().
+     * @return The matching slot, or kNoSlot.
+     */
+    int FindId(const std::string& id) const {
+        if (ids_dirty_) {
+            RebuildIds();
+        }
+        const auto it = slot_by_id_.find(id);
+        return it != slot_by_id_.end() ? it->second : kNoSlot;
+    }
+
+    size_t Size() const {
+        return slots_.size();
+    }
+
+    const ImVec2& Min(int slot) const {
+        return slots_[static_cast<size_t>(slot)].min;
+    }
+
+    const ImVec2& Max(int slot) const {
+        return slots_[static_cast<size_t>(slot)].max;
+    }
+
+    /**
+     * @return How many times the positional lookup has been rebuilt.
+     */
+    uint64_t GetRebuildCount() const {
+        return rebuild_count_;
+    }
+
+private:
+    struct Slot {
+        ImVec2 min;
+        ImVec2 max;
+        std::string id;
+    };
+
+    // Caps the band count so a single tall rect cannot blow up the table.
+    static constexpr size_t kMaxBandsPerSlot = 4;
+
+    void RebuildBands() const {
+        geometry_dirty_ = false;
+        ++rebuild_count_;
+        band_offsets_.clear();
+        band_slots_.clear();
+        if (slots_.empty()) {
+            return;
+        }
+
+        float min_y = slots_.front().min.y;
+        float max_y = slots_.front().max.y;
+        float total_height = 0.0f;
+        for (const Slot& slot : slots_) {
+            min_y = std::min(min_y, slot.min.y);
+            max_y = std::max(max_y, slot.max.y);
+            total_height += std::max(slot.max.y - slot.min.y, 0.0f);
+        }
+
+        const size_t max_bands = slots_.size() * kMaxBandsPerSlot;
+        const float span = std::max(max_y - min_y, 1.0f);
+        origin_y_ = min_y;
+        extent_y_ = max_y;
+        band_height_ = std::max(total_height / static_cast<float>(slots_.size()), 1.0f);
+        band_height_ = std::max(band_height_, span / static_cast<float>(max_bands));
+        const size_t band_count =
+            std::min(static_cast<size_t>(span / band_height_) + 1, max_bands);
+
+        auto band_of = [&](float y) {
+            const size_t band = static_cast<size_t>(std::max((y - origin_y_) / band_height_, 0.0f));
+            return std::min(band, band_count - 1);
+        };
+
+        // Two passes keep the bands in one flat array: count, then fill in
+        // slot order so Find() preserves first-recorded-wins.
+        band_offsets_.assign(band_count + 1, 0);
+        for (const Slot& slot : slots_) {
+            for (size_t band = band_of(slot.min.y); band <= band_of(slot.max.y); ++band) {
+                ++band_offsets_[band + 1];
+            }
+        }
+        for (size_t band = 0; band < band_count; ++band) {
+            band_offsets_[band + 1] += band_offsets_[band];
+        }
+
+        band_slots_.resize(band_offsets_.back());
+        std::vector<uint32_t> cursor(band_offsets_.begin(), band_offsets_.end() - 1);
+        for (size_t index = 0; index < slots_.size(); ++index) {
+            const Slot& slot = slots_[index];
+            for (size_t band = band_of(slot.min.y); band <= band_of(slot.max.y); ++band) {
+                band_slots_[cursor[band]++] = static_cast<uint32_t>(index);
+            }
+        }
+    }
+
+    void RebuildIds() const {
+        ids_dirty_ = false;
+        slot_by_id_.clear();
+        for (size_t index = 0; index < slots_.size(); ++index) {
+            if (!slots_[index].id.empty()) {
+                slot_by_id_.emplace(slots_[index].id, static_cast<int>(index));
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t next_slot_ = 0;
+
+    mutable bool geometry_dirty_ = true;
+    mutable bool ids_dirty_ = true;
+    mutable float origin_y_ = 0.0f;
+    mutable float extent_y_ = 0.0f;
+    mutable float band_height_ = 1.0f;
+    mutable std::vector<uint32_t> band_offsets_;
+    mutable std::vector<uint32_t> band_slots_;
+    mutable std::unordered_map<std::string, int> slot_by_id_;
+    mutable uint64_t rebuild_count_ = 0;
+};
+
+#endif // HIT_TEST_INDEX_H
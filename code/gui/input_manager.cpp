@@ -1,20 +1,33 @@
 #include "input_manager.h"
 #include <algorithm>
+#include <array>
 #include <cassert>
-#include <condition_variable>
-#include <cstring>
 #include <unordered_set>
 #include "debug.h"
+#include "frame_profiler.h"
 
 namespace BN {
 namespace GUI {
 
 namespace {
 
-bool EventsEqual(const SDL_Event& lhs, const SDL_Event& rhs) {
-    return std::memcmp(&lhs, &rhs, sizeof(SDL_Event)) == 0;
+// FNV-1a over the event bytes. Bit 0 is left for the decision and the value is
+// never 0, which marks "no pending decision".
+uint64_t KeyboardEventFingerprint(const SDL_Event& event) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&event);
+    uint64_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < sizeof(SDL_Event); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return (hash & ~uint64_t{1}) | uint64_t{2};
 }
 
+constexpr std::size_t kEventTypeCount = static_cast<std::size_t>(InputManager::EventType::FOCUS_LOST) + 1;
+
+// Context id 0 means "no context" on both handlers and events.
+constexpr uint32_t kNoContextId = 0;
+
 bool IsKeyboardLikeEvent(InputManager::EventType type) {
     using EventType = InputManager::EventType;
     return type == EventType::KEYBOARD_PRESS || type == EventType::KEYBOARD_RELEASE ||
@@ -33,13 +46,51 @@ public:
         EventType type;
         EventHandler handler;
         Priority priority;
-        std::string context;
+        uint32_t context_id;
         bool enabled;
     };
-    
+
+    // Handlers for one event type, highest priority first and in registration
+    // order within a priority. Lists are replaced, never edited in place, so
+    // routing can walk a snapshot while handlers register or unregister.
+    using HandlerList = std::vector<HandlerInfo>;
+    using HandlerListPtr = std::shared_ptr<const HandlerList>;
+
+    HandlerListPtr LoadHandlers(EventType type) const {
+        return std::atomic_load(&handlers_by_type_[static_cast<std::size_t>(type)]);
+    }
+
+    void StoreHandlers(EventType type, HandlerListPtr list) {
+        std::atomic_store(&handlers_by_type_[static_cast<std::size_t>(type)], std::move(list));
+    }
+
+    static bool Accepts(const HandlerInfo& handler_info, const GUIEvent& event) {
+        if (!handler_info.enabled) {
+            return false;
+        }
+        return event.context_id == kNoContextId || handler_info.context_id == kNoContextId ||
+               event.context_id == handler_info.context_id;
+    }
+
+    /**
+     * @return A stable id for a context name; empty names map to kNoContextId.
+     */
+    uint32_t InternContext(const std::string& name) {
+        if (name.empty()) {
+            return kNoContextId;
+        }
+        std::lock_guard<std::mutex> lock(context_ids_mutex_);
+        auto inserted = context_ids_.emplace(name, static_cast<uint32_t>(context_ids_.size() + 1));
+        return inserted.first->second;
+    }
+
     // Member variables
     InputManager* manager_;
-    std::unordered_map<int, HandlerInfo> handlers_;
+    std::array<HandlerListPtr, kEventTypeCount> handlers_by_type_;
+    std::unordered_map<int, EventType> handler_types_;
+    std::mutex context_ids_mutex_;
+    std::unordered_map<std::string, uint32_t> context_ids_;
+    std::atomic<uint32_t> current_context_id_{kNoContextId};
     std::unordered_map<std::string, std::unique_ptr<InputContext>> contexts_;
     std::string current_context_name_;
     std::vector<FocusListener> focus_listeners_;
@@ -57,15 +108,14 @@ public:
     int gui_area_height_ = 0;
     bool gui_area_defined_ = false;
     
-    // Event queue for thread safety
-    std::vector<GUIEvent> event_queue_;
-    std::mutex event_queue_mutex_;
-    std::condition_variable event_queue_cv_;
     std::atomic<bool> processing_events_{false};
+
+    // Motion merged while coalesce_mouse_motion is set, routed by FlushCoalescedInput()
+    SDL_Event pending_motion_{};
+    bool motion_pending_ = false;
     
-    // Statistics
+    // Statistics; relaxed counters, read without synchronising with routing
     Statistics stats_;
-    std::mutex stats_mutex_;
     
     // Methods
     bool ProcessEventInternal(const SDL_Event& event);
@@ -73,8 +123,8 @@ public:
     bool ProcessMouseEventInternal(const SDL_Event& event);
     void RouteEventToHandlers(const GUIEvent& event);
     void UpdateMouseState(const SDL_Event& event);
+    void CoalesceMotion(const SDL_Event& event);
     bool IsMouseInGUIArea(int x, int y) const;
-    void AddEventToQueue(const GUIEvent& event);
 };
 
 InputManager::InputManager() : InputManager(InputSettings{}) {}
@@ -92,8 +142,6 @@ InputManager::~InputManager() {
 }
 
 bool InputManager::Initialize() {
-    std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
-    
     if (initialized_.load()) {
         debuglog(DebugLevel::Warning, "InputManager: Already initialized");
         return true;
@@ -122,22 +170,25 @@ void InputManager::Shutdown() {
     
     debuglog(DebugLevel::Info, "InputManager: Shutting down...");
     
-    // Clear event queue
-    {
-        std::lock_guard<std::mutex> lock(impl_->event_queue_mutex_);
-        impl_->event_queue_.clear();
-    }
-    
+    impl_->motion_pending_ = false;
+
+    pending_keyboard_decision_.store(0, std::memory_order_relaxed);
+
     // Clear handlers and contexts
     {
         std::lock_guard<std::mutex> lock(handlers_mutex_);
-        impl_->handlers_.clear();
+        for (std::size_t type = 0; type < kEventTypeCount; ++type) {
+            impl_->StoreHandlers(static_cast<EventType>(type), nullptr);
+        }
+        impl_->handler_types_.clear();
+        impl_->stats_.active_handlers.store(0, std::memory_order_relaxed);
     }
 
     {
         std::lock_guard<std::mutex> lock(context_mutex_);
         impl_->contexts_.clear();
         impl_->current_context_name_.clear();
+        impl_->current_context_id_.store(kNoContextId, std::memory_order_relaxed);
     }
 
     {
@@ -150,15 +201,26 @@ void InputManager::Shutdown() {
 }
 
 bool InputManager::ProcessEvent(const SDL_Event& event) {
+    GUI_PROFILE_ZONE("InputManager::ProcessEvent");
     if (!initialized_.load() || !enabled_.load()) {
         return false;
     }
     
-    // Update statistics
-    {
-        std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
-        impl_->stats_.events_processed++;
+    impl_->stats_.events_processed.fetch_add(1, std::memory_order_relaxed);
+
+    if (event.type == SDL_MOUSEMOTION && settings_.coalesce_mouse_motion) {
+        const SDL_MouseMotionEvent& pending = impl_->pending_motion_.motion;
+        if (impl_->motion_pending_ &&
+            (pending.windowID != event.motion.windowID || pending.which != event.motion.which)) {
+            FlushCoalescedInput(); // Only merge motion from the same mouse and window
+        }
+        impl_->CoalesceMotion(event);
+        return false;
     }
+
+    // Anything else ends a run of motion; route it first so handlers still see
+    // input in the order it happened.
+    FlushCoalescedInput();
     
     // Process event based on type
     bool consumed = false;
@@ -170,8 +232,7 @@ bool InputManager::ProcessEvent(const SDL_Event& event) {
         consumed = ProcessMouseEvent(event);
     } else if (event.type == SDL_TEXTINPUT) {
         // Handle text input
-        GUIEvent text_event(EventType::TEXT_INPUT, event, Priority::NORMAL);
-        text_event.context = GetActiveContextName();
+        GUIEvent text_event(EventType::TEXT_INPUT, event, Priority::NORMAL, GetActiveContextId());
         if (auto cached = TakePendingSharedFocusKeyboardDecision(text_event)) {
             consumed = *cached;
         } else {
@@ -181,11 +242,9 @@ bool InputManager::ProcessEvent(const SDL_Event& event) {
     
     // Update statistics
     if (consumed) {
-        std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
-        impl_->stats_.events_consumed++;
+        impl_->stats_.events_consumed.fetch_add(1, std::memory_order_relaxed);
     } else if (settings_.pass_through_enabled && current_focus_state_.load() != FocusState::GUI) {
-        std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
-        impl_->stats_.events_passed_through++;
+        impl_->stats_.events_passed_through.fetch_add(1, std::memory_order_relaxed);
     }
     
     return consumed;
@@ -193,8 +252,7 @@ bool InputManager::ProcessEvent(const SDL_Event& event) {
 
 bool InputManager::ProcessKeyboardEvent(const SDL_Event& event) {
     EventType type = (event.type == SDL_KEYDOWN) ? EventType::KEYBOARD_PRESS : EventType::KEYBOARD_RELEASE;
-    GUIEvent gui_event(type, event, DetermineEventPriority(event));
-    gui_event.context = GetActiveContextName();
+    GUIEvent gui_event(type, event, DetermineEventPriority(event), GetActiveContextId());
 
     if (auto cached = TakePendingSharedFocusKeyboardDecision(gui_event)) {
         return *cached;
@@ -206,7 +264,27 @@ bool InputManager::ProcessKeyboardEvent(const SDL_Event& event) {
 bool InputManager::ProcessMouseEvent(const SDL_Event& event) {
     // Update mouse state
     impl_->UpdateMouseState(event);
-    
+    return RouteMouseEvent(event);
+}
+
+bool InputManager::FlushCoalescedInput() {
+    if (!impl_->motion_pending_) {
+        return false;
+    }
+    impl_->motion_pending_ = false;
+    if (!initialized_.load() || !enabled_.load()) {
+        return false;
+    }
+
+    // Mouse state already tracks the run, so only routing is left.
+    const bool consumed = RouteMouseEvent(impl_->pending_motion_);
+    if (consumed) {
+        impl_->stats_.events_consumed.fetch_add(1, std::memory_order_relaxed);
+    }
+    return consumed;
+}
+
+bool InputManager::RouteMouseEvent(const SDL_Event& event) {
     EventType type;
     switch (event.type) {
         case SDL_MOUSEMOTION:
@@ -224,9 +302,14 @@ bool InputManager::ProcessMouseEvent(const SDL_Event& event) {
         default:
             return false;
     }
+
+    // Raw-input fast path: with no handler for this type there is nothing to
+    // route, so skip building the GUIEvent entirely.
+    if (!impl_->LoadHandlers(type)) {
+        return false;
+    }
     
-    GUIEvent gui_event(type, event, DetermineEventPriority(event));
-    gui_event.context = GetActiveContextName();
+    GUIEvent gui_event(type, event, DetermineEventPriority(event), GetActiveContextId());
     return RouteEventToHandlers(gui_event);
 }
 
@@ -278,38 +361,23 @@ bool InputManager::RouteEventToHandlers(const GUIEvent& event) {
 }
 
 bool InputManager::RouteToHandlers(const GUIEvent& event) {
-    std::vector<Impl::HandlerInfo*> handlers_to_call;
-
-    // Collect handlers in priority order
-    {
-        std::lock_guard<std::mutex> lock(handlers_mutex_);
-        for (auto& [id, handler_info] : impl_->handlers_) {
-            if (handler_info.enabled && handler_info.type == event.type && handler_info.priority >= event.priority) {
-                // Check context filter
-                if (!event.context.empty() && !handler_info.context.empty() &&
-                    event.context != handler_info.context) {
-                    continue;
-                }
-                handlers_to_call.push_back(&handler_info);
-            }
-        }
+    // The snapshot keeps the list alive even if a handler unregisters itself.
+    const Impl::HandlerListPtr handlers = impl_->LoadHandlers(event.type);
+    if (!handlers) {
+        return false;
     }
 
-    // Sort by priority (higher first)
-    std::sort(handlers_to_call.begin(), handlers_to_call.end(),
-              [](const Impl::HandlerInfo* a, const Impl::HandlerInfo* b) {
-                  return a->priority > b->priority;
-              });
+    for (const Impl::HandlerInfo& handler_info : *handlers) {
+        if (handler_info.priority < event.priority) {
+            break; // Sorted, so nothing later qualifies either
+        }
+        if (!Impl::Accepts(handler_info, event)) {
+            continue;
+        }
 
-    // Call handlers
-    for (Impl::HandlerInfo* handler_info : handlers_to_call) {
         try {
-            {
-                std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
-                impl_->stats_.handlers_called++;
-            }
-            
-            if (handler_info->handler(event)) {
+            impl_->stats_.handlers_called.fetch_add(1, std::memory_order_relaxed);
+            if (handler_info.handler(event)) {
                 return true; // Event consumed
             }
         } catch (const std::exception& e) {
@@ -321,32 +389,26 @@ bool InputManager::RouteToHandlers(const GUIEvent& event) {
 }
 
 bool InputManager::HasEnabledHandlersForEvent(const GUIEvent& event) const {
-    std::lock_guard<std::mutex> lock(handlers_mutex_);
-
-    for (const auto& [id, handler_info] : impl_->handlers_) {
-        if (!handler_info.enabled) {
-            continue;
-        }
-
-        if (handler_info.type != event.type) {
-            continue;
-        }
+    const Impl::HandlerListPtr handlers = impl_->LoadHandlers(event.type);
+    if (!handlers) {
+        return false;
+    }
 
+    for (const Impl::HandlerInfo& handler_info : *handlers) {
         if (handler_info.priority < event.priority) {
-            continue;
+            break;
         }
-
-        if (!event.context.empty() && !handler_info.context.empty() && event.context != handler_info.context) {
-            continue;
+        if (Impl::Accepts(handler_info, event)) {
+            return true;
         }
-
-        return true;
     }
 
     return false;
 }
 
 int InputManager::RegisterHandler(EventType type, EventHandler handler, Priority priority, const std::string& context) {
+    const uint32_t context_id = impl_->InternContext(context);
+
     std::lock_guard<std::mutex> lock(handlers_mutex_);
 
     int id = next_handler_id_.fetch_add(1);
@@ -354,24 +416,25 @@ int InputManager::RegisterHandler(EventType type, EventHandler handler, Priority
     Impl::HandlerInfo info;
     info.id = id;
     info.type = type;
-    info.handler = handler;
+    info.handler = std::move(handler);
     info.priority = priority;
-    info.context = context;
+    info.context_id = context_id;
     info.enabled = true;
 
-    impl_->handlers_[id] = std::move(info);
-    
-    {
-        std::lock_guard<std::mutex> stats_lock(impl_->stats_mutex_);
-        auto enabled_count = std::count_if(
-            impl_->handlers_.begin(),
-            impl_->handlers_.end(),
-            [](const auto& entry) {
-                return entry.second.enabled;
-            }
-        );
-        impl_->stats_.active_handlers = static_cast<uint32_t>(enabled_count);
-    }
+    // Copy-on-write: routing never sees a list being modified.
+    const Impl::HandlerListPtr current = impl_->LoadHandlers(type);
+    auto updated = current ? std::make_shared<Impl::HandlerList>(*current)
+                           : std::make_shared<Impl::HandlerList>();
+    auto position = std::upper_bound(updated->begin(), updated->end(), priority,
+                                     [](Priority value, const Impl::HandlerInfo& existing) {
+                                         return value > existing.priority;
+                                     });
+    updated->insert(position, std::move(info));
+    impl_->StoreHandlers(type, std::move(updated));
+
+    impl_->handler_types_[id] = type;
+    impl_->stats_.active_handlers.store(static_cast<uint32_t>(impl_->handler_types_.size()),
+                                        std::memory_order_relaxed);
 
     debuglog(DebugLevel::Info, "InputManager: Registered handler ", id, " for type ", static_cast<int>(type));
     return id;
@@ -379,21 +442,29 @@ int InputManager::RegisterHandler(EventType type, EventHandler handler, Priority
 
 void InputManager::UnregisterHandler(int handler_id) {
     std::lock_guard<std::mutex> lock(handlers_mutex_);
-    
-    if (impl_->handlers_.erase(handler_id) > 0) {
-        {
-            std::lock_guard<std::mutex> stats_lock(impl_->stats_mutex_);
-            auto enabled_count = std::count_if(
-                impl_->handlers_.begin(),
-                impl_->handlers_.end(),
-                [](const auto& entry) {
-                    return entry.second.enabled;
-                }
-            );
-            impl_->stats_.active_handlers = static_cast<uint32_t>(enabled_count);
+
+    auto type_it = impl_->handler_types_.find(handler_id);
+    if (type_it == impl_->handler_types_.end()) {
+        return;
+    }
+    const EventType type = type_it->second;
+    impl_->handler_types_.erase(type_it);
+
+    const Impl::HandlerListPtr current = impl_->LoadHandlers(type);
+    if (current) {
+        auto updated = std::make_shared<Impl::HandlerList>();
+        updated->reserve(current->size());
+        for (const Impl::HandlerInfo& handler_info : *current) {
+            if (handler_info.id != handler_id) {
+                updated->push_back(handler_info);
+            }
         }
-        debuglog(DebugLevel::Info, "InputManager: Unregistered handler ", handler_id);
+        impl_->StoreHandlers(type, updated->empty() ? nullptr : Impl::HandlerListPtr(std::move(updated)));
     }
+
+    impl_->stats_.active_handlers.store(static_cast<uint32_t>(impl_->handler_types_.size()),
+                                        std::memory_order_relaxed);
+    debuglog(DebugLevel::Info, "InputManager: Unregistered handler ", handler_id);
 }
 
 void InputManager::SetInputContext(const std::string& context_name, std::unique_ptr<InputContext> context) {
@@ -409,6 +480,7 @@ void InputManager::RemoveInputContext(const std::string& context_name) {
     if (impl_->contexts_.erase(context_name) > 0) {
         if (impl_->current_context_name_ == context_name) {
             impl_->current_context_name_.clear();
+            impl_->current_context_id_.store(kNoContextId, std::memory_order_relaxed);
         }
         debuglog(DebugLevel::Info, "InputManager: Removed input context '", context_name, "'");
     }
@@ -429,19 +501,19 @@ InputContext* InputManager::GetCurrentContext() const {
     return nullptr;
 }
 
-std::string InputManager::GetActiveContextName() const {
-    std::lock_guard<std::mutex> lock(context_mutex_);
-    return impl_->current_context_name_;
+uint32_t InputManager::GetActiveContextId() const {
+    return impl_->current_context_id_.load(std::memory_order_relaxed);
+}
+
+uint32_t InputManager::GetContextId(const std::string& context_name) const {
+    return impl_->InternContext(context_name);
 }
 
 void InputManager::SetFocusState(FocusState focus, const std::string& reason) {
     FocusState previous = current_focus_state_.exchange(focus);
     
     if (previous != focus) {
-        {
-            std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
-            impl_->stats_.focus_changes++;
-        }
+        impl_->stats_.focus_changes.fetch_add(1, std::memory_order_relaxed);
         
         debuglog(DebugLevel::Info, "InputManager: Focus changed from ", static_cast<int>(previous), 
                 " to ", static_cast<int>(focus), " (", reason, ")");
@@ -482,6 +554,9 @@ void InputManager::RemoveFocusListener(int listener_id) {
 }
 
 void InputManager::UpdateSettings(const InputSettings& settings) {
+    if (!settings.coalesce_mouse_motion) {
+        FlushCoalescedInput();
+    }
     settings_ = settings;
     debuglog(DebugLevel::Info, "InputManager: Settings updated");
 }
@@ -491,8 +566,7 @@ bool InputManager::ShouldConsumeEvent(const SDL_Event& event) const {
         return false;
     }
 
-    GUIEvent gui_event(SDLToEventType(event), event, DetermineEventPriority(event));
-    gui_event.context = GetActiveContextName();
+    GUIEvent gui_event(SDLToEventType(event), event, DetermineEventPriority(event), GetActiveContextId());
 
     // If GUI does not currently have focus and pass-through is enabled, we
     // allow the event to continue to the game systems.
@@ -511,13 +585,14 @@ bool InputManager::ShouldConsumeEvent(const SDL_Event& event) const {
 }
 
 InputManager::Statistics InputManager::GetStatistics() const {
-    std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
     return impl_->stats_;
 }
 
 void InputManager::ResetStatistics() {
-    std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
+    // Handler registrations are not reset, so keep the live count.
+    const uint32_t active = impl_->stats_.active_handlers.load(std::memory_order_relaxed);
     impl_->stats_ = Statistics{};
+    impl_->stats_.active_handlers.store(active, std::memory_order_relaxed);
     debuglog(DebugLevel::Info, "InputManager: Statistics reset");
 }
 
@@ -656,16 +731,15 @@ bool InputManager::PreviewSharedFocusKeyboardConsumption(const GUIEvent& event)
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(pending_keyboard_mutex_);
-    if (pending_keyboard_decision_ && EventsEqual(pending_keyboard_decision_->event, event.sdl_event)) {
-        return pending_keyboard_decision_->consumed;
+    const uint64_t fingerprint = KeyboardEventFingerprint(event.sdl_event);
+    const uint64_t pending = pending_keyboard_decision_.load(std::memory_order_acquire);
+    if ((pending & ~uint64_t{1}) == fingerprint) {
+        return (pending & 1) != 0;
     }
 
-    PendingKeyboardDecision decision{};
-    decision.event = event.sdl_event;
-    decision.consumed = const_cast<InputManager*>(this)->RouteToHandlers(event);
-    pending_keyboard_decision_ = decision;
-    return decision.consumed;
+    const bool consumed = const_cast<InputManager*>(this)->RouteToHandlers(event);
+    pending_keyboard_decision_.store(fingerprint | (consumed ? 1 : 0), std::memory_order_release);
+    return consumed;
 }
 
 std::optional<bool> InputManager::TakePendingSharedFocusKeyboardDecision(const GUIEvent& event) {
@@ -673,11 +747,13 @@ std::optional<bool> InputManager::TakePendingSharedFocusKeyboardDecision(const G
         return std::nullopt;
     }
 
-    std::lock_guard<std::mutex> lock(pending_keyboard_mutex_);
-    if (pending_keyboard_decision_ && EventsEqual(pending_keyboard_decision_->event, event.sdl_event)) {
-        bool consumed = pending_keyboard_decision_->consumed;
-        pending_keyboard_decision_.reset();
-        return consumed;
+    uint64_t pending = pending_keyboard_decision_.load(std::memory_order_acquire);
+    if (pending == 0) {
+        return std::nullopt;
+    }
+    if ((pending & ~uint64_t{1}) == KeyboardEventFingerprint(event.sdl_event) &&
+        pending_keyboard_decision_.compare_exchange_strong(pending, 0, std::memory_order_acq_rel)) {
+        return (pending & 1) != 0;
     }
 
     return std::nullopt;
@@ -711,5 +787,26 @@ void InputManager::Impl::UpdateMouseState(const SDL_Event& event) {
     }
 }
 
+void InputManager::Impl::CoalesceMotion(const SDL_Event& event) {
+    if (!motion_pending_) {
+        // The run starts here, so GetMouseDelta() spans the whole run.
+        pending_motion_ = event;
+        motion_pending_ = true;
+        prev_mouse_x_ = mouse_x_;
+        prev_mouse_y_ = mouse_y_;
+    } else {
+        SDL_MouseMotionEvent& merged = pending_motion_.motion;
+        merged.timestamp = event.motion.timestamp;
+        merged.state = event.motion.state;
+        merged.x = event.motion.x;
+        merged.y = event.motion.y;
+        merged.xrel += event.motion.xrel;
+        merged.yrel += event.motion.yrel;
+        stats_.motion_events_coalesced.fetch_add(1, std::memory_order_relaxed);
+    }
+    mouse_x_ = event.motion.x;
+    mouse_y_ = event.motion.y;
+}
+
 } // namespace GUI
 } // namespace BN
\ No newline at end of file
@@ -73,6 +73,8 @@ public:
         int mouse_sensitivity = 50;
         bool mouse_relative_mode = false;
         bool focus_indicator_enabled = true;
+        // Merge runs of SDL_MOUSEMOTION into one routed event; see FlushCoalescedInput()
+        bool coalesce_mouse_motion = false;
     };
 
     /**
@@ -115,6 +117,18 @@ public:
      */
     bool ProcessEvent(const SDL_Event& event);
 
+    /**
+     * @brief Route the motion merged so far when coalesce_mouse_motion is set
+     *
+     * While coalescing, ProcessEvent() folds each SDL_MOUSEMOTION into a pending
+     * event holding the latest position and the accumulated xrel/yrel, and
+     * returns false for it. The pending motion is routed before the next
+     * non-motion event is processed, or when this is called; frame loops call
+     * it once after draining the SDL queue.
+     * @return true if the merged motion was consumed by GUI
+     */
+    bool FlushCoalescedInput();
+
     /**
      * @brief Register an event handler for a specific input type
      * @param type Event type to handle
@@ -144,6 +158,13 @@ public:
      */
     void RemoveInputContext(const std::string& context_name);
 
+    /**
+     * @brief Get the interned id for a context name, as carried by GUIEvent::context_id
+     * @param context_name Context name; ids are stable for the manager's lifetime
+     * @return Context id, or 0 for an empty name
+     */
+    uint32_t GetContextId(const std::string& context_name) const;
+
     /**
      * @brief Get the current input context
      * @return Current input context or nullptr
@@ -246,6 +267,7 @@ public:
         std::atomic<uint64_t> handlers_called{0};
         std::atomic<uint32_t> active_handlers{0};
         std::atomic<uint32_t> focus_changes{0};
+        std::atomic<uint64_t> motion_events_coalesced{0};
 
         Statistics() = default;
 
@@ -256,6 +278,7 @@ public:
             handlers_called.store(other.handlers_called.load());
             active_handlers.store(other.active_handlers.load());
             focus_changes.store(other.focus_changes.load());
+            motion_events_coalesced.store(other.motion_events_coalesced.load());
         }
 
         Statistics& operator=(const Statistics& other) {
@@ -266,6 +289,7 @@ public:
                 handlers_called.store(other.handlers_called.load());
                 active_handlers.store(other.active_handlers.load());
                 focus_changes.store(other.focus_changes.load());
+                motion_events_coalesced.store(other.motion_events_coalesced.load());
             }
             return *this;
         }
@@ -301,21 +325,18 @@ private:
     mutable std::mutex listeners_mutex_;
     mutable std::mutex statistics_mutex_;
 
-    struct PendingKeyboardDecision {
-        SDL_Event event{};
-        bool consumed = false;
-    };
-
     bool ShouldPreviewSharedFocusKeyboardConsumption(const GUIEvent& event) const;
     bool PreviewSharedFocusKeyboardConsumption(const GUIEvent& event) const;
     std::optional<bool> TakePendingSharedFocusKeyboardDecision(const GUIEvent& event);
 
-    mutable std::mutex pending_keyboard_mutex_;
-    mutable std::optional<PendingKeyboardDecision> pending_keyboard_decision_;
+    // Shared-focus keyboard preview: fingerprint of the previewed SDL_Event with
+    // the decision in bit 0, or 0 when nothing is pending.
+    mutable std::atomic<uint64_t> pending_keyboard_decision_{0};
 
     // Internal event routing
     bool ProcessKeyboardEvent(const SDL_Event& event);
     bool ProcessMouseEvent(const SDL_Event& event);
+    bool RouteMouseEvent(const SDL_Event& event);
     bool RouteEventToHandlers(const GUIEvent& event);
     bool RouteToHandlers(const GUIEvent& event);
     bool HasEnabledHandlersForEvent(const GUIEvent& event) const;
@@ -327,22 +348,26 @@ private:
     EventType SDLToEventType(const SDL_Event& event) const;
     Priority DetermineEventPriority(const SDL_Event& event) const;
     bool IsEventConsumedByGUI(const GUIEvent& event) const;
-    std::string GetActiveContextName() const;
+    uint32_t GetActiveContextId() const;
 };
 
 /**
- * @brief GUI Event wrapper for internal use
+ * @brief Lightweight view of an SDL event being routed
+ *
+ * Built on the stack for each dispatch and refers to the caller's SDL_Event, so
+ * handlers must copy anything they need to keep past their return.
  */
 struct GUIEvent {
     InputManager::EventType type;
-    SDL_Event sdl_event;
+    const SDL_Event& sdl_event;
     InputManager::Priority priority;
-    std::string context;
-    int64_t timestamp_ms;
+    uint32_t context_id; // Interned context, see InputManager::GetContextId(); 0 when none
+    int64_t timestamp_ms; // SDL's event timestamp
     bool consumed = false;
 
-    GUIEvent(InputManager::EventType t, const SDL_Event& sdl, InputManager::Priority p = InputManager::Priority::NORMAL)
-        : type(t), sdl_event(sdl), priority(p), timestamp_ms(SDL_GetTicks64()) {}
+    GUIEvent(InputManager::EventType t, const SDL_Event& sdl, InputManager::Priority p = InputManager::Priority::NORMAL,
+             uint32_t context = 0)
+        : type(t), sdl_event(sdl), priority(p), context_id(context), timestamp_ms(sdl.common.timestamp) {}
 };
 
 /**
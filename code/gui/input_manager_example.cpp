@@ -173,7 +173,7 @@ private:
 // Example 2: Input Context Implementation
 class MenuInputContext : public InputContext {
 public:
-    explicit MenuInputContext(const std::string& name) : name_(name) {}
+    MenuInputContext(const std::string& name, uint32_t context_id) : name_(name), context_id_(context_id) {}
     
     bool HandleEvent(const GUIEvent& event) override {
         std::cout << "MenuContext '" << name_ << "' handling event" << std::endl;
@@ -197,16 +197,17 @@ public:
     
     bool ShouldReceiveEvent(const GUIEvent& event) const override {
         // Only receive events when menu is active
-        return event.context == "menu";
+        return event.context_id == context_id_;
     }
     
 private:
     std::string name_;
+    uint32_t context_id_;
 };
 
 class GameInputContext : public InputContext {
 public:
-    explicit GameInputContext(const std::string& name) : name_(name) {}
+    GameInputContext(const std::string& name, uint32_t context_id) : name_(name), context_id_(context_id) {}
     
     bool HandleEvent(const GUIEvent& event) override {
         // Handle game-specific input
@@ -236,11 +237,12 @@ public:
     
     bool ShouldReceiveEvent(const GUIEvent& event) const override {
         // Only receive events when game is active
-        return event.context == "game";
+        return event.context_id == context_id_;
     }
     
 private:
     std::string name_;
+    uint32_t context_id_;
 };
 
 class ContextExample {
@@ -252,8 +254,8 @@ public:
         manager.Initialize();
         
         // Create input contexts
-        auto menu_context = std::make_unique<MenuInputContext>("main_menu");
-        auto game_context = std::make_unique<GameInputContext>("gameplay");
+        auto menu_context = std::make_unique<MenuInputContext>("main_menu", manager.GetContextId("menu"));
+        auto game_context = std::make_unique<GameInputContext>("gameplay", manager.GetContextId("game"));
         
         // Register contexts
         manager.SetInputContext("menu", std::move(menu_context));
@@ -274,8 +276,8 @@ private:
         // Menu context handler
         manager.RegisterHandler(
             InputManager::EventType::MOUSE_BUTTON_PRESS,
-            [](const GUIEvent& event) {
-                if (event.context == "menu") {
+            [menu_id = manager.GetContextId("menu")](const GUIEvent& event) {
+                if (event.context_id == menu_id) {
                     std::cout << "Menu context: Processing mouse event" << std::endl;
                     return true;
                 }
@@ -288,8 +290,8 @@ private:
         // Game context handler
         manager.RegisterHandler(
             InputManager::EventType::KEYBOARD_PRESS,
-            [](const GUIEvent& event) {
-                if (event.context == "game") {
+            [game_id = manager.GetContextId("game")](const GUIEvent& event) {
+                if (event.context_id == game_id) {
                     std::cout << "Game context: Processing key event" << std::endl;
                     return true;
                 }
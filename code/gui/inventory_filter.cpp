@@ -0,0 +1,229 @@
+#include "inventory_filter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INVENTORY_FILTER_SSE2 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+// Longest gram indexed; longer queries use their rarest gram of this size
+constexpr size_t kMaxGram = 3;
+
+char LowerAscii(char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+#if INVENTORY_FILTER_SSE2
+int CountTrailingZeros(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+} // namespace
+
+InventoryFilter::InventoryFilter() : matches_(std::make_shared<const MatchList>()) {}
+
+bool InventoryFilter::Index(const inventory_overlay_state& state) {
+    uint64_t hash = kFnvOffsetBasis;
+    for (const inventory_column& column : state.columns) {
+        const uint64_t count = column.entries.size();
+        hash = HashBytes(hash, &count, sizeof(count));
+        for (const inventory_entry& entry : column.entries) {
+            const char kind = entry.is_category ? 1 : 0;
+            hash = HashBytes(hash, &kind, 1);
+            hash = HashBytes(hash, entry.label.data(), entry.label.size());
+            hash = HashBytes(hash, "\0", 1);
+        }
+    }
+    if (has_index_ && hash == content_hash_) {
+        return false;
+    }
+
+    content_hash_ = hash;
+    has_index_ = true;
+    ++rebuild_count_;
+    entries_.clear();
+    text_.clear();
+    for (auto& gram : grams_) {
+        gram.second.clear();
+    }
+
+    for (size_t column_index = 0; column_index < state.columns.size(); ++column_index) {
+        const auto& entries = state.columns[column_index].entries;
+        for (size_t row_index = 0; row_index < entries.size(); ++row_index) {
+            const inventory_entry& source = entries[row_index];
+            if (source.is_category) {
+                continue;
+            }
+            Entry entry;
+            entry.position.column_index = static_cast<int>(column_index);
+            entry.position.row_index = static_cast<int>(row_index);
+            entry.text_offset = static_cast<uint32_t>(text_.size());
+            entry.text_size = static_cast<uint32_t>(source.label.size());
+            for (char ch : source.label) {
+                text_.push_back(LowerAscii(ch));
+            }
+            const uint32_t entry_index = static_cast<uint32_t>(entries_.size());
+            entries_.push_back(entry);
+            AddGrams(entry_index, EntryText(entry));
+        }
+    }
+
+    // Matches of the old state no longer point at the right rows
+    const std::string query = std::move(query_);
+    has_query_ = false;
+    match_indices_.clear();
+    Apply(query);
+    return true;
+}
+
+std::shared_ptr<const InventoryFilter::MatchList> InventoryFilter::Apply(std::string_view query) {
+    std::string lowered(query.size(), '\0');
+    for (size_t i = 0; i < query.size(); ++i) {
+        lowered[i] = LowerAscii(query[i]);
+    }
+    if (has_query_ && lowered == query_) {
+        last_candidate_count_ = 0;
+        return matches_;
+    }
+
+    scratch_indices_.clear();
+    if (lowered.empty()) {
+        last_candidate_count_ = 0;
+        for (uint32_t index = 0; index < entries_.size(); ++index) {
+            scratch_indices_.push_back(index);
+        }
+    } else if (has_query_ && !query_.empty() && lowered.find(query_) != std::string::npos) {
+        // A label containing the new query contains the old one, so typing
+        // more can only drop entries from the last result
+        last_candidate_count_ = match_indices_.size();
+        for (uint32_t index : match_indices_) {
+            if (ContainsLowered(EntryText(entries_[index]), lowered)) {
+                scratch_indices_.push_back(index);
+            }
+        }
+    } else {
+        const std::vector<uint32_t>* candidates = FindSmallestPostingList(lowered);
+        last_candidate_count_ = candidates ? candidates->size() : 0;
+        if (candidates) {
+            for (uint32_t index : *candidates) {
+                if (ContainsLowered(EntryText(entries_[index]), lowered)) {
+                    scratch_indices_.push_back(index);
+                }
+            }
+        }
+    }
+
+    match_indices_.swap(scratch_indices_);
+    query_ = std::move(lowered);
+    has_query_ = true;
+    PublishMatches();
+    return matches_;
+}
+
+bool InventoryFilter::ContainsLowered(std::string_view haystack, std::string_view needle) {
+    const size_t n = needle.size();
+    if (n == 0) {
+        return true;
+    }
+    if (n > haystack.size()) {
+        return false;
+    }
+
+    size_t start = 0;
+#if INVENTORY_FILTER_SSE2
+    // Compare the needle's first and last byte against 16 positions at once
+    // and only memcmp the positions where both agree.
+    const char* data = haystack.data();
+    const __m128i first = _mm_set1_epi8(needle.front());
+    const __m128i last = _mm_set1_epi8(needle.back());
+    for (; start + n - 1 + 16 <= haystack.size(); start += 16) {
+        const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + start));
+        const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + start + n - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+        while (mask != 0) {
+            const size_t offset = start + static_cast<size_t>(CountTrailingZeros(mask));
+            if (n <= 2 || std::memcmp(data + offset + 1, needle.data() + 1, n - 2) == 0) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    return haystack.find(needle, start) != std::string_view::npos;
+}
+
+uint32_t InventoryFilter::PackGram(const char* bytes, size_t size) {
+    uint32_t key = static_cast<uint32_t>(size) << 24;
+    for (size_t i = 0; i < size; ++i) {
+        key |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[i])) << (16 - 8 * i);
+    }
+    return key;
+}
+
+void InventoryFilter::AddGrams(uint32_t entry_index, std::string_view label) {
+    for (size_t start = 0; start < label.size(); ++start) {
+        for (size_t size = 1; size <= kMaxGram && start + size <= label.size(); ++size) {
+            std::vector<uint32_t>& postings = grams_[PackGram(label.data() + start, size)];
+            // Entries are added in order, so a repeat can only be the last one
+            if (postings.empty() || postings.back() != entry_index) {
+                postings.push_back(entry_index);
+            }
+        }
+    }
+}
+
+const std::vector<uint32_t>* InventoryFilter::FindSmallestPostingList(std::string_view query) const {
+    const size_t size = std::min(query.size(), kMaxGram);
+    const std::vector<uint32_t>* smallest = nullptr;
+    for (size_t start = 0; start + size <= query.size(); ++start) {
+        const auto it = grams_.find(PackGram(query.data() + start, size));
+        if (it == grams_.end() || it->second.empty()) {
+            // A gram no label contains rules out every entry
+            return nullptr;
+        }
+        if (!smallest || it->second.size() < smallest->size()) {
+            smallest = &it->second;
+        }
+    }
+    return smallest;
+}
+
+std::string_view InventoryFilter::EntryText(const Entry& entry) const {
+    return std::string_view(text_.data() + entry.text_offset, entry.text_size);
+}
+
+void InventoryFilter::PublishMatches() {
+    auto matches = std::make_shared<MatchList>();
+    matches->reserve(match_indices_.size());
+    for (uint32_t index : match_indices_) {
+        matches->push_back(entries_[index].position);
+    }
+    matches_ = std::move(matches);
+}
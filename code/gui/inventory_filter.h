@@ -0,0 +1,103 @@
+#ifndef INVENTORY_FILTER_H
+#define INVENTORY_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "InventoryOverlayState.h"
+#include "events.h"
+
+/**
+ * Case-insensitive substring filter over the labels of an inventory state.
+ *
+ * Index() keeps a lowercase copy of every non-category label and an index
+ * from each 1-, 2- and 3-byte gram to the entries containing it. Apply()
+ * starts from the shortest posting list among the query's grams, or, when the
+ * new query contains the last one, from the previous matches, and checks the
+ * remaining candidates with a substring search. Case folding is ASCII
+ * only; other UTF-8 bytes must match exactly.
+ */
+class InventoryFilter {
+public:
+    using Match = cataclysm::gui::FilterMatch;
+    using MatchList = std::vector<Match>;
+
+    InventoryFilter();
+
+    /**
+     * Index the labels of state, unless they are the ones already indexed.
+     * A rebuild re-runs the current query against the new entries.
+     * @return true if the index was rebuilt
+     */
+    bool Index(const inventory_overlay_state& state);
+
+    /**
+     * Filter the indexed entries. An empty query matches every entry.
+     * @param query Text to look for anywhere in a label
+     * @return Matching entries in column then row order
+     */
+    std::shared_ptr<const MatchList> Apply(std::string_view query);
+
+    /**
+     * @return Matches of the last Apply(), or every entry before the first
+     */
+    [[nodiscard]] const std::shared_ptr<const MatchList>& GetMatches() const { return matches_; }
+
+    /**
+     * @return Lowercased query of the last Apply()
+     */
+    [[nodiscard]] const std::string& GetQuery() const { return query_; }
+
+    [[nodiscard]] size_t GetIndexedEntryCount() const { return entries_.size(); }
+
+    /**
+     * @return Labels the last Apply() had to check, for judging the index
+     */
+    [[nodiscard]] size_t GetLastCandidateCount() const { return last_candidate_count_; }
+
+    [[nodiscard]] uint64_t GetRebuildCount() const { return rebuild_count_; }
+
+    /**
+     * Substring search over text that is already lowercase.
+     * @return true if needle occurs in haystack
+     */
+    static bool ContainsLowered(std::string_view haystack, std::string_view needle);
+
+private:
+    struct Entry {
+        Match position;
+        uint32_t text_offset = 0;
+        uint32_t text_size = 0;
+    };
+
+    static uint32_t PackGram(const char* bytes, size_t size);
+    void AddGrams(uint32_t entry_index, std::string_view label);
+    const std::vector<uint32_t>* FindSmallestPostingList(std::string_view query) const;
+    std::string_view EntryText(const Entry& entry) const;
+    void PublishMatches();
+
+    std::vector<Entry> entries_;
+    // Lowercased labels, back to back
+    std::string text_;
+    // Ascending entry indices per gram
+    std::unordered_map<uint32_t, std::vector<uint32_t>> grams_;
+    uint64_t content_hash_ = 0;
+    bool has_index_ = false;
+
+    std::string query_;
+    bool has_query_ = false;
+    // Entry indices behind matches_, the starting point when the query grows
+    std::vector<uint32_t> match_indices_;
+    std::vector<uint32_t> scratch_indices_;
+    std::shared_ptr<const MatchList> matches_;
+
+    size_t last_candidate_count_ = 0;
+    uint64_t rebuild_count_ = 0;
+};
+
+#endif // INVENTORY_FILTER_H
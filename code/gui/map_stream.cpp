@@ -0,0 +1,139 @@
+#include "map_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "debug.h"
+#include "resource_manager.h"
+
+namespace {
+
+// Past this many rects per texture, one bounding rect is cheaper to lock
+constexpr size_t kMaxPendingRects = 32;
+
+SDL_Rect BoundingRect(const std::vector<SDL_Rect>& rects) {
+    SDL_Rect bounds = rects.front();
+    for (const SDL_Rect& rect : rects) {
+        SDL_UnionRect(&bounds, &rect, &bounds);
+    }
+    return bounds;
+}
+
+} // namespace
+
+MapStream::MapStream(SDL_Renderer* renderer, int width, int height)
+    : renderer_(renderer), width_(std::max(width, 0)), height_(std::max(height, 0)) {
+    if (!renderer_ || width_ == 0 || height_ == 0) {
+        return;
+    }
+
+    pixels_.assign(static_cast<size_t>(width_) * static_cast<size_t>(height_) * 4, 0);
+    for (Buffer& buffer : buffers_) {
+        buffer.texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING,
+                                           width_, height_);
+        if (!buffer.texture) {
+            debuglog(DebugLevel::Warning, "MapStream: failed to create ", width_, "x", height_,
+                     " streaming texture: ", SDL_GetError());
+            continue;
+        }
+        buffer.resource = gui::resource_manager::Manager::instance().get_texture(
+            gui::resource_manager::utilities::generate_unique_id("map_stream"), [&](const std::string& id) {
+                return std::make_shared<gui::resource_manager::TextureResource>(
+                    id, reinterpret_cast<ImTextureID>(buffer.texture), static_cast<uint32_t>(width_),
+                    static_cast<uint32_t>(height_));
+            });
+        // Streaming textures start out undefined, so each gets one full upload
+        buffer.pending.push_back(SDL_Rect{0, 0, width_, height_});
+    }
+    has_changes_ = true;
+}
+
+MapStream::~MapStream() {
+    for (Buffer& buffer : buffers_) {
+        if (buffer.resource) {
+            gui::resource_manager::Manager::instance().release_resource(buffer.resource->get_id());
+        }
+        if (buffer.texture) {
+            SDL_DestroyTexture(buffer.texture);
+        }
+    }
+}
+
+bool MapStream::IsValid() const {
+    return buffers_[0].texture && buffers_[1].texture;
+}
+
+uint8_t* MapStream::LockRect(const SDL_Rect& rect) {
+    SDL_Rect clipped;
+    if (!ClipRect(rect, &clipped)) {
+        return nullptr;
+    }
+    MarkDirty(clipped);
+    return pixels_.data() + static_cast<size_t>(clipped.y) * GetPitch() + static_cast<size_t>(clipped.x) * 4;
+}
+
+void MapStream::MarkDirty(const SDL_Rect& rect) {
+    SDL_Rect clipped;
+    if (!ClipRect(rect, &clipped)) {
+        return;
+    }
+
+    for (Buffer& buffer : buffers_) {
+        buffer.pending.push_back(clipped);
+        if (buffer.pending.size() > kMaxPendingRects) {
+            const SDL_Rect bounds = BoundingRect(buffer.pending);
+            buffer.pending.assign(1, bounds);
+        }
+    }
+    has_changes_ = true;
+}
+
+bool MapStream::Present() {
+    if (!IsValid() || !has_changes_) {
+        return false;
+    }
+
+    const int back = 1 - front_;
+    if (!Upload(buffers_[back])) {
+        return false;
+    }
+    front_ = back;
+    has_changes_ = false;
+    presented_ = true;
+    return true;
+}
+
+SDL_Texture* MapStream::GetFrontTexture() const {
+    // Before the first Present() neither texture holds a snapshot yet
+    return presented_ ? buffers_[front_].texture : nullptr;
+}
+
+bool MapStream::ClipRect(const SDL_Rect& rect, SDL_Rect* clipped) const {
+    const SDL_Rect bounds{0, 0, width_, height_};
+    return SDL_IntersectRect(&rect, &bounds, clipped) == SDL_TRUE;
+}
+
+bool MapStream::Upload(Buffer& buffer) {
+    const int src_pitch = GetPitch();
+    for (const SDL_Rect& rect : buffer.pending) {
+        void* locked = nullptr;
+        int dst_pitch = 0;
+        if (SDL_LockTexture(buffer.texture, &rect, &locked, &dst_pitch) != 0) {
+            debuglog(DebugLevel::Warning, "MapStream: failed to lock texture: ", SDL_GetError());
+            return false;
+        }
+
+        const size_t row_bytes = static_cast<size_t>(rect.w) * 4;
+        const uint8_t* src = pixels_.data() + static_cast<size_t>(rect.y) * src_pitch + static_cast<size_t>(rect.x) * 4;
+        uint8_t* dst = static_cast<uint8_t*>(locked);
+        for (int row = 0; row < rect.h; ++row) {
+            std::memcpy(dst, src, row_bytes);
+            src += src_pitch;
+            dst += dst_pitch;
+        }
+        SDL_UnlockTexture(buffer.texture);
+        uploaded_bytes_ += row_bytes * static_cast<size_t>(rect.h);
+    }
+    buffer.pending.clear();
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef MAP_STREAM_H
+#define MAP_STREAM_H
+
+#include <SDL.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gui {
+namespace resource_manager {
+class TextureResource;
+} // namespace resource_manager
+} // namespace gui
+
+/**
+ * Streams a map snapshot into a pair of SDL streaming textures.
+ *
+ * The game writes tile pixels straight into a persistent RGBA buffer and
+ * marks the rects it touched. Present() uploads only those rects into the
+ * back texture and flips, so the texture being displayed is never written
+ * while a frame may still sample it. Each texture also replays the rects it
+ * missed while it was in front, which keeps both copies identical without a
+ * full-map upload.
+ */
+class MapStream {
+public:
+    MapStream(SDL_Renderer* renderer, int width, int height);
+    ~MapStream();
+
+    MapStream(const MapStream&) = delete;
+    MapStream& operator=(const MapStream&) = delete;
+
+    /**
+     * @return true if both streaming textures were created
+     */
+    [[nodiscard]] bool IsValid() const;
+
+    /**
+     * Get the pixels of a rect for writing and mark it dirty. Rows are
+     * GetPitch() bytes apart, pixels are SDL_PIXELFORMAT_RGBA32. The pointer
+     * stays valid for the lifetime of the stream.
+     * @param rect Region to write; clipped to the map
+     * @return Pointer to the rect's top-left pixel, or nullptr if the rect
+     *         lies outside the map
+     */
+    uint8_t* LockRect(const SDL_Rect& rect);
+
+    /**
+     * Mark a rect dirty after writing it through GetPixels().
+     * @param rect Region that changed; clipped to the map
+     */
+    void MarkDirty(const SDL_Rect& rect);
+
+    /**
+     * Upload the dirty rects into the back texture and make it the front one.
+     * @return false if nothing changed since the last call or an upload failed
+     */
+    bool Present();
+
+    /**
+     * @return The texture holding the last presented snapshot
+     */
+    [[nodiscard]] SDL_Texture* GetFrontTexture() const;
+
+    [[nodiscard]] uint8_t* GetPixels() { return pixels_.data(); }
+    [[nodiscard]] int GetPitch() const { return width_ * 4; }
+    [[nodiscard]] int GetWidth() const { return width_; }
+    [[nodiscard]] int GetHeight() const { return height_; }
+
+    /**
+     * @return Bytes copied into textures by Present() so far
+     */
+    [[nodiscard]] uint64_t GetUploadedBytes() const { return uploaded_bytes_; }
+
+private:
+    struct Buffer {
+        SDL_Texture* texture = nullptr;
+        std::shared_ptr<gui::resource_manager::TextureResource> resource;
+        // Rects changed since this texture was last uploaded
+        std::vector<SDL_Rect> pending;
+    };
+
+    bool ClipRect(const SDL_Rect& rect, SDL_Rect* clipped) const;
+    bool Upload(Buffer& buffer);
+
+    SDL_Renderer* renderer_;
+    int width_;
+    int height_;
+    std::vector<uint8_t> pixels_;
+    Buffer buffers_[2];
+    int front_ = 0;
+    bool has_changes_ = false;
+    bool presented_ = false;
+    uint64_t uploaded_bytes_ = 0;
+};
+
+#endif // MAP_STREAM_H
@@ -2,20 +2,199 @@
 #include "imgui.h"
 
 #include <algorithm>
+#include <cmath>
+
+#include "debug.h"
+#include "frame_profiler.h"
+#include "texture_atlas.h"
 
 MapWidget::MapWidget(cataclysm::gui::EventBusAdapter &event_bus_adapter)
     : tile_size_(1.0f, 1.0f), event_bus_adapter_(event_bus_adapter) {
 }
 
-MapWidget::~MapWidget() = default;
+namespace {
+
+// Zoom factor per mouse wheel notch
+constexpr float kZoomStep = 1.25f;
+constexpr float kMaxZoom = 64.0f;
+constexpr int kMaxMipLevels = 8;
+
+} // namespace
+
+MapWidget::~MapWidget() {
+    DestroyMipChain();
+    DestroyTileTexture();
+}
 
 void MapWidget::UpdateMapTexture(SDL_Texture* texture, int width, int height, int tiles_w, int tiles_h) {
+    // A snapshot from the game takes over from the widget-owned surface
+    tile_map_active_ = false;
     map_texture_ = texture;
     texture_size_ = ImVec2(static_cast<float>(width), static_cast<float>(height));
+    InvalidateMipChain();
     tiles_w_ = std::max(0, tiles_w);
     tiles_h_ = std::max(0, tiles_h);
 }
 
+void MapWidget::SetTileSource(SDL_Renderer* renderer, TileResolver resolver, int tile_width, int tile_height) {
+    if (tile_width != tile_width_ || tile_height != tile_height_) {
+        DestroyTileTexture();
+    }
+    SetRenderer(renderer);
+    tile_resolver_ = std::move(resolver);
+    tile_width_ = std::max(0, tile_width);
+    tile_height_ = std::max(0, tile_height);
+    InvalidateTiles();
+}
+
+void MapWidget::UpdateTiles(const std::vector<uint32_t>& tiles, int tiles_w, int tiles_h) {
+    tiles_w = std::max(0, tiles_w);
+    tiles_h = std::max(0, tiles_h);
+    const size_t count = static_cast<size_t>(tiles_w) * static_cast<size_t>(tiles_h);
+    if (tiles.size() < count) {
+        debuglog(DebugLevel::Warning, "MapWidget: tile grid has ", tiles.size(), " ids for ", tiles_w, "x", tiles_h);
+        return;
+    }
+
+    if (!tile_map_active_ || tiles_w != tiles_w_ || tiles_h != tiles_h_) {
+        DestroyTileTexture();
+        tiles_w_ = tiles_w;
+        tiles_h_ = tiles_h;
+        tiles_.assign(tiles.begin(), tiles.begin() + count);
+        tile_map_active_ = true;
+        InvalidateTiles();
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (tiles_[i] != tiles[i]) {
+            tiles_[i] = tiles[i];
+            MarkTileDirty(static_cast<int>(i));
+        }
+    }
+}
+
+void MapWidget::UpdateTiles(const std::vector<TileChange>& changes) {
+    if (!tile_map_active_) {
+        return;
+    }
+    for (const TileChange& change : changes) {
+        if (change.x < 0 || change.y < 0 || change.x >= tiles_w_ || change.y >= tiles_h_) {
+            continue;
+        }
+        const int index = change.y * tiles_w_ + change.x;
+        if (tiles_[index] != change.tile_id) {
+            tiles_[index] = change.tile_id;
+            MarkTileDirty(index);
+        }
+    }
+}
+
+void MapWidget::InvalidateRenderTargets() {
+    InvalidateTiles();
+    InvalidateMipChain();
+}
+
+void MapWidget::InvalidateTiles() {
+    tile_dirty_.assign(tiles_.size(), 1);
+    dirty_tiles_.resize(tiles_.size());
+    for (size_t i = 0; i < tiles_.size(); ++i) {
+        dirty_tiles_[i] = static_cast<int>(i);
+    }
+}
+
+void MapWidget::MarkTileDirty(int index) {
+    if (!tile_dirty_[index]) {
+        tile_dirty_[index] = 1;
+        dirty_tiles_.push_back(index);
+    }
+}
+
+int MapWidget::RedrawDirtyTiles() {
+    if (!tile_map_active_ || dirty_tiles_.empty() || !EnsureTileTexture()) {
+        return 0;
+    }
+
+    SDL_Texture* previous_target = SDL_GetRenderTarget(renderer_);
+    if (SDL_SetRenderTarget(renderer_, tile_texture_) != 0) {
+        return 0;
+    }
+    Uint8 r = 0, g = 0, b = 0, a = 0;
+    SDL_GetRenderDrawColor(renderer_, &r, &g, &b, &a);
+    SDL_BlendMode blend_mode = SDL_BLENDMODE_NONE;
+    SDL_GetRenderDrawBlendMode(renderer_, &blend_mode);
+
+    // Cells are cleared to transparent, then the tile is blended on top
+    SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 0);
+    for (int index : dirty_tiles_) {
+        const SDL_Rect dst{(index % tiles_w_) * tile_width_, (index / tiles_w_) * tile_height_,
+                           tile_width_, tile_height_};
+        SDL_RenderFillRect(renderer_, &dst);
+
+        const gui::resource_manager::AtlasRegion* region = tile_resolver_ ? tile_resolver_(tiles_[index]) : nullptr;
+        if (region) {
+            const SDL_Rect src{region->rect.x, region->rect.y, region->rect.w, region->rect.h};
+            SDL_RenderCopy(renderer_, reinterpret_cast<SDL_Texture*>(region->texture), &src, &dst);
+        }
+        tile_dirty_[index] = 0;
+    }
+
+    SDL_SetRenderTarget(renderer_, previous_target);
+    SDL_SetRenderDrawBlendMode(renderer_, blend_mode);
+    SDL_SetRenderDrawColor(renderer_, r, g, b, a);
+
+    const int redrawn = static_cast<int>(dirty_tiles_.size());
+    dirty_tiles_.clear();
+    map_texture_ = tile_texture_;
+    InvalidateMipChain();
+    return redrawn;
+}
+
+bool MapWidget::EnsureTileTexture() {
+    if (tile_texture_) {
+        return true;
+    }
+    if (!renderer_ || !SDL_RenderTargetSupported(renderer_) || tile_width_ <= 0 || tile_height_ <= 0 ||
+        tiles_w_ <= 0 || tiles_h_ <= 0) {
+        return false;
+    }
+
+    const int width = tiles_w_ * tile_width_;
+    const int height = tiles_h_ * tile_height_;
+    tile_texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!tile_texture_) {
+        debuglog(DebugLevel::Warning, "MapWidget: failed to create ", width, "x", height, " map texture: ",
+                 SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureBlendMode(tile_texture_, SDL_BLENDMODE_BLEND);
+    tile_texture_resource_ = gui::resource_manager::Manager::instance().get_texture(
+        gui::resource_manager::utilities::generate_unique_id("map_tiles"), [&](const std::string& id) {
+            return std::make_shared<gui::resource_manager::TextureResource>(
+                id, reinterpret_cast<ImTextureID>(tile_texture_), static_cast<uint32_t>(width),
+                static_cast<uint32_t>(height));
+        });
+
+    texture_size_ = ImVec2(static_cast<float>(width), static_cast<float>(height));
+    InvalidateTiles();
+    return true;
+}
+
+void MapWidget::DestroyTileTexture() {
+    if (tile_texture_resource_) {
+        gui::resource_manager::Manager::instance().release_resource(tile_texture_resource_->get_id());
+        tile_texture_resource_.reset();
+    }
+    if (tile_texture_) {
+        if (map_texture_ == tile_texture_) {
+            map_texture_ = nullptr;
+        }
+        SDL_DestroyTexture(tile_texture_);
+        tile_texture_ = nullptr;
+    }
+}
+
 const ImVec2 &MapWidget::GetTileSize() const {
     return tile_size_;
 }
@@ -25,6 +204,9 @@ std::optional<TileSelection> MapWidget::GetSelectedTile() const {
 }
 
 void MapWidget::Draw() {
+    GUI_PROFILE_ZONE("MapWidget::Draw");
+    RedrawDirtyTiles();
+
     ImGui::Begin("Game Map");
     if (map_texture_) {
         const float aspect = texture_size_.x / texture_size_.y;
@@ -37,11 +219,16 @@ void MapWidget::Draw() {
         } else {
             draw_size.y = draw_size.x / aspect;
         }
-        ImGui::Image(reinterpret_cast<ImTextureID>(map_texture_), draw_size);
+
+        ImVec2 uv0;
+        ImVec2 uv1;
+        GetVisibleRegion(&uv0, &uv1);
+        SDL_Texture* texture = PrepareMipLevel(draw_size);
+        ImGui::Image(reinterpret_cast<ImTextureID>(texture), draw_size, uv0, uv1);
 
         if (tiles_w_ > 0 && tiles_h_ > 0 && draw_size.x > 0.0f && draw_size.y > 0.0f) {
-            tile_size_.x = draw_size.x / static_cast<float>(tiles_w_);
-            tile_size_.y = draw_size.y / static_cast<float>(tiles_h_);
+            tile_size_.x = draw_size.x / (static_cast<float>(tiles_w_) * (uv1.x - uv0.x));
+            tile_size_.y = draw_size.y / (static_cast<float>(tiles_h_) * (uv1.y - uv0.y));
         } else {
             tile_size_ = ImVec2(0.0f, 0.0f);
         }
@@ -55,29 +242,42 @@ void MapWidget::Draw() {
             ImVec2 image_pos = ImGui::GetItemRectMin();
             ImVec2 relative_pos = ImVec2(mouse_pos.x - image_pos.x, mouse_pos.y - image_pos.y);
 
-            if (tiles_w_ > 0 && tiles_h_ > 0 && draw_size.x > 0.0f && draw_size.y > 0.0f) {
-                float normalized_x = relative_pos.x / draw_size.x;
-                float normalized_y = relative_pos.y / draw_size.y;
-
-                normalized_x = std::clamp(normalized_x, 0.0f, 1.0f);
-                normalized_y = std::clamp(normalized_y, 0.0f, 1.0f);
+            if (draw_size.x > 0.0f && draw_size.y > 0.0f) {
+                const ImVec2 normalized(std::clamp(relative_pos.x / draw_size.x, 0.0f, 1.0f),
+                                        std::clamp(relative_pos.y / draw_size.y, 0.0f, 1.0f));
 
-                int tile_x = static_cast<int>(normalized_x * static_cast<float>(tiles_w_));
-                int tile_y = static_cast<int>(normalized_y * static_cast<float>(tiles_h_));
-
-                const int max_tile_x = std::max(tiles_w_ - 1, 0);
-                const int max_tile_y = std::max(tiles_h_ - 1, 0);
+                // Wheel zooms around the cursor, right-drag pans
+                const ImGuiIO& io = ImGui::GetIO();
+                if (io.MouseWheel != 0.0f) {
+                    ZoomAt(std::pow(kZoomStep, io.MouseWheel), normalized);
+                }
+                if (ImGui::IsMouseDragging(ImGuiMouseButton_Right)) {
+                    Pan(ImVec2(-io.MouseDelta.x / draw_size.x, -io.MouseDelta.y / draw_size.y));
+                }
+            }
 
-                tile_x = std::clamp(tile_x, 0, max_tile_x);
-                tile_y = std::clamp(tile_y, 0, max_tile_y);
+            const auto tile = draw_size.x > 0.0f && draw_size.y > 0.0f
+                                  ? TileAt(ImVec2(relative_pos.x / draw_size.x, relative_pos.y / draw_size.y))
+                                  : std::nullopt;
+            if (tile) {
+                const int tile_x = tile->x;
+                const int tile_y = tile->y;
 
-                event_bus_adapter_.publishMapTileHovered(tile_x, tile_y);
+                const bool hover_changed = !last_hovered_tile_ ||
+                                           last_hovered_tile_->x != tile_x ||
+                                           last_hovered_tile_->y != tile_y;
+                if (hover_changed) {
+                    last_hovered_tile_ = TileSelection{tile_x, tile_y};
+                    event_bus_adapter_.enqueue(cataclysm::gui::MapTileHoveredEvent(tile_x, tile_y));
+                }
 
                 if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
                     selected_tile_ = TileSelection{tile_x, tile_y};
-                    event_bus_adapter_.publishMapTileClicked(tile_x, tile_y);
+                    event_bus_adapter_.enqueue(cataclysm::gui::MapTileClickedEvent(tile_x, tile_y));
                 }
             }
+        } else {
+            last_hovered_tile_.reset();
         }
     } else {
         tile_size_ = ImVec2(0.0f, 0.0f);
@@ -87,6 +287,175 @@ void MapWidget::Draw() {
     ImGui::End();
 }
 
+void MapWidget::SetRenderer(SDL_Renderer* renderer) {
+    if (renderer != renderer_) {
+        DestroyTileTexture();
+        DestroyMipChain();
+        renderer_ = renderer;
+        InvalidateTiles();
+    }
+}
+
+void MapWidget::SetZoom(float zoom) {
+    zoom_ = std::clamp(zoom, 1.0f, kMaxZoom);
+    ClampView();
+}
+
+void MapWidget::ZoomAt(float factor, const ImVec2& normalized_pos) {
+    ImVec2 uv0;
+    ImVec2 uv1;
+    GetVisibleRegion(&uv0, &uv1);
+    const ImVec2 focus(uv0.x + normalized_pos.x * (uv1.x - uv0.x), uv0.y + normalized_pos.y * (uv1.y - uv0.y));
+
+    zoom_ = std::clamp(zoom_ * factor, 1.0f, kMaxZoom);
+
+    // Keep the texel under the cursor in place
+    const float span = 1.0f / zoom_;
+    view_center_ = ImVec2(focus.x + (0.5f - normalized_pos.x) * span, focus.y + (0.5f - normalized_pos.y) * span);
+    ClampView();
+}
+
+void MapWidget::Pan(const ImVec2& normalized_delta) {
+    const float span = 1.0f / zoom_;
+    view_center_.x += normalized_delta.x * span;
+    view_center_.y += normalized_delta.y * span;
+    ClampView();
+}
+
+void MapWidget::ResetView() {
+    zoom_ = 1.0f;
+    view_center_ = ImVec2(0.5f, 0.5f);
+}
+
+void MapWidget::GetVisibleRegion(ImVec2* uv0, ImVec2* uv1) const {
+    const float half_span = 0.5f / zoom_;
+    *uv0 = ImVec2(view_center_.x - half_span, view_center_.y - half_span);
+    *uv1 = ImVec2(view_center_.x + half_span, view_center_.y + half_span);
+}
+
+std::optional<TileSelection> MapWidget::TileAt(const ImVec2& normalized_pos) const {
+    if (tiles_w_ <= 0 || tiles_h_ <= 0) {
+        return std::nullopt;
+    }
+
+    ImVec2 uv0;
+    ImVec2 uv1;
+    GetVisibleRegion(&uv0, &uv1);
+    const float u = uv0.x + std::clamp(normalized_pos.x, 0.0f, 1.0f) * (uv1.x - uv0.x);
+    const float v = uv0.y + std::clamp(normalized_pos.y, 0.0f, 1.0f) * (uv1.y - uv0.y);
+
+    const int tile_x = std::clamp(static_cast<int>(u * static_cast<float>(tiles_w_)), 0, tiles_w_ - 1);
+    const int tile_y = std::clamp(static_cast<int>(v * static_cast<float>(tiles_h_)), 0, tiles_h_ - 1);
+    return TileSelection{tile_x, tile_y};
+}
+
+void MapWidget::ClampView() {
+    const float half_span = 0.5f / zoom_;
+    view_center_.x = std::clamp(view_center_.x, half_span, 1.0f - half_span);
+    view_center_.y = std::clamp(view_center_.y, half_span, 1.0f - half_span);
+}
+
+SDL_Texture* MapWidget::PrepareMipLevel(const ImVec2& draw_size) {
+    mip_level_ = 0;
+    if (!map_texture_ || !renderer_ || draw_size.x <= 0.0f || draw_size.y <= 0.0f ||
+        !SDL_RenderTargetSupported(renderer_)) {
+        return map_texture_;
+    }
+
+    // Texels of the visible region per screen pixel; each level halves it
+    const float texels_per_pixel = std::max(texture_size_.x / (draw_size.x * zoom_),
+                                            texture_size_.y / (draw_size.y * zoom_));
+    int wanted = texels_per_pixel >= 2.0f ? static_cast<int>(std::floor(std::log2(texels_per_pixel))) : 0;
+    wanted = std::min(wanted, kMaxMipLevels);
+    if (wanted == 0) {
+        return map_texture_;
+    }
+
+    if (mip_base_size_.x != texture_size_.x || mip_base_size_.y != texture_size_.y) {
+        DestroyMipChain();
+        mip_base_size_ = texture_size_;
+    }
+    // Another texture of the same size, such as the other buffer of a map
+    // stream, keeps the levels and only redraws them
+    if (mip_source_ != map_texture_) {
+        InvalidateMipChain();
+        mip_source_ = map_texture_;
+    }
+
+    SDL_Texture* source = map_texture_;
+    for (int level = 1; level <= wanted; ++level) {
+        const int width = std::max(1, static_cast<int>(texture_size_.x) >> level);
+        const int height = std::max(1, static_cast<int>(texture_size_.y) >> level);
+        if (static_cast<size_t>(level) > mips_.size()) {
+            MipLevel mip;
+            mip.texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, width, height);
+            if (!mip.texture) {
+                break;
+            }
+            SDL_SetTextureBlendMode(mip.texture, SDL_BLENDMODE_BLEND);
+            SDL_SetTextureScaleMode(mip.texture, SDL_ScaleModeLinear);
+            mip.resource = gui::resource_manager::Manager::instance().get_texture(
+                gui::resource_manager::utilities::generate_unique_id("map_mip"), [&](const std::string& id) {
+                    return std::make_shared<gui::resource_manager::TextureResource>(
+                        id, reinterpret_cast<ImTextureID>(mip.texture), static_cast<uint32_t>(width),
+                        static_cast<uint32_t>(height));
+                });
+            mips_.push_back(std::move(mip));
+        }
+
+        MipLevel& mip = mips_[level - 1];
+        if (!mip.valid && !Downsample(source, mip.texture)) {
+            break;
+        }
+        mip.valid = true;
+        mip_level_ = level;
+        source = mip.texture;
+    }
+    return source;
+}
+
+bool MapWidget::Downsample(SDL_Texture* source, SDL_Texture* target) {
+    SDL_Texture* previous_target = SDL_GetRenderTarget(renderer_);
+    if (SDL_SetRenderTarget(renderer_, target) != 0) {
+        return false;
+    }
+
+    // Linear filtering of a half-size copy averages each 2x2 block. The source
+    // may be the game's texture, so its sampling state is put back afterwards.
+    SDL_ScaleMode scale_mode = SDL_ScaleModeNearest;
+    SDL_BlendMode blend_mode = SDL_BLENDMODE_NONE;
+    SDL_GetTextureScaleMode(source, &scale_mode);
+    SDL_GetTextureBlendMode(source, &blend_mode);
+    SDL_SetTextureScaleMode(source, SDL_ScaleModeLinear);
+    SDL_SetTextureBlendMode(source, SDL_BLENDMODE_NONE);
+    const bool copied = SDL_RenderCopy(renderer_, source, nullptr, nullptr) == 0;
+    SDL_SetTextureScaleMode(source, scale_mode);
+    SDL_SetTextureBlendMode(source, blend_mode);
+
+    SDL_SetRenderTarget(renderer_, previous_target);
+    return copied;
+}
+
+void MapWidget::InvalidateMipChain() {
+    for (MipLevel& mip : mips_) {
+        mip.valid = false;
+    }
+}
+
+void MapWidget::DestroyMipChain() {
+    for (MipLevel& mip : mips_) {
+        if (mip.resource) {
+            gui::resource_manager::Manager::instance().release_resource(mip.resource->get_id());
+        }
+        if (mip.texture) {
+            SDL_DestroyTexture(mip.texture);
+        }
+    }
+    mips_.clear();
+    mip_source_ = nullptr;
+    mip_level_ = 0;
+}
+
 bool MapWidget::GetLastImageRect(ImVec2* min, ImVec2* max) const {
     if (!has_image_rect_ || min == nullptr || max == nullptr) {
         return false;
@@ -3,6 +3,9 @@
 
 #include <SDL.h>
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -10,11 +13,24 @@
 #include "event_bus_adapter.h"
 #include "imgui.h"
 
+namespace gui {
+namespace resource_manager {
+struct AtlasRegion;
+class TextureResource;
+} // namespace resource_manager
+} // namespace gui
+
 struct TileSelection {
     int x = 0;
     int y = 0;
 };
 
+struct TileChange {
+    int x = 0;
+    int y = 0;
+    uint32_t tile_id = 0;
+};
+
 class MapWidget {
 public:
     explicit MapWidget(cataclysm::gui::EventBusAdapter &event_bus_adapter);
@@ -23,6 +39,104 @@ public:
     void Draw();
     void UpdateMapTexture(SDL_Texture* texture, int width, int height, int tiles_w, int tiles_h);
 
+    /**
+     * Maps a tile id to its image in a TextureAtlas; nullptr leaves the cell
+     * empty.
+     */
+    using TileResolver = std::function<const gui::resource_manager::AtlasRegion*(uint32_t tile_id)>;
+
+    /**
+     * Let the widget own the map surface and draw it from atlas tiles.
+     * @param renderer Renderer that owns the atlas textures
+     * @param resolver Looks up the atlas image for a tile id
+     * @param tile_width Width of one cell in the map texture, in pixels
+     * @param tile_height Height of one cell in the map texture, in pixels
+     */
+    void SetTileSource(SDL_Renderer* renderer, TileResolver resolver, int tile_width, int tile_height);
+
+    /**
+     * Replace the whole tile grid. Only cells whose id changed are redrawn,
+     * unless the grid size changes.
+     * @param tiles Row-major tile ids, tiles_w * tiles_h entries
+     */
+    void UpdateTiles(const std::vector<uint32_t>& tiles, int tiles_w, int tiles_h);
+
+    /**
+     * Change individual cells of the current grid. Out-of-range cells are
+     * ignored.
+     */
+    void UpdateTiles(const std::vector<TileChange>& changes);
+
+    /**
+     * Redraw every cell of the widget-owned map surface.
+     */
+    void InvalidateTiles();
+
+    /**
+     * Redraw the map surface and the mip chain, e.g. after
+     * SDL_RENDER_TARGETS_RESET dropped the contents of target textures.
+     */
+    void InvalidateRenderTargets();
+
+    /**
+     * Draw the dirty cells into the map texture. Draw() calls this; it only
+     * needs calling directly to render the map without a frame.
+     * @return Number of cells redrawn
+     */
+    int RedrawDirtyTiles();
+
+    /**
+     * Renderer used for the widget's own textures: the tile surface and the
+     * mip chain built when the map is shown smaller than its texture.
+     */
+    void SetRenderer(SDL_Renderer* renderer);
+
+    /**
+     * @param zoom Magnification relative to fitting the whole map; clamped
+     *        to [1, 64]
+     */
+    void SetZoom(float zoom);
+    [[nodiscard]] float GetZoom() const { return zoom_; }
+
+    /**
+     * Zoom while keeping the map point under normalized_pos in place.
+     * @param factor Multiplier applied to the current zoom
+     * @param normalized_pos Position inside the drawn image, 0..1 per axis
+     */
+    void ZoomAt(float factor, const ImVec2& normalized_pos);
+
+    /**
+     * Move the view by a fraction of the drawn image size.
+     */
+    void Pan(const ImVec2& normalized_delta);
+
+    void ResetView();
+
+    /**
+     * Get the part of the map currently shown, as texture coordinates.
+     */
+    void GetVisibleRegion(ImVec2* uv0, ImVec2* uv1) const;
+
+    /**
+     * Map a position inside the drawn image to a tile at the current zoom.
+     * @param normalized_pos Position inside the drawn image, 0..1 per axis
+     * @return The tile, or nullopt without a tile grid
+     */
+    [[nodiscard]] std::optional<TileSelection> TileAt(const ImVec2& normalized_pos) const;
+
+    /**
+     * Pick the mip level closest to the on-screen size and build the levels
+     * it needs that are out of date. Draw() calls this.
+     * @param draw_size Size of the drawn image in pixels
+     * @return The texture to draw
+     */
+    SDL_Texture* PrepareMipLevel(const ImVec2& draw_size);
+
+    /**
+     * @return Mip level used for the last frame; 0 is the map texture itself
+     */
+    [[nodiscard]] int GetMipLevel() const { return mip_level_; }
+
     [[nodiscard]] const ImVec2 &GetTileSize() const;
     [[nodiscard]] std::optional<TileSelection> GetSelectedTile() const;
     [[nodiscard]] bool GetLastImageRect(ImVec2* min, ImVec2* max) const;
@@ -30,6 +144,7 @@ public:
 private:
     ImVec2 tile_size_;
     std::optional<TileSelection> selected_tile_;
+    std::optional<TileSelection> last_hovered_tile_;
     cataclysm::gui::EventBusAdapter &event_bus_adapter_;
     SDL_Texture* map_texture_ = nullptr;
     ImVec2 texture_size_{0,0};
@@ -38,6 +153,46 @@ private:
     bool has_image_rect_ = false;
     ImVec2 last_image_min_{0.0f, 0.0f};
     ImVec2 last_image_max_{0.0f, 0.0f};
+
+    struct MipLevel {
+        SDL_Texture* texture = nullptr;
+        std::shared_ptr<gui::resource_manager::TextureResource> resource;
+        bool valid = false;
+    };
+
+    void ClampView();
+    bool Downsample(SDL_Texture* source, SDL_Texture* target);
+    void InvalidateMipChain();
+    void DestroyMipChain();
+
+    void MarkTileDirty(int index);
+    bool EnsureTileTexture();
+    void DestroyTileTexture();
+
+    SDL_Renderer* renderer_ = nullptr;
+
+    // View: zoom 1 fits the whole map, view_center_ is in texture coordinates
+    float zoom_ = 1.0f;
+    ImVec2 view_center_{0.5f, 0.5f};
+
+    // Level n is the map texture downsampled by 2^n, redrawn lazily after the
+    // map changes and only down to the level being drawn. The textures are
+    // kept while the map keeps its size.
+    std::vector<MipLevel> mips_;
+    SDL_Texture* mip_source_ = nullptr;
+    ImVec2 mip_base_size_{0.0f, 0.0f};
+    int mip_level_ = 0;
+
+    // Widget-owned map surface (SetTileSource / UpdateTiles)
+    TileResolver tile_resolver_;
+    int tile_width_ = 0;
+    int tile_height_ = 0;
+    bool tile_map_active_ = false;
+    std::vector<uint32_t> tiles_;
+    std::vector<uint8_t> tile_dirty_;
+    std::vector<int> dirty_tiles_;
+    SDL_Texture* tile_texture_ = nullptr;
+    std::shared_ptr<gui::resource_manager::TextureResource> tile_texture_resource_;
 };
 
 #endif // MAP_WIDGET_H
@@ -3,6 +3,7 @@
 
 #include "event_bus.h"
 #include <string>
+#include <string_view>
 
 namespace cataclysm {
 namespace gui {
@@ -10,7 +11,7 @@ namespace gui {
 class UIButtonClickedEvent : public Event {
 public:
     UIButtonClickedEvent(std::string button_id) : button_id(button_id) {}
-    std::string getEventType() const override { return "UIButtonClickedEvent"; }
+    std::string_view getEventType() const override { return "UIButtonClickedEvent"; }
     std::unique_ptr<Event> clone() const override { return std::make_unique<UIButtonClickedEvent>(*this); }
 
     std::string button_id;
@@ -11,7 +11,7 @@ auto make_inventory_click_default() {
 }
 
 auto make_inventory_key_default() {
-    return std::function<void(const SDL_KeyboardEvent&)>([](const SDL_KeyboardEvent&) {});
+    return std::function<void(const SDL_KeyboardEvent&, int)>([](const SDL_KeyboardEvent&, int) {});
 }
 
 auto make_character_tab_default() {
@@ -92,7 +92,7 @@ void OverlayInteractionBridge::register_inventory_subscriptions() {
 
     inventory_key_subscription_ = event_bus_adapter_.subscribe<InventoryKeyInputEvent>(
         [this](const InventoryKeyInputEvent& event) {
-            inventory_key_handler_(event.getKeyEvent());
+            inventory_key_handler_(event.getKeyEvent(), event.getRepeatCount());
         });
 }
 
@@ -124,18 +124,16 @@ void OverlayInteractionBridge::unregister_character_subscriptions() {
     unsubscribe_and_reset(character_command_subscription_);
 }
 
-void OverlayInteractionBridge::unsubscribe_and_reset(std::shared_ptr<EventSubscription>& subscription) {
-    if (subscription) {
-        subscription->unsubscribe();
-        subscription.reset();
-    }
+void OverlayInteractionBridge::unsubscribe_and_reset(EventSubscription& subscription) {
+    subscription.unsubscribe();
 }
 
 void OverlayInteractionBridge::set_inventory_click_handler(std::function<void(const inventory_entry&)> handler) {
     assign_or_default(inventory_click_handler_, std::move(handler), make_inventory_click_default());
 }
 
-void OverlayInteractionBridge::set_inventory_key_handler(std::function<void(const SDL_KeyboardEvent&)> handler) {
+void OverlayInteractionBridge::set_inventory_key_handler(
+    std::function<void(const SDL_KeyboardEvent&, int)> handler) {
     assign_or_default(inventory_key_handler_, std::move(handler), make_inventory_key_default());
 }
 
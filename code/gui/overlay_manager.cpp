@@ -1,12 +1,18 @@
 #include "overlay_manager.h"
 #include "overlay_renderer.h"
+#include "frame_arena.h"
+#include "frame_profiler.h"
+#include "map_stream.h"
+#include "map_widget.h"
 #include "overlay_ui.h"
 #include "event_bus_adapter.h"
 #include "overlay_interaction_bridge.h"
 #include "mock_events.h"
 #include "InventoryWidget.h"
+#include "CharacterWidget.h"
 #include "ui_adaptor.h"
 #include "ui_manager.h"
+#include "resource_manager.h"
 #include <algorithm>
 #include <cstring>
 #include <iostream>
@@ -28,8 +34,28 @@ struct OverlayManager::Impl {
     std::unique_ptr<cataclysm::gui::EventBusAdapter> event_bus_adapter;
     std::unique_ptr<cataclysm::gui::OverlayInteractionBridge> interaction_bridge;
 
+    // Game-written map snapshot (BeginMapStreaming)
+    std::unique_ptr<MapStream> map_stream;
+    int map_stream_tiles_w = 0;
+    int map_stream_tiles_h = 0;
+
     Config config;
     bool is_initialized = false;
+    bool has_subsystems = false;
+
+    // Map state handed over before the UI exists (Config::lazy_init)
+    SDL_Texture* pending_map_texture = nullptr;
+    int pending_map_width = 0;
+    int pending_map_height = 0;
+    int pending_map_tiles_w = 0;
+    int pending_map_tiles_h = 0;
+    MapTileResolver pending_tile_resolver;
+    int pending_tile_width = 0;
+    int pending_tile_height = 0;
+    std::vector<uint32_t> pending_tiles;
+    int pending_tiles_w = 0;
+    int pending_tiles_h = 0;
+    std::optional<std::pair<std::string, float>> pending_font;
     bool is_open = false;
     bool is_focused = false;
     bool is_minimized = false;
@@ -43,14 +69,27 @@ struct OverlayManager::Impl {
     bool overlay_has_focus = false;
     bool pass_through_enabled = true;
     bool inventory_widget_visible_ = false;
-    std::optional<inventory_overlay_state> inventory_state_;
+    std::string inventory_filter_;
+    std::shared_ptr<const inventory_overlay_state> inventory_state_;
+    // Set when inventory_state_ is owned exclusively and may be patched in place.
+    std::shared_ptr<inventory_overlay_state> owned_inventory_state_;
     bool character_widget_visible_ = false;
     std::optional<character_overlay_state> character_state_;
     std::unique_ptr<cataclysm::gui::UiAdaptor> ui_adaptor;
     bool registered_with_ui_manager = false;
 
+    // Idle-frame skipping (Config::skip_idle_frames).
+    bool frame_dirty = true;
+    int settle_frames_remaining = 0;
+    uint64_t skipped_frames = 0;
+
+    // Widget scratch memory for the frame being built, reset after Render()
+    FrameArena frame_arena;
+
+    bool profiler_visible = false;
+
     std::function<void(const inventory_entry&)> inventory_click_handler = [](const inventory_entry&) {};
-    std::function<void(const SDL_KeyboardEvent&)> inventory_key_handler = [](const SDL_KeyboardEvent&) {};
+    std::function<void(const SDL_KeyboardEvent&, int)> inventory_key_handler = [](const SDL_KeyboardEvent&, int) {};
     std::function<void(const std::string&)> character_tab_handler = [](const std::string&) {};
     std::function<void(const std::string&, int)> character_row_handler = [](const std::string&, int) {};
     std::function<void(cataclysm::gui::CharacterCommand)> character_command_handler =
@@ -79,13 +118,220 @@ struct OverlayManager::Impl {
         return true;
     }
 
+    // Only tabs whose row text changed lose their measured layout.
+    void InvalidateChangedCharacterTabs(const character_overlay_state& next) {
+        if (!overlay_ui->HasCharacterWidget()) {
+            return;
+        }
+        CharacterWidget& widget = overlay_ui->GetCharacterWidget();
+        if (!character_state_) {
+            widget.InvalidateTextLayout();
+            return;
+        }
+        for (const auto& tab : next.tabs) {
+            const auto previous = std::find_if(character_state_->tabs.begin(), character_state_->tabs.end(),
+                                               [&](const character_overlay_tab& candidate) {
+                                                   return candidate.id == tab.id;
+                                               });
+            const bool unchanged =
+                previous != character_state_->tabs.end() &&
+                std::equal(tab.rows.begin(), tab.rows.end(), previous->rows.begin(), previous->rows.end(),
+                           [](const character_overlay_column_entry& a, const character_overlay_column_entry& b) {
+                               return a.name == b.name && a.value == b.value;
+                           });
+            if (!unchanged) {
+                widget.InvalidateTextLayout(tab.id);
+            }
+        }
+    }
+
+    void MarkDirty() {
+        frame_dirty = true;
+    }
+
+    bool NeedsFrame() const {
+        // The profiler panel shows live timings, so it keeps frames coming
+        return frame_dirty || settle_frames_remaining > 0 || profiler_visible ||
+               overlay_renderer->WantsContinuousFrames();
+    }
+
+    void DiscardQueuedEvents() {
+        if (event_bus_adapter) {
+            event_bus_adapter->discardQueued();
+        }
+    }
+
     void NotifyRedraw() {
+        MarkDirty();
         cataclysm::gui::UiManager::instance().request_redraw();
         if (redraw_callback) {
             redraw_callback();
         }
     }
 
+    // Inventory text is where translated and player-named strings show up, so
+    // its codepoints drive which glyphs the atlas loads.
+    void RequestEntryGlyphs(const inventory_entry& entry) {
+        overlay_renderer->RequestGlyphs(entry.label);
+        overlay_renderer->RequestGlyphs(entry.hotkey);
+        overlay_renderer->RequestGlyphs(entry.disabled_msg);
+    }
+
+    void RequestInventoryGlyphs(const inventory_overlay_state& state) {
+        if (!overlay_renderer) return;
+
+        overlay_renderer->RequestGlyphs(state.title);
+        overlay_renderer->RequestGlyphs(state.hotkey_hint);
+        overlay_renderer->RequestGlyphs(state.weight_label);
+        overlay_renderer->RequestGlyphs(state.volume_label);
+        overlay_renderer->RequestGlyphs(state.filter_string);
+        for (const auto& column : state.columns) {
+            overlay_renderer->RequestGlyphs(column.name);
+            for (const auto& entry : column.entries) {
+                RequestEntryGlyphs(entry);
+            }
+        }
+    }
+
+    void SetPendingTiles(const std::vector<uint32_t>& tiles, int tiles_w, int tiles_h) {
+        pending_tiles = tiles;
+        pending_tiles_w = tiles_w;
+        pending_tiles_h = tiles_h;
+    }
+
+    void ApplyPendingTileChanges(const std::vector<TileChange>& changes) {
+        for (const TileChange& change : changes) {
+            if (change.x >= 0 && change.x < pending_tiles_w && change.y >= 0 && change.y < pending_tiles_h) {
+                pending_tiles[static_cast<size_t>(change.y) * pending_tiles_w + change.x] = change.tile_id;
+            }
+        }
+    }
+
+    // Hand everything recorded while the subsystems were deferred to the new UI
+    void ApplyPendingState() {
+        MapWidget& map = overlay_ui->GetMapWidget();
+        if (map_stream && map_stream->GetFrontTexture()) {
+            map.UpdateMapTexture(map_stream->GetFrontTexture(), map_stream->GetWidth(), map_stream->GetHeight(),
+                                 map_stream_tiles_w, map_stream_tiles_h);
+        } else if (pending_map_texture) {
+            map.UpdateMapTexture(pending_map_texture, pending_map_width, pending_map_height, pending_map_tiles_w,
+                                 pending_map_tiles_h);
+        }
+        pending_map_texture = nullptr;
+
+        if (pending_tile_resolver) {
+            map.SetTileSource(renderer, std::move(pending_tile_resolver), pending_tile_width, pending_tile_height);
+            pending_tile_resolver = nullptr;
+            if (!pending_tiles.empty()) {
+                map.UpdateTiles(pending_tiles, pending_tiles_w, pending_tiles_h);
+            }
+        }
+        pending_tiles.clear();
+
+        if (pending_font) {
+            overlay_renderer->SetFont(pending_font->first, pending_font->second);
+            pending_font.reset();
+        }
+        if (inventory_state_) {
+            RequestInventoryGlyphs(*inventory_state_);
+            ApplyInventoryFilter();
+        }
+    }
+
+    void SetInventoryState(std::shared_ptr<inventory_overlay_state> state) {
+        RequestInventoryGlyphs(*state);
+        owned_inventory_state_ = state;
+        inventory_state_ = std::move(state);
+        ApplyInventoryFilter();
+        NotifyRedraw();
+    }
+
+    // Re-run the widget's filter against the current state. The widget only
+    // re-indexes when entry labels actually changed.
+    void ApplyInventoryFilter() {
+        if (!overlay_ui || !inventory_state_) {
+            return;
+        }
+        if (inventory_filter_.empty() &&
+            (!overlay_ui->HasInventoryWidget() || !overlay_ui->GetInventoryWidget().IsFiltering())) {
+            return;
+        }
+        overlay_ui->GetInventoryWidget().SetFilter(inventory_filter_, *inventory_state_);
+    }
+
+    bool ApplyEntryPatch(inventory_overlay_state& state, const inventory_entry_patch& patch) {
+        if (patch.column < 0 || patch.column >= static_cast<int>(state.columns.size())) {
+            LogError("Inventory patch column out of range: " + std::to_string(patch.column));
+            return false;
+        }
+
+        auto& entries = state.columns[patch.column].entries;
+        const int size = static_cast<int>(entries.size());
+        const int limit = patch.op == inventory_entry_patch::operation::insert ? size + 1 : size;
+        if (patch.row < 0 || patch.row >= limit) {
+            LogError("Inventory patch row out of range: " + std::to_string(patch.row));
+            return false;
+        }
+
+        switch (patch.op) {
+            case inventory_entry_patch::operation::set_flags:
+                entries[patch.row].is_selected = patch.entry.is_selected;
+                entries[patch.row].is_highlighted = patch.entry.is_highlighted;
+                break;
+            case inventory_entry_patch::operation::replace:
+                entries[patch.row] = patch.entry;
+                if (overlay_renderer) RequestEntryGlyphs(patch.entry);
+                break;
+            case inventory_entry_patch::operation::insert:
+                entries.insert(entries.begin() + patch.row, patch.entry);
+                if (overlay_renderer) RequestEntryGlyphs(patch.entry);
+                break;
+            case inventory_entry_patch::operation::erase:
+                entries.erase(entries.begin() + patch.row);
+                break;
+        }
+        return true;
+    }
+
+    bool PatchInventory(const inventory_overlay_patch& patch) {
+        if (!inventory_state_) {
+            LogError("Inventory patch applied before any inventory state");
+            return false;
+        }
+
+        // Shared snapshots are copied once; afterwards patches apply in place.
+        // inventory_state_ and owned_inventory_state_ account for two references;
+        // any more means a caller still holds the snapshot from GetInventoryState().
+        if (!owned_inventory_state_ || owned_inventory_state_.use_count() > 2) {
+            owned_inventory_state_ = std::make_shared<inventory_overlay_state>(*inventory_state_);
+            inventory_state_ = owned_inventory_state_;
+        }
+
+        inventory_overlay_state& state = *owned_inventory_state_;
+        bool applied = true;
+        for (const auto& entry_patch : patch.entries) {
+            if (!ApplyEntryPatch(state, entry_patch)) {
+                applied = false;
+                break;
+            }
+        }
+        if (applied) {
+            if (patch.active_column) {
+                state.active_column = *patch.active_column;
+            }
+            for (size_t i = 0; i < patch.scroll_positions.size(); ++i) {
+                if (patch.scroll_positions[i]) {
+                    state.columns[i].scroll_position = *patch.scroll_positions[i];
+                }
+            }
+        }
+
+        // Operations before a failing one stay applied, so refilter either way
+        ApplyInventoryFilter();
+        NotifyRedraw();
+        return applied;
+    }
+
     void StartInventoryForwarding() {
         if (!interaction_bridge) {
             return;
@@ -136,11 +382,11 @@ struct OverlayManager::Impl {
         }
     }
 
-    void SetInventoryKeyHandler(std::function<void(const SDL_KeyboardEvent&)> handler) {
+    void SetInventoryKeyHandler(std::function<void(const SDL_KeyboardEvent&, int)> handler) {
         if (handler) {
             inventory_key_handler = std::move(handler);
         } else {
-            inventory_key_handler = [](const SDL_KeyboardEvent&) {};
+            inventory_key_handler = [](const SDL_KeyboardEvent&, int) {};
         }
 
         if (is_open && inventory_widget_visible_) {
@@ -235,6 +481,20 @@ bool OverlayManager::InitializeInternal(const Config& config) {
         return false;
     }
 
+    if (config.lazy_init) {
+        pImpl_->UpdateFocusState();
+        return true;
+    }
+
+    return CreateSubsystems();
+}
+
+bool OverlayManager::CreateSubsystems() {
+    if (pImpl_->has_subsystems) {
+        return true;
+    }
+
+    const Config& config = pImpl_->config;
     pImpl_->overlay_renderer = std::make_unique<OverlayRenderer>();
     if (!pImpl_->overlay_renderer) {
         pImpl_->LogError("Failed to create OverlayRenderer");
@@ -250,34 +510,77 @@ bool OverlayManager::InitializeInternal(const Config& config) {
     pImpl_->overlay_ui = std::make_unique<OverlayUI>(*pImpl_->event_bus_adapter);
     pImpl_->event_bus_adapter->initialize();
     pImpl_->interaction_bridge = std::make_unique<cataclysm::gui::OverlayInteractionBridge>(*pImpl_->event_bus_adapter);
+    pImpl_->overlay_ui->GetMapWidget().SetRenderer(pImpl_->renderer);
 
     pImpl_->event_bus_adapter->subscribe<cataclysm::gui::UIButtonClickedEvent>([](const cataclysm::gui::UIButtonClickedEvent& event) {
         std::cout << "Button clicked event received: " << event.button_id << std::endl;
     });
+    // ToggleManager's "frame_profiler" component switches the profiler panel
+    pImpl_->event_bus_adapter->subscribe<cataclysm::gui::UiComponentToggledEvent>(
+        [this](const cataclysm::gui::UiComponentToggledEvent& event) {
+            if (event.getComponentId() == "frame_profiler") {
+                SetProfilerVisible(event.isVisible() && event.isEnabled());
+            }
+        });
 
     if (!config.ini_filename.empty()) {
         pImpl_->overlay_renderer->SetIniFilename(config.ini_filename);
     }
+    if (!config.layout_ini.empty()) {
+        pImpl_->overlay_renderer->LoadIniSettings(config.layout_ini);
+    }
+    pImpl_->overlay_renderer->SetFontCacheDirectory(config.font_cache_directory);
+
+    // Idle frames are re-composited from the cached target instead of
+    // re-submitting ImGui geometry.
+    pImpl_->overlay_renderer->SetRenderTargetCaching(config.skip_idle_frames);
+    gui::resource_manager::Manager::instance().integrate_with_sdl_renderer(pImpl_->renderer);
 
     pImpl_->UpdateFocusState();
 
     pImpl_->ui_adaptor = std::make_unique<cataclysm::gui::UiAdaptor>();
+    // Redraws are coalesced into the next Render(), which rebuilds the frame
     pImpl_->ui_adaptor->set_redraw_callback([this]() {
-        this->Render();
+        pImpl_->MarkDirty();
     });
     pImpl_->ui_adaptor->set_screen_resize_callback([this](int width, int height) {
         this->OnWindowResized(width, height);
     });
+
+    pImpl_->has_subsystems = true;
+    pImpl_->ApplyPendingState();
+    return true;
+}
+
+bool OverlayManager::Prewarm() {
+    if (!pImpl_->is_initialized) {
+        return false;
+    }
+    if (pImpl_->has_subsystems) {
+        return true;
+    }
+    if (!CreateSubsystems()) {
+        DestroySubsystems();
+        return false;
+    }
     return true;
 }
 
+bool OverlayManager::HasSubsystems() const {
+    return pImpl_->has_subsystems;
+}
+
 void OverlayManager::Shutdown() {
     if (!pImpl_->is_initialized) {
         return;
     }
 
     Close();
+    DestroySubsystems();
+    pImpl_->is_initialized = false;
+}
 
+void OverlayManager::DestroySubsystems() {
     if (pImpl_->ui_adaptor && pImpl_->registered_with_ui_manager) {
         cataclysm::gui::UiManager::instance().unregister_adaptor(*pImpl_->ui_adaptor);
         pImpl_->registered_with_ui_manager = false;
@@ -289,28 +592,82 @@ void OverlayManager::Shutdown() {
         pImpl_->interaction_bridge.reset();
     }
 
+    // Widgets hold a reference to the adapter
+    pImpl_->overlay_ui.reset();
+
     if (pImpl_->event_bus_adapter) {
         pImpl_->event_bus_adapter->shutdown();
         pImpl_->event_bus_adapter.reset();
     }
 
+    pImpl_->map_stream.reset();
+
     if (pImpl_->overlay_renderer) {
         pImpl_->overlay_renderer->Shutdown();
         pImpl_->overlay_renderer.reset();
     }
 
-    pImpl_->is_initialized = false;
+    gui::resource_manager::Manager::instance().integrate_with_sdl_renderer(nullptr);
+    pImpl_->has_subsystems = false;
+}
+
+namespace {
+constexpr int kIdleSettleFrames = 2;
 }
 
 void OverlayManager::Render() {
+    GUI_PROFILE_FRAME();
+    GUI_PROFILE_ZONE("OverlayManager::Render");
+
+    // Gameplay events posted from worker threads are delivered here, on the UI
+    // thread, even while the overlay is hidden so the channel never backs up.
+    if (pImpl_->event_bus_adapter) {
+        pImpl_->event_bus_adapter->dispatchPosted();
+    } else if (pImpl_->is_initialized) {
+        // Subsystems deferred by Config::lazy_init; drain the global bus directly
+        cataclysm::gui::EventBusManager::getGlobalEventBus().dispatchPosted();
+    }
+
+    // Every request_redraw() since the last frame is answered here, once
+    cataclysm::gui::UiManager::instance().dispatch_redraws();
+
+    // Input queued while no frame is built would otherwise be delivered after
+    // the next Open() or restore
     if (!pImpl_->is_initialized || !pImpl_->config.enabled || !pImpl_->is_open) {
+        pImpl_->DiscardQueuedEvents();
         return;
     }
 
     if (pImpl_->config.minimize_pause && pImpl_->is_minimized) {
+        pImpl_->DiscardQueuedEvents();
         return;
     }
 
+    // Textures decoded in the background are uploaded within a per-frame
+    // budget; a frame that gains textures is rebuilt to show them.
+    if (gui::resource_manager::Manager::instance().process_uploads() > 0) {
+        pImpl_->MarkDirty();
+    }
+
+    if (pImpl_->config.skip_idle_frames && !pImpl_->NeedsFrame()) {
+        pImpl_->overlay_renderer->RenderCached();
+        ++pImpl_->skipped_frames;
+        if (pImpl_->event_bus_adapter) {
+            pImpl_->event_bus_adapter->flush();
+        }
+        return;
+    }
+
+    // ImGui resolves hover and layout changes a frame or two after the input
+    // that caused them, so keep building frames briefly after each change.
+    if (pImpl_->frame_dirty) {
+        pImpl_->frame_dirty = false;
+        pImpl_->settle_frames_remaining = kIdleSettleFrames;
+    } else if (pImpl_->settle_frames_remaining > 0) {
+        --pImpl_->settle_frames_remaining;
+    }
+
+    FrameArena::Scope arena_scope(&pImpl_->frame_arena);
     pImpl_->overlay_renderer->NewFrame();
     pImpl_->overlay_ui->Draw();
     if (pImpl_->inventory_widget_visible_ && pImpl_->inventory_state_) {
@@ -319,7 +676,25 @@ void OverlayManager::Render() {
     if (pImpl_->character_widget_visible_ && pImpl_->character_state_) {
         pImpl_->overlay_ui->DrawCharacter(*pImpl_->character_state_);
     }
+    if (pImpl_->profiler_visible) {
+        FrameProfiler::Get().DrawPanel(&pImpl_->profiler_visible);
+        if (!pImpl_->profiler_visible) {
+            FrameProfiler::Get().SetEnabled(false); // Closed from its title bar
+        }
+    }
     pImpl_->overlay_renderer->Render();
+
+    // Widgets queue their interaction events while the frame is being built;
+    // deliver them in one batch now that drawing is finished.
+    if (pImpl_->event_bus_adapter) {
+        pImpl_->event_bus_adapter->flush();
+    }
+
+    gui::resource_manager::Manager::instance().periodic_cleanup();
+
+    // Everything the widgets took from the arena, including input handled
+    // since the last frame, is released together
+    pImpl_->frame_arena.Reset();
 }
 
 void OverlayManager::UpdateMapTexture(SDL_Texture* texture, int width, int height, int tiles_w, int tiles_h) {
@@ -328,20 +703,148 @@ void OverlayManager::UpdateMapTexture(SDL_Texture* texture, int width, int heigh
     }
     if (pImpl_->overlay_ui) {
         pImpl_->overlay_ui->UpdateMapTexture(texture, width, height, tiles_w, tiles_h);
+    } else {
+        pImpl_->pending_map_texture = texture;
+        pImpl_->pending_map_width = width;
+        pImpl_->pending_map_height = height;
+        pImpl_->pending_map_tiles_w = tiles_w;
+        pImpl_->pending_map_tiles_h = tiles_h;
+    }
+    pImpl_->MarkDirty();
+}
+
+MapStream* OverlayManager::BeginMapStreaming(int width, int height, int tiles_w, int tiles_h) {
+    if (!pImpl_->is_initialized || !pImpl_->config.enabled) {
+        return nullptr;
+    }
+
+    auto& stream = pImpl_->map_stream;
+    if (!stream || stream->GetWidth() != width || stream->GetHeight() != height) {
+        if (pImpl_->overlay_ui && stream) {
+            // The widget must not draw a texture that is about to be destroyed
+            pImpl_->overlay_ui->UpdateMapTexture(nullptr, 0, 0, 0, 0);
+        }
+        stream = std::make_unique<MapStream>(pImpl_->renderer, width, height);
+        if (!stream->IsValid()) {
+            LogError("Failed to create map stream textures");
+            stream.reset();
+            return nullptr;
+        }
+    }
+    pImpl_->map_stream_tiles_w = tiles_w;
+    pImpl_->map_stream_tiles_h = tiles_h;
+    return stream.get();
+}
+
+void OverlayManager::PresentMapStream() {
+    auto& stream = pImpl_->map_stream;
+    if (!pImpl_->is_initialized || !stream || !stream->Present()) {
+        return;
+    }
+    if (pImpl_->overlay_ui) {
+        pImpl_->overlay_ui->UpdateMapTexture(stream->GetFrontTexture(), stream->GetWidth(), stream->GetHeight(),
+                                             pImpl_->map_stream_tiles_w, pImpl_->map_stream_tiles_h);
+    }
+    pImpl_->MarkDirty();
+}
+
+void OverlayManager::StopMapStreaming() {
+    if (!pImpl_->map_stream) {
+        return;
+    }
+    if (pImpl_->overlay_ui) {
+        pImpl_->overlay_ui->UpdateMapTexture(nullptr, 0, 0, 0, 0);
+    }
+    pImpl_->map_stream.reset();
+    pImpl_->MarkDirty();
+}
+
+void OverlayManager::SetMapTileSource(MapTileResolver resolver, int tile_width, int tile_height) {
+    if (!pImpl_->is_initialized) {
+        return;
+    }
+    if (!pImpl_->overlay_ui) {
+        pImpl_->pending_tile_resolver = std::move(resolver);
+        pImpl_->pending_tile_width = tile_width;
+        pImpl_->pending_tile_height = tile_height;
+        return;
     }
+    pImpl_->overlay_ui->GetMapWidget().SetTileSource(pImpl_->renderer, std::move(resolver), tile_width, tile_height);
+    pImpl_->MarkDirty();
+}
+
+void OverlayManager::UpdateMapTiles(const std::vector<uint32_t>& tiles, int tiles_w, int tiles_h) {
+    if (!pImpl_->is_initialized || !pImpl_->config.enabled) {
+        return;
+    }
+    if (!pImpl_->overlay_ui) {
+        pImpl_->SetPendingTiles(tiles, tiles_w, tiles_h);
+        return;
+    }
+    pImpl_->overlay_ui->GetMapWidget().UpdateTiles(tiles, tiles_w, tiles_h);
+    pImpl_->MarkDirty();
+}
+
+void OverlayManager::UpdateMapTiles(const std::vector<TileChange>& changes) {
+    if (!pImpl_->is_initialized || !pImpl_->config.enabled) {
+        return;
+    }
+    if (!pImpl_->overlay_ui) {
+        pImpl_->ApplyPendingTileChanges(changes);
+        return;
+    }
+    pImpl_->overlay_ui->GetMapWidget().UpdateTiles(changes);
+    pImpl_->MarkDirty();
 }
 
 void OverlayManager::UpdateInventory(const inventory_overlay_state& state) {
-    pImpl_->inventory_state_ = state;
+    pImpl_->SetInventoryState(std::make_shared<inventory_overlay_state>(state));
+}
+
+void OverlayManager::UpdateInventory(inventory_overlay_state&& state) {
+    pImpl_->SetInventoryState(std::make_shared<inventory_overlay_state>(std::move(state)));
+}
+
+void OverlayManager::UpdateInventory(std::shared_ptr<const inventory_overlay_state> state) {
+    if (state) {
+        pImpl_->RequestInventoryGlyphs(*state);
+    }
+    pImpl_->owned_inventory_state_.reset();
+    pImpl_->inventory_state_ = std::move(state);
+    pImpl_->ApplyInventoryFilter();
+    pImpl_->NotifyRedraw();
+}
+
+void OverlayManager::SetInventoryFilter(const std::string& filter_text) {
+    if (filter_text == pImpl_->inventory_filter_) {
+        return;
+    }
+    pImpl_->inventory_filter_ = filter_text;
+    pImpl_->ApplyInventoryFilter();
     pImpl_->NotifyRedraw();
 }
 
+const std::string& OverlayManager::GetInventoryFilter() const {
+    return pImpl_->inventory_filter_;
+}
+
+bool OverlayManager::PatchInventory(const inventory_overlay_patch& patch) {
+    return pImpl_->PatchInventory(patch);
+}
+
+std::shared_ptr<const inventory_overlay_state> OverlayManager::GetInventoryState() const {
+    return pImpl_->inventory_state_;
+}
+
 void OverlayManager::ShowInventory() {
     if (pImpl_->inventory_widget_visible_) {
         return;
     }
 
     pImpl_->inventory_widget_visible_ = true;
+    if (pImpl_->overlay_ui) {
+        pImpl_->overlay_ui->GetInventoryWidget();
+    }
     if (pImpl_->is_open) {
         pImpl_->StartInventoryForwarding();
     }
@@ -368,6 +871,9 @@ bool OverlayManager::IsInventoryVisible() const {
 }
 
 void OverlayManager::UpdateCharacter(const character_overlay_state& state) {
+    if (pImpl_->overlay_ui) {
+        pImpl_->InvalidateChangedCharacterTabs(state);
+    }
     pImpl_->character_state_ = state;
     pImpl_->NotifyRedraw();
 }
@@ -378,6 +884,9 @@ void OverlayManager::ShowCharacter() {
     }
 
     pImpl_->character_widget_visible_ = true;
+    if (pImpl_->overlay_ui) {
+        pImpl_->overlay_ui->GetCharacterWidget();
+    }
     if (pImpl_->is_open) {
         pImpl_->StartCharacterForwarding();
     }
@@ -439,7 +948,7 @@ void OverlayManager::SetInventoryClickHandler(std::function<void(const inventory
     pImpl_->SetInventoryClickHandler(std::move(handler));
 }
 
-void OverlayManager::SetInventoryKeyHandler(std::function<void(const SDL_KeyboardEvent&)> handler) {
+void OverlayManager::SetInventoryKeyHandler(std::function<void(const SDL_KeyboardEvent&, int)> handler) {
     if (!pImpl_) {
         return;
     }
@@ -499,15 +1008,25 @@ bool OverlayManager::HandleEvent(const SDL_Event& event) {
             }
             pImpl_->UpdateFocusState();
             break;
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            // Target textures lost their contents
+            if (pImpl_->overlay_ui) {
+                pImpl_->overlay_ui->GetMapWidget().InvalidateRenderTargets();
+                pImpl_->MarkDirty();
+            }
+            break;
     }
 
     if (pImpl_->overlay_has_focus && pImpl_->overlay_renderer) {
+        FrameArena::Scope arena_scope(&pImpl_->frame_arena);
+        pImpl_->MarkDirty();
         const bool renderer_consumed = pImpl_->overlay_renderer->HandleEvent(event);
 
         bool widget_consumed = false;
         if (pImpl_->overlay_ui) {
             if (pImpl_->inventory_widget_visible_ && pImpl_->inventory_state_) {
-                widget_consumed = pImpl_->overlay_ui->GetInventoryWidget().HandleEvent(event) || widget_consumed;
+                widget_consumed = pImpl_->overlay_ui->GetInventoryWidget().HandleEvent(event, *pImpl_->inventory_state_) || widget_consumed;
             }
             if (pImpl_->character_widget_visible_ && pImpl_->character_state_) {
                 widget_consumed = pImpl_->overlay_ui->GetCharacterWidget().HandleEvent(
@@ -550,6 +1069,10 @@ void OverlayManager::Open() {
         return;
     }
 
+    if (!Prewarm()) {
+        return;
+    }
+
     pImpl_->is_open = true;
     pImpl_->UpdateFocusState();
 
@@ -583,6 +1106,8 @@ void OverlayManager::Close() {
 
     pImpl_->StopInventoryForwarding();
     pImpl_->StopCharacterForwarding();
+    // Clicks and keys from this session must not reach the host after the next Open()
+    pImpl_->DiscardQueuedEvents();
 
     if (pImpl_->event_bus_adapter) {
         pImpl_->event_bus_adapter->publishOverlayClose(kOverlayLifecycleId, false);
@@ -625,14 +1150,19 @@ bool OverlayManager::IsMinimized() const {
 void OverlayManager::SetFocused(bool focused) {
     pImpl_->is_focused = focused;
     pImpl_->UpdateFocusState();
+    pImpl_->MarkDirty();
 }
 
 void OverlayManager::OnWindowResized(int width, int height) {
-    if (!pImpl_->is_initialized || !pImpl_->overlay_renderer) {
+    if (!pImpl_->is_initialized) {
         return;
     }
 
-    pImpl_->overlay_renderer->OnWindowResized(width, height);
+    // A renderer built later by lazy init reads the window size itself, but
+    // the host still needs to hear about the resize now
+    if (pImpl_->overlay_renderer) {
+        pImpl_->overlay_renderer->OnWindowResized(width, height);
+    }
 
     if (pImpl_->resize_callback) {
         pImpl_->resize_callback(width, height);
@@ -641,6 +1171,68 @@ void OverlayManager::OnWindowResized(int width, int height) {
     pImpl_->NotifyRedraw();
 }
 
+void OverlayManager::SetDPIScale(float dpi_scale) {
+    if (!pImpl_->is_initialized) {
+        return;
+    }
+    if (dpi_scale <= 0.0f || dpi_scale > 10.0f) {
+        LogError("Invalid DPI scale");
+        return;
+    }
+    if (dpi_scale == pImpl_->config.dpi_scale) {
+        return;
+    }
+
+    // A renderer built later by lazy init starts at the new scale
+    pImpl_->config.dpi_scale = dpi_scale;
+    if (pImpl_->overlay_renderer) {
+        pImpl_->overlay_renderer->SetDPIScale(dpi_scale);
+    }
+    pImpl_->NotifyRedraw();
+}
+
+void OverlayManager::SetFont(const std::string& family, float size_pixels) {
+    if (!pImpl_->is_initialized) {
+        return;
+    }
+    if (!pImpl_->overlay_renderer) {
+        pImpl_->pending_font.emplace(family, size_pixels);
+        return;
+    }
+
+    pImpl_->overlay_renderer->SetFont(family, size_pixels);
+    pImpl_->NotifyRedraw();
+}
+
+void OverlayManager::MarkDirty() {
+    pImpl_->MarkDirty();
+}
+
+uint64_t OverlayManager::GetSkippedFrameCount() const {
+    return pImpl_->skipped_frames;
+}
+
+bool OverlayManager::IsRenderTargetCacheValid() const {
+    return pImpl_->overlay_renderer && pImpl_->overlay_renderer->IsRenderTargetCacheValid();
+}
+
+const FrameArena& OverlayManager::GetFrameArena() const {
+    return pImpl_->frame_arena;
+}
+
+void OverlayManager::SetProfilerVisible(bool visible) {
+    if (pImpl_->profiler_visible == visible) {
+        return;
+    }
+    pImpl_->profiler_visible = visible;
+    FrameProfiler::Get().SetEnabled(visible);
+    pImpl_->MarkDirty();
+}
+
+bool OverlayManager::IsProfilerVisible() const {
+    return pImpl_->profiler_visible;
+}
+
 void OverlayManager::RegisterRedrawCallback(RedrawCallback callback) {
     pImpl_->redraw_callback = callback;
 }
@@ -2,11 +2,18 @@
 #define OVERLAY_MANAGER_H
 
 #include <SDL.h>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <functional>
+#include <vector>
 
+class FrameArena;
+class MapStream;
+struct TileChange;
 struct inventory_entry;
+struct inventory_overlay_state;
+struct inventory_overlay_patch;
 
 namespace cataclysm {
 namespace gui {
@@ -14,6 +21,12 @@ enum class CharacterCommand;
 } // namespace gui
 } // namespace cataclysm
 
+namespace gui {
+namespace resource_manager {
+struct AtlasRegion;
+} // namespace resource_manager
+} // namespace gui
+
 class OverlayManager {
 public:
     struct Impl;
@@ -23,7 +36,20 @@ public:
         bool pass_through_input = true;
         float dpi_scale = 1.0f;
         bool minimize_pause = true;
+        // Only rebuild the overlay after state updates, input or ImGui activity;
+        // idle frames re-composite the previous frame instead.
+        bool skip_idle_frames = false;
         std::string ini_filename;
+        // Window layout in ini form, e.g. from a startup snapshot; when set it
+        // is loaded instead of reading ini_filename at startup.
+        std::string layout_ini;
+        // Rasterized font atlases are kept here between sessions; empty
+        // keeps them in memory only.
+        std::string font_cache_directory;
+        // Initialize() only records the window, renderer and config. The
+        // renderer, UI and event plumbing are built on the first Open() or
+        // Prewarm(), and each widget when it is first shown.
+        bool lazy_init = false;
 
         Config() = default;
     };
@@ -36,7 +62,74 @@ public:
     void Render();
 
     void UpdateMapTexture(SDL_Texture* texture, int width, int height, int tiles_w, int tiles_h);
+
+    /**
+     * Let the game write map pixels into overlay-owned streaming textures
+     * instead of rendering a full snapshot each turn. Write changed tiles
+     * through the returned stream, then call PresentMapStream(). Calling
+     * again with the same size keeps the current stream.
+     * @return The stream to write into, or nullptr if it could not be created
+     */
+    MapStream* BeginMapStreaming(int width, int height, int tiles_w, int tiles_h);
+
+    /**
+     * Upload the rects written since the last call and show them.
+     */
+    void PresentMapStream();
+
+    /**
+     * Destroy the map stream. UpdateMapTexture() is used for the map again.
+     */
+    void StopMapStreaming();
+
+    using MapTileResolver = std::function<const gui::resource_manager::AtlasRegion*(uint32_t tile_id)>;
+
+    /**
+     * Have the map widget draw the map itself from atlas tiles, so a turn
+     * only costs a blit per changed cell. See MapWidget::SetTileSource().
+     * The atlas stays with the caller, which has to upload its images again
+     * after SDL_RENDER_TARGETS_RESET; HandleEvent() redraws the overlay's own
+     * textures from them.
+     */
+    void SetMapTileSource(MapTileResolver resolver, int tile_width, int tile_height);
+
+    /**
+     * Replace the tile grid; only cells whose id changed are redrawn.
+     * @param tiles Row-major tile ids, tiles_w * tiles_h entries
+     */
+    void UpdateMapTiles(const std::vector<uint32_t>& tiles, int tiles_w, int tiles_h);
+
+    /**
+     * Change individual cells, e.g. where monsters moved this turn.
+     */
+    void UpdateMapTiles(const std::vector<TileChange>& changes);
     void UpdateInventory(const struct inventory_overlay_state& state);
+    void UpdateInventory(inventory_overlay_state&& state);
+
+    /**
+     * Share an immutable snapshot instead of copying it. The overlay keeps a
+     * reference until the next update; a later PatchInventory() copies it once.
+     */
+    void UpdateInventory(std::shared_ptr<const inventory_overlay_state> state);
+
+    /**
+     * Apply entry-level changes to the current inventory state, costing
+     * O(changed entries) rather than a full update.
+     * @return false if there is no inventory state or an operation is out of
+     *         range; operations before the failing one stay applied
+     */
+    bool PatchInventory(const inventory_overlay_patch& patch);
+
+    std::shared_ptr<const inventory_overlay_state> GetInventoryState() const;
+
+    /**
+     * Filter the inventory widget to entries whose label contains
+     * filter_text. The filter is kept across inventory updates and patches;
+     * each application publishes a UiFilterAppliedEvent with the matches.
+     * @param filter_text Text to match, ignoring ASCII case; empty shows all rows
+     */
+    void SetInventoryFilter(const std::string& filter_text);
+    const std::string& GetInventoryFilter() const;
     void ShowInventory();
     void HideInventory();
     bool IsInventoryVisible() const;
@@ -52,7 +145,11 @@ public:
     void StopCharacterForwarding();
 
     void SetInventoryClickHandler(std::function<void(const inventory_entry&)> handler);
-    void SetInventoryKeyHandler(std::function<void(const SDL_KeyboardEvent&)> handler);
+    /**
+     * @param handler Receives each forwarded key and how many times it was
+     *        pressed in a row, e.g. the steps of one wheel burst
+     */
+    void SetInventoryKeyHandler(std::function<void(const SDL_KeyboardEvent&, int)> handler);
     void SetCharacterTabHandler(std::function<void(const std::string&)> handler);
     void SetCharacterRowHandler(std::function<void(const std::string&, int)> handler);
     void SetCharacterCommandHandler(std::function<void(cataclysm::gui::CharacterCommand)> handler);
@@ -61,6 +158,18 @@ public:
 
     void Open();
 
+    /**
+     * Build the subsystems deferred by Config::lazy_init ahead of the first
+     * Open(), e.g. on an idle frame. Does nothing once they exist.
+     * @return false if they could not be created
+     */
+    bool Prewarm();
+
+    /**
+     * @return true once the renderer, UI and event plumbing exist
+     */
+    bool HasSubsystems() const;
+
     void Close();
 
     bool IsOpen() const;
@@ -75,6 +184,55 @@ public:
 
     void OnWindowResized(int width, int height);
 
+    /**
+     * Change the DPI scale, e.g. when the window moves to another display.
+     * Fonts are rasterized again for the new scale and the cached frame is
+     * rebuilt on the next Render().
+     * @param dpi_scale New scale, in (0, 10] like Config::dpi_scale
+     */
+    void SetDPIScale(float dpi_scale);
+
+    /**
+     * Change the overlay font, e.g. after GUISettings::setFontFamily() or
+     * setFontSize(). Atlases built before are restored from the font cache.
+     * @param family Path to a TTF file; empty selects ImGui's built-in font
+     * @param size_pixels Font size before DPI scaling
+     */
+    void SetFont(const std::string& family, float size_pixels);
+
+    /**
+     * Force the next Render() to rebuild the overlay, e.g. for a game-driven
+     * animation. Only meaningful with Config::skip_idle_frames.
+     */
+    void MarkDirty();
+
+    /**
+     * @return Number of Render() calls that reused the previous frame
+     */
+    uint64_t GetSkippedFrameCount() const;
+
+    /**
+     * @return true if the last frame is cached in a render target, so idle
+     *         frames are redrawn with a single copy
+     */
+    bool IsRenderTargetCacheValid() const;
+
+    /**
+     * Scratch memory for strings and buffers widgets need only while a frame
+     * is built. Installed as FrameArena::Current() during Render() and
+     * HandleEvent(), and reset after each rendered frame.
+     * @return The overlay's frame arena
+     */
+    const FrameArena& GetFrameArena() const;
+
+    /**
+     * Show or hide the frame profiler panel. Zones are recorded while it is
+     * shown. Toggling ToggleManager's "frame_profiler" component calls this
+     * through the UiComponentToggledEvent it publishes.
+     */
+    void SetProfilerVisible(bool visible);
+    bool IsProfilerVisible() const;
+
     using RedrawCallback = std::function<void()>;
     using ResizeCallback = std::function<void(int, int)>;
 
@@ -96,6 +254,10 @@ private:
 
     bool InitializeInternal(const Config& config);
 
+    bool CreateSubsystems();
+
+    void DestroySubsystems();
+
     bool ValidateConfig(const Config& config) const;
 
     void LogError(const std::string& error) const;
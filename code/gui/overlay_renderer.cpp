@@ -2,6 +2,10 @@
 #include <iostream>
 #include <cstring>
 
+#include "font_atlas_cache.h"
+#include "frame_profiler.h"
+#include "resource_manager.h"
+
 #include "imgui.h"
 #include "backends/imgui_impl_sdl2.h"
 #include "backends/imgui_impl_sdlrenderer2.h"
@@ -21,9 +25,29 @@ struct OverlayRenderer::Impl {
     std::string log_filename;
     bool docking_enabled = false;
     bool viewports_enabled = false;
-    
+
+    // Offscreen copy of the last overlay frame; rebuilt lazily after a resize
+    // or DPI change.
+    bool cache_render_target = false;
+    SDL_Texture* render_target = nullptr;
+    int render_target_width = 0;
+    int render_target_height = 0;
+    bool render_target_valid = false;
+
+    // The render target is registered with the resource manager so its VRAM
+    // shows up in the GUI memory statistics and counts against the limit.
+    std::string render_target_resource_id =
+        gui::resource_manager::utilities::generate_unique_id("overlay_target");
+    std::shared_ptr<gui::resource_manager::TextureResource> render_target_resource;
+
+    // Font atlases are restored from the cache when the font, size, DPI or
+    // glyph set returns to one seen before, here or in an earlier session.
+    gui::resource_manager::FontAtlasCache font_cache;
+    gui::resource_manager::FontAtlasKey font_key;
+    bool font_atlas_dirty = true;
+
     std::string last_error;
-    
+
     Impl() = default;
     ~Impl() = default;
     
@@ -70,8 +94,123 @@ struct OverlayRenderer::Impl {
         if (!io) return;
         
         dpi_scale = scale;
-        io->FontGlobalScale = dpi_scale;
         io->DisplayFramebufferScale = ImVec2(scale, scale);
+
+        // Glyphs are rasterized at the DPI scale instead of being stretched
+        // through FontGlobalScale.
+        font_key.scale = scale;
+        font_atlas_dirty = true;
+        DestroyRenderTarget();
+    }
+
+    bool LoadFontAtlas() {
+        if (!io || !io->Fonts) return false;
+
+        font_atlas_dirty = false;
+        bool loaded = font_cache.load(font_key, *io->Fonts);
+        if (!loaded && !font_key.family.empty()) {
+            LogError("Failed to load font '" + font_key.family + "', using the default font");
+            font_key.family.clear();
+            loaded = font_cache.load(font_key, *io->Fonts);
+        }
+        if (!loaded) {
+            LogError("Failed to build font atlas");
+            return false;
+        }
+
+        io->FontGlobalScale = 1.0f;
+        io->FontDefault = nullptr;
+
+        // The backend uploads the new atlas on its next NewFrame()
+        ImGui_ImplSDLRenderer2_DestroyFontsTexture();
+        DestroyRenderTarget();
+        return true;
+    }
+
+    void DestroyRenderTarget() {
+        if (render_target_resource) {
+            gui::resource_manager::Manager::instance().release_resource(render_target_resource_id);
+            render_target_resource.reset();
+        }
+        if (render_target) {
+            SDL_DestroyTexture(render_target);
+            render_target = nullptr;
+        }
+        render_target_width = 0;
+        render_target_height = 0;
+        render_target_valid = false;
+    }
+
+    bool EnsureRenderTarget() {
+        if (!cache_render_target || !renderer || !SDL_RenderTargetSupported(renderer)) {
+            return false;
+        }
+
+        int width = 0;
+        int height = 0;
+        if (SDL_GetRendererOutputSize(renderer, &width, &height) != 0 || width <= 0 || height <= 0) {
+            return false;
+        }
+        if (render_target && width == render_target_width && height == render_target_height) {
+            return true;
+        }
+
+        DestroyRenderTarget();
+        render_target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                          width, height);
+        if (!render_target) {
+            LogError(std::string("Failed to create overlay render target: ") + SDL_GetError());
+            cache_render_target = false;
+            return false;
+        }
+
+        // ImGui blends into a transparent target, leaving premultiplied colour;
+        // composite it with matching factors so translucent panels stay correct.
+        const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        if (SDL_SetTextureBlendMode(render_target, premultiplied) != 0) {
+            SDL_SetTextureBlendMode(render_target, SDL_BLENDMODE_BLEND);
+        }
+
+        render_target_width = width;
+        render_target_height = height;
+        render_target_resource = gui::resource_manager::Manager::instance().get_texture(
+            render_target_resource_id, [this](const std::string& id) {
+                return std::make_shared<gui::resource_manager::TextureResource>(
+                    id, reinterpret_cast<ImTextureID>(render_target), static_cast<uint32_t>(render_target_width),
+                    static_cast<uint32_t>(render_target_height));
+            });
+        return true;
+    }
+
+    bool RenderDrawDataToTarget(ImDrawData* draw_data) {
+        if (!EnsureRenderTarget()) {
+            return false;
+        }
+
+        SDL_Texture* previous_target = SDL_GetRenderTarget(renderer);
+        Uint8 r = 0, g = 0, b = 0, a = 0;
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+
+        if (SDL_SetRenderTarget(renderer, render_target) != 0) {
+            LogError(std::string("Failed to bind overlay render target: ") + SDL_GetError());
+            DestroyRenderTarget();
+            cache_render_target = false;
+            return false;
+        }
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        ImGui_ImplSDLRenderer2_RenderDrawData(draw_data, renderer);
+
+        SDL_SetRenderTarget(renderer, previous_target);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+        render_target_valid = true;
+        return true;
+    }
+
+    void CompositeRenderTarget() {
+        SDL_RenderCopy(renderer, render_target, nullptr, nullptr);
     }
 };
 
@@ -142,6 +281,7 @@ void OverlayRenderer::Shutdown() {
         return;
     }
     
+    pImpl_->DestroyRenderTarget();
     ImGui_ImplSDLRenderer2_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     
@@ -156,27 +296,78 @@ void OverlayRenderer::Shutdown() {
 }
 
 void OverlayRenderer::NewFrame() {
+    GUI_PROFILE_ZONE("OverlayRenderer::NewFrame");
     if (!pImpl_->is_initialized || !pImpl_->has_context) {
         return;
     }
     
+    // Atlas changes have to land between frames, before the backend uploads
+    // the font texture.
+    if (pImpl_->font_cache.merge_missing_glyphs(pImpl_->font_key)) {
+        pImpl_->font_atlas_dirty = true;
+    }
+    if (pImpl_->font_atlas_dirty) {
+        pImpl_->LoadFontAtlas();
+    }
+
     ImGui_ImplSDLRenderer2_NewFrame();
     ImGui_ImplSDL2_NewFrame();
     ImGui::NewFrame();
 }
 
 void OverlayRenderer::Render() {
+    GUI_PROFILE_ZONE("OverlayRenderer::Render");
     if (!pImpl_->is_initialized || !pImpl_->has_context) {
         return;
     }
     
     ImGui::Render();
     ImDrawData* draw_data = ImGui::GetDrawData();
-    if (draw_data) {
+    if (!draw_data) {
+        return;
+    }
+
+    if (pImpl_->RenderDrawDataToTarget(draw_data)) {
+        pImpl_->CompositeRenderTarget();
+    } else {
+        ImGui_ImplSDLRenderer2_RenderDrawData(draw_data, pImpl_->renderer);
+    }
+}
+
+void OverlayRenderer::RenderCached() {
+    if (!pImpl_->is_initialized || !pImpl_->has_context) {
+        return;
+    }
+
+    if (pImpl_->render_target_valid) {
+        pImpl_->CompositeRenderTarget();
+        return;
+    }
+
+    // Draw data stays valid until the next NewFrame().
+    ImDrawData* draw_data = ImGui::GetDrawData();
+    if (draw_data && draw_data->Valid) {
         ImGui_ImplSDLRenderer2_RenderDrawData(draw_data, pImpl_->renderer);
     }
 }
 
+bool OverlayRenderer::WantsContinuousFrames() const {
+    if (!pImpl_->is_initialized || !pImpl_->io) {
+        return false;
+    }
+
+    const ImGuiIO& io = *pImpl_->io;
+    if (io.WantTextInput) {
+        return true;
+    }
+    for (bool down : io.MouseDown) {
+        if (down) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool OverlayRenderer::HandleEvent(const SDL_Event& event) {
     if (!pImpl_->is_initialized || !pImpl_->has_context) {
         return false;
@@ -196,6 +387,26 @@ void OverlayRenderer::OnWindowResized(int width, int height) {
     }
     
     pImpl_->io->DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+    pImpl_->DestroyRenderTarget();
+}
+
+void OverlayRenderer::SetDPIScale(float dpi_scale) {
+    if (!pImpl_->is_initialized || dpi_scale <= 0.0f) {
+        return;
+    }
+
+    pImpl_->ApplyDPISettings(dpi_scale);
+}
+
+void OverlayRenderer::SetRenderTargetCaching(bool enabled) {
+    pImpl_->cache_render_target = enabled;
+    if (!enabled) {
+        pImpl_->DestroyRenderTarget();
+    }
+}
+
+bool OverlayRenderer::IsRenderTargetCacheValid() const {
+    return pImpl_->render_target_valid;
 }
 
 void OverlayRenderer::SetIniFilename(const std::string& filename) {
@@ -210,6 +421,14 @@ void OverlayRenderer::SetIniFilename(const std::string& filename) {
     }
 }
 
+void OverlayRenderer::LoadIniSettings(const std::string& ini) {
+    if (!pImpl_->is_initialized || !pImpl_->has_context) {
+        return;
+    }
+
+    ImGui::LoadIniSettingsFromMemory(ini.data(), ini.size());
+}
+
 void OverlayRenderer::SetLogFilename(const std::string& filename) {
     pImpl_->log_filename = filename;
     
@@ -267,9 +486,27 @@ void OverlayRenderer::RebuildFontAtlas() {
         return;
     }
     
-    if (pImpl_->io && pImpl_->io->Fonts) {
-        pImpl_->io->Fonts->Clear();
-        pImpl_->io->Fonts->AddFontDefault();
-        pImpl_->io->Fonts->Build();
+    pImpl_->LoadFontAtlas();
+}
+
+void OverlayRenderer::SetFont(const std::string& family, float size_pixels) {
+    if (size_pixels <= 0.0f) {
+        pImpl_->LogError("Font size must be positive");
+        return;
+    }
+    if (pImpl_->font_key.family != family) {
+        // Glyphs merged for another font say nothing about this one
+        pImpl_->font_key.ranges.clear();
     }
+    pImpl_->font_key.family = family;
+    pImpl_->font_key.size_pixels = size_pixels;
+    pImpl_->font_atlas_dirty = true;
+}
+
+void OverlayRenderer::SetFontCacheDirectory(const std::string& directory) {
+    pImpl_->font_cache.set_directory(directory);
+}
+
+void OverlayRenderer::RequestGlyphs(const std::string& text) {
+    pImpl_->font_cache.request_glyphs(text);
 }
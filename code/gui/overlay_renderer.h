@@ -19,12 +19,53 @@ public:
 
     void Render();
 
+    /**
+     * Draw the last rendered frame again without building a new one.
+     * Used on idle frames when nothing in the overlay has changed. With
+     * render-target caching this is a single texture copy.
+     */
+    void RenderCached();
+
+    /**
+     * Render ImGui into an offscreen SDL_Texture and composite that over the
+     * current target, so unchanged frames can be redrawn with one copy.
+     * Falls back to direct rendering when the renderer lacks target support.
+     * @param enabled Whether to cache the overlay in a render target
+     */
+    void SetRenderTargetCaching(bool enabled);
+
+    /**
+     * @return true if the last frame was rendered into the cached target
+     */
+    bool IsRenderTargetCacheValid() const;
+
+    /**
+     * @return true while ImGui is mid-interaction (text input, drags) and
+     *         needs new frames even without fresh input events
+     */
+    bool WantsContinuousFrames() const;
+
     bool HandleEvent(const SDL_Event& event);
 
     void OnWindowResized(int width, int height);
 
+    /**
+     * Change the DPI scale, e.g. after the window moved to another display.
+     * Glyphs are rasterized again at the next NewFrame().
+     * @param dpi_scale New scale; values <= 0 are ignored
+     */
+    void SetDPIScale(float dpi_scale);
+
     void SetIniFilename(const std::string& filename);
 
+    /**
+     * Load window layout from ini text already in memory, e.g. a startup
+     * snapshot. Called before the first frame, ImGui then skips reading the
+     * ini file; the file is still written when the layout changes.
+     * @param ini Layout in ImGui's ini format
+     */
+    void LoadIniSettings(const std::string& ini);
+
     void SetLogFilename(const std::string& filename);
 
     void SetDockingEnabled(bool enabled);
@@ -39,8 +80,34 @@ public:
 
     bool HasContext() const;
 
+    /**
+     * Load the atlas for the current font settings, restoring it from the
+     * font cache when that configuration has been built before.
+     */
     void RebuildFontAtlas();
 
+    /**
+     * Select the overlay font. Takes effect at the next NewFrame().
+     * @param family Path to a TTF file; empty selects ImGui's built-in font
+     * @param size_pixels Font size before DPI scaling
+     */
+    void SetFont(const std::string& family, float size_pixels);
+
+    /**
+     * Store rasterized font atlases in a directory so later sessions skip
+     * rasterization. Set before the first frame to benefit at startup.
+     * @param directory Cache directory; empty keeps the cache in memory
+     */
+    void SetFontCacheDirectory(const std::string& directory);
+
+    /**
+     * Make sure the font can draw the given UTF-8 text. Codepoints outside
+     * the loaded glyph ranges are merged into the atlas at the next
+     * NewFrame(), so large scripts such as CJK are only rasterized as used.
+     * @param text UTF-8 text about to be displayed
+     */
+    void RequestGlyphs(const std::string& text);
+
     OverlayRenderer();
     ~OverlayRenderer();
     OverlayRenderer(const OverlayRenderer&) = delete;
@@ -56,8 +123,6 @@ private:
 
     void SetupImGuiConfig();
 
-    void ApplyDPISettings(float dpi_scale);
-
     void LogError(const std::string& error);
 };
 
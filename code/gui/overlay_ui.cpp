@@ -8,8 +8,6 @@
 
 OverlayUI::OverlayUI(cataclysm::gui::EventBusAdapter &event_bus_adapter)
     : map_widget_(std::make_unique<MapWidget>(event_bus_adapter)),
-      inventory_widget_(std::make_unique<InventoryWidget>(event_bus_adapter)),
-      character_widget_(std::make_unique<CharacterWidget>(event_bus_adapter)),
       event_bus_adapter_(event_bus_adapter) {}
 
 OverlayUI::~OverlayUI() = default;
@@ -20,11 +18,11 @@ void OverlayUI::Draw() {
 }
 
 void OverlayUI::DrawInventory(const inventory_overlay_state& state) {
-    inventory_widget_->Draw(state);
+    GetInventoryWidget().Draw(state);
 }
 
 void OverlayUI::DrawCharacter(const character_overlay_state &state) {
-    character_widget_->Draw(state);
+    GetCharacterWidget().Draw(state);
 }
 
 void OverlayUI::UpdateMapTexture(SDL_Texture* texture, int width, int height, int tiles_w, int tiles_h) {
@@ -36,9 +34,15 @@ MapWidget& OverlayUI::GetMapWidget() {
 }
 
 InventoryWidget& OverlayUI::GetInventoryWidget() {
+    if (!inventory_widget_) {
+        inventory_widget_ = std::make_unique<InventoryWidget>(event_bus_adapter_);
+    }
     return *inventory_widget_;
 }
 
 CharacterWidget& OverlayUI::GetCharacterWidget() {
+    if (!character_widget_) {
+        character_widget_ = std::make_unique<CharacterWidget>(event_bus_adapter_);
+    }
     return *character_widget_;
 }
@@ -29,8 +29,11 @@ public:
     void UpdateMapTexture(SDL_Texture* texture, int width, int height, int tiles_w, int tiles_h);
 
     MapWidget& GetMapWidget();
+    // The inventory and character widgets are created on first access
     InventoryWidget& GetInventoryWidget();
     CharacterWidget& GetCharacterWidget();
+    bool HasInventoryWidget() const { return inventory_widget_ != nullptr; }
+    bool HasCharacterWidget() const { return character_widget_ != nullptr; }
 
 private:
     std::unique_ptr<MapWidget> map_widget_;
@@ -3,11 +3,15 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
-#include <fstream>
-#include <iostream>
-#include <thread>
+#include <cctype>
+#include <cstdlib>
+#include <ostream>
 #include <chrono>
 
+#include <SDL.h>
+
+#include "debug.h"
+
 namespace gui {
 
 namespace resource_manager {
@@ -49,18 +53,27 @@ TextureResource::TextureResource(const std::string& id, ImTextureID texture, uin
 }
 
 TextureResource::~TextureResource() {
-    // Texture cleanup is handled by the underlying graphics system
-    // This destructor ensures proper RAII behavior
+    destroy_texture();
+}
+
+void TextureResource::destroy_texture() {
+    // Textures handed in by callers belong to the graphics system; ones the
+    // manager created itself carry a deleter
+    if (deleter_ && texture_ != ImTextureID{}) {
+        deleter_(texture_);
+    }
+    texture_ = ImTextureID{};
 }
 
 // FontResource implementation
 FontResource::FontResource(const std::string& id, ImFont* font)
     : Resource(id, ResourceType::Font)
-    , font_(font) {
-    
+    , font_(font)
+    , glyphs_(font) {
+
     if (font_) {
-        // Approximate font memory usage
-        set_size(font_->MetricsTotalSize);
+        // Approximate font memory usage from its share of the RGBA atlas
+        set_size(static_cast<uint64_t>(font_->MetricsTotalSurface) * 4);
     }
     update_last_access();
 }
@@ -68,16 +81,25 @@ FontResource::FontResource(const std::string& id, ImFont* font)
 bool FontResource::supports_text(const std::string& text) const {
     if (!font_) return false;
     
-    ImGuiIO& io = ImGui::GetIO();
-    for (unsigned char c : text) {
-        if (c == 0) break;
-        if (font_->FindGlyph(c) == nullptr) {
+    for (size_t offset = 0; offset < text.size();) {
+        const uint32_t codepoint = utilities::next_codepoint(text, offset);
+        if (codepoint == 0) break;
+        if (!glyphs_.contains(codepoint)) {
             return false;
         }
     }
     return true;
 }
 
+// GlyphSet implementation
+GlyphSet::GlyphSet(const ImFont* font) {
+    if (!font) return;
+    
+    for (const ImFontGlyph& glyph : font->Glyphs) {
+        insert(glyph.Codepoint);
+    }
+}
+
 // ShaderResource implementation
 ShaderResource::ShaderResource(const std::string& id, const std::string& vertex_source, const std::string& fragment_source)
     : Resource(id, ResourceType::Shader)
@@ -128,123 +150,312 @@ Manager& Manager::instance() {
     return instance_;
 }
 
-std::shared_ptr<TextureResource> Manager::get_texture(const std::string& id, const TextureCreator& creator) {
+Manager::~Manager() {
+    stop_loaders();
+}
+
+template<typename T>
+std::shared_ptr<T> Manager::get_pooled_resource(
+    const std::string& id,
+    ResourceType type,
+    ResourcePool<T>& pool,
+    const std::function<std::shared_ptr<T>(const std::string&)>& creator) {
+    
     if (id.empty() || !creator) return nullptr;
     
-    std::shared_ptr<TextureResource> resource;
+    // Tracked resources are served without touching the pool or the creator
+    {
+        std::shared_lock<std::shared_mutex> lock(resources_mutex_);
+        auto it = resources_.find(id);
+        if (it != resources_.end()) {
+            if (it->second->get_type() != type) return nullptr;
+            touch(*it->second);
+            return std::static_pointer_cast<T>(it->second);
+        }
+    }
     
-    // Try pool first
-    resource = texture_pool_.get(id);
+    // A released resource still referenced elsewhere comes back from the pool
+    auto resource = pool.get(id);
     if (resource) {
-        resource->update_last_access();
-        return resource;
+        stats_.pool_hits++;
+    } else {
+        stats_.pool_misses++;
+        resource = creator(id);
+        if (!resource) return nullptr;
     }
     
-    // Create new resource
-    resource = creator(id);
-    if (resource) {
+    {
         std::unique_lock<std::shared_mutex> lock(resources_mutex_);
         
-        // Check if resource already exists
+        // Another thread may have stored it meanwhile
         auto it = resources_.find(id);
         if (it != resources_.end()) {
-            // Resource exists, use it
-            return std::static_pointer_cast<TextureResource>(it->second);
+            if (it->second->get_type() != type) return nullptr;
+            touch(*it->second);
+            return std::static_pointer_cast<T>(it->second);
         }
         
-        // Store new resource
-        resources_[id] = resource;
-        update_memory_stats(ResourceType::Texture, resource->get_size(), true);
+        resource->update_last_access();
+        insert_locked(id, resource);
     }
     
+    enforce_memory_limit();
     return resource;
 }
 
+std::shared_ptr<TextureResource> Manager::get_texture(const std::string& id, const TextureCreator& creator) {
+    return get_pooled_resource<TextureResource>(id, ResourceType::Texture, texture_pool_, creator);
+}
+
 std::shared_ptr<FontResource> Manager::get_font(const std::string& id, const FontCreator& creator) {
-    if (id.empty() || !creator) return nullptr;
+    return get_pooled_resource<FontResource>(id, ResourceType::Font, font_pool_, creator);
+}
+
+std::shared_ptr<ShaderResource> Manager::get_shader(const std::string& id, const ShaderCreator& creator) {
+    return get_pooled_resource<ShaderResource>(id, ResourceType::Shader, shader_pool_, creator);
+}
+
+std::shared_ptr<BufferResource> Manager::get_buffer(const std::string& id, ResourceType type, const BufferCreator& creator) {
+    return get_pooled_resource<BufferResource>(id, type, buffer_pool_, creator);
+}
+
+std::shared_ptr<TextureRequest> Manager::request_texture(const std::string& id, const ImageDecoder& decoder) {
+    if (id.empty() || !decoder) return nullptr;
     
-    std::shared_ptr<FontResource> resource;
+    {
+        std::shared_lock<std::shared_mutex> lock(resources_mutex_);
+        auto it = resources_.find(id);
+        if (it != resources_.end()) {
+            if (it->second->get_type() != ResourceType::Texture) return nullptr;
+            touch(*it->second);
+            auto request = std::make_shared<TextureRequest>(id);
+            request->texture_ = std::static_pointer_cast<TextureResource>(it->second);
+            request->state_.store(TextureRequest::State::Ready, std::memory_order_release);
+            return request;
+        }
+    }
     
-    // Try pool first
-    resource = font_pool_.get(id);
-    if (resource) {
-        resource->update_last_access();
-        return resource;
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    auto in_flight = in_flight_requests_.find(id);
+    if (in_flight != in_flight_requests_.end()) {
+        return in_flight->second;
     }
     
-    // Create new resource
-    resource = creator(id);
-    if (resource) {
-        std::unique_lock<std::shared_mutex> lock(resources_mutex_);
-        
-        auto it = resources_.find(id);
-        if (it != resources_.end()) {
-            return std::static_pointer_cast<FontResource>(it->second);
+    auto request = std::make_shared<TextureRequest>(id);
+    request->decoder_ = decoder;
+    request->generation_ = upload_generation_.load();
+    in_flight_requests_.emplace(id, request);
+    load_queue_.push_back(request);
+    stats_.pending_loads++;
+    
+    start_loaders_locked();
+    load_cv_.notify_one();
+    return request;
+}
+
+size_t Manager::process_uploads() {
+    if (!renderer_) return 0;
+    
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t uploaded_bytes = 0;
+    size_t uploaded = 0;
+    
+    for (;;) {
+        std::shared_ptr<TextureRequest> request;
+        {
+            std::lock_guard<std::mutex> lock(upload_mutex_);
+            if (upload_queue_.empty()) break;
+            
+            const uint64_t next_bytes = upload_queue_.front()->image_.pixels.size();
+            if (uploaded > 0 && (uploaded_bytes + next_bytes > upload_budget_bytes_ ||
+                                 std::chrono::steady_clock::now() - start >= upload_budget_time_)) {
+                break;
+            }
+            request = std::move(upload_queue_.front());
+            upload_queue_.pop_front();
         }
         
-        resources_[id] = resource;
-        update_memory_stats(ResourceType::Font, resource->get_size(), true);
+        uploaded_bytes += request->image_.pixels.size();
+        upload(*request);
+        uploaded++;
     }
     
-    return resource;
+    if (uploaded > 0) {
+        enforce_memory_limit();
+    }
+    return uploaded;
 }
 
-std::shared_ptr<ShaderResource> Manager::get_shader(const std::string& id, const ShaderCreator& creator) {
-    if (id.empty() || !creator) return nullptr;
-    
-    std::shared_ptr<ShaderResource> resource;
+void Manager::set_upload_budget(uint64_t bytes_per_frame, std::chrono::microseconds time_per_frame) {
+    std::lock_guard<std::mutex> lock(upload_mutex_);
+    upload_budget_bytes_ = bytes_per_frame;
+    upload_budget_time_ = time_per_frame;
+}
+
+void Manager::set_loader_threads(size_t count) {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    loader_thread_count_ = std::max<size_t>(count, 1);
+}
+
+void Manager::start_loaders_locked() {
+    if (!loader_threads_.empty() || stopping_loaders_) return;
     
-    // Try pool first
-    resource = shader_pool_.get(id);
-    if (resource) {
-        resource->update_last_access();
-        return resource;
+    for (size_t i = 0; i < loader_thread_count_; ++i) {
+        loader_threads_.emplace_back(&Manager::loader_main, this);
+    }
+}
+
+void Manager::stop_loaders() {
+    {
+        std::lock_guard<std::mutex> lock(load_mutex_);
+        stopping_loaders_ = true;
     }
+    load_cv_.notify_all();
     
-    // Create new resource
-    resource = creator(id);
-    if (resource) {
-        std::unique_lock<std::shared_mutex> lock(resources_mutex_);
+    for (std::thread& thread : loader_threads_) {
+        thread.join();
+    }
+    loader_threads_.clear();
+}
+
+void Manager::loader_main() {
+    for (;;) {
+        std::shared_ptr<TextureRequest> request;
+        {
+            std::unique_lock<std::mutex> lock(load_mutex_);
+            load_cv_.wait(lock, [this] { return stopping_loaders_ || !load_queue_.empty(); });
+            if (stopping_loaders_) return;
+            
+            request = std::move(load_queue_.front());
+            load_queue_.pop_front();
+        }
         
-        auto it = resources_.find(id);
-        if (it != resources_.end()) {
-            return std::static_pointer_cast<ShaderResource>(it->second);
+        DecodedImage image;
+        const bool decoded = request->decoder_(request->id_, image) && image.width > 0 && image.height > 0 &&
+                             image.pixels.size() >= static_cast<size_t>(image.width) * image.height * 4;
+        if (!decoded) {
+            debuglog(DebugLevel::Warning, "Resource Manager: failed to decode texture '", request->id_, "'");
+            finish_request(*request, TextureRequest::State::Failed);
+            continue;
         }
         
-        resources_[id] = resource;
-        update_memory_stats(ResourceType::Shader, resource->get_size(), true);
+        std::unique_lock<std::mutex> lock(upload_mutex_);
+        if (request->generation_ != upload_generation_.load()) {
+            // The renderer it was meant for went away while it decoded
+            lock.unlock();
+            finish_request(*request, TextureRequest::State::Failed);
+            continue;
+        }
+        stats_.pending_upload_bytes += image.pixels.size();
+        request->image_ = std::move(image);
+        request->state_.store(TextureRequest::State::Decoded, std::memory_order_release);
+        upload_queue_.push_back(std::move(request));
     }
-    
-    return resource;
 }
 
-std::shared_ptr<BufferResource> Manager::get_buffer(const std::string& id, ResourceType type, const BufferCreator& creator) {
-    if (id.empty() || !creator) return nullptr;
+void Manager::upload(TextureRequest& request) {
+    DecodedImage image = std::move(request.image_);
+    stats_.pending_upload_bytes -= image.pixels.size();
     
-    std::shared_ptr<BufferResource> resource;
+    SDL_Renderer* renderer = static_cast<SDL_Renderer*>(renderer_);
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                             static_cast<int>(image.width), static_cast<int>(image.height));
+    if (!texture || SDL_UpdateTexture(texture, nullptr, image.pixels.data(), static_cast<int>(image.width * 4)) != 0) {
+        debuglog(DebugLevel::Warning, "Resource Manager: failed to upload texture '", request.id_, "': ", SDL_GetError());
+        if (texture) {
+            SDL_DestroyTexture(texture);
+        }
+        finish_request(request, TextureRequest::State::Failed);
+        return;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
     
-    // Try pool first
-    resource = buffer_pool_.get(id);
-    if (resource) {
-        resource->update_last_access();
-        return resource;
+    auto resource = std::make_shared<TextureResource>(
+        request.id_, reinterpret_cast<ImTextureID>(texture), image.width, image.height);
+    resource->set_deleter([](ImTextureID id) {
+        SDL_DestroyTexture(reinterpret_cast<SDL_Texture*>(id));
+    });
+    
+    {
+        std::unique_lock<std::shared_mutex> lock(resources_mutex_);
+        auto it = resources_.find(request.id_);
+        if (it == resources_.end()) {
+            insert_locked(request.id_, resource);
+        } else if (it->second->get_type() == ResourceType::Texture) {
+            // A synchronous get_texture() got there first; keep its resource
+            resource = std::static_pointer_cast<TextureResource>(it->second);
+        } else {
+            resource.reset();
+        }
     }
     
-    // Create new resource
-    resource = creator(id);
-    if (resource) {
+    if (!resource) {
+        finish_request(request, TextureRequest::State::Failed);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(request.mutex_);
+        request.texture_ = resource;
+    }
+    finish_request(request, TextureRequest::State::Ready);
+}
+
+void Manager::finish_request(TextureRequest& request, TextureRequest::State state) {
+    request.decoder_ = nullptr;
+    request.state_.store(state, std::memory_order_release);
+    stats_.pending_loads--;
+    
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    auto it = in_flight_requests_.find(request.id_);
+    // A discarded request may finish after a new one for the same id started
+    if (it != in_flight_requests_.end() && it->second.get() == &request) {
+        in_flight_requests_.erase(it);
+    }
+}
+
+void Manager::discard_requests() {
+    std::deque<std::shared_ptr<TextureRequest>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex_);
+        upload_generation_++;
+        dropped.swap(upload_queue_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(load_mutex_);
+        dropped.insert(dropped.end(), load_queue_.begin(), load_queue_.end());
+        load_queue_.clear();
+        // Requests still decoding are failed by their loader thread
+        in_flight_requests_.clear();
+    }
+    
+    for (const auto& request : dropped) {
+        stats_.pending_upload_bytes -= request->image_.pixels.size();
+        request->image_ = DecodedImage{};
+        finish_request(*request, TextureRequest::State::Failed);
+    }
+}
+
+void Manager::release_owned_textures() {
+    std::vector<std::shared_ptr<TextureResource>> released;
+    {
         std::unique_lock<std::shared_mutex> lock(resources_mutex_);
-        
-        auto it = resources_.find(id);
-        if (it != resources_.end()) {
-            return std::static_pointer_cast<BufferResource>(it->second);
+        for (const auto& pair : resources_) {
+            if (pair.second->get_type() != ResourceType::Texture) continue;
+            auto texture = std::static_pointer_cast<TextureResource>(pair.second);
+            if (texture->owns_texture()) {
+                released.push_back(std::move(texture));
+            }
+        }
+        for (const auto& texture : released) {
+            release_locked(*texture);
         }
-        
-        resources_[id] = resource;
-        update_memory_stats(type, resource->get_size(), true);
     }
     
-    return resource;
+    // Handles held elsewhere keep the resource, but not the texture
+    for (const auto& texture : released) {
+        texture->destroy_texture();
+    }
 }
 
 std::shared_ptr<Resource> Manager::get_resource(const std::string& id) {
@@ -254,7 +465,7 @@ std::shared_ptr<Resource> Manager::get_resource(const std::string& id) {
     auto it = resources_.find(id);
     
     if (it != resources_.end()) {
-        it->second->update_last_access();
+        touch(*it->second);
         return it->second;
     }
     
@@ -275,36 +486,7 @@ void Manager::release_resource(const std::string& id) {
     auto it = resources_.find(id);
     
     if (it != resources_.end()) {
-        auto resource = it->second;
-        
-        // Update statistics
-        update_memory_stats(resource->get_type(), resource->get_size(), false);
-        
-        // Release to appropriate pool
-        switch (resource->get_type()) {
-            case ResourceType::Texture:
-                if (auto tex = std::dynamic_pointer_cast<TextureResource>(resource)) {
-                    texture_pool_.release(id, tex);
-                }
-                break;
-            case ResourceType::Font:
-                if (auto font = std::dynamic_pointer_cast<FontResource>(resource)) {
-                    font_pool_.release(id, font);
-                }
-                break;
-            case ResourceType::Shader:
-                if (auto shader = std::dynamic_pointer_cast<ShaderResource>(resource)) {
-                    shader_pool_.release(id, shader);
-                }
-                break;
-            default:
-                if (auto buffer = std::dynamic_pointer_cast<BufferResource>(resource)) {
-                    buffer_pool_.release(id, buffer);
-                }
-                break;
-        }
-        
-        resources_.erase(it);
+        release_locked(*it->second);
     }
 }
 
@@ -312,21 +494,17 @@ void Manager::validate_resources() {
     std::unique_lock<std::shared_mutex> lock(resources_mutex_);
     
     for (auto it = resources_.begin(); it != resources_.end();) {
-        auto resource = it->second;
+        Resource& resource = *it->second;
         
         // Check if resource is still valid
         bool is_valid = true;
         
-        switch (resource->get_type()) {
+        switch (resource.get_type()) {
             case ResourceType::Texture:
-                if (auto tex = std::dynamic_pointer_cast<TextureResource>(resource)) {
-                    is_valid = tex->get_texture() != nullptr;
-                }
+                is_valid = static_cast<TextureResource&>(resource).get_texture() != ImTextureID{};
                 break;
             case ResourceType::Font:
-                if (auto font = std::dynamic_pointer_cast<FontResource>(resource)) {
-                    is_valid = font->get_font() != nullptr;
-                }
+                is_valid = static_cast<FontResource&>(resource).get_font() != nullptr;
                 break;
             default:
                 // For other resource types, assume they're valid if they exist
@@ -334,7 +512,9 @@ void Manager::validate_resources() {
         }
         
         if (!is_valid) {
-            update_memory_stats(resource->get_type(), resource->get_size(), false);
+            update_memory_stats(resource.get_type(), resource.get_size(), false);
+            lru_unlink(resource);
+            resource.lru_key_ = nullptr;
             it = resources_.erase(it);
         } else {
             ++it;
@@ -343,43 +523,11 @@ void Manager::validate_resources() {
 }
 
 void Manager::cleanup_stale_resources(std::chrono::seconds timeout) {
-    auto now = std::chrono::steady_clock::now();
-    
     std::unique_lock<std::shared_mutex> lock(resources_mutex_);
     
-    for (auto it = resources_.begin(); it != resources_.end();) {
-        auto resource = it->second;
-        
-        if (resource->is_stale(timeout)) {
-            // Release to pool instead of deleting
-            switch (resource->get_type()) {
-                case ResourceType::Texture:
-                    if (auto tex = std::dynamic_pointer_cast<TextureResource>(resource)) {
-                        texture_pool_.release(it->first, tex);
-                    }
-                    break;
-                case ResourceType::Font:
-                    if (auto font = std::dynamic_pointer_cast<FontResource>(resource)) {
-                        font_pool_.release(it->first, font);
-                    }
-                    break;
-                case ResourceType::Shader:
-                    if (auto shader = std::dynamic_pointer_cast<ShaderResource>(resource)) {
-                        shader_pool_.release(it->first, shader);
-                    }
-                    break;
-                default:
-                    if (auto buffer = std::dynamic_pointer_cast<BufferResource>(resource)) {
-                        buffer_pool_.release(it->first, buffer);
-                    }
-                    break;
-            }
-            
-            update_memory_stats(resource->get_type(), resource->get_size(), false);
-            it = resources_.erase(it);
-        } else {
-            ++it;
-        }
+    // The tail is the least recently used, so stop at the first fresh resource
+    while (lru_tail_ && lru_tail_->is_stale(timeout)) {
+        release_locked(*lru_tail_);
     }
 }
 
@@ -389,9 +537,14 @@ void Manager::clear_all_resources() {
     // Clear all resources
     for (auto& pair : resources_) {
         update_memory_stats(pair.second->get_type(), pair.second->get_size(), false);
+        pair.second->lru_prev_ = nullptr;
+        pair.second->lru_next_ = nullptr;
+        pair.second->lru_key_ = nullptr;
     }
     
     resources_.clear();
+    lru_head_ = nullptr;
+    lru_tail_ = nullptr;
     
     // Clean up pools
     texture_pool_.cleanup();
@@ -415,29 +568,34 @@ void Manager::cleanup_pools() {
 }
 
 void Manager::log_resource_usage() const {
-    auto stats = get_stats();
-    
-    std::cout << "=== GUI Resource Manager Statistics ===\n";
-    std::cout << "Total Allocated: " << utilities::format_memory_size(stats.total_allocated) << "\n";
-    std::cout << "Total Freed: " << utilities::format_memory_size(stats.total_freed) << "\n";
-    std::cout << "Current Usage: " << utilities::format_memory_size(stats.current_usage()) << "\n";
-    std::cout << "Active Textures: " << stats.active_textures << "\n";
-    std::cout << "Active Fonts: " << stats.active_fonts << "\n";
-    std::cout << "Active Shaders: " << stats.active_shaders << "\n";
-    std::cout << "Active Buffers: " << stats.active_buffers << "\n";
-    std::cout << "Pool Efficiency: " << std::fixed << std::setprecision(1) << stats.pool_efficiency() << "%\n";
-    std::cout << "Pool Hits: " << stats.pool_hits << "\n";
-    std::cout << "Pool Misses: " << stats.pool_misses << "\n";
-    
-    std::cout << "\n=== Pool Statistics ===\n";
-    std::cout << "Texture Pool: " << texture_pool_.get_available_count() << " available\n";
-    std::cout << "Font Pool: " << font_pool_.get_available_count() << " available\n";
-    std::cout << "Shader Pool: " << shader_pool_.get_available_count() << " available\n";
-    std::cout << "Buffer Pool: " << buffer_pool_.get_available_count() << " available\n";
+    const MemoryStats& stats = get_stats();
+    std::ostringstream out;
+    
+    out << "=== GUI Resource Manager Statistics ===\n";
+    out << "Total Allocated: " << utilities::format_memory_size(stats.total_allocated) << "\n";
+    out << "Total Freed: " << utilities::format_memory_size(stats.total_freed) << "\n";
+    out << "Current Usage: " << utilities::format_memory_size(stats.current_usage()) << "\n";
+    out << "Active Textures: " << stats.active_textures << "\n";
+    out << "Active Fonts: " << stats.active_fonts << "\n";
+    out << "Active Shaders: " << stats.active_shaders << "\n";
+    out << "Active Buffers: " << stats.active_buffers << "\n";
+    out << "Pool Efficiency: " << std::fixed << std::setprecision(1) << stats.pool_efficiency() << "%\n";
+    out << "Pool Hits: " << stats.pool_hits << "\n";
+    out << "Pool Misses: " << stats.pool_misses << "\n";
+    out << "Pending Loads: " << stats.pending_loads << " ("
+        << utilities::format_memory_size(stats.pending_upload_bytes) << " awaiting upload)\n";
+    
+    out << "\n=== Pool Statistics ===\n";
+    out << "Texture Pool: " << texture_pool_.get_available_count() << " available\n";
+    out << "Font Pool: " << font_pool_.get_available_count() << " available\n";
+    out << "Shader Pool: " << shader_pool_.get_available_count() << " available\n";
+    out << "Buffer Pool: " << buffer_pool_.get_available_count() << " available\n";
+    
+    debuglog(DebugLevel::Info, out.str());
 }
 
 void Manager::generate_memory_report(std::ostream& report) const {
-    auto stats = get_stats();
+    const MemoryStats& stats = get_stats();
     
     report << "GUI Resource Manager Memory Report\n";
     report << "==================================\n\n";
@@ -464,6 +622,11 @@ void Manager::generate_memory_report(std::ostream& report) const {
     report << "Pool Hits: " << stats.pool_hits << "\n";
     report << "Pool Misses: " << stats.pool_misses << "\n\n";
     
+    report << "Asynchronous Loads:\n";
+    report << "-------------------\n";
+    report << "Pending Loads: " << stats.pending_loads << "\n";
+    report << "Awaiting Upload: " << utilities::format_memory_size(stats.pending_upload_bytes) << "\n\n";
+    
     report << "Pool Statistics:\n";
     report << "---------------\n";
     report << "Texture Pool: " << texture_pool_.get_available_count() << " available (" 
@@ -498,7 +661,13 @@ void Manager::integrate_with_ui_manager() {
 }
 
 void Manager::integrate_with_sdl_renderer(void* renderer) {
-    // This would integrate with SDL2 renderer for texture management
+    // Asynchronously loaded textures are created on this renderer by
+    // process_uploads(); nullptr pauses uploads
+    if (renderer_ && renderer != renderer_) {
+        discard_requests();
+        release_owned_textures();
+    }
+    renderer_ = renderer;
 }
 
 void Manager::integrate_with_input_system() {
@@ -544,96 +713,112 @@ void Manager::update_memory_stats(ResourceType type, uint64_t size, bool allocat
 }
 
 bool Manager::check_memory_limit(uint64_t additional_size) const {
-    uint64_t current_usage = stats_.current_usage();
-    return (current_usage + additional_size) <= memory_limit_;
+    // Decoded images waiting for upload already have their memory committed
+    return (stats_.projected_usage() + additional_size) <= memory_limit_;
 }
 
 void Manager::enforce_memory_limit() {
-    uint64_t current_usage = stats_.current_usage();
+    if (stats_.projected_usage() <= memory_limit_) return;
     
-    if (current_usage > memory_limit_) {
-        // Clean up stale resources first
-        cleanup_stale_resources(std::chrono::seconds(60)); // Shorter timeout for memory pressure
-        
-        current_usage = stats_.current_usage();
-        
-        if (current_usage > memory_limit_) {
-            // If still over limit, clean all pools
-            cleanup_pools();
-            
-            current_usage = stats_.current_usage();
-            
-            if (current_usage > memory_limit_) {
-                // Last resort: clear least recently used resources
-                std::vector<std::pair<std::string, std::shared_ptr<Resource>>> resources_copy;
-                {
-                    std::shared_lock<std::shared_mutex> lock(resources_mutex_);
-                    resources_copy.reserve(resources_.size());
-                    for (const auto& pair : resources_) {
-                        resources_copy.emplace_back(pair.first, pair.second);
-                    }
-                }
-                
-                // Sort by last access time (oldest first)
-                std::sort(resources_copy.begin(), resources_copy.end(),
-                    [](const auto& a, const auto& b) {
-                        return a.second->get_last_access() < b.second->get_last_access();
-                    });
-                
-                // Remove oldest resources until under limit
-                for (const auto& pair : resources_copy) {
-                    release_resource(pair.first);
-                    current_usage = stats_.current_usage();
-                    if (current_usage <= memory_limit_) {
-                        break;
-                    }
-                }
-            }
-        }
+    // Evict from the cold end of the recency list until under the limit,
+    // counting decoded images still waiting for upload; stale resources are
+    // the first to go. The most recent one is kept so the caller that just
+    // asked for it gets a live resource.
+    std::unique_lock<std::shared_mutex> lock(resources_mutex_);
+    while (lru_tail_ && lru_tail_ != lru_head_ && stats_.projected_usage() > memory_limit_) {
+        release_locked(*lru_tail_);
     }
 }
 
-template<typename T>
-std::shared_ptr<T> Manager::get_pooled_resource(
-    const std::string& id,
-    ResourceType type,
-    ResourcePool<T>& pool,
-    const std::function<std::shared_ptr<T>(const std::string&)>& creator) {
-    
-    if (id.empty() || !creator) return nullptr;
-    
-    // Try pool first
-    auto resource = pool.get(id);
-    if (resource) {
-        resource->update_last_access();
-        return resource;
+void Manager::periodic_cleanup() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_cleanup_ >= cleanup_interval_) {
+        last_cleanup_ = now;
+        cleanup_stale_resources();
+        cleanup_pools();
     }
+    enforce_memory_limit();
+}
+
+void Manager::insert_locked(const std::string& id, const std::shared_ptr<Resource>& resource) {
+    auto result = resources_.emplace(id, resource);
+    resource->lru_key_ = &result.first->first;
+    lru_push_front(*resource);
+    update_memory_stats(resource->get_type(), resource->get_size(), true);
+}
+
+void Manager::release_locked(Resource& resource) {
+    auto it = resources_.find(*resource.lru_key_);
+    // Keep the resource alive past the erase; the pool only holds a weak reference
+    std::shared_ptr<Resource> owned = it->second;
     
-    // Create new resource
-    resource = creator(id);
-    if (resource) {
-        std::unique_lock<std::shared_mutex> lock(resources_mutex_);
-        
-        // Check if resource already exists
-        auto it = resources_.find(id);
-        if (it != resources_.end()) {
-            return std::static_pointer_cast<T>(it->second);
-        }
-        
-        // Store new resource
-        resources_[id] = resource;
-        update_memory_stats(type, resource->get_size(), true);
+    update_memory_stats(resource.get_type(), resource.get_size(), false);
+    release_to_pool(it->first, owned);
+    lru_unlink(resource);
+    resource.lru_key_ = nullptr;
+    resources_.erase(it);
+}
+
+void Manager::lru_push_front(Resource& resource) {
+    resource.lru_prev_ = nullptr;
+    resource.lru_next_ = lru_head_;
+    if (lru_head_) {
+        lru_head_->lru_prev_ = &resource;
+    } else {
+        lru_tail_ = &resource;
+    }
+    lru_head_ = &resource;
+}
+
+void Manager::lru_unlink(Resource& resource) {
+    if (resource.lru_prev_) {
+        resource.lru_prev_->lru_next_ = resource.lru_next_;
+    } else {
+        lru_head_ = resource.lru_next_;
+    }
+    if (resource.lru_next_) {
+        resource.lru_next_->lru_prev_ = resource.lru_prev_;
+    } else {
+        lru_tail_ = resource.lru_prev_;
+    }
+    resource.lru_prev_ = nullptr;
+    resource.lru_next_ = nullptr;
+}
+
+void Manager::touch(Resource& resource) {
+    std::lock_guard<std::mutex> lock(lru_mutex_);
+    resource.update_last_access();
+    if (lru_head_ != &resource) {
+        lru_unlink(resource);
+        lru_push_front(resource);
+    }
+}
+
+void Manager::release_to_pool(const std::string& id, const std::shared_ptr<Resource>& resource) {
+    // The type tag is set by the concrete class, so these casts are exact
+    switch (resource->get_type()) {
+        case ResourceType::Texture:
+            texture_pool_.release(id, std::static_pointer_cast<TextureResource>(resource));
+            break;
+        case ResourceType::Font:
+            font_pool_.release(id, std::static_pointer_cast<FontResource>(resource));
+            break;
+        case ResourceType::Shader:
+            shader_pool_.release(id, std::static_pointer_cast<ShaderResource>(resource));
+            break;
+        default:
+            buffer_pool_.release(id, std::static_pointer_cast<BufferResource>(resource));
+            break;
     }
-    
-    return resource;
 }
 
 // ScopedTexture implementation
-ScopedTexture::ScopedTexture(const std::string& id, Manager& manager) : manager_(manager) {
+ScopedTexture::ScopedTexture(const std::string& id, Manager& manager) : manager_(&manager) {
     if (!id.empty()) {
-        resource_ = manager_.get_resource(id);
-        if (resource_ && resource_->get_type() == ResourceType::Texture) {
+        auto resource = manager_->get_resource(id);
+        if (resource && resource->get_type() == ResourceType::Texture) {
             id_ = id;
+            resource_ = std::static_pointer_cast<TextureResource>(resource);
         }
     }
 }
@@ -659,11 +844,12 @@ ScopedTexture& ScopedTexture::operator=(ScopedTexture&& other) noexcept {
 }
 
 // ScopedFont implementation
-ScopedFont::ScopedFont(const std::string& id, Manager& manager) : manager_(manager) {
+ScopedFont::ScopedFont(const std::string& id, Manager& manager) : manager_(&manager) {
     if (!id.empty()) {
-        resource_ = manager_.get_resource(id);
-        if (resource_ && resource_->get_type() == ResourceType::Font) {
+        auto resource = manager_->get_resource(id);
+        if (resource && resource->get_type() == ResourceType::Font) {
             id_ = id;
+            resource_ = std::static_pointer_cast<FontResource>(resource);
         }
     }
 }
@@ -689,11 +875,12 @@ ScopedFont& ScopedFont::operator=(ScopedFont&& other) noexcept {
 }
 
 // ScopedShader implementation
-ScopedShader::ScopedShader(const std::string& id, Manager& manager) : manager_(manager) {
+ScopedShader::ScopedShader(const std::string& id, Manager& manager) : manager_(&manager) {
     if (!id.empty()) {
-        resource_ = manager_.get_resource(id);
-        if (resource_ && resource_->get_type() == ResourceType::Shader) {
+        auto resource = manager_->get_resource(id);
+        if (resource && resource->get_type() == ResourceType::Shader) {
             id_ = id;
+            resource_ = std::static_pointer_cast<ShaderResource>(resource);
         }
     }
 }
@@ -720,11 +907,12 @@ ScopedShader& ScopedShader::operator=(ScopedShader&& other) noexcept {
 
 // ScopedBuffer implementation
 ScopedBuffer::ScopedBuffer(const std::string& id, ResourceType type, Manager& manager) 
-    : manager_(manager), type_(type) {
+    : manager_(&manager), type_(type) {
     if (!id.empty()) {
-        resource_ = manager_.get_resource(id);
-        if (resource_ && resource_->get_type() == type) {
+        auto resource = manager_->get_resource(id);
+        if (resource && resource->get_type() == type) {
             id_ = id;
+            resource_ = std::static_pointer_cast<BufferResource>(resource);
         }
     }
 }
@@ -806,6 +994,29 @@ bool is_valid_resource_id(const std::string& id) {
     return true;
 }
 
+uint32_t next_codepoint(const std::string& text, size_t& offset) {
+    const auto byte_at = [&text](size_t index) { return static_cast<unsigned char>(text[index]); };
+    
+    const unsigned char lead = byte_at(offset);
+    const size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x06 ? 2 : (lead >> 4) == 0x0E ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+    if (length == 0 || offset + length > text.size()) {
+        offset++;
+        return 0xFFFD;
+    }
+    
+    uint32_t codepoint = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+        const unsigned char next = byte_at(offset + i);
+        if ((next & 0xC0) != 0x80) {
+            offset++;
+            return 0xFFFD;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    offset += length;
+    return codepoint;
+}
+
 std::string generate_unique_id(const std::string& prefix) {
     static std::atomic<uint64_t> counter{0};
     uint64_t id = counter.fetch_add(1);
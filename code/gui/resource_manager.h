@@ -7,26 +7,15 @@
 #include <vector>
 #include <chrono>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
 #include <atomic>
 #include <cstdint>
+#include <iosfwd>
 
-// Forward declarations
-namespace catacurses {
-    class window;
-}
-
-namespace ImGui {
-    struct ImDrawList;
-    struct ImDrawCmd;
-    struct ImFont;
-    struct ImTextureID;
-}
-
-namespace sdl {
-    class renderer;
-    class texture;
-    class font;
-}
+#include "imgui.h"
 
 namespace gui {
 
@@ -57,11 +46,21 @@ struct MemoryStats {
     std::atomic<uint32_t> pool_hits{0};
     std::atomic<uint32_t> pool_misses{0};
     
+    // Asynchronous loads: requests not yet uploaded, and decoded pixels waiting
+    // for their upload slot
+    std::atomic<uint32_t> pending_loads{0};
+    std::atomic<uint64_t> pending_upload_bytes{0};
+    
     // Get current allocated size
     uint64_t current_usage() const { 
         return total_allocated.load() - total_freed.load();
     }
     
+    // Allocated size once every decoded load has been uploaded
+    uint64_t projected_usage() const {
+        return current_usage() + pending_upload_bytes.load();
+    }
+
     // Get pool efficiency percentage
     double pool_efficiency() const {
         uint32_t total = pool_hits.load() + pool_misses.load();
@@ -69,13 +68,14 @@ struct MemoryStats {
     }
 };
 
-// Resource identifier using RAII
+class Manager;
+
+// Resource identifier using RAII. Only the concrete resource classes below
+// construct one, so the type tag always names the dynamic type.
 class Resource {
 public:
-    Resource() = default;
-    explicit Resource(const std::string& id, ResourceType type);
     virtual ~Resource() = default;
-    
+
     // Move semantics
     Resource(Resource&& other) noexcept;
     Resource& operator=(Resource&& other) noexcept;
@@ -98,19 +98,40 @@ public:
         return std::chrono::duration_cast<std::chrono::seconds>(now - last_access_) > timeout;
     }
 
+protected:
+    Resource() = default;
+    explicit Resource(const std::string& id, ResourceType type);
+
 private:
+    friend class Manager;
+
     std::string id_;
     ResourceType type_{ResourceType::Texture};
     uint64_t size_{0};
     std::chrono::steady_clock::time_point last_access_{std::chrono::steady_clock::now()};
+
+    // Intrusive recency list links, owned by the Manager tracking this resource
+    Resource* lru_prev_{nullptr};
+    Resource* lru_next_{nullptr};
+    const std::string* lru_key_{nullptr};
 };
 
 // Texture resource with automatic cleanup
 class TextureResource : public Resource {
 public:
+    using Deleter = std::function<void(ImTextureID)>;
+    
     TextureResource(const std::string& id, ImTextureID texture, uint32_t width, uint32_t height);
     ~TextureResource() override;
     
+    // Textures the resource owns are destroyed through the deleter
+    void set_deleter(Deleter deleter) { deleter_ = std::move(deleter); }
+    bool owns_texture() const { return static_cast<bool>(deleter_); }
+    
+    // Destroy an owned texture now, e.g. before its renderer goes away;
+    // handles still held elsewhere see a null texture afterwards
+    void destroy_texture();
+
     ImTextureID get_texture() const { return texture_; }
     uint32_t get_width() const { return width_; }
     uint32_t get_height() const { return height_; }
@@ -122,9 +143,80 @@ public:
     }
 
 private:
-    ImTextureID texture_{nullptr};
+    ImTextureID texture_{};
     uint32_t width_{0};
     uint32_t height_{0};
+    Deleter deleter_;
+};
+
+// RGBA32 pixels produced by an ImageDecoder, tightly packed
+struct DecodedImage {
+    std::vector<uint8_t> pixels;
+    uint32_t width{0};
+    uint32_t height{0};
+};
+
+// Runs on a loader thread; returns false if the image cannot be decoded
+using ImageDecoder = std::function<bool(const std::string& id, DecodedImage& image)>;
+
+// Placeholder returned by Manager::request_texture(). The texture appears once
+// the decoded pixels have been uploaded on the render thread.
+class TextureRequest {
+public:
+    enum class State : uint8_t {
+        Queued,
+        Decoded,
+        Ready,
+        Failed
+    };
+    
+    explicit TextureRequest(const std::string& id) : id_(id) {}
+    
+    const std::string& get_id() const { return id_; }
+    State get_state() const { return state_.load(std::memory_order_acquire); }
+    bool is_ready() const { return get_state() == State::Ready; }
+    bool is_done() const { return get_state() == State::Ready || get_state() == State::Failed; }
+    
+    // Null until the request is ready
+    std::shared_ptr<TextureResource> get() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return texture_;
+    }
+
+private:
+    friend class Manager;
+    
+    std::string id_;
+    std::atomic<State> state_{State::Queued};
+    uint64_t generation_{0};
+    mutable std::mutex mutex_;
+    std::shared_ptr<TextureResource> texture_;
+    ImageDecoder decoder_;
+    DecodedImage image_;
+};
+
+// Codepoint membership bitset, one bit per codepoint
+class GlyphSet {
+public:
+    GlyphSet() = default;
+    // Every glyph the font has rasterized
+    explicit GlyphSet(const ImFont* font);
+    
+    void insert(uint32_t codepoint) {
+        const size_t word = codepoint >> 6;
+        if (word >= bits_.size()) bits_.resize(word + 1, 0);
+        bits_[word] |= uint64_t{1} << (codepoint & 63);
+    }
+    
+    bool contains(uint32_t codepoint) const {
+        const size_t word = codepoint >> 6;
+        return word < bits_.size() && ((bits_[word] >> (codepoint & 63)) & 1) != 0;
+    }
+    
+    void clear() { bits_.clear(); }
+
+private:
+    std::vector<uint64_t> bits_;
 };
 
 // Font resource with caching
@@ -134,13 +226,15 @@ public:
     ~FontResource() override = default;
     
     ImFont* get_font() const { return font_; }
-    void set_font(ImFont* font) { font_ = font; }
+    // Call again after the font's atlas is rebuilt so the glyph set is current
+    void set_font(ImFont* font) { font_ = font; glyphs_ = GlyphSet(font); }
     
-    // Check if font supports specific characters
+    // Check if font has a glyph for every codepoint of the UTF-8 text
     bool supports_text(const std::string& text) const;
 
 private:
     ImFont* font_{nullptr};
+    GlyphSet glyphs_;
 };
 
 // Shader resource for GPU programs
@@ -194,9 +288,11 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
         
         auto it = available_.find(id);
-        if (it != available_.end() && !it->second->expired()) {
-            pool_hits_++;
-            return it->second.lock();
+        if (it != available_.end()) {
+            if (auto resource = it->second.lock()) {
+                pool_hits_++;
+                return resource;
+            }
         }
         
         pool_misses_++;
@@ -207,8 +303,8 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
         
         if (available_.size() >= max_size_) {
-            // Clean up oldest entries
-            cleanup();
+            // Clean up expired entries
+            cleanup_locked();
         }
         
         available_[id] = resource;
@@ -216,14 +312,7 @@ public:
     
     void cleanup() {
         std::lock_guard<std::mutex> lock(mutex_);
-        
-        for (auto it = available_.begin(); it != available_.end();) {
-            if (it->second.expired()) {
-                it = available_.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        cleanup_locked();
     }
     
     void set_max_size(size_t max_size) { 
@@ -240,6 +329,16 @@ public:
     uint32_t get_misses() const { return pool_misses_.load(); }
 
 private:
+    void cleanup_locked() {
+        for (auto it = available_.begin(); it != available_.end();) {
+            if (it->second.expired()) {
+                it = available_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    
     std::unordered_map<std::string, std::weak_ptr<T>> available_;
     mutable std::mutex mutex_;
     size_t max_size_;
@@ -264,6 +363,17 @@ public:
     std::shared_ptr<ShaderResource> get_shader(const std::string& id, const ShaderCreator& creator);
     std::shared_ptr<BufferResource> get_buffer(const std::string& id, ResourceType type, const BufferCreator& creator);
     
+    // Asynchronous texture loading: the decoder runs on a loader thread and
+    // process_uploads() creates the SDL texture on the render thread. A request
+    // for an id that is tracked or already in flight shares the existing one.
+    std::shared_ptr<TextureRequest> request_texture(const std::string& id, const ImageDecoder& decoder);
+    
+    // Upload decoded images until either budget is spent; at least one image is
+    // uploaded per call so large ones still make progress. Returns how many.
+    size_t process_uploads();
+    void set_upload_budget(uint64_t bytes_per_frame, std::chrono::microseconds time_per_frame);
+    void set_loader_threads(size_t count);
+
     // Direct resource access
     std::shared_ptr<Resource> get_resource(const std::string& id);
     bool has_resource(const std::string& id) const;
@@ -293,16 +403,22 @@ public:
     
     // Integration with existing Cataclysm systems
     void integrate_with_ui_manager();
+    // Replacing or detaching a renderer destroys the textures the manager
+    // created on it and drops queued and in-flight async requests
     void integrate_with_sdl_renderer(void* renderer);
     void integrate_with_input_system();
     
     // Thread safety
     void set_thread_safe(bool safe) { thread_safe_ = safe; }
     bool is_thread_safe() const { return thread_safe_; }
+    
+    // Stale-resource sweep and memory limit check. Safe to call every frame;
+    // it only does work once per cleanup interval or when over the limit.
+    void periodic_cleanup();
 
 private:
     Manager() = default;
-    ~Manager() = default;
+    ~Manager();
     
     // Non-copyable
     Manager(const Manager&) = delete;
@@ -312,12 +428,37 @@ private:
     std::unordered_map<std::string, std::shared_ptr<Resource>> resources_;
     mutable std::shared_mutex resources_mutex_;
     
+    // Recency list over resources_, most recently used at the head. Links change
+    // under a unique resources_mutex_ lock, or under a shared one plus lru_mutex_
+    // when a lookup records an access.
+    Resource* lru_head_{nullptr};
+    Resource* lru_tail_{nullptr};
+    mutable std::mutex lru_mutex_;
+
     // Resource pools
     ResourcePool<TextureResource> texture_pool_{1000};
     ResourcePool<FontResource> font_pool_{100};
     ResourcePool<ShaderResource> shader_pool_{50};
     ResourcePool<BufferResource> buffer_pool_{2000};
     
+    // Asynchronous loading
+    void* renderer_{nullptr};
+    std::vector<std::thread> loader_threads_;
+    size_t loader_thread_count_{2};
+    std::deque<std::shared_ptr<TextureRequest>> load_queue_;
+    std::unordered_map<std::string, std::shared_ptr<TextureRequest>> in_flight_requests_;
+    std::mutex load_mutex_;
+    std::condition_variable load_cv_;
+    bool stopping_loaders_{false};
+    
+    std::deque<std::shared_ptr<TextureRequest>> upload_queue_;
+    std::mutex upload_mutex_;
+    // Bumped under upload_mutex_ when the renderer goes away; decodes started
+    // before that are dropped instead of queued for upload
+    std::atomic<uint64_t> upload_generation_{0};
+    uint64_t upload_budget_bytes_{4 * 1024 * 1024};
+    std::chrono::microseconds upload_budget_time_{std::chrono::milliseconds(2)};
+    
     // Memory statistics and limits
     MemoryStats stats_;
     uint64_t memory_limit_{100 * 1024 * 1024}; // 100MB default
@@ -342,10 +483,28 @@ private:
     bool check_memory_limit(uint64_t additional_size) const;
     void enforce_memory_limit();
     
+    // Storage and recency list helpers; callers hold a unique resources_mutex_ lock
+    void insert_locked(const std::string& id, const std::shared_ptr<Resource>& resource);
+    void release_locked(Resource& resource);
+    void lru_push_front(Resource& resource);
+    void lru_unlink(Resource& resource);
+    void release_to_pool(const std::string& id, const std::shared_ptr<Resource>& resource);
+    
+    // Record an access; callers hold at least a shared resources_mutex_ lock
+    void touch(Resource& resource);
+    
+    // Loader threads; started on the first request
+    void start_loaders_locked();
+    void stop_loaders();
+    void loader_main();
+    void upload(TextureRequest& request);
+    void finish_request(TextureRequest& request, TextureRequest::State state);
+    void discard_requests();
+    void release_owned_textures();
+
     // Integration hooks
     static void ui_manager_redraw_hook();
     static void sdl_renderer_cleanup_hook();
-    void periodic_cleanup();
 };
 
 // RAII resource handles for automatic resource management
@@ -355,21 +514,8 @@ public:
     ~ScopedTexture() { release(); }
     
     // Move semantics
-    ScopedTexture(ScopedTexture&& other) noexcept : manager_(other.manager_), id_(other.id_), resource_(other.resource_) {
-        other.id_.clear();
-        other.resource_.reset();
-    }
-    ScopedTexture& operator=(ScopedTexture&& other) noexcept {
-        if (this != &other) {
-            release();
-            manager_ = other.manager_;
-            id_ = other.id_;
-            resource_ = other.resource_;
-            other.id_.clear();
-            other.resource_.reset();
-        }
-        return *this;
-    }
+    ScopedTexture(ScopedTexture&& other) noexcept;
+    ScopedTexture& operator=(ScopedTexture&& other) noexcept;
     
     // Non-copyable
     ScopedTexture(const ScopedTexture&) = delete;
@@ -381,14 +527,14 @@ public:
     
     void release() {
         if (!id_.empty()) {
-            manager_.release_resource(id_);
+            manager_->release_resource(id_);
             id_.clear();
             resource_.reset();
         }
     }
 
 private:
-    Manager& manager_;
+    Manager* manager_;
     std::string id_;
     std::shared_ptr<TextureResource> resource_;
 };
@@ -399,21 +545,8 @@ public:
     ~ScopedFont() { release(); }
     
     // Move semantics
-    ScopedFont(ScopedFont&& other) noexcept : manager_(other.manager_), id_(other.id_), resource_(other.resource_) {
-        other.id_.clear();
-        other.resource_.reset();
-    }
-    ScopedFont& operator=(ScopedFont&& other) noexcept {
-        if (this != &other) {
-            release();
-            manager_ = other.manager_;
-            id_ = other.id_;
-            resource_ = other.resource_;
-            other.id_.clear();
-            other.resource_.reset();
-        }
-        return *this;
-    }
+    ScopedFont(ScopedFont&& other) noexcept;
+    ScopedFont& operator=(ScopedFont&& other) noexcept;
     
     // Non-copyable
     ScopedFont(const ScopedFont&) = delete;
@@ -425,14 +558,14 @@ public:
     
     void release() {
         if (!id_.empty()) {
-            manager_.release_resource(id_);
+            manager_->release_resource(id_);
             id_.clear();
             resource_.reset();
         }
     }
 
 private:
-    Manager& manager_;
+    Manager* manager_;
     std::string id_;
     std::shared_ptr<FontResource> resource_;
 };
@@ -443,21 +576,8 @@ public:
     ~ScopedShader() { release(); }
     
     // Move semantics
-    ScopedShader(ScopedShader&& other) noexcept : manager_(other.manager_), id_(other.id_), resource_(other.resource_) {
-        other.id_.clear();
-        other.resource_.reset();
-    }
-    ScopedShader& operator=(ScopedShader&& other) noexcept {
-        if (this != &other) {
-            release();
-            manager_ = other.manager_;
-            id_ = other.id_;
-            resource_ = other.resource_;
-            other.id_.clear();
-            other.resource_.reset();
-        }
-        return *this;
-    }
+    ScopedShader(ScopedShader&& other) noexcept;
+    ScopedShader& operator=(ScopedShader&& other) noexcept;
     
     // Non-copyable
     ScopedShader(const ScopedShader&) = delete;
@@ -469,14 +589,14 @@ public:
     
     void release() {
         if (!id_.empty()) {
-            manager_.release_resource(id_);
+            manager_->release_resource(id_);
             id_.clear();
             resource_.reset();
         }
     }
 
 private:
-    Manager& manager_;
+    Manager* manager_;
     std::string id_;
     std::shared_ptr<ShaderResource> resource_;
 };
@@ -487,24 +607,8 @@ public:
     ~ScopedBuffer() { release(); }
     
     // Move semantics
-    ScopedBuffer(ScopedBuffer&& other) noexcept : manager_(other.manager_), id_(other.id_), type_(other.type_), resource_(other.resource_) {
-        other.id_.clear();
-        other.type_ = ResourceType::Texture;
-        other.resource_.reset();
-    }
-    ScopedBuffer& operator=(ScopedBuffer&& other) noexcept {
-        if (this != &other) {
-            release();
-            manager_ = other.manager_;
-            id_ = other.id_;
-            type_ = other.type_;
-            resource_ = other.resource_;
-            other.id_.clear();
-            other.type_ = ResourceType::Texture;
-            other.resource_.reset();
-        }
-        return *this;
-    }
+    ScopedBuffer(ScopedBuffer&& other) noexcept;
+    ScopedBuffer& operator=(ScopedBuffer&& other) noexcept;
     
     // Non-copyable
     ScopedBuffer(const ScopedBuffer&) = delete;
@@ -517,14 +621,14 @@ public:
     
     void release() {
         if (!id_.empty()) {
-            manager_.release_resource(id_);
+            manager_->release_resource(id_);
             id_.clear();
             resource_.reset();
         }
     }
 
 private:
-    Manager& manager_;
+    Manager* manager_;
     std::string id_;
     ResourceType type_;
     std::shared_ptr<BufferResource> resource_;
@@ -542,6 +646,10 @@ std::string resource_type_to_string(ResourceType type);
 // Check if a resource ID follows naming conventions
 bool is_valid_resource_id(const std::string& id);
 
+// Decode the UTF-8 codepoint at offset and advance past it; malformed bytes
+// decode as U+FFFD one byte at a time
+uint32_t next_codepoint(const std::string& text, size_t& offset);
+
 // Generate unique resource ID
 std::string generate_unique_id(const std::string& prefix = "res");
 
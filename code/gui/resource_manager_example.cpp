@@ -1,5 +1,7 @@
 #include "resource_manager.h"
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <string>
 
@@ -16,14 +18,14 @@ std::shared_ptr<gui::resource_manager::TextureResource> create_default_texture(c
     uint32_t width = 64;
     uint32_t height = 64;
     
-    return std::make_shared<gui::resource_manager::TextureResource>(id, mock_texture, width, height);
+    return std::make_shared<gui::resource_manager::TextureResource>(id, reinterpret_cast<ImTextureID>(mock_texture), width, height);
 }
 
 // Example font creation function
 std::shared_ptr<gui::resource_manager::FontResource> create_default_font(const std::string& id) {
     // In a real implementation, this would create an actual ImGui font
     // For this example, we'll simulate font creation
-    ImGui::ImFont* mock_font = nullptr; // In real code, this would be a valid ImFont pointer
+    ImFont* mock_font = nullptr; // In real code, this would be a valid ImFont pointer
     
     return std::make_shared<gui::resource_manager::FontResource>(id, mock_font);
 }
@@ -147,7 +149,7 @@ void demonstrate_resource_pooling() {
     }
     
     // Print pool statistics
-    auto stats = manager.get_stats();
+    const auto& stats = manager.get_stats();
     std::cout << "Pool efficiency: " << std::fixed << std::setprecision(1) 
               << stats.pool_efficiency() << "%\n";
     std::cout << "Pool hits: " << stats.pool_hits << "\n";
@@ -187,7 +189,7 @@ void demonstrate_memory_tracking() {
         gui::resource_manager::ResourceType::VertexBuffer, create_default_buffer);
     
     // Print memory statistics
-    auto stats = manager.get_stats();
+    const auto& stats = manager.get_stats();
     std::cout << "Current memory usage: " << gui::resource_manager::utilities::format_memory_size(stats.current_usage()) << "\n";
     std::cout << "Total allocated: " << gui::resource_manager::utilities::format_memory_size(stats.total_allocated) << "\n";
     std::cout << "Active textures: " << stats.active_textures << "\n";
@@ -0,0 +1,347 @@
+#include "settings_snapshot.h"
+#include "debug.h"
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CataclysmBN {
+namespace GUI {
+
+namespace {
+
+constexpr char kMagic[4] = {'C', 'B', 'N', 'S'};
+// magic, version, section count, source hash
+constexpr size_t kHeaderSize = 4 + 4 + 4 + 8;
+constexpr size_t kSectionEntrySize = 4 * 3;
+
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+constexpr uint64_t kMissingSourceHash = 0x6d697373696e6721ull;
+
+uint64_t fnv1a(const uint8_t* data, size_t size, uint64_t hash = kFnvOffsetBasis) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+void appendU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xffu));
+    }
+}
+
+void appendU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xffu));
+    }
+}
+
+uint32_t loadU32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint64_t loadU64(const uint8_t* data) {
+    return static_cast<uint64_t>(loadU32(data)) | (static_cast<uint64_t>(loadU32(data + 4)) << 32);
+}
+
+} // namespace
+
+// MappedFile
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        m_isEmptyFile = true;
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        ::close(fd);
+        m_isEmptyFile = true;
+        return true;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file referenced on its own
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+    m_file = nullptr;
+    m_mapping = nullptr;
+#else
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_isEmptyFile = false;
+}
+
+// SnapshotWriter
+
+void SnapshotWriter::beginSection(SnapshotSection section) {
+    if (m_inSection) {
+        endSection();
+    }
+    m_sections.push_back({static_cast<uint32_t>(section), static_cast<uint32_t>(m_payload.size()), 0});
+    m_inSection = true;
+}
+
+void SnapshotWriter::endSection() {
+    if (!m_inSection) {
+        return;
+    }
+    SectionEntry& entry = m_sections.back();
+    entry.size = static_cast<uint32_t>(m_payload.size()) - entry.offset;
+    m_inSection = false;
+}
+
+void SnapshotWriter::writeU32(uint32_t value) {
+    appendU32(m_payload, value);
+}
+
+void SnapshotWriter::writeInt(int value) {
+    appendU32(m_payload, static_cast<uint32_t>(value));
+}
+
+void SnapshotWriter::writeBool(bool value) {
+    m_payload.push_back(value ? 1 : 0);
+}
+
+void SnapshotWriter::writeString(const std::string& value) {
+    appendU32(m_payload, static_cast<uint32_t>(value.size()));
+    m_payload.append(value);
+}
+
+std::string SnapshotWriter::finish(uint64_t sourceHash) const {
+    std::vector<SectionEntry> sections = m_sections;
+    if (m_inSection) {
+        sections.back().size = static_cast<uint32_t>(m_payload.size()) - sections.back().offset;
+    }
+
+    std::string out;
+    out.reserve(kHeaderSize + sections.size() * kSectionEntrySize + m_payload.size());
+    out.append(kMagic, sizeof(kMagic));
+    appendU32(out, SettingsSnapshot::kVersion);
+    appendU32(out, static_cast<uint32_t>(sections.size()));
+    appendU64(out, sourceHash);
+    for (const SectionEntry& entry : sections) {
+        appendU32(out, entry.tag);
+        appendU32(out, entry.offset);
+        appendU32(out, entry.size);
+    }
+    out.append(m_payload);
+    return out;
+}
+
+// SnapshotReader
+
+bool SnapshotReader::take(size_t bytes, const uint8_t** out) {
+    if (m_failed || !m_data || m_size - m_offset < bytes) {
+        m_failed = true;
+        return false;
+    }
+    *out = m_data + m_offset;
+    m_offset += bytes;
+    return true;
+}
+
+uint32_t SnapshotReader::readU32() {
+    const uint8_t* bytes = nullptr;
+    return take(4, &bytes) ? loadU32(bytes) : 0;
+}
+
+int SnapshotReader::readInt() {
+    return static_cast<int>(readU32());
+}
+
+bool SnapshotReader::readBool() {
+    const uint8_t* bytes = nullptr;
+    return take(1, &bytes) && *bytes != 0;
+}
+
+std::string SnapshotReader::readString() {
+    const uint32_t length = readU32();
+    const uint8_t* bytes = nullptr;
+    if (!take(length, &bytes)) {
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(bytes), length);
+}
+
+// SettingsSnapshot
+
+bool SettingsSnapshot::open(const std::string& path, uint64_t expectedSourceHash) {
+    close();
+
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const uint8_t* data = m_file.data();
+    const size_t size = m_file.size();
+    if (size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        debuglog(DebugLevel::Info, "Ignoring settings snapshot with a bad header: ", path);
+        close();
+        return false;
+    }
+    if (loadU32(data + 4) != kVersion) {
+        debuglog(DebugLevel::Info, "Ignoring settings snapshot from another version: ", path);
+        close();
+        return false;
+    }
+    if (loadU64(data + 12) != expectedSourceHash) {
+        debuglog(DebugLevel::Info, "Settings snapshot is stale, falling back to JSON: ", path);
+        close();
+        return false;
+    }
+
+    const uint32_t count = loadU32(data + 8);
+    if (count > (size - kHeaderSize) / kSectionEntrySize) {
+        close();
+        return false;
+    }
+    const size_t payloadOffset = kHeaderSize + static_cast<size_t>(count) * kSectionEntrySize;
+    const size_t payloadSize = size - payloadOffset;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* entry = data + kHeaderSize + static_cast<size_t>(i) * kSectionEntrySize;
+        const size_t offset = loadU32(entry + 4);
+        const size_t length = loadU32(entry + 8);
+        if (offset > payloadSize || length > payloadSize - offset) {
+            debuglog(DebugLevel::Info, "Ignoring truncated settings snapshot: ", path);
+            close();
+            return false;
+        }
+        m_sections.push_back({loadU32(entry), data + payloadOffset + offset, length});
+    }
+
+    m_valid = true;
+    return true;
+}
+
+void SettingsSnapshot::close() {
+    m_sections.clear();
+    m_file.close();
+    m_valid = false;
+}
+
+bool SettingsSnapshot::hasSection(SnapshotSection section) const {
+    for (const SectionView& view : m_sections) {
+        if (view.tag == static_cast<uint32_t>(section)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SnapshotReader SettingsSnapshot::getSection(SnapshotSection section) const {
+    for (const SectionView& view : m_sections) {
+        if (view.tag == static_cast<uint32_t>(section)) {
+            return SnapshotReader(view.data, view.size);
+        }
+    }
+    return SnapshotReader();
+}
+
+uint64_t SettingsSnapshot::hashFile(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return kMissingSourceHash;
+    }
+    return fnv1a(file.data(), file.size());
+}
+
+uint64_t SettingsSnapshot::hashContents(const std::string& contents) {
+    return fnv1a(reinterpret_cast<const uint8_t*>(contents.data()), contents.size());
+}
+
+uint64_t SettingsSnapshot::hashSources(const std::vector<std::string>& paths) {
+    uint64_t hash = 0;
+    for (const std::string& path : paths) {
+        hash = combineHashes(hash, hashFile(path));
+    }
+    return hash;
+}
+
+uint64_t SettingsSnapshot::combineHashes(uint64_t seed, uint64_t value) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<uint8_t>((value >> (8 * i)) & 0xffu);
+    }
+    return fnv1a(bytes, sizeof(bytes), seed);
+}
+
+} // namespace GUI
+} // namespace CataclysmBN
@@ -0,0 +1,146 @@
+#ifndef SETTINGS_SNAPSHOT_H
+#define SETTINGS_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CataclysmBN {
+namespace GUI {
+
+/**
+ * Read-only view of a whole file. Uses the platform's memory mapping so a
+ * snapshot is paged in as it is read instead of copied up front.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr || m_isEmptyFile; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_isEmptyFile = false;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+// Sections a startup snapshot may carry
+enum class SnapshotSection : uint32_t {
+    Settings = 1,   // GUISettings values
+    Toggles = 2,    // ToggleManager components and shortcuts
+    Layout = 3      // ImGui window layout, in ini form
+};
+
+/**
+ * Builds a snapshot: sections are appended in order and finish() prefixes
+ * them with the header and section table.
+ */
+class SnapshotWriter {
+public:
+    void beginSection(SnapshotSection section);
+    void endSection();
+
+    void writeU32(uint32_t value);
+    void writeInt(int value);
+    void writeBool(bool value);
+    void writeString(const std::string& value);
+
+    // Header, section table and payload, ready to be written to disk
+    std::string finish(uint64_t sourceHash) const;
+
+private:
+    struct SectionEntry {
+        uint32_t tag;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    std::vector<SectionEntry> m_sections;
+    std::string m_payload;
+    bool m_inSection = false;
+};
+
+/**
+ * Bounds-checked cursor over one section. A read past the end leaves the
+ * reader failed and returns zero values, so callers check ok() once at the end.
+ */
+class SnapshotReader {
+public:
+    SnapshotReader() = default;
+    SnapshotReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    uint32_t readU32();
+    int readInt();
+    bool readBool();
+    std::string readString();
+
+    bool ok() const { return !m_failed && m_data != nullptr; }
+    bool atEnd() const { return m_offset == m_size; }
+
+private:
+    bool take(size_t bytes, const uint8_t** out);
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_offset = 0;
+    bool m_failed = false;
+};
+
+/**
+ * Optional binary snapshot of settings, toggle state and window layout read
+ * at startup instead of parsing each JSON/ini source. The snapshot records a
+ * hash of those sources; if any of them changed since it was written, open()
+ * rejects it and the caller falls back to the text files.
+ *
+ * Prebuilt font atlases are not duplicated here: FontAtlasCache already
+ * keeps them in its own binary cache directory.
+ */
+class SettingsSnapshot {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    // Map the snapshot and validate its header, version, section table and source hash
+    bool open(const std::string& path, uint64_t expectedSourceHash);
+    void close();
+
+    bool isOpen() const { return m_valid; }
+    bool hasSection(SnapshotSection section) const;
+    SnapshotReader getSection(SnapshotSection section) const;
+
+    // Hash the contents of text sources; a missing source hashes differently from an empty one.
+    // A source hash folds the per-source hashes in order with combineHashes(), starting from 0.
+    static uint64_t hashFile(const std::string& path);
+    static uint64_t hashContents(const std::string& contents);
+    static uint64_t combineHashes(uint64_t seed, uint64_t value);
+    static uint64_t hashSources(const std::vector<std::string>& paths);
+
+private:
+    struct SectionView {
+        uint32_t tag;
+        const uint8_t* data;
+        size_t size;
+    };
+
+    MappedFile m_file;
+    std::vector<SectionView> m_sections;
+    bool m_valid = false;
+};
+
+} // namespace GUI
+} // namespace CataclysmBN
+
+#endif // SETTINGS_SNAPSHOT_H
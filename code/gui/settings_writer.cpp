@@ -0,0 +1,212 @@
+#include "settings_writer.h"
+#include "debug.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace CataclysmBN {
+namespace GUI {
+
+namespace {
+
+// Unique per call and per process, so concurrent writers of one path never
+// share a temporary file
+std::string temporaryPathFor(const std::string& path) {
+    static const unsigned processToken = std::random_device{}();
+    static std::atomic<unsigned> counter{0};
+    std::ostringstream name;
+    name << path << ".tmp." << std::hex << processToken << '.' << counter.fetch_add(1);
+    return name.str();
+}
+
+} // namespace
+
+SettingsWriter::SettingsWriter(std::chrono::milliseconds debounce)
+    : m_debounce(debounce)
+    , m_flushRequests(0)
+    , m_writeCount(0)
+    , m_failedWriteCount(0)
+    , m_stopping(false) {}
+
+SettingsWriter::~SettingsWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+SettingsWriter& SettingsWriter::getInstance() {
+    static SettingsWriter instance;
+    return instance;
+}
+
+void SettingsWriter::schedule(const std::string& path, std::string contents) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        PendingWrite& pending = m_pending[path];
+        pending.contents = std::move(contents);
+        pending.deadline = Clock::now() + m_debounce;
+        if (!m_worker.joinable()) {
+            m_worker = std::thread(&SettingsWriter::run, this);
+        }
+    }
+    m_wake.notify_one();
+}
+
+void SettingsWriter::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_worker.joinable()) {
+        return;
+    }
+    ++m_flushRequests;
+    m_wake.notify_one();
+    m_idle.wait(lock, [this] { return m_pending.empty() && m_writing.empty(); });
+    --m_flushRequests;
+}
+
+bool SettingsWriter::write(const std::string& path, const std::string& contents) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Pending contents are older than these
+        m_pending.erase(path);
+        m_idle.wait(lock, [this, &path] { return m_writing.count(path) == 0; });
+        m_writing.insert(path);
+    }
+
+    const bool written = writeAtomically(path, contents);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writing.erase(path);
+    }
+    // Wake flush() and the background thread, which skips paths being written
+    m_idle.notify_all();
+    m_wake.notify_one();
+    return written;
+}
+
+void SettingsWriter::setDebounce(std::chrono::milliseconds debounce) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_debounce = debounce;
+}
+
+std::chrono::milliseconds SettingsWriter::getDebounce() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_debounce;
+}
+
+size_t SettingsWriter::getWriteCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writeCount;
+}
+
+size_t SettingsWriter::getFailedWriteCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failedWriteCount;
+}
+
+bool SettingsWriter::writeAtomically(const std::string& path, const std::string& contents) {
+    const std::filesystem::path target(path);
+    const std::filesystem::path temp(temporaryPathFor(path));
+    std::error_code ec;
+
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), ec);
+        if (ec) {
+            debuglog(DebugLevel::Warning, "Failed to create config directory ", target.parent_path().string(),
+                     ": ", ec.message());
+            return false;
+        }
+    }
+
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            debuglog(DebugLevel::Warning, "Failed to open ", temp.string(), " for writing");
+            return false;
+        }
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        file.close();
+        if (!file) {
+            debuglog(DebugLevel::Warning, "Failed to write ", temp.string());
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        debuglog(DebugLevel::Warning, "Failed to replace ", path, ": ", ec.message());
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+void SettingsWriter::run() {
+    std::vector<std::pair<std::string, std::string>> batch;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+        if (m_pending.empty() && m_stopping) {
+            return;
+        }
+
+        // Shutdown and flush() write everything now; otherwise wait out the debounce
+        const bool writeAll = m_stopping || m_flushRequests > 0;
+        const Clock::time_point now = Clock::now();
+        Clock::time_point nextDeadline = Clock::time_point::max();
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            if (m_writing.count(it->first) != 0) {
+                // write() is replacing this path; it wakes us when done
+                ++it;
+            } else if (writeAll || it->second.deadline <= now) {
+                batch.emplace_back(it->first, std::move(it->second.contents));
+                it = m_pending.erase(it);
+            } else {
+                nextDeadline = std::min(nextDeadline, it->second.deadline);
+                ++it;
+            }
+        }
+
+        if (batch.empty()) {
+            m_wake.wait_until(lock, nextDeadline);
+            continue;
+        }
+
+        for (const auto& entry : batch) {
+            m_writing.insert(entry.first);
+        }
+        lock.unlock();
+
+        size_t written = 0;
+        for (const auto& entry : batch) {
+            if (writeAtomically(entry.first, entry.second)) {
+                ++written;
+            }
+        }
+        const size_t failed = batch.size() - written;
+
+        lock.lock();
+        for (const auto& entry : batch) {
+            m_writing.erase(entry.first);
+        }
+        batch.clear();
+        m_writeCount += written;
+        m_failedWriteCount += failed;
+        m_idle.notify_all();
+    }
+}
+
+} // namespace GUI
+} // namespace CataclysmBN
@@ -0,0 +1,88 @@
+#ifndef SETTINGS_WRITER_H
+#define SETTINGS_WRITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace CataclysmBN {
+namespace GUI {
+
+/**
+ * SettingsWriter persists configuration files on a background thread.
+ * Callers hand over the serialized contents; writes to the same path are
+ * debounced so that a burst of changes (e.g. dragging a slider) produces
+ * one write of the latest contents once the burst settles. Files are
+ * replaced atomically through a temporary file and rename, so a crash
+ * mid-write never leaves a truncated config behind.
+ *
+ * Explicit saves go through write(), which replaces any pending contents
+ * for the path and never runs alongside a background write of it, so an
+ * older debounced write cannot land after an explicit save.
+ */
+class SettingsWriter {
+public:
+    explicit SettingsWriter(std::chrono::milliseconds debounce = std::chrono::milliseconds(250));
+    // Writes everything still pending before returning
+    ~SettingsWriter();
+
+    SettingsWriter(const SettingsWriter&) = delete;
+    SettingsWriter& operator=(const SettingsWriter&) = delete;
+
+    // Singleton access
+    static SettingsWriter& getInstance();
+
+    // Queue contents for path, replacing anything still pending for it
+    void schedule(const std::string& path, std::string contents);
+
+    // Block until every scheduled write is on disk
+    void flush();
+
+    // Write contents to path now, dropping anything still pending for it.
+    // Returns false if the file could not be replaced.
+    bool write(const std::string& path, const std::string& contents);
+
+    void setDebounce(std::chrono::milliseconds debounce);
+    std::chrono::milliseconds getDebounce() const;
+
+    // Number of files written by the background thread so far
+    size_t getWriteCount() const;
+    size_t getFailedWriteCount() const;
+
+    // Write contents to a uniquely named temporary file next to path and
+    // rename it over path
+    static bool writeAtomically(const std::string& path, const std::string& contents);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingWrite {
+        std::string contents;
+        Clock::time_point deadline;
+    };
+
+    void run();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::map<std::string, PendingWrite> m_pending;
+    std::chrono::milliseconds m_debounce;
+    // Paths being written right now, by the background thread or write()
+    std::set<std::string> m_writing;
+    int m_flushRequests;
+    size_t m_writeCount;
+    size_t m_failedWriteCount;
+    bool m_stopping;
+    std::thread m_worker;
+};
+
+} // namespace GUI
+} // namespace CataclysmBN
+
+#endif // SETTINGS_WRITER_H
@@ -1,7 +1,22 @@
 #include <algorithm>
+#include <any>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 #include <SDL.h>
@@ -11,17 +26,66 @@
 #include "CharacterWidget.h"
 #include "InventoryOverlayState.h"
 #include "InventoryWidget.h"
+#include "data_binding_manager.h"
+#include "debug.h"
 #include "event_bus_adapter.h"
 #include "event_bus.h"
 #include "events.h"
+#include "font_atlas_cache.h"
+#include "frame_arena.h"
+#include "frame_profiler.h"
+#include "hit_test_index.h"
+#include "inventory_filter.h"
+#include "map_stream.h"
+#include "resource_manager.h"
+#include "settings_snapshot.h"
+#include "settings_writer.h"
+#include "texture_atlas.h"
+#include "theme_palette.h"
 #include "imgui.h"
 #include "overlay_manager.h"
 #include "map_widget.h"
 #include "overlay_ui.h"
+#include "ui_adaptor.h"
 #include "ui_manager.h"
 
+#if GUI_TEST_TOGGLE_MANAGER
+#include "toggle_manager.h"
+#endif
+
+// Counts heap allocations while enabled, for tests asserting a path allocates nothing
+static std::atomic<bool> g_count_allocations{false};
+static std::atomic<size_t> g_allocation_count{0};
+
+static void* CountedAllocate(std::size_t size) {
+    if (g_count_allocations.load(std::memory_order_relaxed)) {
+        g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return CountedAllocate(size); }
+void* operator new[](std::size_t size) { return CountedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
 namespace {
 
+// Number of heap allocations made while running fn
+template <typename Fn>
+size_t CountAllocations(Fn&& fn) {
+    g_allocation_count.store(0, std::memory_order_relaxed);
+    g_count_allocations.store(true, std::memory_order_relaxed);
+    fn();
+    g_count_allocations.store(false, std::memory_order_relaxed);
+    return g_allocation_count.load(std::memory_order_relaxed);
+}
+
 void RunInputManagerEventRoutingTests() {
     SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
     SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
@@ -185,6 +249,989 @@ void RunInputManagerEventRoutingTests() {
     SDL_QuitSubSystem(SDL_INIT_VIDEO);
 }
 
+void RunInputManagerDispatchOrderTest() {
+    using BN::GUI::InputManager;
+
+    InputManager manager;
+    assert(manager.Initialize());
+    manager.SetGUIAreaBounds(0, 0, 256, 256);
+    manager.SetFocusState(InputManager::FocusState::GUI, "dispatch-tests");
+
+    std::vector<int> order;
+    int self_removing_id = 0;
+    const int low_id = manager.RegisterHandler(
+        InputManager::EventType::MOUSE_MOVE,
+        [&](const BN::GUI::GUIEvent&) {
+            order.push_back(1);
+            return false;
+        },
+        InputManager::Priority::LOW);
+    manager.RegisterHandler(
+        InputManager::EventType::MOUSE_MOVE,
+        [&](const BN::GUI::GUIEvent&) {
+            order.push_back(3);
+            return false;
+        },
+        InputManager::Priority::HIGHEST);
+    self_removing_id = manager.RegisterHandler(
+        InputManager::EventType::MOUSE_MOVE,
+        [&](const BN::GUI::GUIEvent&) {
+            order.push_back(2);
+            manager.UnregisterHandler(self_removing_id);
+            return false;
+        },
+        InputManager::Priority::NORMAL);
+    manager.RegisterHandler(
+        InputManager::EventType::MOUSE_MOVE,
+        [&](const BN::GUI::GUIEvent&) {
+            order.push_back(4);
+            return false;
+        },
+        InputManager::Priority::HIGHEST);
+    manager.RegisterHandler(
+        InputManager::EventType::MOUSE_BUTTON_PRESS,
+        [&](const BN::GUI::GUIEvent&) {
+            order.push_back(99);
+            return true;
+        },
+        InputManager::Priority::HIGHEST);
+    assert(manager.GetStatistics().active_handlers.load() == 5);
+
+    SDL_Event motion{};
+    motion.type = SDL_MOUSEMOTION;
+    motion.motion.type = SDL_MOUSEMOTION;
+    motion.motion.x = 32;
+    motion.motion.y = 32;
+
+    // Highest priority first, registration order within a priority; handlers
+    // below the event's priority never run and other event types are untouched.
+    assert(!manager.ProcessEvent(motion));
+    assert((order == std::vector<int>{3, 4, 2}));
+    assert(manager.GetStatistics().handlers_called.load() == 3);
+
+    // The handler that unregistered itself is gone on the next event.
+    order.clear();
+    assert(!manager.ProcessEvent(motion));
+    assert((order == std::vector<int>{3, 4}));
+    assert(manager.GetStatistics().active_handlers.load() == 4);
+
+    manager.UnregisterHandler(low_id);
+    manager.UnregisterHandler(low_id);
+    assert(manager.GetStatistics().active_handlers.load() == 3);
+
+    manager.ResetStatistics();
+    assert(manager.GetStatistics().handlers_called.load() == 0);
+    assert(manager.GetStatistics().active_handlers.load() == 3);
+
+    bool filtered_called = false;
+    const SDL_Event* routed_event = nullptr;
+    manager.RegisterHandler(
+        InputManager::EventType::KEYBOARD_PRESS,
+        [&](const BN::GUI::GUIEvent& event) {
+            filtered_called = true;
+            routed_event = &event.sdl_event;
+            return true;
+        },
+        InputManager::Priority::NORMAL, "inventory");
+    const uint32_t inventory_context = manager.GetContextId("inventory");
+    assert(inventory_context != 0);
+    assert(manager.GetContextId("inventory") == inventory_context);
+    assert(manager.GetContextId("") == 0);
+
+    SDL_Event key_down{};
+    key_down.type = SDL_KEYDOWN;
+    key_down.key.type = SDL_KEYDOWN;
+    key_down.key.keysym.sym = SDLK_a;
+
+    // With no active context, context-scoped handlers still receive events.
+    // Handlers see a view of the caller's event rather than a copy.
+    assert(manager.ProcessEvent(key_down));
+    assert(filtered_called);
+    assert(routed_event == &key_down);
+
+    manager.Shutdown();
+    assert(manager.GetStatistics().active_handlers.load() == 0);
+}
+
+void RunInputManagerMotionCoalescingTest() {
+    using BN::GUI::InputManager;
+
+    InputManager::InputSettings settings;
+    settings.coalesce_mouse_motion = true;
+    InputManager manager(settings);
+    assert(manager.Initialize());
+    manager.SetGUIAreaBounds(0, 0, 256, 256);
+    manager.SetFocusState(InputManager::FocusState::GUI, "coalescing-tests");
+
+    std::vector<SDL_Event> delivered;
+    auto record = [&](const BN::GUI::GUIEvent& event) {
+        delivered.push_back(event.sdl_event);
+        return true;
+    };
+    manager.RegisterHandler(InputManager::EventType::MOUSE_MOVE, record);
+    manager.RegisterHandler(InputManager::EventType::MOUSE_BUTTON_PRESS, record, InputManager::Priority::HIGH);
+    manager.RegisterHandler(InputManager::EventType::MOUSE_WHEEL, record);
+
+    SDL_Event motion{};
+    motion.type = SDL_MOUSEMOTION;
+    motion.motion.type = SDL_MOUSEMOTION;
+    motion.motion.x = 10;
+    motion.motion.y = 10;
+    assert(!manager.ProcessEvent(motion));
+    assert(manager.FlushCoalescedInput());
+    delivered.clear();
+
+    for (int step = 1; step <= 5; ++step) {
+        motion.motion.x = 10 + step * 2;
+        motion.motion.y = 10 + step;
+        motion.motion.xrel = 2;
+        motion.motion.yrel = 1;
+        assert(!manager.ProcessEvent(motion));
+    }
+    assert(delivered.empty());
+
+    int dx = 0;
+    int dy = 0;
+    manager.GetMouseDelta(dx, dy);
+    assert(dx == 10 && dy == 5);
+
+    assert(manager.FlushCoalescedInput());
+    assert(delivered.size() == 1);
+    assert(delivered[0].motion.x == 20 && delivered[0].motion.y == 15);
+    assert(delivered[0].motion.xrel == 10 && delivered[0].motion.yrel == 5);
+    assert(!manager.FlushCoalescedInput());
+    assert(manager.GetStatistics().motion_events_coalesced.load() == 4);
+
+    // Buttons and wheel arrive exactly, after the motion that preceded them.
+    delivered.clear();
+    motion.motion.x = 40;
+    motion.motion.y = 40;
+    assert(!manager.ProcessEvent(motion));
+
+    SDL_Event button{};
+    button.type = SDL_MOUSEBUTTONDOWN;
+    button.button.type = SDL_MOUSEBUTTONDOWN;
+    button.button.button = SDL_BUTTON_LEFT;
+    button.button.x = 40;
+    button.button.y = 40;
+    assert(manager.ProcessEvent(button));
+
+    SDL_Event wheel{};
+    wheel.type = SDL_MOUSEWHEEL;
+    wheel.wheel.type = SDL_MOUSEWHEEL;
+    wheel.wheel.y = 1;
+    manager.ProcessEvent(wheel);
+    manager.ProcessEvent(wheel);
+
+    assert(delivered.size() == 4);
+    assert(delivered[0].type == SDL_MOUSEMOTION && delivered[0].motion.x == 40);
+    assert(delivered[1].type == SDL_MOUSEBUTTONDOWN);
+    assert(delivered[2].type == SDL_MOUSEWHEEL && delivered[3].type == SDL_MOUSEWHEEL);
+
+    manager.Shutdown();
+}
+
+void RunTextureAtlasTest() {
+    using gui::resource_manager::AtlasRegion;
+    using gui::resource_manager::ShelfPacker;
+    using gui::resource_manager::TextureAtlas;
+
+    // Same-height entries share shelves; released shelves are reused.
+    ShelfPacker packer(64, 64, 0);
+    auto a = packer.insert(16, 16);
+    auto b = packer.insert(16, 16);
+    auto c = packer.insert(16, 32);
+    assert(a && b && c);
+    assert(a->y == b->y && b->x == a->x + 16);
+    assert(c->y == 16);
+    assert(!packer.insert(65, 1));
+    packer.release(*a);
+    assert(packer.get_fragmentation() > 0.0);
+    packer.release(*b);
+    auto reused = packer.insert(16, 16);
+    assert(reused && reused->x == 0 && reused->y == 0);
+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+    SDL_Window* window = SDL_CreateWindow(
+        "atlas", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    assert(renderer != nullptr);
+
+    {
+        TextureAtlas atlas(renderer, 128, 1);
+        std::vector<uint32_t> pixels(32 * 32, 0xffffffffu);
+
+        // A column of icons lands on one page texture, so ImGui can batch them.
+        std::vector<const AtlasRegion*> icons;
+        for (int i = 0; i < 16; ++i) {
+            const AtlasRegion* region =
+                atlas.add("icon_" + std::to_string(i), pixels.data(), 30, 30, 32 * 4);
+            assert(region != nullptr);
+            icons.push_back(region);
+        }
+        assert(atlas.get_page_count() == 1);
+        for (const AtlasRegion* region : icons) {
+            assert(region->texture == atlas.get_page_texture(0));
+            assert(region->uv0.x >= 0.0f && region->uv1.x <= 1.0f && region->uv0.x < region->uv1.x);
+            assert(region->uv0.y >= 0.0f && region->uv1.y <= 1.0f && region->uv0.y < region->uv1.y);
+        }
+        assert(!atlas.add("too_many", pixels.data(), 30, 30, 32 * 4));
+
+        // Evicting leaves holes; the next add that needs the room repacks the
+        // page and survivors keep their handle with updated coordinates.
+        for (int i = 0; i < 16; i += 2) {
+            assert(atlas.remove("icon_" + std::to_string(i)));
+        }
+        const AtlasRegion* survivor = atlas.find("icon_15");
+        assert(survivor != nullptr);
+        const AtlasRegion* wide = atlas.add("wide", pixels.data(), 32, 30, 32 * 4);
+        assert(wide != nullptr);
+        assert(atlas.find("icon_15") == survivor);
+        assert(survivor->texture == atlas.get_page_texture(0));
+        assert(atlas.get_entry_count() == 9);
+    }
+
+    {
+        // Evicting the end of a shelf frees room even though the repack
+        // leaves every survivor where it was.
+        TextureAtlas atlas(renderer, 128, 1);
+        std::vector<uint32_t> pixels(128 * 128, 0xffffffffu);
+        const AtlasRegion* tall = atlas.add("tall", pixels.data(), 120, 95, 128 * 4);
+        const AtlasRegion* left = atlas.add("left", pixels.data(), 60, 30, 128 * 4);
+        assert(tall && left && atlas.add("right", pixels.data(), 60, 30, 128 * 4));
+        assert(!atlas.add("blocked", pixels.data(), 30, 30, 128 * 4));
+        assert(atlas.remove("right"));
+        const int tall_y = tall->rect.y;
+        const int left_x = left->rect.x;
+        assert(atlas.add("small", pixels.data(), 30, 30, 128 * 4) != nullptr);
+        assert(tall->rect.y == tall_y && left->rect.x == left_x);
+        assert(atlas.get_page_count() == 1);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void RunResourceManagerLruTest() {
+    using gui::resource_manager::Manager;
+    using gui::resource_manager::TextureResource;
+
+    Manager& manager = Manager::instance();
+    const uint64_t previous_limit = manager.get_memory_limit();
+    const uint64_t baseline = manager.get_total_memory_usage();
+
+    int created = 0;
+    auto make_texture = [&created](const std::string& id) {
+        ++created;
+        return std::make_shared<TextureResource>(id, ImTextureID{}, 16, 16); // 1 KiB
+    };
+
+    auto a = manager.get_texture("lru_test_a", make_texture);
+    manager.get_texture("lru_test_b", make_texture);
+    manager.get_texture("lru_test_c", make_texture);
+    assert(a && created == 3);
+
+    // Tracked resources are served without calling the creator, and move to
+    // the front of the recency list.
+    assert(manager.get_texture("lru_test_a", make_texture) == a);
+    assert(created == 3);
+
+    // Going over the limit evicts from the cold end: b, then c.
+    manager.set_memory_limit(baseline + 3 * 1024);
+    manager.get_texture("lru_test_d", make_texture);
+    assert(!manager.has_resource("lru_test_b"));
+    assert(manager.has_resource("lru_test_a"));
+    assert(manager.has_resource("lru_test_c"));
+    assert(manager.has_resource("lru_test_d"));
+    assert(manager.get_total_memory_usage() == baseline + 3 * 1024);
+
+    manager.get_texture("lru_test_b", make_texture);
+    assert(created == 5);
+    assert(!manager.has_resource("lru_test_c"));
+    assert(manager.has_resource("lru_test_a"));
+
+    // A released resource still held elsewhere comes back from the pool.
+    manager.release_resource("lru_test_a");
+    assert(!manager.has_resource("lru_test_a"));
+    assert(manager.get_texture("lru_test_a", make_texture) == a);
+    assert(created == 5);
+
+    for (const char* id : {"lru_test_a", "lru_test_b", "lru_test_d"}) {
+        manager.release_resource(id);
+    }
+    manager.set_memory_limit(previous_limit);
+    assert(manager.get_total_memory_usage() == baseline);
+}
+
+void RunResourceManagerAsyncLoadTest() {
+    using gui::resource_manager::DecodedImage;
+    using gui::resource_manager::Manager;
+    using gui::resource_manager::TextureRequest;
+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+    SDL_Window* window = SDL_CreateWindow(
+        "async", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    assert(renderer != nullptr);
+
+    Manager& manager = Manager::instance();
+    manager.integrate_with_sdl_renderer(renderer);
+    manager.set_upload_budget(8 * 8 * 4, std::chrono::milliseconds(50));
+
+    std::atomic<int> decodes{0};
+    auto decode = [&decodes](const std::string&, DecodedImage& image) {
+        ++decodes;
+        image.width = 8;
+        image.height = 8;
+        image.pixels.assign(8 * 8 * 4, 0xff);
+        return true;
+    };
+
+    auto first = manager.request_texture("async_test_a", decode);
+    auto second = manager.request_texture("async_test_b", decode);
+    assert(manager.request_texture("async_test_a", decode) == first);
+    auto broken = manager.request_texture(
+        "async_test_broken", [](const std::string&, DecodedImage&) { return false; });
+    assert(first && second && broken);
+    assert(!first->is_ready() && !first->get());
+
+    // Decoding happens off this thread; nothing reaches the renderer until
+    // uploads are pumped.
+    for (int i = 0; i < 500; ++i) {
+        if (first->get_state() == TextureRequest::State::Decoded &&
+            second->get_state() == TextureRequest::State::Decoded && broken->is_done()) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    assert(broken->get_state() == TextureRequest::State::Failed);
+    assert(decodes.load() == 2);
+    assert(manager.get_stats().pending_loads.load() == 2);
+    assert(manager.get_stats().pending_upload_bytes.load() == 2 * 8 * 8 * 4);
+    assert(!manager.has_resource("async_test_a"));
+
+    // The budget fits one image per frame.
+    assert(manager.process_uploads() == 1);
+    assert(manager.process_uploads() == 1);
+    assert(manager.process_uploads() == 0);
+    assert(first->is_ready() && second->is_ready());
+    assert(first->get() && first->get()->get_width() == 8);
+    assert(manager.has_resource("async_test_a"));
+    assert(manager.get_stats().pending_loads.load() == 0);
+    assert(manager.get_stats().pending_upload_bytes.load() == 0);
+
+    // Tracked textures are handed back ready without decoding again.
+    auto again = manager.request_texture("async_test_b", decode);
+    assert(again->is_ready() && again->get() == second->get());
+    assert(decodes.load() == 2);
+
+    // Detaching the renderer destroys its textures, even ones still held, and
+    // drops uploads that were meant for it.
+    auto pending = manager.request_texture("async_test_c", decode);
+    for (int i = 0; i < 500 && pending->get_state() != TextureRequest::State::Decoded; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    assert(pending->get_state() == TextureRequest::State::Decoded);
+    auto held = second->get();
+    manager.integrate_with_sdl_renderer(nullptr);
+    assert(held->get_texture() == ImTextureID{});
+    assert(!manager.has_resource("async_test_a") && !manager.has_resource("async_test_b"));
+    assert(pending->get_state() == TextureRequest::State::Failed);
+    assert(manager.get_stats().pending_loads.load() == 0);
+    assert(manager.get_stats().pending_upload_bytes.load() == 0);
+
+    manager.integrate_with_sdl_renderer(renderer);
+    assert(manager.process_uploads() == 0);
+    assert(!manager.has_resource("async_test_c"));
+
+    held.reset();
+    pending.reset();
+    first.reset();
+    second.reset();
+    again.reset();
+    manager.set_upload_budget(4 * 1024 * 1024, std::chrono::milliseconds(2));
+    manager.integrate_with_sdl_renderer(nullptr);
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void RunFontAtlasCacheTest() {
+    using gui::resource_manager::FontAtlasCache;
+    using gui::resource_manager::FontAtlasKey;
+    using gui::resource_manager::FontResource;
+
+    const auto directory = std::filesystem::temp_directory_path() / "cbngui_font_cache_test";
+    std::filesystem::remove_all(directory);
+
+    FontAtlasKey key;
+    ImFontAtlas atlas;
+    FontAtlasCache cache;
+    cache.set_directory(directory.string());
+    assert(cache.load(key, atlas));
+    assert(cache.get_rasterizations() == 1);
+    assert(atlas.Fonts.Size == 1);
+    const ImFontGlyph* glyph = atlas.Fonts[0]->FindGlyphNoFallback('A');
+    assert(glyph != nullptr);
+    const float advance = glyph->AdvanceX;
+    const ImWchar ellipsis = atlas.Fonts[0]->EllipsisChar;
+    const int width = atlas.TexWidth;
+    const int height = atlas.TexHeight;
+
+    // Switching back to a known size is a memory hit.
+    key.size_pixels = 20.0f;
+    assert(cache.load(key, atlas));
+    key.size_pixels = 13.0f;
+    assert(cache.load(key, atlas));
+    assert(cache.get_rasterizations() == 2);
+    assert(cache.get_memory_hits() == 1);
+    assert(atlas.TexWidth == width && atlas.TexHeight == height);
+
+    // A fresh cache, as on the next startup, restores the atlas from disk.
+    ImFontAtlas restored;
+    FontAtlasCache startup;
+    startup.set_directory(directory.string());
+    assert(startup.load(key, restored));
+    assert(startup.get_disk_hits() == 1);
+    assert(startup.get_rasterizations() == 0);
+    assert(restored.TexWidth == width && restored.TexHeight == height);
+    glyph = restored.Fonts[0]->FindGlyphNoFallback('A');
+    assert(glyph != nullptr && glyph->AdvanceX == advance);
+    assert(restored.Fonts[0]->ConfigData == &restored.ConfigData[0]);
+    assert(restored.Fonts[0]->EllipsisChar == ellipsis);
+    unsigned char* pixels = nullptr;
+    int restored_width = 0;
+    int restored_height = 0;
+    restored.GetTexDataAsRGBA32(&pixels, &restored_width, &restored_height);
+    assert(pixels != nullptr && restored_width == width);
+
+    FontResource font("font_cache_test", restored.Fonts[0]);
+    assert(font.supports_text("Hello, world"));
+    assert(!font.supports_text("\xD0\x9F\xD1\x80\xD0\xB8")); // Cyrillic
+    assert(!font.supports_text("\xFF"));                  // Malformed UTF-8
+
+    // Only codepoints outside the loaded ranges are queued, each once.
+    startup.request_glyphs("Hello");
+    assert(!startup.has_missing_glyphs());
+    startup.request_glyphs("\xD0\x9F\xD1\x80\xD0\xB8");
+    assert(startup.has_missing_glyphs());
+    assert(startup.merge_missing_glyphs(key));
+    assert(!key.ranges.empty() && key.ranges.back() == 0);
+    assert(!startup.merge_missing_glyphs(key));
+    // Each merge writes a new file; the least recently used are pruned.
+    startup.set_max_disk_entries(2);
+    assert(startup.load(key, restored));
+    assert(startup.get_rasterizations() == 1);
+    size_t cache_files = 0;
+    for (const auto& item : std::filesystem::directory_iterator(directory)) {
+        cache_files += item.path().extension() == ".bin" ? 1 : 0;
+    }
+    assert(cache_files == 2);
+    FontAtlasKey base_key;
+    ImFontAtlas base_atlas;
+    FontAtlasCache next_startup;
+    next_startup.set_directory(directory.string());
+    assert(next_startup.load(base_key, base_atlas));
+    assert(next_startup.get_disk_hits() == 1);
+    startup.request_glyphs("\xD0\x9F");
+    assert(!startup.has_missing_glyphs());
+
+    // Replacing the font file at the same path changes the cache id, so its
+    // old atlas is not restored.
+    std::filesystem::create_directories(directory);
+    FontAtlasKey file_key;
+    file_key.family = (directory / "replaced.ttf").string();
+    std::ofstream(file_key.family, std::ios::binary) << "first";
+    const std::string first_id = FontAtlasCache::get_cache_id(file_key);
+    std::ofstream(file_key.family, std::ios::binary | std::ios::trunc) << "second version";
+    assert(FontAtlasCache::get_cache_id(file_key) != first_id);
+    assert(FontAtlasCache::get_cache_id(file_key) == FontAtlasCache::get_cache_id(file_key));
+
+    std::filesystem::remove_all(directory);
+}
+
+void RunMapStreamTest() {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+    SDL_Window* window = SDL_CreateWindow(
+        "stream", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    assert(renderer != nullptr);
+
+    const uint64_t full_map = 64 * 32 * 4;
+    const uint64_t tile = 8 * 8 * 4;
+    {
+        MapStream stream(renderer, 64, 32);
+        assert(stream.IsValid());
+        assert(stream.GetFrontTexture() == nullptr);
+        assert(stream.GetPitch() == 64 * 4);
+
+        // The first present fills the back texture completely.
+        assert(stream.Present());
+        SDL_Texture* first = stream.GetFrontTexture();
+        assert(first != nullptr);
+        assert(stream.GetUploadedBytes() == full_map);
+        assert(!stream.Present());
+
+        uint8_t* pixels = stream.LockRect(SDL_Rect{8, 8, 8, 8});
+        assert(pixels == stream.GetPixels() + 8 * stream.GetPitch() + 8 * 4);
+        pixels[0] = 0xff;
+        assert(stream.LockRect(SDL_Rect{64, 0, 8, 8}) == nullptr);
+
+        // The other texture still needs its initial fill plus the new tile.
+        assert(stream.Present());
+        SDL_Texture* second = stream.GetFrontTexture();
+        assert(second != nullptr && second != first);
+        assert(stream.GetUploadedBytes() == 2 * full_map + tile);
+
+        // From now on each flip replays only the rects the texture missed.
+        stream.MarkDirty(SDL_Rect{56, 24, 16, 16}); // Clipped to 8x8
+        assert(stream.Present());
+        assert(stream.GetFrontTexture() == first);
+        assert(stream.GetUploadedBytes() == 2 * full_map + 3 * tile);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void RunMapWidgetTileMapTest() {
+    using gui::resource_manager::AtlasRegion;
+    using gui::resource_manager::TextureAtlas;
+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+    SDL_Window* window = SDL_CreateWindow(
+        "tiles", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE | SDL_RENDERER_TARGETTEXTURE);
+    assert(renderer != nullptr);
+
+    {
+        TextureAtlas atlas(renderer, 64, 1);
+        std::vector<uint32_t> grass(8 * 8, 0xff00ff00);
+        std::vector<uint32_t> monster(8 * 8, 0xff0000ff);
+        const AtlasRegion* grass_region = atlas.add("tile_grass", grass.data(), 8, 8, 8 * 4);
+        const AtlasRegion* monster_region = atlas.add("tile_monster", monster.data(), 8, 8, 8 * 4);
+        assert(grass_region && monster_region);
+
+        cataclysm::gui::EventBus bus;
+        cataclysm::gui::EventBusAdapter adapter(bus);
+        MapWidget widget(adapter);
+
+        int lookups = 0;
+        widget.SetTileSource(renderer, [&](uint32_t tile_id) -> const AtlasRegion* {
+            ++lookups;
+            return tile_id == 1 ? grass_region : tile_id == 2 ? monster_region : nullptr;
+        }, 8, 8);
+
+        std::vector<uint32_t> grid(4 * 3, 1);
+        widget.UpdateTiles(grid, 4, 3);
+        assert(widget.RedrawDirtyTiles() == 12);
+        assert(widget.RedrawDirtyTiles() == 0);
+
+        // A turn where a monster steps onto the map touches two cells.
+        widget.UpdateTiles(std::vector<TileChange>{{1, 1, 2}, {2, 1, 1}, {9, 9, 2}});
+        lookups = 0;
+        assert(widget.RedrawDirtyTiles() == 1);
+        assert(lookups == 1);
+
+        grid[1 * 4 + 1] = 1;
+        grid[1 * 4 + 2] = 2;
+        grid[0] = 0;
+        widget.UpdateTiles(grid, 4, 3);
+        assert(widget.RedrawDirtyTiles() == 3);
+
+        // A different grid size rebuilds the surface.
+        widget.UpdateTiles(std::vector<uint32_t>(2 * 2, 1), 2, 2);
+        assert(widget.RedrawDirtyTiles() == 4);
+
+        widget.InvalidateTiles();
+        assert(widget.RedrawDirtyTiles() == 4);
+
+        // A snapshot texture from the game switches tile rendering off.
+        widget.UpdateMapTexture(nullptr, 0, 0, 0, 0);
+        widget.UpdateTiles(std::vector<TileChange>{{0, 0, 2}});
+        assert(widget.RedrawDirtyTiles() == 0);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void RunMapWidgetZoomTest() {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+    SDL_Window* window = SDL_CreateWindow(
+        "zoom", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 64, 64, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE | SDL_RENDERER_TARGETTEXTURE);
+    assert(renderer != nullptr);
+    SDL_Texture* snapshot =
+        SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, 512, 512);
+    assert(snapshot != nullptr);
+
+    {
+        cataclysm::gui::EventBus bus;
+        cataclysm::gui::EventBusAdapter adapter(bus);
+        MapWidget widget(adapter);
+        widget.SetRenderer(renderer);
+        widget.UpdateMapTexture(snapshot, 512, 512, 64, 64);
+
+        ImVec2 uv0;
+        ImVec2 uv1;
+        widget.GetVisibleRegion(&uv0, &uv1);
+        assert(uv0.x == 0.0f && uv0.y == 0.0f && uv1.x == 1.0f && uv1.y == 1.0f);
+        assert(widget.TileAt(ImVec2(0.5f, 0.5f))->x == 32);
+
+        // Shown at 64px, the 512px snapshot is drawn from the 1/8 level.
+        SDL_Texture* level = widget.PrepareMipLevel(ImVec2(64.0f, 64.0f));
+        assert(level != nullptr && level != snapshot);
+        assert(widget.GetMipLevel() == 3);
+        assert(widget.PrepareMipLevel(ImVec2(512.0f, 512.0f)) == snapshot);
+        assert(widget.GetMipLevel() == 0);
+
+        // Alternating between two textures of one size, as a map stream does,
+        // redraws the levels without recreating them.
+        SDL_Texture* back_buffer =
+            SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, 512, 512);
+        assert(back_buffer != nullptr);
+        widget.UpdateMapTexture(back_buffer, 512, 512, 64, 64);
+        assert(widget.PrepareMipLevel(ImVec2(64.0f, 64.0f)) == level);
+        widget.UpdateMapTexture(snapshot, 512, 512, 64, 64);
+        assert(widget.PrepareMipLevel(ImVec2(64.0f, 64.0f)) == level);
+        widget.InvalidateRenderTargets();
+        assert(widget.PrepareMipLevel(ImVec2(64.0f, 64.0f)) == level);
+        SDL_DestroyTexture(back_buffer);
+
+        // Zooming keeps the tile under the cursor and picks a finer level.
+        const TileSelection before = *widget.TileAt(ImVec2(0.25f, 0.25f));
+        widget.ZoomAt(4.0f, ImVec2(0.25f, 0.25f));
+        assert(widget.GetZoom() == 4.0f);
+        const TileSelection after = *widget.TileAt(ImVec2(0.25f, 0.25f));
+        assert(before.x == after.x && before.y == after.y);
+        widget.PrepareMipLevel(ImVec2(64.0f, 64.0f));
+        assert(widget.GetMipLevel() == 1);
+
+        // The view never leaves the map.
+        widget.Pan(ImVec2(-10.0f, 0.0f));
+        widget.GetVisibleRegion(&uv0, &uv1);
+        assert(uv0.x == 0.0f && uv1.x == 0.25f);
+        assert(widget.TileAt(ImVec2(1.0f, 0.0f))->x == 16);
+
+        widget.SetZoom(0.5f);
+        assert(widget.GetZoom() == 1.0f);
+        widget.ResetView();
+        widget.GetVisibleRegion(&uv0, &uv1);
+        assert(uv0.x == 0.0f && uv1.y == 1.0f);
+    }
+
+    SDL_DestroyTexture(snapshot);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+std::string ReadWholeFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void RunSettingsWriterTest() {
+    using CataclysmBN::GUI::SettingsWriter;
+
+    const auto directory = std::filesystem::temp_directory_path() / "cbngui_settings_writer_test";
+    std::filesystem::remove_all(directory);
+    const auto path = directory / "nested" / "gui_settings.json";
+
+    // A burst of saves within the debounce window becomes one write of the last contents.
+    SettingsWriter writer(std::chrono::milliseconds(50));
+    for (int i = 0; i < 20; ++i) {
+        writer.schedule(path.string(), "{\"font_size\": " + std::to_string(i) + "}");
+    }
+    assert(writer.getWriteCount() == 0);
+    assert(!std::filesystem::exists(path));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (writer.getWriteCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(writer.getWriteCount() == 1);
+    assert(ReadWholeFile(path) == "{\"font_size\": 19}");
+    assert(std::distance(std::filesystem::directory_iterator(path.parent_path()),
+                         std::filesystem::directory_iterator()) == 1);
+
+    // flush() writes pending contents without waiting out the debounce.
+    writer.setDebounce(std::chrono::milliseconds(60000));
+    writer.schedule(path.string(), "second");
+    writer.flush();
+    assert(writer.getWriteCount() == 2);
+    assert(ReadWholeFile(path) == "second");
+
+    // Pending writes survive the writer going away.
+    {
+        SettingsWriter shutdown(std::chrono::milliseconds(60000));
+        shutdown.schedule(path.string(), "third");
+    }
+    assert(ReadWholeFile(path) == "third");
+    assert(writer.getFailedWriteCount() == 0);
+
+    // An explicit write replaces contents still waiting out the debounce, so
+    // they cannot land on top of it later.
+    writer.schedule(path.string(), "stale");
+    assert(writer.write(path.string(), "explicit"));
+    writer.flush();
+    assert(ReadWholeFile(path) == "explicit");
+
+    // Explicit and background writes of one path never interleave.
+    writer.setDebounce(std::chrono::milliseconds(0));
+    std::thread background([&writer, &path] {
+        for (int i = 0; i < 50; ++i) {
+            writer.schedule(path.string(), std::string(4096, 'b'));
+        }
+    });
+    for (int i = 0; i < 50; ++i) {
+        assert(writer.write(path.string(), std::string(4096, 'e')));
+    }
+    background.join();
+    writer.flush();
+    const std::string last = ReadWholeFile(path);
+    assert(last == std::string(4096, 'b') || last == std::string(4096, 'e'));
+    assert(writer.getFailedWriteCount() == 0);
+
+    std::filesystem::remove_all(directory);
+}
+
+void RunSettingsSnapshotTest() {
+    using CataclysmBN::GUI::SettingsSnapshot;
+    using CataclysmBN::GUI::SettingsWriter;
+    using CataclysmBN::GUI::SnapshotReader;
+    using CataclysmBN::GUI::SnapshotSection;
+    using CataclysmBN::GUI::SnapshotWriter;
+
+    const auto directory = std::filesystem::temp_directory_path() / "cbngui_settings_snapshot_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::string source = (directory / "gui_settings.json").string();
+    const std::string layout = (directory / "imgui.ini").string();
+    const std::string path = (directory / "gui_snapshot.bin").string();
+
+    assert(SettingsWriter::writeAtomically(source, "{\"font_size\": 16}"));
+    const uint64_t hash = SettingsSnapshot::hashSources({source, layout});
+    // The writer side hashes the contents it is about to save; both must agree.
+    assert(hash == SettingsSnapshot::combineHashes(
+                       SettingsSnapshot::combineHashes(0, SettingsSnapshot::hashContents("{\"font_size\": 16}")),
+                       SettingsSnapshot::hashFile(layout)));
+
+    SnapshotWriter writer;
+    writer.beginSection(SnapshotSection::Settings);
+    writer.writeInt(-3);
+    writer.writeString("Arial");
+    writer.writeBool(true);
+    writer.endSection();
+    writer.beginSection(SnapshotSection::Layout);
+    writer.writeString("[Window][Inventory]\nPos=10,20\n");
+    writer.endSection();
+    assert(SettingsWriter::writeAtomically(path, writer.finish(hash)));
+
+    SettingsSnapshot snapshot;
+    assert(snapshot.open(path, hash));
+    assert(snapshot.hasSection(SnapshotSection::Settings));
+    assert(!snapshot.hasSection(SnapshotSection::Toggles));
+    SnapshotReader settings = snapshot.getSection(SnapshotSection::Settings);
+    assert(settings.readInt() == -3);
+    assert(settings.readString() == "Arial");
+    assert(settings.readBool());
+    assert(settings.ok() && settings.atEnd());
+    // Reading past the section fails instead of running into the next one.
+    assert(settings.readU32() == 0);
+    assert(!settings.ok());
+    SnapshotReader layoutSection = snapshot.getSection(SnapshotSection::Layout);
+    assert(layoutSection.readString() == "[Window][Inventory]\nPos=10,20\n");
+    assert(!snapshot.getSection(SnapshotSection::Toggles).ok());
+    snapshot.close();
+
+    // Editing a JSON source, or creating a source that was missing, makes the snapshot stale.
+    assert(SettingsWriter::writeAtomically(source, "{\"font_size\": 18}"));
+    assert(!snapshot.open(path, SettingsSnapshot::hashSources({source, layout})));
+    assert(SettingsWriter::writeAtomically(source, "{\"font_size\": 16}"));
+    assert(SettingsWriter::writeAtomically(layout, ""));
+    assert(!snapshot.open(path, SettingsSnapshot::hashSources({source, layout})));
+
+    // Truncated and foreign files are rejected.
+    std::string bytes = writer.finish(hash);
+    assert(SettingsWriter::writeAtomically(path, bytes.substr(0, bytes.size() - 4)));
+    assert(!snapshot.open(path, hash));
+    bytes[0] = 'X';
+    assert(SettingsWriter::writeAtomically(path, bytes));
+    assert(!snapshot.open(path, hash));
+    assert(!snapshot.open((directory / "missing.bin").string(), hash));
+
+    std::filesystem::remove_all(directory);
+}
+
+#if GUI_TEST_TOGGLE_MANAGER
+void RunToggleManagerRegistryTest() {
+    using CataclysmBN::GUI::ToggleManager;
+
+    ToggleManager manager;
+    std::vector<std::string> notified;
+    manager.addComponentStateChangeCallback([&](const std::string& id, bool, bool) {
+        notified.push_back(id);
+    });
+    std::vector<std::string> published;
+    auto toggled_subscription = cataclysm::gui::EventBusManager::getGlobalEventBus()
+        .subscribe<cataclysm::gui::UiComponentToggledEvent>([&](const cataclysm::gui::UiComponentToggledEvent& event) {
+            published.push_back(event.getComponentId());
+        });
+
+    const ToggleManager::ComponentHandle alpha = manager.registerComponent("test_alpha", "Alpha", true, "Test Category");
+    const ToggleManager::ComponentHandle beta = manager.registerComponent("test_beta", "Beta", false, "Test Category");
+    assert(alpha != ToggleManager::kInvalidHandle && beta != ToggleManager::kInvalidHandle);
+    assert(alpha != beta);
+
+    // Re-registering after unregistering keeps the slot
+    assert(manager.unregisterComponent("test_alpha"));
+    assert(manager.getComponentHandle("test_alpha") == ToggleManager::kInvalidHandle);
+    assert(manager.registerComponent("test_alpha", "Alpha", true, "Test Category") == alpha);
+    assert(manager.getComponentHandle("test_alpha") == alpha);
+
+    // Only the component whose bit flipped is told about a category change
+    notified.clear();
+    published.clear();
+    manager.setCategoryVisible("Test Category", true);
+    assert(notified.size() == 1 && notified[0] == "test_beta");
+    assert(published == notified);
+    notified.clear();
+    manager.setCategoryVisible("Test Category", true);
+    assert(notified.empty());
+    manager.setComponentVisible(alpha, false);
+    notified.clear();
+    manager.setCategoryVisible("Test Category", false);
+    assert(notified.size() == 1 && notified[0] == "test_beta");
+
+    // Callbacks run once the whole category is updated, even across bitset words
+    ToggleManager::ComponentHandle last_bulk = ToggleManager::kInvalidHandle;
+    for (int i = 0; i < 70; ++i) {
+        last_bulk = manager.registerComponent("test_bulk_" + std::to_string(i), "Bulk", false, "Test Bulk");
+        assert(last_bulk != ToggleManager::kInvalidHandle);
+    }
+    size_t bulk_calls = 0;
+    bool saw_stale_state = false;
+    const int observer = manager.addComponentStateChangeCallback([&](const std::string&, bool, bool) {
+        ++bulk_calls;
+        saw_stale_state = saw_stale_state || !manager.isComponentVisible(last_bulk);
+    });
+    manager.setCategoryVisible("Test Bulk", true);
+    assert(bulk_calls == 70);
+    assert(!saw_stale_state);
+    assert(manager.removeCallback(observer));
+    for (int i = 0; i < 70; ++i) {
+        assert(manager.unregisterComponent("test_bulk_" + std::to_string(i)));
+    }
+    manager.setCategoryVisible("Test Category", true);
+
+    // A shortcut toggles one component; binding it again moves it
+    manager.registerToggleShortcut("test_alpha", 'q', true, false);
+    assert(manager.getShortcutForComponent("test_alpha") == "Ctrl+Key_113");
+    manager.registerToggleShortcut("test_beta", 'q', true, false);
+    assert(manager.getShortcutForComponent("test_alpha").empty());
+    assert(manager.getShortcutForComponent("test_beta") == "Ctrl+Key_113");
+    assert(manager.isComponentVisible(beta));
+    assert(manager.processKeyboardToggle('q', true, false));
+    assert(!manager.isComponentVisible(beta));
+    assert(manager.isComponentVisible(alpha));
+
+    // Handle queries on an unregistered component report it off and refuse changes
+    assert(manager.unregisterComponent("test_beta"));
+    assert(!manager.isComponentVisible(beta));
+    assert(!manager.isComponentEnabled(beta));
+    notified.clear();
+    assert(!manager.setComponentVisible(beta, true));
+    assert(!manager.setComponentEnabled(beta, true));
+    assert(notified.empty());
+    assert(!manager.isComponentVisible(beta));
+    assert(!manager.processKeyboardToggle('q', true, false));
+    assert(!manager.isComponentVisible(ToggleManager::kInvalidHandle));
+    assert(!manager.setComponentVisible(ToggleManager::kInvalidHandle, true));
+
+    // Defaults come back in the slots they had before the reset
+    const ToggleManager::ComponentHandle profiler = manager.getComponentHandle("frame_profiler");
+    const ToggleManager::ComponentHandle inventory = manager.getComponentHandle("inventory_panel");
+    assert(profiler != ToggleManager::kInvalidHandle && inventory != ToggleManager::kInvalidHandle);
+    const int default_count = manager.getComponentCount() - 1;
+    manager.resetToDefaults();
+    assert(manager.getComponentCount() == default_count);
+    assert(manager.getComponentHandle("frame_profiler") == profiler);
+    assert(manager.getComponentHandle("inventory_panel") == inventory);
+    assert(manager.getComponentHandle("test_alpha") == ToggleManager::kInvalidHandle);
+    assert(!manager.isComponentVisible(alpha));
+    assert(manager.registerComponent("test_alpha", "Alpha", true, "Test Category") == alpha);
+    toggled_subscription.unsubscribe();
+}
+#endif
+
+void RunUiManagerRedrawCoalescingTest() {
+    auto& ui_manager = cataclysm::gui::UiManager::instance();
+    ui_manager.dispatch_redraws();
+
+    int first_redraws = 0;
+    int second_redraws = 0;
+    cataclysm::gui::UiAdaptor first;
+    cataclysm::gui::UiAdaptor second;
+    first.set_redraw_callback([&]() {
+        ++first_redraws;
+        // Requests made while redrawing wait for the next frame
+        ui_manager.request_redraw();
+    });
+    second.set_redraw_callback([&]() { ++second_redraws; });
+    ui_manager.register_adaptor(first);
+    ui_manager.register_adaptor(second);
+    ui_manager.register_adaptor(first);
+    assert(ui_manager.registered_count() == 2);
+
+    assert(!ui_manager.dispatch_redraws());
+    for (int i = 0; i < 5; ++i) {
+        ui_manager.request_redraw();
+    }
+    assert(ui_manager.redraw_pending());
+    assert(first_redraws == 0 && second_redraws == 0);
+
+    assert(ui_manager.dispatch_redraws());
+    assert(first_redraws == 1 && second_redraws == 1);
+    assert(ui_manager.redraw_pending());
+    assert(ui_manager.dispatch_redraws());
+    assert(first_redraws == 2 && second_redraws == 2);
+
+    ui_manager.unregister_adaptor(first);
+    assert(!ui_manager.is_registered(first) && ui_manager.is_registered(second));
+    assert(ui_manager.dispatch_redraws());
+    assert(first_redraws == 2 && second_redraws == 3);
+    assert(!ui_manager.dispatch_redraws());
+
+    ui_manager.unregister_adaptor(second);
+    assert(ui_manager.registered_count() == 0);
+}
+
 void RunOverlayManagerUiIntegrationTest() {
     SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
 
@@ -258,6 +1305,287 @@ void RunOverlayManagerUiIntegrationTest() {
     SDL_QuitSubSystem(SDL_INIT_VIDEO);
 }
 
+void RunOverlayIdleFrameSkipTest() {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+
+    SDL_Window* window = SDL_CreateWindow(
+        "overlay", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 640, 480, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    if (!renderer) {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    }
+    assert(renderer != nullptr);
+
+    OverlayManager overlay_manager;
+    OverlayManager::Config config;
+    config.skip_idle_frames = true;
+    assert(overlay_manager.Initialize(window, renderer, config));
+
+    overlay_manager.Open();
+    overlay_manager.ShowInventory();
+    inventory_overlay_state inventory_state{};
+    inventory_state.columns[0].name = "Worn";
+    overlay_manager.UpdateInventory(inventory_state);
+
+    // Once the frame has settled, further renders reuse it.
+    for (int i = 0; i < 8; ++i) {
+        overlay_manager.Render();
+    }
+    const uint64_t skipped_while_idle = overlay_manager.GetSkippedFrameCount();
+    assert(skipped_while_idle > 0);
+
+    // New state forces a rebuild on the next frame.
+    overlay_manager.MarkDirty();
+    overlay_manager.Render();
+    assert(overlay_manager.GetSkippedFrameCount() == skipped_while_idle);
+
+    overlay_manager.Close();
+    overlay_manager.HideInventory();
+    overlay_manager.Shutdown();
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void RunOverlayRenderTargetCacheTest() {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+
+    SDL_Window* window = SDL_CreateWindow(
+        "overlay", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 640, 480, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    if (!renderer) {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    }
+    assert(renderer != nullptr);
+    assert(SDL_RenderTargetSupported(renderer));
+
+    OverlayManager overlay_manager;
+    OverlayManager::Config config;
+    config.skip_idle_frames = true;
+    assert(overlay_manager.Initialize(window, renderer, config));
+    assert(!overlay_manager.IsRenderTargetCacheValid());
+
+    overlay_manager.Open();
+    overlay_manager.ShowInventory();
+    inventory_overlay_state inventory_state{};
+    inventory_state.columns[0].name = "Worn";
+    overlay_manager.UpdateInventory(inventory_state);
+
+    // Settled frames are composited from the cached target; each call after
+    // that is a skip, not a rebuild.
+    auto settle = [&overlay_manager]() {
+        for (int i = 0; i < 8; ++i) {
+            overlay_manager.Render();
+        }
+        assert(overlay_manager.IsRenderTargetCacheValid());
+        const uint64_t skipped = overlay_manager.GetSkippedFrameCount();
+        overlay_manager.Render();
+        overlay_manager.Render();
+        assert(overlay_manager.GetSkippedFrameCount() == skipped + 2);
+        assert(overlay_manager.IsRenderTargetCacheValid());
+    };
+    settle();
+
+    // A resize drops the target; the next frame rebuilds it at the new size.
+    SDL_SetWindowSize(window, 800, 600);
+    SDL_Event resize{};
+    resize.type = SDL_WINDOWEVENT;
+    resize.window.event = SDL_WINDOWEVENT_SIZE_CHANGED;
+    resize.window.data1 = 800;
+    resize.window.data2 = 600;
+    overlay_manager.HandleEvent(resize);
+    assert(!overlay_manager.IsRenderTargetCacheValid());
+    uint64_t skipped_before = overlay_manager.GetSkippedFrameCount();
+    overlay_manager.Render();
+    assert(overlay_manager.GetSkippedFrameCount() == skipped_before);
+    assert(overlay_manager.IsRenderTargetCacheValid());
+    settle();
+
+    // So does a DPI change, which also rasterizes the font again.
+    overlay_manager.SetDPIScale(2.0f);
+    assert(!overlay_manager.IsRenderTargetCacheValid());
+    skipped_before = overlay_manager.GetSkippedFrameCount();
+    overlay_manager.Render();
+    assert(overlay_manager.GetSkippedFrameCount() == skipped_before);
+    assert(overlay_manager.IsRenderTargetCacheValid());
+    settle();
+
+    // Rejected or unchanged scales keep the cached frame.
+    overlay_manager.SetDPIScale(0.0f);
+    overlay_manager.SetDPIScale(2.0f);
+    assert(overlay_manager.IsRenderTargetCacheValid());
+
+    overlay_manager.Close();
+    overlay_manager.HideInventory();
+    overlay_manager.Shutdown();
+    assert(!overlay_manager.IsRenderTargetCacheValid());
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void RunOverlayLazyInitTest() {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+
+    SDL_Window* window = SDL_CreateWindow(
+        "overlay", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 640, 480, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    if (!renderer) {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    }
+    assert(renderer != nullptr);
+
+    ImGuiContext* const context_before = ImGui::GetCurrentContext();
+    OverlayManager overlay_manager;
+    OverlayManager::Config config;
+    config.lazy_init = true;
+    assert(overlay_manager.Initialize(window, renderer, config));
+    assert(!overlay_manager.HasSubsystems());
+    assert(ImGui::GetCurrentContext() == context_before);
+
+    // State handed over while deferred is kept for the UI built later.
+    inventory_overlay_state inventory_state{};
+    inventory_state.columns[0].name = "Worn";
+    overlay_manager.UpdateInventory(inventory_state);
+    overlay_manager.ShowInventory();
+    overlay_manager.UpdateMapTiles(std::vector<uint32_t>(16, 0u), 4, 4);
+    overlay_manager.Render();
+    assert(!overlay_manager.HasSubsystems());
+
+    // The host hears about resizes before there is a renderer to resize.
+    int resized_width = 0;
+    int resized_height = 0;
+    overlay_manager.RegisterResizeCallback([&](int width, int height) {
+        resized_width = width;
+        resized_height = height;
+    });
+    overlay_manager.OnWindowResized(800, 600);
+    assert(resized_width == 800 && resized_height == 600);
+    assert(!overlay_manager.HasSubsystems());
+
+    // An idle-frame prewarm builds everything; Open() then has nothing left to do.
+    assert(overlay_manager.Prewarm());
+    assert(overlay_manager.HasSubsystems());
+    assert(ImGui::GetCurrentContext() != context_before);
+    overlay_manager.Open();
+    assert(overlay_manager.IsOpen());
+    overlay_manager.Render();
+    overlay_manager.Close();
+    overlay_manager.HideInventory();
+    overlay_manager.Shutdown();
+    assert(!overlay_manager.HasSubsystems());
+
+    // Without a prewarm, the first Open() builds the subsystems.
+    OverlayManager on_open;
+    assert(on_open.Initialize(window, renderer, config));
+    on_open.Open();
+    assert(on_open.HasSubsystems() && on_open.IsOpen());
+    on_open.Render();
+    on_open.Close();
+    on_open.Shutdown();
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void RunOverlayInventoryDeltaUpdateTest() {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+        assert(!"SDL_InitSubSystem(SDL_INIT_VIDEO) failed");
+    }
+
+    SDL_Window* window = SDL_CreateWindow(
+        "overlay", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 640, 480, SDL_WINDOW_HIDDEN);
+    assert(window != nullptr);
+
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    if (!renderer) {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    }
+    assert(renderer != nullptr);
+
+    OverlayManager overlay_manager;
+    assert(overlay_manager.Initialize(window, renderer));
+
+    inventory_overlay_patch select_second{};
+    inventory_entry_patch select{};
+    select.op = inventory_entry_patch::operation::set_flags;
+    select.column = 1;
+    select.row = 1;
+    select.entry.is_selected = true;
+    select_second.entries.push_back(select);
+    assert(!overlay_manager.PatchInventory(select_second));
+
+    auto snapshot = std::make_shared<inventory_overlay_state>();
+    snapshot->columns[1].entries.resize(3);
+    overlay_manager.UpdateInventory(std::shared_ptr<const inventory_overlay_state>(snapshot));
+    assert(overlay_manager.GetInventoryState().get() == snapshot.get());
+
+    // Patching a shared snapshot copies it once and leaves the caller's copy alone.
+    assert(overlay_manager.PatchInventory(select_second));
+    auto patched = overlay_manager.GetInventoryState();
+    assert(patched.get() != snapshot.get());
+    assert(!snapshot->columns[1].entries[1].is_selected);
+    assert(patched->columns[1].entries[1].is_selected);
+
+    inventory_overlay_patch reshape{};
+    inventory_entry_patch erase{};
+    erase.op = inventory_entry_patch::operation::erase;
+    erase.column = 1;
+    erase.row = 0;
+    inventory_entry_patch insert{};
+    insert.op = inventory_entry_patch::operation::insert;
+    insert.column = 1;
+    insert.row = 2;
+    insert.entry.label = "rope";
+    reshape.entries = {erase, insert};
+    reshape.active_column = 1;
+    reshape.scroll_positions[1] = 1;
+    patched.reset();
+    const inventory_overlay_state* owned = overlay_manager.GetInventoryState().get();
+    assert(overlay_manager.PatchInventory(reshape));
+    auto reshaped = overlay_manager.GetInventoryState();
+    assert(reshaped.get() == owned);
+    assert(reshaped->columns[1].entries.size() == 3);
+    assert(reshaped->columns[1].entries[0].is_selected);
+    assert(reshaped->columns[1].entries[2].label == "rope");
+    assert(reshaped->active_column == 1);
+    assert(reshaped->columns[1].scroll_position == 1);
+
+    inventory_overlay_patch out_of_range{};
+    erase.row = 3;
+    out_of_range.entries.push_back(erase);
+    assert(!overlay_manager.PatchInventory(out_of_range));
+
+    overlay_manager.Shutdown();
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
 struct MockInventorySelector {
     int active_column = 0;
     std::string filter_text;
@@ -424,11 +1752,13 @@ void RunOverlayInventoryInteractionBridgeTest() {
 
     overlay_manager.SetInventoryKeyHandler([
         &actual_context
-    ](const SDL_KeyboardEvent &key_event) {
+    ](const SDL_KeyboardEvent &key_event, int repeat_count) {
         SDL_Event wrapped{};
         wrapped.type = key_event.type;
         wrapped.key = key_event;
-        actual_context.handle_event(wrapped);
+        for (int i = 0; i < repeat_count; ++i) {
+            actual_context.handle_event(wrapped);
+        }
     });
 
     cataclysm::gui::InventoryItemClickedEvent pre_click(clicked_entry);
@@ -477,12 +1807,28 @@ void RunOverlayInventoryInteractionBridgeTest() {
     assert(actual_selector.filter_text == expected_selector.filter_text);
     assert(actual_selector.examine_invoked == expected_selector.examine_invoked);
 
+    // A click still queued when the overlay closes is dropped, not delivered
+    // after the next Open().
+    event_bus.enqueue(cataclysm::gui::InventoryItemClickedEvent(clicked_entry));
     overlay_manager.Close();
+    assert(event_bus.getQueuedEventCount() == 0);
 
     cataclysm::gui::InventoryItemClickedEvent post_click(clicked_entry);
     event_bus.publish(post_click);
     assert(actual_selector.activated_entries == expected_selector.activated_entries);
 
+    overlay_manager.Open();
+    overlay_manager.Render();
+    assert(actual_selector.activated_entries == expected_selector.activated_entries);
+
+    // ToggleManager's frame_profiler component reaches the overlay through the bus.
+    const cataclysm::gui::Symbol profiler_id("frame_profiler");
+    event_bus.publish(cataclysm::gui::UiComponentToggledEvent(profiler_id, true, true));
+    assert(overlay_manager.IsProfilerVisible());
+    event_bus.publish(cataclysm::gui::UiComponentToggledEvent(profiler_id, true, false));
+    assert(!overlay_manager.IsProfilerVisible());
+    overlay_manager.Close();
+
     overlay_manager.HideInventory();
     overlay_manager.Shutdown();
 
@@ -540,7 +1886,7 @@ void RunOverlayCharacterInteractionBridgeTest() {
 
     auto &event_bus = cataclysm::gui::EventBusManager::getGlobalEventBus();
 
-    cataclysm::gui::CharacterTabRequestedEvent pre_open_tab("skills");
+    cataclysm::gui::CharacterTabRequestedEvent pre_open_tab(cataclysm::gui::Symbol("skills"));
     event_bus.publish(pre_open_tab);
     assert(actual_display.active_tab_index == -1);
 
@@ -549,12 +1895,12 @@ void RunOverlayCharacterInteractionBridgeTest() {
     overlay_manager.SetFocused(true);
 
     expected_display.request_tab("skills");
-    cataclysm::gui::CharacterTabRequestedEvent tab_event("skills");
+    cataclysm::gui::CharacterTabRequestedEvent tab_event(cataclysm::gui::Symbol("skills"));
     event_bus.publish(tab_event);
     assert(actual_display.active_tab_index == expected_display.active_tab_index);
 
     expected_display.activate_row("traits", 2);
-    cataclysm::gui::CharacterRowActivatedEvent row_event("traits", 2);
+    cataclysm::gui::CharacterRowActivatedEvent row_event(cataclysm::gui::Symbol("traits"), 2);
     event_bus.publish(row_event);
     assert(actual_display.active_tab_index == expected_display.active_tab_index);
     assert(actual_display.active_row_index == expected_display.active_row_index);
@@ -568,7 +1914,7 @@ void RunOverlayCharacterInteractionBridgeTest() {
     overlay_manager.HideCharacter();
     const int hidden_tab_index = actual_display.active_tab_index;
     const int hidden_row_index = actual_display.active_row_index;
-    cataclysm::gui::CharacterTabRequestedEvent hidden_tab("stats");
+    cataclysm::gui::CharacterTabRequestedEvent hidden_tab(cataclysm::gui::Symbol("stats"));
     event_bus.publish(hidden_tab);
     assert(actual_display.active_tab_index == hidden_tab_index);
     assert(actual_display.active_row_index == hidden_row_index);
@@ -579,7 +1925,7 @@ void RunOverlayCharacterInteractionBridgeTest() {
     assert(actual_display.active_tab_index == expected_display.active_tab_index);
 
     expected_display.activate_row("effects", 1);
-    cataclysm::gui::CharacterRowActivatedEvent effects_row("effects", 1);
+    cataclysm::gui::CharacterRowActivatedEvent effects_row(cataclysm::gui::Symbol("effects"), 1);
     event_bus.publish(effects_row);
     assert(actual_display.active_tab_index == expected_display.active_tab_index);
     assert(actual_display.active_row_index == expected_display.active_row_index);
@@ -591,7 +1937,7 @@ void RunOverlayCharacterInteractionBridgeTest() {
     event_bus.publish(closed_command);
     assert(actual_display.command_count == expected_display.command_count);
     assert(actual_display.last_command == expected_display.last_command);
-    cataclysm::gui::CharacterTabRequestedEvent closed_tab("skills");
+    cataclysm::gui::CharacterTabRequestedEvent closed_tab(cataclysm::gui::Symbol("skills"));
     event_bus.publish(closed_tab);
     assert(actual_display.active_tab_index == closed_tab_index);
     assert(actual_display.active_row_index == closed_row_index);
@@ -637,7 +1983,7 @@ void RunOverlayInventoryBridgeModalEventTest() {
     overlay_manager.SetInventoryKeyHandler([
         &inventory_key_forwarded,
         &forwarded_keycode
-    ](const SDL_KeyboardEvent &key_event) {
+    ](const SDL_KeyboardEvent &key_event, int) {
         inventory_key_forwarded = true;
         forwarded_keycode = key_event.keysym.sym;
     });
@@ -765,7 +2111,7 @@ void RunOverlayCharacterBridgeModalEventTest() {
 
     auto &event_bus = cataclysm::gui::EventBusManager::getGlobalEventBus();
 
-    cataclysm::gui::CharacterTabRequestedEvent pre_open_tab("stats");
+    cataclysm::gui::CharacterTabRequestedEvent pre_open_tab(cataclysm::gui::Symbol("stats"));
     event_bus.publish(pre_open_tab);
     assert(!character_tab_forwarded);
 
@@ -792,7 +2138,7 @@ void RunOverlayCharacterBridgeModalEventTest() {
 
     character_tab_forwarded = false;
     forwarded_tab_id.clear();
-    cataclysm::gui::CharacterTabRequestedEvent tab_event("skills");
+    cataclysm::gui::CharacterTabRequestedEvent tab_event(cataclysm::gui::Symbol("skills"));
     event_bus.publish(tab_event);
     assert(character_tab_forwarded);
     assert(forwarded_tab_id == "skills");
@@ -800,7 +2146,7 @@ void RunOverlayCharacterBridgeModalEventTest() {
     character_row_forwarded = false;
     forwarded_row_tab.clear();
     forwarded_row_index = -1;
-    cataclysm::gui::CharacterRowActivatedEvent row_event("effects", 1);
+    cataclysm::gui::CharacterRowActivatedEvent row_event(cataclysm::gui::Symbol("effects"), 1);
     event_bus.publish(row_event);
     assert(character_row_forwarded);
     assert(forwarded_row_tab == "effects");
@@ -843,6 +2189,8 @@ struct EventRecorder {
     SDL_Keycode last_forwarded_keycode = SDLK_UNKNOWN;
     SDL_Scancode last_forwarded_scancode = SDL_SCANCODE_UNKNOWN;
     SDL_Keymod last_forwarded_mod = KMOD_NONE;
+    int inventory_key_events = 0;
+    int last_forwarded_repeat_count = 0;
     std::string last_tab_id;
     size_t last_row_index = 0;
     cataclysm::gui::CharacterCommand last_character_command = cataclysm::gui::CharacterCommand::HELP;
@@ -853,6 +2201,7 @@ struct EventRecorder {
     std::string last_filter_text;
     std::string last_filter_target;
     bool last_filter_case_sensitive = false;
+    std::vector<cataclysm::gui::FilterMatch> last_filter_matches;
     std::string last_item_id;
     std::string last_item_source;
     bool last_item_double_click = false;
@@ -993,6 +2342,7 @@ void RenderOverlayFrame(OverlayUI& overlay_ui,
 }
 
 void RenderFrame(ImGuiIO& io,
+                 cataclysm::gui::EventBusAdapter& adapter,
                  OverlayUI& overlay_ui,
                  const inventory_overlay_state& inventory_state,
                  const character_overlay_state& character_state,
@@ -1004,15 +2354,17 @@ void RenderFrame(ImGuiIO& io,
     ImGui::NewFrame();
     RenderOverlayFrame(overlay_ui, inventory_state, character_state);
     ImGui::Render();
+    adapter.flush();
 }
 
 void RunVisualInteractionTest(ImGuiIO& io,
+                              cataclysm::gui::EventBusAdapter& adapter,
                               OverlayUI& overlay_ui,
                               const inventory_overlay_state& inventory_state,
                               const character_overlay_state& character_state,
                               EventRecorder& recorder) {
-    RenderFrame(io, overlay_ui, inventory_state, character_state, ImVec2(-1000.0f, -1000.0f), false);
-    RenderFrame(io, overlay_ui, inventory_state, character_state, ImVec2(-1000.0f, -1000.0f), false);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, ImVec2(-1000.0f, -1000.0f), false);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, ImVec2(-1000.0f, -1000.0f), false);
 
     ImVec2 map_min, map_max;
     assert(overlay_ui.GetMapWidget().GetLastImageRect(&map_min, &map_max));
@@ -1034,9 +2386,9 @@ void RunVisualInteractionTest(ImGuiIO& io,
     assert(overlay_ui.GetCharacterWidget().GetCommandButtonRect("Confirm", &button_min, &button_max));
     const ImVec2 button_target = RectCenter(button_min, button_max);
 
-    RenderFrame(io, overlay_ui, inventory_state, character_state, map_target, false);
-    RenderFrame(io, overlay_ui, inventory_state, character_state, map_target, true);
-    RenderFrame(io, overlay_ui, inventory_state, character_state, map_target, false);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, map_target, false);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, map_target, true);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, map_target, false);
 
     assert(recorder.map_tile_hovered);
     assert(recorder.map_tile_clicked);
@@ -1052,8 +2404,22 @@ void RunVisualInteractionTest(ImGuiIO& io,
     click_event.button.x = static_cast<int>(item_target.x);
     click_event.button.y = static_cast<int>(item_target.y);
 
-    const bool click_consumed = overlay_ui.GetInventoryWidget().HandleEvent(click_event);
+    // A click resolved against a state that no longer matches the drawn rows is ignored.
+    inventory_overlay_state stale_state = inventory_state;
+    for (auto& column : stale_state.columns) {
+        for (auto& entry : column.entries) {
+            if (entry.label == "Water") {
+                entry.label = "Dirty water";
+            }
+        }
+    }
+    assert(!overlay_ui.GetInventoryWidget().HandleEvent(click_event, stale_state));
+    assert(!recorder.inventory_item_clicked);
+
+    const bool click_consumed = overlay_ui.GetInventoryWidget().HandleEvent(click_event, inventory_state);
     assert(click_consumed);
+    assert(!recorder.inventory_item_clicked);
+    adapter.flush();
     assert(recorder.inventory_item_clicked);
     assert(recorder.last_inventory_entry.label == "Water");
     assert(recorder.last_inventory_entry.hotkey == "c");
@@ -1072,8 +2438,9 @@ void RunVisualInteractionTest(ImGuiIO& io,
     minus_key_event.key.keysym.scancode = SDL_SCANCODE_MINUS;
     minus_key_event.key.keysym.sym = SDLK_MINUS;
 
-    const bool minus_consumed = overlay_ui.GetInventoryWidget().HandleEvent(minus_key_event);
+    const bool minus_consumed = overlay_ui.GetInventoryWidget().HandleEvent(minus_key_event, inventory_state);
     assert(minus_consumed);
+    adapter.flush();
     assert(recorder.inventory_key_forwarded);
     assert(recorder.last_forwarded_keycode == SDLK_MINUS);
     assert(recorder.last_forwarded_scancode == SDL_SCANCODE_MINUS);
@@ -1092,8 +2459,10 @@ void RunVisualInteractionTest(ImGuiIO& io,
     wheel_event.wheel.y = 1;
     wheel_event.wheel.preciseY = 0.0f;
 
-    const bool wheel_consumed = overlay_ui.GetInventoryWidget().HandleEvent(wheel_event);
+    const bool wheel_consumed = overlay_ui.GetInventoryWidget().HandleEvent(wheel_event, inventory_state);
     assert(wheel_consumed);
+    assert(!recorder.inventory_key_forwarded);
+    adapter.flush();
     assert(recorder.inventory_key_forwarded);
     assert(recorder.last_forwarded_keycode == SDLK_UP);
     assert(recorder.last_forwarded_scancode == SDL_SCANCODE_UP);
@@ -1111,33 +2480,190 @@ void RunVisualInteractionTest(ImGuiIO& io,
     precise_wheel_event.wheel.preciseY = 1.0f;
 
     const bool precise_wheel_consumed =
-        overlay_ui.GetInventoryWidget().HandleEvent(precise_wheel_event);
+        overlay_ui.GetInventoryWidget().HandleEvent(precise_wheel_event, inventory_state);
     assert(precise_wheel_consumed);
+    adapter.flush();
     assert(recorder.inventory_key_forwarded);
     assert(recorder.last_forwarded_keycode == SDLK_UP);
     assert(recorder.last_forwarded_scancode == SDL_SCANCODE_UP);
     assert(recorder.last_forwarded_mod == KMOD_NONE);
 
-    RenderFrame(io, overlay_ui, inventory_state, character_state, tab_target, true);
-    RenderFrame(io, overlay_ui, inventory_state, character_state, tab_target, false);
+    // A multi-step wheel burst is coalesced into one event carrying the step count.
+    recorder.inventory_key_events = 0;
+    SDL_Event burst_wheel_event = wheel_event;
+    burst_wheel_event.wheel.y = -3;
+    assert(overlay_ui.GetInventoryWidget().HandleEvent(burst_wheel_event, inventory_state));
+    adapter.flush();
+    assert(recorder.inventory_key_events == 1);
+    assert(recorder.last_forwarded_repeat_count == 3);
+    assert(recorder.last_forwarded_keycode == SDLK_DOWN);
+
+    // Only runs merge: Down, Up, Down stays three events in arrival order, and
+    // a key pressed after the wheel is delivered after it.
+    std::vector<std::pair<SDL_Keycode, int>> forwarded_keys;
+    auto order_sub = adapter.subscribe<cataclysm::gui::InventoryKeyInputEvent>(
+        [&forwarded_keys](const cataclysm::gui::InventoryKeyInputEvent &event) {
+            forwarded_keys.emplace_back(event.getKeyEvent().keysym.sym, event.getRepeatCount());
+        });
+    SDL_Event wheel_down = wheel_event;
+    wheel_down.wheel.y = -1;
+    assert(overlay_ui.GetInventoryWidget().HandleEvent(wheel_down, inventory_state));
+    assert(overlay_ui.GetInventoryWidget().HandleEvent(wheel_down, inventory_state));
+    assert(overlay_ui.GetInventoryWidget().HandleEvent(wheel_event, inventory_state));
+    assert(overlay_ui.GetInventoryWidget().HandleEvent(wheel_down, inventory_state));
+    assert(overlay_ui.GetInventoryWidget().HandleEvent(minus_key_event, inventory_state));
+    adapter.flush();
+    assert((forwarded_keys == std::vector<std::pair<SDL_Keycode, int>>{
+                {SDLK_DOWN, 2}, {SDLK_UP, 1}, {SDLK_DOWN, 1}, {SDLK_MINUS, 1}}));
+    order_sub.unsubscribe();
+
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, tab_target, true);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, tab_target, false);
 
     assert(recorder.character_tab_requested);
     assert(recorder.last_tab_id == "traits");
 
-    RenderFrame(io, overlay_ui, inventory_state, character_state, row_target, true);
-    RenderFrame(io, overlay_ui, inventory_state, character_state, row_target, false);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, row_target, true);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, row_target, false);
 
     assert(recorder.character_row_activated);
     assert(recorder.last_tab_id == "skills");
     assert(recorder.last_row_index == 1);
 
-    RenderFrame(io, overlay_ui, inventory_state, character_state, button_target, true);
-    RenderFrame(io, overlay_ui, inventory_state, character_state, button_target, false);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, button_target, true);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, button_target, false);
 
     assert(recorder.character_command_received);
     assert(recorder.last_character_command == cataclysm::gui::CharacterCommand::CONFIRM);
 }
 
+void RunInventoryColumnClippingTest(ImGuiIO& io,
+                                    cataclysm::gui::EventBusAdapter& adapter,
+                                    OverlayUI& overlay_ui,
+                                    const character_overlay_state& character_state) {
+    inventory_overlay_state long_state = BuildMockInventoryState();
+    auto& entries = long_state.columns[1].entries;
+    entries.clear();
+    for (int i = 0; i < 600; ++i) {
+        inventory_entry entry{};
+        entry.label = "item " + std::to_string(i);
+        entry.is_category = (i % 50) == 0;
+        entries.push_back(entry);
+    }
+
+    const ImVec2 off_screen(-1000.0f, -1000.0f);
+    RenderFrame(io, adapter, overlay_ui, long_state, character_state, off_screen, false);
+    RenderFrame(io, adapter, overlay_ui, long_state, character_state, off_screen, false);
+
+    // Only the rows that fit in the column body are built.
+    ImVec2 min, max;
+    assert(overlay_ui.GetInventoryWidget().GetEntryRect("", "item 1", &min, &max));
+    assert(!overlay_ui.GetInventoryWidget().GetEntryRect("", "item 599", &min, &max));
+
+    long_state.columns[1].scroll_position = 590;
+    RenderFrame(io, adapter, overlay_ui, long_state, character_state, off_screen, false);
+    RenderFrame(io, adapter, overlay_ui, long_state, character_state, off_screen, false);
+    assert(overlay_ui.GetInventoryWidget().GetEntryRect("", "item 590", &min, &max));
+    assert(!overlay_ui.GetInventoryWidget().GetEntryRect("", "item 1", &min, &max));
+}
+
+void RunInventoryWidgetFilterTest(ImGuiIO& io,
+                                  cataclysm::gui::EventBusAdapter& adapter,
+                                  OverlayUI& overlay_ui,
+                                  const character_overlay_state& character_state,
+                                  EventRecorder& recorder) {
+    const inventory_overlay_state state = BuildMockInventoryState();
+    InventoryWidget& widget = overlay_ui.GetInventoryWidget();
+    const ImVec2 off_screen(-1000.0f, -1000.0f);
+
+    recorder.filter_applied = false;
+    widget.SetFilter("AN", state);
+    assert(widget.IsFiltering());
+    assert(recorder.filter_applied);
+    assert(recorder.last_filter_text == "AN");
+    assert(recorder.last_filter_target == "inventory_widget");
+    assert((recorder.last_filter_matches == std::vector<cataclysm::gui::FilterMatch>{{0, 2}, {1, 2}, {1, 4}}));
+
+    // Only the matching rows are laid out.
+    RenderFrame(io, adapter, overlay_ui, state, character_state, off_screen, false);
+    RenderFrame(io, adapter, overlay_ui, state, character_state, off_screen, false);
+    ImVec2 min, max;
+    assert(widget.GetEntryRect("d", "Can of Beans", &min, &max));
+    assert(widget.GetEntryRect("e", "Bandage", &min, &max));
+    assert(widget.GetEntryRect("b", "Jeans", &min, &max));
+    assert(!widget.GetEntryRect("c", "Water", &min, &max));
+    assert(!widget.GetEntryRect("a", "Backpack", &min, &max));
+
+    widget.SetFilter("", state);
+    assert(!widget.IsFiltering());
+    assert(recorder.last_filter_matches.size() == 8);
+    RenderFrame(io, adapter, overlay_ui, state, character_state, off_screen, false);
+    RenderFrame(io, adapter, overlay_ui, state, character_state, off_screen, false);
+    assert(widget.GetEntryRect("c", "Water", &min, &max));
+}
+
+void RunCharacterTableClippingTest(ImGuiIO& io,
+                                   cataclysm::gui::EventBusAdapter& adapter,
+                                   OverlayUI& overlay_ui,
+                                   const inventory_overlay_state& inventory_state) {
+    character_overlay_state long_state = BuildMockCharacterState();
+    auto skills = std::find_if(long_state.tabs.begin(), long_state.tabs.end(),
+                               [](const character_overlay_tab& tab) { return tab.id == "skills"; });
+    assert(skills != long_state.tabs.end());
+    skills->rows.clear();
+    for (int i = 0; i < 400; ++i) {
+        skills->rows.push_back({"skill " + std::to_string(i), std::to_string(i), "",
+                                IM_COL32(255, 255, 255, 255), false});
+    }
+    overlay_ui.GetCharacterWidget().InvalidateTextLayout("skills");
+
+    const ImVec2 off_screen(-1000.0f, -1000.0f);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, long_state, off_screen, false);
+    RenderFrame(io, adapter, overlay_ui, inventory_state, long_state, off_screen, false);
+
+    // Only rows inside the tab's visible area are built.
+    ImVec2 min, max;
+    assert(overlay_ui.GetCharacterWidget().GetRowRect("skills", 1, &min, &max));
+    assert(!overlay_ui.GetCharacterWidget().GetRowRect("skills", 399, &min, &max));
+
+    // The active row is always laid out, even when scrolled out of view.
+    long_state.active_row_index = 350;
+    RenderFrame(io, adapter, overlay_ui, inventory_state, long_state, off_screen, false);
+    assert(overlay_ui.GetCharacterWidget().GetRowRect("skills", 350, &min, &max));
+
+    overlay_ui.GetCharacterWidget().InvalidateTextLayout("skills");
+}
+
+void RunWidgetFrameAllocationTest(ImGuiIO& io,
+                                  cataclysm::gui::EventBusAdapter& adapter,
+                                  OverlayUI& overlay_ui,
+                                  const inventory_overlay_state& inventory_state,
+                                  const character_overlay_state& character_state) {
+    // Same arena handling as OverlayManager::Render()
+    FrameArena arena;
+    auto render_frame = [&] {
+        {
+            FrameArena::Scope scope(&arena);
+            RenderFrame(io, adapter, overlay_ui, inventory_state, character_state, ImVec2(-1000.0f, -1000.0f),
+                        false);
+        }
+        arena.Reset();
+    };
+
+    // The first frames size the widgets' containers and the arena's blocks.
+    for (int frame = 0; frame < 3; ++frame) {
+        render_frame();
+    }
+    assert(arena.GetPeakBytesUsed() > 0);
+
+    const size_t allocations = CountAllocations([&] {
+        for (int frame = 0; frame < 10; ++frame) {
+            render_frame();
+        }
+    });
+    assert(allocations == 0);
+}
+
 void RunOverlayLifecycleTest(cataclysm::gui::EventBusAdapter &adapter, EventRecorder &recorder) {
     auto stats_before = adapter.getStatistics();
     const int published_before = stats_before["events_published"];
@@ -1176,11 +2702,1001 @@ void RunOverlayLifecycleTest(cataclysm::gui::EventBusAdapter &adapter, EventReco
     assert(published_after >= published_before + 5);
 }
 
+void RunEventBusDeferredDispatchTest() {
+    cataclysm::gui::EventBus event_bus;
+
+    std::vector<int> delivered_x;
+    bool requeued = false;
+    auto subscription = event_bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+        [&](const cataclysm::gui::MapTileHoveredEvent& event) {
+            delivered_x.push_back(event.getX());
+            if (!requeued) {
+                requeued = true;
+                event_bus.enqueue(cataclysm::gui::MapTileHoveredEvent(99, 0));
+            }
+        });
+
+    event_bus.enqueue(cataclysm::gui::MapTileHoveredEvent(1, 0));
+    event_bus.enqueue(cataclysm::gui::MapTileHoveredEvent(2, 0));
+    event_bus.enqueue(cataclysm::gui::MapTileHoveredEvent(3, 0));
+    assert(delivered_x.empty());
+    assert(event_bus.getQueuedEventCount() == 3);
+
+    assert(event_bus.flush() == 3);
+    assert((delivered_x == std::vector<int>{1, 2, 3}));
+
+    // Events queued by a handler during a flush wait for the next frame.
+    assert(event_bus.getQueuedEventCount() == 1);
+    assert(event_bus.flush() == 1);
+    assert(delivered_x.back() == 99);
+    assert(event_bus.flush() == 0);
+
+    subscription.unsubscribe();
+}
+
+void RunEventBusCoalescingTest() {
+    cataclysm::gui::EventBus event_bus;
+
+    std::vector<int> hovered_x;
+    auto hover_subscription = event_bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+        [&](const cataclysm::gui::MapTileHoveredEvent& event) { hovered_x.push_back(event.getX()); });
+    assert(event_bus.setCoalescing<cataclysm::gui::MapTileHoveredEvent>(
+        cataclysm::gui::CoalesceMode::LatestWins));
+
+    std::vector<std::string> notices;
+    auto notice_subscription = event_bus.subscribe<cataclysm::gui::GameplayNoticeEvent>(
+        [&](const cataclysm::gui::GameplayNoticeEvent& event) { notices.push_back(event.getMessage()); });
+    assert(!event_bus.setCoalescing<cataclysm::gui::GameplayNoticeEvent>(
+        cataclysm::gui::CoalesceMode::DedupeIdentical));
+    assert(event_bus.setCoalescing<cataclysm::gui::GameplayNoticeEvent>(
+        cataclysm::gui::CoalesceMode::DedupeIdentical,
+        [](const cataclysm::gui::GameplayNoticeEvent& a, const cataclysm::gui::GameplayNoticeEvent& b) {
+            return a.getMessage() == b.getMessage();
+        }));
+
+    for (int x = 0; x < 5; ++x) {
+        event_bus.enqueue(cataclysm::gui::MapTileHoveredEvent(x, 0));
+    }
+    event_bus.enqueue(cataclysm::gui::GameplayNoticeEvent("door", cataclysm::gui::Symbol("info")));
+    event_bus.enqueue(cataclysm::gui::GameplayNoticeEvent("door", cataclysm::gui::Symbol("info")));
+    event_bus.enqueue(cataclysm::gui::GameplayNoticeEvent("window", cataclysm::gui::Symbol("info")));
+    assert(event_bus.getQueuedEventCount() == 3);
+
+    assert(event_bus.flush() == 3);
+    assert((hovered_x == std::vector<int>{4}));
+    assert((notices == std::vector<std::string>{"door", "window"}));
+
+    // Synchronous publish is never coalesced.
+    event_bus.publish(cataclysm::gui::MapTileHoveredEvent(7, 0));
+    event_bus.publish(cataclysm::gui::MapTileHoveredEvent(7, 0));
+    assert(hovered_x.size() == 3);
+
+    // Discarded events are never delivered; the queue keeps working afterwards.
+    event_bus.enqueue(cataclysm::gui::MapTileHoveredEvent(9, 0));
+    event_bus.enqueue(cataclysm::gui::GameplayNoticeEvent("gate", cataclysm::gui::Symbol("info")));
+    assert(event_bus.discardQueued() == 2);
+    assert(event_bus.getQueuedEventCount() == 0);
+    assert(event_bus.flush() == 0);
+    event_bus.enqueue(cataclysm::gui::MapTileHoveredEvent(5, 0));
+    assert(event_bus.flush() == 1);
+    assert((hovered_x == std::vector<int>{4, 7, 7, 5}));
+    assert(notices.size() == 2);
+
+    hover_subscription.unsubscribe();
+    notice_subscription.unsubscribe();
+}
+
+void RunEventBusSubscriptionHandleTest() {
+    cataclysm::gui::EventBus event_bus;
+
+    int first_calls = 0;
+    auto first = event_bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+        [&first_calls](const cataclysm::gui::MapTileHoveredEvent&) { ++first_calls; });
+    const auto stale = first;
+    first.unsubscribe();
+    assert(!first);
+    assert(!stale.isActive());
+
+    // The freed slot is reused; the stale copy must not reach the new subscriber.
+    int second_calls = 0;
+    auto second = event_bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+        [&second_calls](const cataclysm::gui::MapTileHoveredEvent&) { ++second_calls; });
+    assert(second.getId() != stale.getId());
+    auto stale_copy = stale;
+    stale_copy.unsubscribe();
+    assert(second.isActive());
+    event_bus.publish(cataclysm::gui::MapTileHoveredEvent(1, 1));
+    assert(first_calls == 0);
+    assert(second_calls == 1);
+
+    // A subscriber may drop itself mid-publish without disturbing the others.
+    cataclysm::gui::EventSubscription self;
+    int self_calls = 0;
+    self = event_bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+        [&self, &self_calls](const cataclysm::gui::MapTileHoveredEvent&) {
+            ++self_calls;
+            self.unsubscribe();
+        });
+    event_bus.publish(cataclysm::gui::MapTileHoveredEvent(2, 2));
+    event_bus.publish(cataclysm::gui::MapTileHoveredEvent(3, 3));
+    assert(self_calls == 1);
+    assert(second_calls == 3);
+    assert(event_bus.getSubscriptionCount<cataclysm::gui::MapTileHoveredEvent>() == 1);
+
+    // Typical handler captures fit in the record without a separate allocation.
+    auto capture_this_and_callback = [&second_calls, callback = std::function<void(int)>()](int) {
+        (void)second_calls;
+    };
+    static_assert(cataclysm::gui::detail::InlineDelegate<void(int), cataclysm::gui::EventBus::kInlineCallbackSize>::
+                      storesInline<decltype(capture_this_and_callback)>(),
+                  "adapter-style callbacks should be stored inline");
+
+    second.unsubscribe();
+    assert(event_bus.isEmpty());
+}
+
+void RunEventBusDynamicPublishTest() {
+    cataclysm::gui::EventBus event_bus;
+
+    std::vector<std::pair<int, int>> hovered;
+    auto hover_subscription = event_bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+        [&hovered](const cataclysm::gui::MapTileHoveredEvent& event) {
+            hovered.emplace_back(event.getX(), event.getY());
+        });
+    int notices = 0;
+    auto notice_subscription = event_bus.subscribe<cataclysm::gui::GameplayNoticeEvent>(
+        [&notices](const cataclysm::gui::GameplayNoticeEvent&) { ++notices; });
+
+    // A replayed stream only knows its events through the base class.
+    std::vector<std::unique_ptr<cataclysm::gui::Event>> recorded;
+    recorded.push_back(std::make_unique<cataclysm::gui::MapTileHoveredEvent>(4, 5));
+    recorded.push_back(std::make_unique<cataclysm::gui::GameplayNoticeEvent>("saved", cataclysm::gui::Symbol("info")));
+    recorded.push_back(std::make_unique<cataclysm::gui::MapTileClickedEvent>(4, 5));
+    recorded.push_back(nullptr);
+    for (const auto& event : recorded) {
+        event_bus.publishDynamic(event);
+    }
+
+    assert(hovered.size() == 1);
+    assert(hovered[0] == std::make_pair(4, 5));
+    assert(notices == 1);
+
+    hover_subscription.unsubscribe();
+    event_bus.publishDynamic(*recorded[0]);
+    assert(hovered.size() == 1);
+
+    notice_subscription.unsubscribe();
+}
+
+void RunEventPayloadAllocationTest() {
+    using cataclysm::gui::GameplayStatusChangeEvent;
+    using cataclysm::gui::SharedText;
+    using cataclysm::gui::Symbol;
+
+    // Interning returns the same storage however the text is spelled.
+    const Symbol health("health");
+    assert(health == Symbol(std::string("health")));
+    assert(&health.str() == &Symbol(std::string_view("health")).str());
+    assert(health != Symbol("stamina"));
+    assert(Symbol().empty() && Symbol("").empty());
+    const size_t interned = Symbol::getInternedCount();
+    Symbol repeat("health");
+    assert(Symbol::getInternedCount() == interned);
+
+    GameplayStatusChangeEvent typed(health, "critical");
+    cataclysm::gui::Event& base = typed;
+    assert(base.getEventType() == GameplayStatusChangeEvent::kTypeName);
+    assert(base.getEventType() == "gameplay_status_change");
+    assert(typed.getSource() == "gameplay");
+
+    // Clones share free-form text instead of copying it.
+    cataclysm::gui::GameplayNoticeEvent notice(std::string(64, 'x'), cataclysm::gui::Symbol("info"));
+    auto cloned = notice.clone();
+    const auto& cloned_notice = static_cast<const cataclysm::gui::GameplayNoticeEvent&>(*cloned);
+    assert(&cloned_notice.getMessage() == &notice.getMessage());
+    assert(cloned_notice.getNoticeType() == "info");
+    assert(cloned_notice.getSource() == "gameplay");
+
+    cataclysm::gui::EventBus event_bus;
+    int delivered = 0;
+    bool matched = true;
+    const SharedText critical("critical");
+    const SharedText stable("stable");
+    auto subscription = event_bus.subscribe<GameplayStatusChangeEvent>(
+        [&](const GameplayStatusChangeEvent& event) {
+            ++delivered;
+            matched = matched && &event.getStatusType() == &health.str() &&
+                      event.getNewValue() == critical.str() && event.getOldValue() == stable.str() &&
+                      event.getEventTypeName() == GameplayStatusChangeEvent::kTypeName;
+        });
+    GameplayStatusChangeEvent warmup(health, critical);
+    warmup.setOldValue(stable);
+    event_bus.publish(warmup);
+
+    const SharedText message(std::string(64, 'y'));
+    const Symbol warning("warning");
+    // Runtime values are not interned, so events carrying new ones leave the
+    // symbol table alone once their source and identifiers exist.
+    const Symbol inventory_panel("inventory_panel");
+    cataclysm::gui::UiItemSelectedEvent first_selected("1", inventory_panel);
+    const size_t symbols = Symbol::getInternedCount();
+    for (int i = 2; i < 10; ++i) {
+        GameplayStatusChangeEvent runtime(health, std::to_string(i * 100));
+        runtime.setOldValue(std::to_string(i * 100 - 1));
+        cataclysm::gui::UiItemSelectedEvent selected(std::to_string(i), inventory_panel);
+        assert(selected.getItemId() == std::to_string(i));
+    }
+    assert(Symbol::getInternedCount() == symbols);
+
+    const size_t allocations = CountAllocations([&] {
+        for (int i = 0; i < 100; ++i) {
+            GameplayStatusChangeEvent event(health, critical);
+            event.setOldValue(stable);
+            event_bus.publish(event);
+
+            cataclysm::gui::GameplayNoticeEvent copy(message, warning);
+            cataclysm::gui::GameplayNoticeEvent shared = copy;
+            matched = matched && &shared.getMessage() == &message.str() &&
+                      shared.getEventType() == "gameplay_notice";
+        }
+    });
+    assert(allocations == 0);
+    assert(delivered == 101);
+    assert(matched);
+
+    subscription.unsubscribe();
+}
+
+void RunEventBusProfilingTest() {
+    cataclysm::gui::EventBus event_bus;
+
+    int calls = 0;
+    auto subscription = event_bus.subscribe<cataclysm::gui::MapTileHoveredEvent>(
+        [&calls](const cataclysm::gui::MapTileHoveredEvent&) { ++calls; });
+
+    // Nothing is recorded until profiling is switched on.
+    event_bus.publish(cataclysm::gui::MapTileHoveredEvent(0, 0));
+    auto profile = event_bus.getProfileSnapshot();
+    assert(profile.event_types.size() == 1);
+    assert(profile.event_types[0].publishes == 0);
+    assert(profile.event_types[0].subscriptions.size() == 1);
+    assert(profile.event_types[0].subscriptions[0].handler.invocations == 0);
+
+    event_bus.setProfilingEnabled(true);
+    for (int i = 0; i < 3; ++i) {
+        event_bus.publish(cataclysm::gui::MapTileHoveredEvent(i, i));
+    }
+    event_bus.publish(cataclysm::gui::MapTileClickedEvent(1, 1));
+    event_bus.setProfilingEnabled(false);
+    assert(calls == 4);
+
+    profile = event_bus.getProfileSnapshot();
+    const cataclysm::gui::EventTypeProfile* hovered = nullptr;
+    const cataclysm::gui::EventTypeProfile* clicked = nullptr;
+    for (const auto& type : profile.event_types) {
+        if (type.type_name == typeid(cataclysm::gui::MapTileHoveredEvent).name()) {
+            hovered = &type;
+        } else if (type.type_name == typeid(cataclysm::gui::MapTileClickedEvent).name()) {
+            clicked = &type;
+        }
+    }
+    assert(hovered && clicked);
+    assert(hovered->publishes == 3);
+    assert(hovered->handlers.invocations == 3);
+    assert(hovered->handlers.max_ns <= hovered->handlers.total_ns);
+    assert(hovered->subscriptions.size() == 1);
+    assert(hovered->subscriptions[0].subscription_id == subscription.getId());
+    uint64_t bucketed = 0;
+    for (uint64_t count : hovered->subscriptions[0].handler.latency_histogram) {
+        bucketed += count;
+    }
+    assert(bucketed == 3);
+    // Publishing without subscribers is still counted.
+    assert(clicked->publishes == 1);
+    assert(clicked->handlers.invocations == 0);
+
+    event_bus.resetProfile();
+    profile = event_bus.getProfileSnapshot();
+    for (const auto& type : profile.event_types) {
+        assert(type.publishes == 0);
+        assert(type.handlers.invocations == 0);
+    }
+
+    subscription.unsubscribe();
+}
+
+void RunEventBusCrossThreadPostTest() {
+    constexpr int kProducers = 4;
+    constexpr int kEventsPerProducer = 500;
+    cataclysm::gui::EventBus event_bus(kProducers * kEventsPerProducer);
+
+    const std::thread::id ui_thread = std::this_thread::get_id();
+    int received = 0;
+    long long item_count_total = 0;
+    bool handled_off_thread = false;
+    auto subscription = event_bus.subscribe<cataclysm::gui::GameplayInventoryChangeEvent>(
+        [&](const cataclysm::gui::GameplayInventoryChangeEvent& event) {
+            handled_off_thread = handled_off_thread || std::this_thread::get_id() != ui_thread;
+            ++received;
+            item_count_total += event.getItemCount();
+        });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&event_bus]() {
+            for (int i = 0; i < kEventsPerProducer; ++i) {
+                cataclysm::gui::GameplayInventoryChangeEvent event(cataclysm::gui::Symbol("added"));
+                event.setItemCount(1);
+                const bool posted = event_bus.post(event);
+                assert(posted);
+                (void)posted;
+            }
+        });
+    }
+
+    // Nothing is delivered until the UI thread drains the channel.
+    while (received < kProducers * kEventsPerProducer) {
+        event_bus.dispatchPosted();
+        std::this_thread::yield();
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    assert(!handled_off_thread);
+    assert(item_count_total == kProducers * kEventsPerProducer);
+    assert(event_bus.getDroppedPostedEventCount() == 0);
+
+    // The channel is bounded; overflow is rejected rather than blocking.
+    cataclysm::gui::EventBus small_bus(4);
+    for (int i = 0; i < 4; ++i) {
+        assert(small_bus.post(cataclysm::gui::GameplayNoticeEvent("n", cataclysm::gui::Symbol("info"))));
+    }
+    assert(!small_bus.post(cataclysm::gui::GameplayNoticeEvent("overflow", cataclysm::gui::Symbol("info"))));
+    assert(small_bus.getDroppedPostedEventCount() == 1);
+    assert(small_bus.dispatchPosted() == 4);
+
+    subscription.unsubscribe();
+}
+
 }  // namespace
 
+void RunHitTestIndexTest() {
+    HitTestIndex index;
+    auto lay_out_columns = [&index](float row_height) {
+        index.BeginLayout();
+        for (int column = 0; column < 3; ++column) {
+            for (int row = 0; row < 100; ++row) {
+                const float x = column * 200.0f;
+                const float y = row * row_height;
+                index.Add(ImVec2(x, y), ImVec2(x + 180.0f, y + row_height - 2.0f),
+                          std::to_string(column) + ":" + std::to_string(row));
+            }
+        }
+        index.EndLayout();
+    };
+
+    lay_out_columns(20.0f);
+    assert(index.Size() == 300);
+    assert(index.Find(ImVec2(10.0f, 5.0f)) == 0);
+    assert(index.Find(ImVec2(210.0f, 45.0f)) == 102);
+    assert(index.Find(ImVec2(590.0f, 1990.0f)) == HitTestIndex::kNoSlot);
+    assert(index.Find(ImVec2(410.0f, 1990.0f)) == 299);
+    assert(index.Find(ImVec2(190.0f, 5.0f)) == HitTestIndex::kNoSlot);
+    assert(index.Find(ImVec2(10.0f, 19.0f)) == HitTestIndex::kNoSlot);
+    assert(index.Find(ImVec2(10.0f, -1.0f)) == HitTestIndex::kNoSlot);
+    assert(index.FindId("1:2") == 102);
+    assert(index.FindId("3:0") == HitTestIndex::kNoSlot);
+
+    // Re-recording an identical layout does not rebuild the lookup.
+    const uint64_t rebuilds = index.GetRebuildCount();
+    lay_out_columns(20.0f);
+    assert(index.Find(ImVec2(210.0f, 45.0f)) == 102);
+    assert(index.GetRebuildCount() == rebuilds);
+
+    lay_out_columns(30.0f);
+    assert(index.Find(ImVec2(210.0f, 45.0f)) == 101);
+    assert(index.GetRebuildCount() == rebuilds + 1);
+
+    index.BeginLayout();
+    index.Add(ImVec2(0.0f, 0.0f), ImVec2(10.0f, 10.0f), "only");
+    index.EndLayout();
+    assert(index.Size() == 1);
+    assert(index.Find(ImVec2(210.0f, 45.0f)) == HitTestIndex::kNoSlot);
+    assert(index.Find(ImVec2(10.0f, 10.0f)) == 0);
+    assert(index.FindId("1:2") == HitTestIndex::kNoSlot);
+    assert(index.FindId("only") == 0);
+}
+
+void RunFrameProfilerTest() {
+    FrameProfiler& profiler = FrameProfiler::Get();
+    profiler.Clear();
+    assert(!profiler.IsEnabled());
+
+    // Zones are dropped while the profiler is off.
+    profiler.BeginFrame();
+    {
+        GUI_PROFILE_ZONE("test.disabled");
+    }
+    profiler.SetEnabled(true);
+    profiler.BeginFrame();
+    assert(profiler.GetLastFrame().zones.empty());
+
+    // One frame with nested zones on this thread and one on a worker.
+    {
+        GUI_PROFILE_ZONE("test.outer");
+        {
+            GUI_PROFILE_ZONE("test.inner");
+        }
+        std::thread worker([&profiler] {
+            profiler.SetThreadName("Worker");
+            GUI_PROFILE_ZONE("test.worker");
+        });
+        worker.join();
+    }
+    profiler.BeginFrame();
+
+    const ProfileFrame frame = profiler.GetLastFrame();
+    assert(frame.end_ns >= frame.start_ns);
+    assert(frame.zones.size() == 3);
+    const ProfileZoneRecord* outer = nullptr;
+    const ProfileZoneRecord* inner = nullptr;
+    const ProfileZoneRecord* worker = nullptr;
+    for (const ProfileZoneRecord& zone : frame.zones) {
+        const std::string_view name = zone.name;
+        if (name == "test.outer") {
+            outer = &zone;
+        } else if (name == "test.inner") {
+            inner = &zone;
+        } else if (name == "test.worker") {
+            worker = &zone;
+        }
+    }
+    assert(outer && inner && worker);
+    assert(outer->depth == 0 && inner->depth == 1 && worker->depth == 0);
+    assert(inner->start_ns >= outer->start_ns && inner->end_ns <= outer->end_ns);
+    assert(outer->thread_index == inner->thread_index);
+    assert(worker->thread_index != outer->thread_index);
+    assert(profiler.GetThreadName(worker->thread_index) == "Worker");
+    assert(profiler.GetThreadName(outer->thread_index) == "UI");
+    assert(!profiler.GetFrameTimes().empty());
+
+    // A paused profiler keeps showing the frame it stopped on.
+    profiler.SetPaused(true);
+    {
+        GUI_PROFILE_ZONE("test.paused");
+    }
+    profiler.BeginFrame();
+    assert(profiler.GetLastFrame().index == frame.index);
+    profiler.SetPaused(false);
+
+    // The ring keeps only the newest zones once a thread wraps it.
+    for (size_t i = 0; i < FrameProfiler::kZonesPerThread + 10; ++i) {
+        GUI_PROFILE_ZONE("test.flood");
+    }
+    profiler.BeginFrame();
+    assert(profiler.GetLastFrame().zones.size() == FrameProfiler::kZonesPerThread);
+
+    std::ostringstream trace;
+    assert(profiler.WriteChromeTrace(trace));
+    const std::string json = trace.str();
+    assert(json.find("\"traceEvents\"") != std::string::npos);
+    assert(json.find("\"name\":\"test.worker\",\"cat\":\"gui\",\"ph\":\"X\"") != std::string::npos);
+    assert(json.find("\"args\":{\"name\":\"Worker\"}") != std::string::npos);
+
+    profiler.SetEnabled(false);
+    profiler.Clear();
+    assert(profiler.GetLastFrame().zones.empty());
+    assert(profiler.GetFrameTimes().empty());
+}
+
+void RunInventoryFilterTest() {
+    using Match = cataclysm::gui::FilterMatch;
+
+    // The vectorized search has to agree with a plain find at every offset,
+    // including matches that straddle or end exactly at a 16-byte block.
+    const std::string haystack = "a bottle of purified water, a plastic bottle and some dirty water";
+    for (size_t start = 0; start < haystack.size(); ++start) {
+        for (size_t size = 1; start + size <= haystack.size() && size <= 20; ++size) {
+            const std::string needle = haystack.substr(start, size);
+            assert(InventoryFilter::ContainsLowered(haystack, needle));
+            assert(InventoryFilter::ContainsLowered(haystack.substr(0, start + size), needle));
+            const std::string truncated = haystack.substr(0, start + size - 1);
+            assert(InventoryFilter::ContainsLowered(truncated, needle) ==
+                   (truncated.find(needle) != std::string::npos));
+        }
+    }
+    assert(!InventoryFilter::ContainsLowered(haystack, "waterr"));
+    assert(!InventoryFilter::ContainsLowered("wat", "water"));
+    assert(InventoryFilter::ContainsLowered("anything", ""));
+
+    inventory_overlay_state state{};
+    state.columns[0].entries = {
+        {"Water", "", true, false, false, false, false, ""},
+        {"Bottle of Water", "a", false, false, false, false, false, ""},
+        {"Clean WATER (fresh)", "b", false, false, false, false, false, ""},
+        {"Watch", "c", false, false, false, false, false, ""},
+    };
+    state.columns[2].entries = {
+        {"dirty water", "d", false, false, false, false, false, ""},
+        {"Rock", "e", false, false, false, false, false, ""},
+    };
+
+    InventoryFilter filter;
+    assert(filter.Index(state));
+    assert(!filter.Index(state));
+    assert(filter.GetIndexedEntryCount() == 5);
+    assert(filter.GetMatches()->size() == 5);
+
+    // Category headers are never matched; case is ignored both ways.
+    auto matches = filter.Apply("WaTeR");
+    assert((*matches == std::vector<Match>{{0, 1}, {0, 2}, {2, 0}}));
+    assert(filter.GetQuery() == "water");
+    assert(filter.Apply("wat")->size() == 4);
+    assert(filter.GetLastCandidateCount() == 4);
+    assert(filter.Apply("zzz")->empty());
+    assert(filter.GetLastCandidateCount() == 0);
+    assert(filter.Apply("")->size() == 5);
+
+    // A growing query only re-checks the previous matches.
+    const size_t after_w = filter.Apply("w")->size();
+    const size_t after_wa = filter.Apply("wa")->size();
+    assert(filter.GetLastCandidateCount() == after_w);
+    // Text added in front narrows just the same.
+    filter.Apply("dirty wa");
+    assert(filter.GetLastCandidateCount() == after_wa);
+    assert((*filter.GetMatches() == std::vector<Match>{{2, 0}}));
+
+    // Changed labels re-index and re-run the current query.
+    filter.Apply("rock");
+    state.columns[2].entries[1].label = "Rocket";
+    state.columns[2].entries.push_back({"rock salt", "f", false, false, false, false, false, ""});
+    assert(filter.Index(state));
+    assert((*filter.GetMatches() == std::vector<Match>{{2, 1}, {2, 2}}));
+    assert(filter.GetQuery() == "rock");
+
+    // Typing into a large loot pile only ever re-checks the previous matches;
+    // gui_bench times the same keystrokes against a frame budget.
+    static const char* const kWords[] = {"bottle", "water", "rag", "nail", "pipe", "canned", "beans", "plank",
+                                         "steel", "wire", "battery", "jacket", "boots", "scrap", "glass"};
+    inventory_overlay_state pile{};
+    for (int i = 0; i < 2000; ++i) {
+        std::string label = kWords[i % 15];
+        label += ' ';
+        label += kWords[(i * 7 + 3) % 15];
+        label += " #" + std::to_string(i);
+        pile.columns[1].entries.push_back({label, "", false, false, false, false, false, ""});
+    }
+    InventoryFilter pile_filter;
+    pile_filter.Index(pile);
+    const std::string typed = "steel glass #1";
+    pile_filter.Apply(typed.substr(0, 1));
+    assert(pile_filter.GetLastCandidateCount() < pile.columns[1].entries.size());
+    for (size_t length = 2; length <= typed.size(); ++length) {
+        const size_t previous_matches = pile_filter.GetMatches()->size();
+        pile_filter.Apply(typed.substr(0, length));
+        assert(pile_filter.GetLastCandidateCount() <= previous_matches);
+        assert(pile_filter.GetMatches()->size() <= previous_matches);
+    }
+    assert(pile_filter.GetLastCandidateCount() < 200);
+    assert(!pile_filter.GetMatches()->empty());
+    for (const Match& match : *pile_filter.GetMatches()) {
+        assert(pile.columns[1].entries[match.row_index].label.find("steel glass #1") != std::string::npos);
+    }
+}
+
+void RunFrameArenaTest() {
+    FrameArena arena(1024);
+    assert(FrameArena::Current() == nullptr);
+
+    void* first = arena.Allocate(3, 1);
+    void* aligned = arena.Allocate(16, 16);
+    assert(first != nullptr && aligned != nullptr);
+    assert(reinterpret_cast<uintptr_t>(aligned) % 16 == 0);
+    const std::string_view copy = arena.CopyString("hotkey");
+    assert(copy == "hotkey" && copy.data()[copy.size()] == '\0');
+    assert(arena.GetBlockCount() == 1);
+
+    // Oversized requests get their own block instead of failing.
+    assert(arena.Allocate(4096) != nullptr);
+    assert(arena.GetBlockCount() == 2);
+    const size_t capacity = arena.GetCapacity();
+
+    arena.Reset();
+    assert(arena.GetBytesUsed() == 0);
+    assert(arena.GetPeakBytesUsed() >= 4096);
+    assert(arena.Allocate(3, 1) == first);
+    arena.Reset();
+
+    // Containers pick up whichever arena is current when they are created.
+    FrameString heap_string;
+    assert(heap_string.get_allocator().GetArena() == nullptr);
+    {
+        FrameArena::Scope scope(&arena);
+        assert(FrameArena::Current() == &arena);
+        {
+            FrameArena nested_arena(256);
+            FrameArena::Scope nested(&nested_arena);
+            assert(FrameArena::Current() == &nested_arena);
+        }
+        assert(FrameArena::Current() == &arena);
+
+        FrameString text("a label long enough to leave the small string buffer");
+        assert(text.get_allocator().GetArena() == &arena);
+        assert(arena.GetBytesUsed() > text.size());
+    }
+    assert(FrameArena::Current() == nullptr);
+    arena.Reset();
+
+    // A frame that repeats the previous one's work reuses the same blocks.
+    auto build_frame = [&arena] {
+        FrameArena::Scope scope(&arena);
+        FrameVector<std::string_view> tokens;
+        FrameString row_id;
+        for (int row = 0; row < 200; ++row) {
+            row_id.assign("inventory_column_row:");
+            row_id.append(std::to_string(row % 10));
+            tokens.push_back(arena.CopyString(row_id));
+        }
+        assert(tokens.size() == 200 && tokens.back() == "inventory_column_row:9");
+        arena.Reset();
+    };
+    build_frame();
+    const size_t warmed_capacity = arena.GetCapacity();
+    assert(warmed_capacity >= capacity);
+    assert(CountAllocations([&] {
+               for (int frame = 0; frame < 10; ++frame) {
+                   build_frame();
+               }
+           }) == 0);
+    assert(arena.GetCapacity() == warmed_capacity);
+}
+
+void RunThemePaletteTest() {
+    ThemePalette& palette = ThemePalette::Get();
+    palette.Configure(PaletteTheme::Default, false);
+    const ThemePalette::Colors& colors = palette.Current();
+    const uint64_t rebuilds = palette.GetRebuildCount();
+    const ImU32 default_favorite = colors.Packed(PaletteColor::Favorite);
+
+    // Reading the palette again without a settings change does not rebuild it.
+    palette.Current();
+    assert(palette.GetRebuildCount() == rebuilds);
+
+    assert(colors.RowText(false, false, false) == PaletteColor::Text);
+    assert(colors.RowText(true, false, true) == PaletteColor::FavoriteEmphasis);
+    assert(colors.RowText(true, true, false) == PaletteColor::Disabled);
+
+    palette.Configure(PaletteTheme::Accessibility, false);
+    assert(palette.Current().Packed(PaletteColor::Favorite) != default_favorite);
+    assert(palette.GetRebuildCount() == rebuilds + 1);
+
+    palette.Configure(PaletteTheme::Default, true);
+    const ImU32 high_contrast_favorite = palette.Current().Packed(PaletteColor::Favorite);
+    palette.Configure(PaletteTheme::HighContrast, false);
+    assert(palette.Current().Packed(PaletteColor::Favorite) == high_contrast_favorite);
+
+    palette.Configure(PaletteTheme::Default, false);
+    assert(palette.Current().Packed(PaletteColor::Favorite) == default_favorite);
+}
+
+void RunDataBindingPushUpdateTest() {
+    cataclysm::gui::EventBus bus;
+    cataclysm::gui::EventBusAdapter adapter(bus);
+    cataclysm::gui::DataBindingManager manager(adapter);
+    manager.setUpdateRateLimit(0);
+    manager.initialize();
+
+    int weight = 10;
+    int provider_calls = 0;
+    auto source = std::make_shared<cataclysm::gui::TypedDataSource<int>>(
+        "weight", [&weight, &provider_calls]() {
+            ++provider_calls;
+            return weight;
+        });
+
+    int deliveries = 0;
+    int last_value = 0;
+    auto record = [&deliveries, &last_value](const std::string&, std::any data) {
+        ++deliveries;
+        last_value = std::any_cast<int>(data);
+    };
+    assert(manager.createBinding("weight_label", source, record));
+    assert(manager.createBinding("weight_bar", source, record));
+
+    // Two readers of one source share a single provider run.
+    manager.updateDirtyBindings();
+    assert(deliveries == 2);
+    assert(last_value == 10);
+    assert(provider_calls == 1);
+
+    // Nothing changed, so nothing is visited or recomputed.
+    manager.updateDirtyBindings();
+    assert(deliveries == 2);
+    assert(provider_calls == 1);
+
+    weight = 12;
+    source->markChanged();
+    manager.updateDirtyBindings();
+    assert(deliveries == 4);
+    assert(last_value == 12);
+    assert(provider_calls == 2);
+
+    // Polling only reports a change when the value differs.
+    source->refresh();
+    manager.updateDirtyBindings();
+    assert(deliveries == 4);
+    assert(provider_calls == 3);
+
+    // Sources can also be reported changed through the event bus by name.
+    weight = 15;
+    bus.publish(cataclysm::gui::UiDataBindingUpdateEvent(cataclysm::gui::Symbol(""), cataclysm::gui::Symbol("weight")));
+    manager.updateDirtyBindings();
+    assert(deliveries == 6);
+    assert(last_value == 15);
+    assert(provider_calls == 4);
+
+    // Redelivery of one binding reuses the cached value.
+    assert(manager.markBindingDirty("weight_label"));
+    manager.updateDirtyBindings();
+    assert(deliveries == 7);
+    assert(provider_calls == 4);
+
+    assert(manager.removeBinding("weight_bar"));
+    source->markChanged();
+    manager.updateDirtyBindings();
+    assert(deliveries == 8);
+
+    manager.shutdown();
+    source->markChanged();
+}
+
+void RunDataBindingTypedCallbackTest() {
+    cataclysm::gui::EventBus bus;
+    cataclysm::gui::EventBusAdapter adapter(bus);
+    cataclysm::gui::DataBindingManager manager(adapter);
+    manager.setUpdateRateLimit(0);
+    manager.initialize();
+
+    inventory_overlay_state inventory = BuildMockInventoryState();
+    int provider_calls = 0;
+    auto source = cataclysm::gui::DataSourceBuilder::create<inventory_overlay_state>(
+        "inventory", std::function<inventory_overlay_state()>([&inventory, &provider_calls]() {
+            ++provider_calls;
+            return inventory;
+        }));
+
+    const inventory_overlay_state* delivered = nullptr;
+    std::string delivered_title;
+    assert(manager.createBinding<inventory_overlay_state>(
+        "inventory_view", source, [&delivered, &delivered_title](const inventory_overlay_state& state) {
+            delivered = &state;
+            delivered_title = state.title;
+        }));
+    assert(!manager.createBinding<int>("inventory_count", source, [](const int&) {}));
+
+    manager.updateDirtyBindings();
+    assert(delivered != nullptr);
+    assert(delivered_title == inventory.title);
+    assert(provider_calls == 1);
+
+    // Later updates hand out the same binding-owned value.
+    const inventory_overlay_state* first = delivered;
+    inventory.title = "Updated inventory";
+    source->markChanged();
+    manager.updateDirtyBindings();
+    assert(delivered == first);
+    assert(delivered_title == "Updated inventory");
+    assert(provider_calls == 2);
+
+    manager.shutdown();
+}
+
+void RunDataBindingDependencyGraphTest() {
+    cataclysm::gui::EventBus bus;
+    cataclysm::gui::EventBusAdapter adapter(bus);
+    cataclysm::gui::DataBindingManager manager(adapter);
+    manager.setUpdateRateLimit(0);
+    manager.initialize();
+
+    int weight = 10;
+    int volume = 5;
+    auto weight_source = std::make_shared<cataclysm::gui::TypedDataSource<int>>(
+        "weight", [&weight]() { return weight; });
+    auto volume_source = std::make_shared<cataclysm::gui::TypedDataSource<int>>(
+        "volume", [&volume]() { return volume; });
+    assert(manager.createBinding<int>("weight_label", weight_source, nullptr));
+    assert(manager.createBinding<int>("volume_label", volume_source, nullptr));
+
+    int encumbrance = 0;
+    int encumbrance_computes = 0;
+    assert(manager.createComputedBinding<int>(
+        "encumbrance", {"weight_label", "volume_label"},
+        [&]() {
+            ++encumbrance_computes;
+            return weight_source->getValue() + volume_source->getValue();
+        },
+        [&encumbrance](const int& value) { encumbrance = value; }));
+
+    std::string encumbrance_label;
+    int label_computes = 0;
+    assert(manager.createComputedBinding<std::string>(
+        "encumbrance_label", {"encumbrance"},
+        [&]() {
+            ++label_computes;
+            return "Encumbrance " + std::to_string(encumbrance);
+        },
+        [&encumbrance_label](const std::string& value) { encumbrance_label = value; }));
+    assert(!manager.createComputedBinding<int>("orphan", {"missing"}, [] { return 0; }, nullptr));
+
+    // Inputs are computed before the values derived from them.
+    manager.updateDirtyBindings();
+    assert(encumbrance == 15);
+    assert(encumbrance_label == "Encumbrance 15");
+    assert(encumbrance_computes == 1);
+    assert(label_computes == 1);
+
+    // The total is unchanged, so the label subtree is skipped.
+    weight = 11;
+    volume = 4;
+    weight_source->markChanged();
+    volume_source->markChanged();
+    manager.updateDirtyBindings();
+    assert(encumbrance_computes == 2);
+    assert(label_computes == 1);
+
+    weight = 20;
+    weight_source->markChanged();
+    manager.updateDirtyBindings();
+    assert(encumbrance_computes == 3);
+    assert(label_computes == 2);
+    assert(encumbrance_label == "Encumbrance 24");
+
+    manager.updateDirtyBindings();
+    assert(encumbrance_computes == 3);
+    assert(label_computes == 2);
+
+    // Inputs cannot be removed from under their dependents.
+    assert(!manager.removeBinding("encumbrance"));
+    assert(manager.removeBinding("encumbrance_label"));
+    assert(manager.removeBinding("encumbrance"));
+
+    manager.shutdown();
+}
+
+void RunDataBindingRetryTest() {
+    cataclysm::gui::EventBus bus;
+    cataclysm::gui::EventBusAdapter adapter(bus);
+    auto source = std::make_shared<cataclysm::gui::TypedDataSource<int>>("weight", [] { return 7; });
+    {
+        cataclysm::gui::DataBindingManager manager(adapter);
+        manager.setUpdateRateLimit(0);
+        manager.initialize();
+
+        // A delivery that throws is retried on the next update.
+        int calls = 0;
+        assert(manager.createBinding("weight_label", source, [&calls](const std::string&, std::any) {
+            if (++calls == 2) {
+                throw std::runtime_error("delivery failed");
+            }
+        }));
+        manager.updateDirtyBindings();
+        assert(calls == 1);
+        source->markChanged();
+        manager.updateDirtyBindings();
+        assert(calls == 2);
+        manager.updateDirtyBindings();
+        assert(calls == 3);
+        assert(manager.getBindingStatus().at("weight_label").rfind("dirty=false", 0) == 0);
+        manager.updateDirtyBindings();
+        assert(calls == 3);
+
+        // Changes made while a binding is being delivered, by its own callback
+        // or by another thread, are delivered on the next update.
+        auto counter = std::make_shared<cataclysm::gui::TypedDataSource<int>>("counter", [] { return 0; });
+        int counter_calls = 0;
+        std::uint64_t last_version = 0;
+        assert(manager.createBinding("counter_label", counter,
+                                     [&](const std::string&, std::any) {
+                                         last_version = counter->getVersion();
+                                         ++counter_calls;
+                                         if (counter_calls == 1) {
+                                             counter->markChanged();
+                                         } else if (counter_calls == 2) {
+                                             std::thread([&counter] { counter->markChanged(); }).join();
+                                         }
+                                     }));
+        manager.updateDirtyBindings();
+        assert(counter_calls == 1);
+        manager.updateDirtyBindings();
+        assert(counter_calls == 2);
+        manager.updateDirtyBindings();
+        assert(counter_calls == 3);
+        assert(last_version == counter->getVersion());
+        manager.updateDirtyBindings();
+        assert(counter_calls == 3);
+    }
+
+    // A manager that was never initialized still detaches from its sources.
+    {
+        cataclysm::gui::DataBindingManager manager(adapter);
+        assert(manager.createBinding("weight_label", source, nullptr));
+    }
+    source->markChanged();
+}
+
+void RunDebugLogTest() {
+    std::vector<std::pair<DebugLevel, std::string>> lines;
+    std::mutex lines_mutex;
+    setDebugLogWriter([&](DebugLevel level, const std::string& message) {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+        lines.emplace_back(level, message);
+    });
+    const DebugLevel previous_level = getDebugLogLevel();
+    assert(previous_level == DebugLevel::Warning);
+    assert(!isDebugLogEnabled(DebugLevel::Info));
+
+    setDebugLogLevel(DebugLevel::Warning);
+    debuglog(DebugLevel::Info, "filtered ", 1);
+    debuglog(DebugLevel::Warning, "kept ", 2);
+    debuglog(DebugLevel::Error, "kept ", 3);
+
+    // Levels below GUI_LOG_MIN_LEVEL stay out even when the runtime allows them.
+    setDebugLogLevel(DebugLevel::Trace);
+    debuglog(DebugLevel::Trace, "trace");
+    flushDebugLog();
+
+    {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+        const size_t expected = kDebugLogCompiledMinLevel <= DebugLevel::Trace ? 3u : 2u;
+        assert(lines.size() == expected);
+        assert(lines[0].first == DebugLevel::Warning && lines[0].second == "kept 2");
+        assert(lines[1].first == DebugLevel::Error && lines[1].second == "kept 3");
+    }
+
+    setDebugLogLevel(previous_level);
+    setDebugLogWriter(nullptr);
+}
+
 int main() {
+    RunEventBusDeferredDispatchTest();
+    RunEventBusCoalescingTest();
+    RunEventBusSubscriptionHandleTest();
+    RunEventBusDynamicPublishTest();
+    RunEventPayloadAllocationTest();
+    RunEventBusProfilingTest();
+    RunEventBusCrossThreadPostTest();
+    RunHitTestIndexTest();
+    RunFrameArenaTest();
+    RunFrameProfilerTest();
+    RunInventoryFilterTest();
+    RunThemePaletteTest();
+    RunDataBindingPushUpdateTest();
+    RunDataBindingTypedCallbackTest();
+    RunDataBindingDependencyGraphTest();
+    RunDataBindingRetryTest();
+    RunDebugLogTest();
     RunInputManagerEventRoutingTests();
+    RunInputManagerDispatchOrderTest();
+    RunInputManagerMotionCoalescingTest();
+    RunTextureAtlasTest();
+    RunResourceManagerLruTest();
+    RunResourceManagerAsyncLoadTest();
+    RunFontAtlasCacheTest();
+    RunSettingsWriterTest();
+    RunSettingsSnapshotTest();
+#if GUI_TEST_TOGGLE_MANAGER
+    RunToggleManagerRegistryTest();
+#endif
+    RunUiManagerRedrawCoalescingTest();
+    RunMapStreamTest();
+    RunMapWidgetTileMapTest();
+    RunMapWidgetZoomTest();
     RunOverlayManagerUiIntegrationTest();
+    RunOverlayIdleFrameSkipTest();
+    RunOverlayRenderTargetCacheTest();
+    RunOverlayLazyInitTest();
+    RunOverlayInventoryDeltaUpdateTest();
     RunOverlayInventoryInteractionBridgeTest();
     RunOverlayCharacterInteractionBridgeTest();
     RunOverlayInventoryBridgeModalEventTest();
@@ -1229,6 +3745,8 @@ int main() {
             recorder.last_forwarded_keycode = event.getKeyEvent().keysym.sym;
             recorder.last_forwarded_scancode = event.getKeyEvent().keysym.scancode;
             recorder.last_forwarded_mod = static_cast<SDL_Keymod>(event.getKeyEvent().keysym.mod);
+            recorder.last_forwarded_repeat_count = event.getRepeatCount();
+            ++recorder.inventory_key_events;
         });
 
     auto tab_sub = event_bus.subscribe<cataclysm::gui::CharacterTabRequestedEvent>(
@@ -1270,6 +3788,7 @@ int main() {
             recorder.last_filter_text = event.getFilterText();
             recorder.last_filter_target = event.getTargetComponent();
             recorder.last_filter_case_sensitive = event.isCaseSensitive();
+            recorder.last_filter_matches = event.getMatches();
         });
 
     auto item_selected_sub = event_bus.subscribe<cataclysm::gui::UiItemSelectedEvent>(
@@ -1295,23 +3814,27 @@ int main() {
     const auto inventory_state = BuildMockInventoryState();
     const auto character_state = BuildMockCharacterState();
 
-    RunVisualInteractionTest(io, overlay_ui, inventory_state, character_state, recorder);
+    RunVisualInteractionTest(io, adapter, overlay_ui, inventory_state, character_state, recorder);
+    RunInventoryColumnClippingTest(io, adapter, overlay_ui, character_state);
+    RunInventoryWidgetFilterTest(io, adapter, overlay_ui, character_state, recorder);
+    RunCharacterTableClippingTest(io, adapter, overlay_ui, inventory_state);
+    RunWidgetFrameAllocationTest(io, adapter, overlay_ui, inventory_state, character_state);
     RunOverlayLifecycleTest(adapter, recorder);
 
     adapter.shutdown();
 
-    hover_sub->unsubscribe();
-    click_sub->unsubscribe();
-    inventory_sub->unsubscribe();
-    inventory_key_sub->unsubscribe();
-    tab_sub->unsubscribe();
-    row_sub->unsubscribe();
-    overlay_open_sub->unsubscribe();
-    overlay_close_sub->unsubscribe();
-    filter_sub->unsubscribe();
-    item_selected_sub->unsubscribe();
-    data_binding_sub->unsubscribe();
-    command_sub->unsubscribe();
+    hover_sub.unsubscribe();
+    click_sub.unsubscribe();
+    inventory_sub.unsubscribe();
+    inventory_key_sub.unsubscribe();
+    tab_sub.unsubscribe();
+    row_sub.unsubscribe();
+    overlay_open_sub.unsubscribe();
+    overlay_close_sub.unsubscribe();
+    filter_sub.unsubscribe();
+    item_selected_sub.unsubscribe();
+    data_binding_sub.unsubscribe();
+    command_sub.unsubscribe();
 
     ImGui::DestroyContext();
 
@@ -0,0 +1,302 @@
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "debug.h"
+
+namespace gui {
+
+namespace resource_manager {
+
+// ShelfPacker implementation
+ShelfPacker::ShelfPacker(int width, int height, int padding)
+    : width_(width)
+    , height_(height)
+    , padding_(std::max(padding, 0)) {
+}
+
+std::optional<AtlasRect> ShelfPacker::insert(int w, int h) {
+    if (w <= 0 || h <= 0) return std::nullopt;
+
+    const int padded_w = w + padding_;
+    const int padded_h = h + padding_;
+    if (padded_w > width_ || padded_h > height_) return std::nullopt;
+
+    // Best fit: the shelf wasting the least height. Shelves more than twice as
+    // tall as the entry are only used when no new shelf can be opened.
+    Shelf* best = nullptr;
+    int best_waste = std::numeric_limits<int>::max();
+    for (Shelf& shelf : shelves_) {
+        if (shelf.height < padded_h || width_ - shelf.cursor_x < padded_w) continue;
+        const int waste = shelf.height - padded_h;
+        if (waste < best_waste) {
+            best = &shelf;
+            best_waste = waste;
+        }
+    }
+
+    const bool can_open_shelf = next_y_ + padded_h <= height_;
+    if (!best || (best_waste > padded_h && can_open_shelf)) {
+        if (!can_open_shelf) return std::nullopt;
+        shelves_.push_back({next_y_, padded_h, 0, 0});
+        next_y_ += padded_h;
+        best = &shelves_.back();
+    }
+
+    AtlasRect rect{best->cursor_x, best->y, w, h};
+    best->cursor_x += padded_w;
+    best->live++;
+    used_area_ += static_cast<uint64_t>(w) * static_cast<uint64_t>(h);
+    return rect;
+}
+
+void ShelfPacker::release(const AtlasRect& rect) {
+    auto it = std::find_if(shelves_.begin(), shelves_.end(),
+                           [&](const Shelf& shelf) { return shelf.y == rect.y; });
+    if (it == shelves_.end() || it->live == 0) return;
+
+    used_area_ -= static_cast<uint64_t>(rect.w) * static_cast<uint64_t>(rect.h);
+    if (--it->live == 0) {
+        it->cursor_x = 0;
+    }
+
+    // Trailing empty shelves give their height back to the page
+    while (!shelves_.empty() && shelves_.back().live == 0) {
+        next_y_ = shelves_.back().y;
+        shelves_.pop_back();
+    }
+}
+
+void ShelfPacker::reset() {
+    shelves_.clear();
+    next_y_ = 0;
+    used_area_ = 0;
+}
+
+double ShelfPacker::get_fragmentation() const {
+    uint64_t shelved = 0;
+    for (const Shelf& shelf : shelves_) {
+        shelved += static_cast<uint64_t>(shelf.cursor_x) * static_cast<uint64_t>(shelf.height);
+    }
+    return shelved > 0 ? 1.0 - static_cast<double>(used_area_) / static_cast<double>(shelved) : 0.0;
+}
+
+// TextureAtlas implementation
+TextureAtlas::TextureAtlas(SDL_Renderer* renderer, int page_size, size_t max_pages)
+    : renderer_(renderer)
+    , page_size_(page_size)
+    , max_pages_(std::max<size_t>(max_pages, 1)) {
+}
+
+TextureAtlas::~TextureAtlas() {
+    clear();
+}
+
+const AtlasRegion* TextureAtlas::add(const std::string& id, const void* rgba_pixels, int width, int height, int pitch) {
+    if (id.empty() || !rgba_pixels || !renderer_) return nullptr;
+
+    auto existing = entries_.find(id);
+    if (existing != entries_.end()) {
+        AtlasRegion& region = existing->second;
+        if (region.rect.w == width && region.rect.h == height) {
+            SDL_Rect dst{region.rect.x, region.rect.y, width, height};
+            SDL_UpdateTexture(pages_[region.page].texture, &dst, rgba_pixels, pitch);
+            return &region;
+        }
+        remove(id);
+    }
+
+    auto placement = allocate(width, height);
+    if (!placement) {
+        debuglog(DebugLevel::Warning, "TextureAtlas: no room for '", id, "' (", width, "x", height, ")");
+        return nullptr;
+    }
+
+    const uint32_t page = placement->first;
+    const AtlasRect& rect = placement->second;
+    SDL_Rect dst{rect.x, rect.y, rect.w, rect.h};
+    if (SDL_UpdateTexture(pages_[page].texture, &dst, rgba_pixels, pitch) != 0) {
+        pages_[page].packer.release(rect);
+        return nullptr;
+    }
+
+    AtlasRegion& region = entries_[id];
+    update_region(region, page, rect);
+    return &region;
+}
+
+const AtlasRegion* TextureAtlas::find(const std::string& id) const {
+    auto it = entries_.find(id);
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+bool TextureAtlas::remove(const std::string& id) {
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return false;
+
+    pages_[it->second.page].packer.release(it->second.rect);
+    entries_.erase(it);
+    return true;
+}
+
+void TextureAtlas::clear() {
+    entries_.clear();
+    for (Page& page : pages_) {
+        if (page.resource) {
+            Manager::instance().release_resource(page.resource->get_id());
+        }
+        if (page.texture) {
+            SDL_DestroyTexture(page.texture);
+        }
+    }
+    pages_.clear();
+}
+
+size_t TextureAtlas::defragment(double threshold) {
+    size_t moved = 0;
+    for (uint32_t page = 0; page < pages_.size(); ++page) {
+        if (pages_[page].packer.get_fragmentation() > threshold) {
+            repack_page(page, moved);
+        }
+    }
+    return moved;
+}
+
+ImTextureID TextureAtlas::get_page_texture(size_t page) const {
+    return page < pages_.size() ? reinterpret_cast<ImTextureID>(pages_[page].texture) : ImTextureID{};
+}
+
+uint64_t TextureAtlas::get_memory_usage() const {
+    const uint64_t page_bytes = static_cast<uint64_t>(page_size_) * static_cast<uint64_t>(page_size_) * 4;
+    return page_bytes * pages_.size();
+}
+
+bool TextureAtlas::create_page() {
+    if (pages_.size() >= max_pages_) return false;
+
+    // Render-target access lets defragment() move texels without a CPU copy
+    const int access = SDL_RenderTargetSupported(renderer_) ? SDL_TEXTUREACCESS_TARGET : SDL_TEXTUREACCESS_STATIC;
+    SDL_Texture* texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, access, page_size_, page_size_);
+    if (!texture) {
+        debuglog(DebugLevel::Warning, "TextureAtlas: failed to create ", page_size_, "x", page_size_, " page");
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    auto resource = Manager::instance().get_texture(
+        utilities::generate_unique_id("atlas_page"), [&](const std::string& resource_id) {
+            return std::make_shared<TextureResource>(resource_id, reinterpret_cast<ImTextureID>(texture),
+                                                     static_cast<uint32_t>(page_size_),
+                                                     static_cast<uint32_t>(page_size_));
+        });
+    pages_.push_back({texture, ShelfPacker(page_size_, page_size_), resource});
+    return true;
+}
+
+std::optional<std::pair<uint32_t, AtlasRect>> TextureAtlas::allocate(int width, int height) {
+    for (uint32_t page = 0; page < pages_.size(); ++page) {
+        if (auto rect = pages_[page].packer.insert(width, height)) {
+            return std::make_pair(page, *rect);
+        }
+    }
+
+    if (create_page()) {
+        const uint32_t page = static_cast<uint32_t>(pages_.size() - 1);
+        if (auto rect = pages_[page].packer.insert(width, height)) {
+            return std::make_pair(page, *rect);
+        }
+        return std::nullopt;
+    }
+
+    // Out of pages: reclaim holes left by evicted entries and retry. A repack
+    // can free room without moving anything, e.g. when only the end of a
+    // shelf was evicted, so any repacked page is worth another try.
+    bool repacked = false;
+    size_t moved = 0;
+    for (uint32_t page = 0; page < pages_.size(); ++page) {
+        if (pages_[page].packer.get_fragmentation() > 0.0) {
+            repacked = repack_page(page, moved) || repacked;
+        }
+    }
+    if (repacked) {
+        for (uint32_t page = 0; page < pages_.size(); ++page) {
+            if (auto rect = pages_[page].packer.insert(width, height)) {
+                return std::make_pair(page, *rect);
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+bool TextureAtlas::repack_page(uint32_t page, size_t& moved) {
+    if (!SDL_RenderTargetSupported(renderer_)) return false;
+
+    std::vector<AtlasRegion*> residents;
+    for (auto& pair : entries_) {
+        if (pair.second.page == page) {
+            residents.push_back(&pair.second);
+        }
+    }
+
+    // Tallest first packs shelves tightest
+    std::sort(residents.begin(), residents.end(), [](const AtlasRegion* a, const AtlasRegion* b) {
+        return a->rect.h != b->rect.h ? a->rect.h > b->rect.h : a->rect.w > b->rect.w;
+    });
+
+    ShelfPacker packer(page_size_, page_size_);
+    std::vector<AtlasRect> placements;
+    placements.reserve(residents.size());
+    for (const AtlasRegion* region : residents) {
+        auto rect = packer.insert(region->rect.w, region->rect.h);
+        if (!rect) return false;
+        placements.push_back(*rect);
+    }
+
+    SDL_Texture* texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                                             page_size_, page_size_);
+    if (!texture) return false;
+
+    SDL_Texture* old_texture = pages_[page].texture;
+    SDL_Texture* previous_target = SDL_GetRenderTarget(renderer_);
+    SDL_SetRenderTarget(renderer_, texture);
+    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 0);
+    SDL_RenderClear(renderer_);
+    SDL_SetTextureBlendMode(old_texture, SDL_BLENDMODE_NONE); // Copy alpha as-is
+    for (size_t i = 0; i < residents.size(); ++i) {
+        const AtlasRect& from = residents[i]->rect;
+        const AtlasRect& to = placements[i];
+        SDL_Rect src{from.x, from.y, from.w, from.h};
+        SDL_Rect dst{to.x, to.y, to.w, to.h};
+        SDL_RenderCopy(renderer_, old_texture, &src, &dst);
+    }
+    SDL_SetRenderTarget(renderer_, previous_target);
+    SDL_DestroyTexture(old_texture);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    pages_[page].texture = texture;
+    pages_[page].packer = packer;
+    if (pages_[page].resource) {
+        pages_[page].resource->set_texture(reinterpret_cast<ImTextureID>(texture));
+    }
+    for (size_t i = 0; i < residents.size(); ++i) {
+        const AtlasRect& from = residents[i]->rect;
+        if (from.x != placements[i].x || from.y != placements[i].y) {
+            moved++;
+        }
+        update_region(*residents[i], page, placements[i]);
+    }
+    return true;
+}
+
+void TextureAtlas::update_region(AtlasRegion& region, uint32_t page, const AtlasRect& rect) const {
+    const float scale = 1.0f / static_cast<float>(page_size_);
+    region.texture = reinterpret_cast<ImTextureID>(pages_[page].texture);
+    region.page = page;
+    region.rect = rect;
+    region.uv0 = ImVec2(rect.x * scale, rect.y * scale);
+    region.uv1 = ImVec2((rect.x + rect.w) * scale, (rect.y + rect.h) * scale);
+}
+
+} // namespace resource_manager
+
+} // namespace gui
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL.h>
+
+#include "imgui.h"
+#include "resource_manager.h"
+
+namespace gui {
+
+namespace resource_manager {
+
+// Pixel rectangle inside an atlas page
+struct AtlasRect {
+    int x{0};
+    int y{0};
+    int w{0};
+    int h{0};
+};
+
+// Shelf packer: the page is cut into horizontal shelves, each as tall as the
+// first entry placed on it, and filled left to right. Entries that are close in
+// height (icons, glyphs, tiles) pack densely and insertion is O(shelves).
+class ShelfPacker {
+public:
+    ShelfPacker(int width, int height, int padding = 1);
+
+    // Reserve a w x h rect plus padding; nullopt when the page is full
+    std::optional<AtlasRect> insert(int w, int h);
+
+    // Give a rect back. Space is reused once its whole shelf is empty, or
+    // after the owner repacks the page.
+    void release(const AtlasRect& rect);
+
+    void reset();
+
+    int get_width() const { return width_; }
+    int get_height() const { return height_; }
+    uint64_t get_used_area() const { return used_area_; }
+
+    // Fraction of the shelved area no longer backing a live rect
+    double get_fragmentation() const;
+
+private:
+    struct Shelf {
+        int y{0};
+        int height{0};
+        int cursor_x{0};
+        uint32_t live{0};
+    };
+
+    int width_;
+    int height_;
+    int padding_;
+    std::vector<Shelf> shelves_;
+    int next_y_{0};
+    uint64_t used_area_{0};
+};
+
+// Where an atlas entry lives. The pointer returned by TextureAtlas::find()
+// stays valid until the entry is removed; defragment() updates it in place.
+struct AtlasRegion {
+    ImTextureID texture{};
+    ImVec2 uv0{0.0f, 0.0f};
+    ImVec2 uv1{0.0f, 0.0f};
+    uint32_t page{0};
+    AtlasRect rect;
+};
+
+// Packs small RGBA images (map tiles, item icons) into a few large SDL textures
+// so ImGui can draw runs of them without breaking the draw command batch. Each
+// page is registered with the resource Manager for memory accounting.
+class TextureAtlas {
+public:
+    TextureAtlas(SDL_Renderer* renderer, int page_size = 2048, size_t max_pages = 4);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Upload an image into the atlas. Re-adding an id replaces its pixels.
+    // Returns nullptr when the image cannot be placed even after repacking.
+    const AtlasRegion* add(const std::string& id, const void* rgba_pixels, int width, int height, int pitch);
+
+    const AtlasRegion* find(const std::string& id) const;
+    bool remove(const std::string& id);
+    void clear();
+
+    // Repack pages whose fragmentation exceeds the threshold, copying texels
+    // on the GPU. Returns how many entries moved.
+    size_t defragment(double threshold = 0.25);
+
+    size_t get_page_count() const { return pages_.size(); }
+    ImTextureID get_page_texture(size_t page) const;
+    size_t get_entry_count() const { return entries_.size(); }
+    uint64_t get_memory_usage() const;
+
+private:
+    struct Page {
+        SDL_Texture* texture{nullptr};
+        ShelfPacker packer;
+        std::shared_ptr<TextureResource> resource;
+    };
+
+    bool create_page();
+    std::optional<std::pair<uint32_t, AtlasRect>> allocate(int width, int height);
+    bool repack_page(uint32_t page, size_t& moved);
+    void update_region(AtlasRegion& region, uint32_t page, const AtlasRect& rect) const;
+
+    SDL_Renderer* renderer_;
+    int page_size_;
+    size_t max_pages_;
+    std::vector<Page> pages_;
+    std::unordered_map<std::string, AtlasRegion> entries_;
+};
+
+} // namespace resource_manager
+
+} // namespace gui
@@ -0,0 +1,90 @@
+#include "theme_palette.h"
+
+#include <algorithm>
+
+namespace {
+
+struct ThemeTint {
+    ImVec4 favorite;
+    ImVec4 disabled;
+    float highlight_lighten;
+    float text_lighten;
+};
+
+// Indexed by PaletteTheme.
+constexpr std::array<ThemeTint, 4> kThemeTints = {{
+    {ImVec4(1.0f, 0.85f, 0.2f, 1.0f), ImVec4(0.8f, 0.3f, 0.3f, 1.0f), 0.1f, 0.2f},
+    {ImVec4(1.0f, 0.85f, 0.2f, 1.0f), ImVec4(0.8f, 0.3f, 0.3f, 1.0f), 0.1f, 0.2f},
+    {ImVec4(1.0f, 0.95f, 0.0f, 1.0f), ImVec4(1.0f, 0.35f, 0.35f, 1.0f), 0.2f, 0.3f},
+    {ImVec4(0.35f, 0.7f, 1.0f, 1.0f), ImVec4(0.95f, 0.6f, 0.0f, 1.0f), 0.15f, 0.25f},
+}};
+
+ImVec4 LightenColor(const ImVec4& color, float amount) {
+    return ImVec4(std::min(color.x + amount, 1.0f),
+                  std::min(color.y + amount, 1.0f),
+                  std::min(color.z + amount, 1.0f),
+                  color.w);
+}
+
+}  // namespace
+
+ThemePalette& ThemePalette::Get() {
+    static ThemePalette palette;
+    return palette;
+}
+
+void ThemePalette::Configure(PaletteTheme theme, bool high_contrast) {
+    theme_.store(static_cast<uint8_t>(theme), std::memory_order_relaxed);
+    high_contrast_.store(high_contrast, std::memory_order_relaxed);
+    requested_version_.fetch_add(1, std::memory_order_release);
+}
+
+void ThemePalette::Invalidate() {
+    requested_version_.fetch_add(1, std::memory_order_release);
+}
+
+const ThemePalette::Colors& ThemePalette::Current() {
+    const uint64_t requested = requested_version_.load(std::memory_order_acquire);
+    ImGuiContext* context = ImGui::GetCurrentContext();
+    if (requested != built_version_ || context != built_context_) {
+        built_version_ = requested;
+        built_context_ = context;
+        Rebuild();
+    }
+    return colors_;
+}
+
+void ThemePalette::Rebuild() {
+    ++rebuild_count_;
+
+    size_t theme_index = std::min<size_t>(theme_.load(std::memory_order_relaxed), kThemeTints.size() - 1);
+    if (high_contrast_.load(std::memory_order_relaxed)) {
+        theme_index = static_cast<size_t>(PaletteTheme::HighContrast);
+    }
+    const ThemeTint& tint = kThemeTints[theme_index];
+
+    ImVec4 text(1.0f, 1.0f, 1.0f, 1.0f);
+    ImVec4 header(0.26f, 0.59f, 0.98f, 0.31f);
+    ImVec4 child_background(0.0f, 0.0f, 0.0f, 0.0f);
+    if (built_context_ != nullptr) {
+        text = ImGui::GetStyleColorVec4(ImGuiCol_Text);
+        header = ImGui::GetStyleColorVec4(ImGuiCol_Header);
+        child_background = ImGui::GetStyleColorVec4(ImGuiCol_ChildBg);
+    }
+
+    auto set = [this](PaletteColor color, const ImVec4& value) {
+        const size_t index = static_cast<size_t>(color);
+        colors_.values[index] = value;
+        colors_.packed[index] = ImGui::ColorConvertFloat4ToU32(value);
+    };
+
+    set(PaletteColor::Text, text);
+    set(PaletteColor::TextEmphasis, LightenColor(text, tint.text_lighten));
+    set(PaletteColor::Favorite, tint.favorite);
+    set(PaletteColor::FavoriteEmphasis, LightenColor(tint.favorite, tint.text_lighten));
+    set(PaletteColor::Disabled, tint.disabled);
+    set(PaletteColor::DisabledEmphasis, LightenColor(tint.disabled, tint.text_lighten));
+    set(PaletteColor::Highlight, header);
+    set(PaletteColor::HighlightEmphasis, LightenColor(header, tint.highlight_lighten));
+    set(PaletteColor::ActiveColumnBackground, LightenColor(child_background, tint.highlight_lighten));
+}
@@ -0,0 +1,123 @@
+#ifndef THEME_PALETTE_H
+#define THEME_PALETTE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "imgui.h"
+
+/**
+ * Colors the widgets draw with, indexed into ThemePalette.
+ *
+ * The "Emphasis" variants are used where a row is both selected and
+ * highlighted and are precomputed so the row loops do no color math.
+ */
+enum class PaletteColor : uint8_t {
+    Text,
+    TextEmphasis,
+    Favorite,
+    FavoriteEmphasis,
+    Disabled,
+    DisabledEmphasis,
+    Highlight,
+    HighlightEmphasis,
+    ActiveColumnBackground,
+    Count
+};
+
+/**
+ * Mirrors GUISettings::UITheme so widgets do not depend on the settings module.
+ */
+enum class PaletteTheme : uint8_t {
+    Default = 0,
+    Dark = 1,
+    HighContrast = 2,
+    Accessibility = 3
+};
+
+/**
+ * Per-theme color table shared by the overlay widgets.
+ *
+ * The table is derived from the theme and the current ImGui style, and only
+ * changes when the settings are applied. Widgets call Current() once per draw
+ * and index the result; a rebuild happens there when Configure() or
+ * Invalidate() has been called since, or when a different ImGui context is
+ * current.
+ */
+class ThemePalette {
+public:
+    static constexpr size_t kColorCount = static_cast<size_t>(PaletteColor::Count);
+
+    struct Colors {
+        std::array<ImVec4, kColorCount> values{};
+        std::array<ImU32, kColorCount> packed{};
+
+        const ImVec4& operator[](PaletteColor color) const {
+            return values[static_cast<size_t>(color)];
+        }
+
+        ImU32 Packed(PaletteColor color) const {
+            return packed[static_cast<size_t>(color)];
+        }
+
+        /**
+         * Text color for an inventory row.
+         * @param favorite Row is a favorite.
+         * @param disabled Row is disabled; takes precedence over favorite.
+         * @param emphasis Row is both selected and highlighted.
+         */
+        PaletteColor RowText(bool favorite, bool disabled, bool emphasis) const {
+            int base = static_cast<int>(PaletteColor::Text);
+            if (disabled) {
+                base = static_cast<int>(PaletteColor::Disabled);
+            } else if (favorite) {
+                base = static_cast<int>(PaletteColor::Favorite);
+            }
+            return static_cast<PaletteColor>(base + (emphasis ? 1 : 0));
+        }
+    };
+
+    static ThemePalette& Get();
+
+    /**
+     * Selects the theme the next rebuild derives its colors from.
+     * @param theme Theme from GUISettings.
+     * @param high_contrast Accessibility high-contrast override.
+     */
+    void Configure(PaletteTheme theme, bool high_contrast);
+
+    /**
+     * Forces a rebuild on the next Current(), e.g. after the ImGui style changed.
+     */
+    void Invalidate();
+
+    /**
+     * @return The color table for the current theme and ImGui context.
+     */
+    const Colors& Current();
+
+    /**
+     * @return How many times the table has been rebuilt.
+     */
+    uint64_t GetRebuildCount() const {
+        return rebuild_count_;
+    }
+
+private:
+    ThemePalette() = default;
+
+    void Rebuild();
+
+    std::atomic<uint8_t> theme_{static_cast<uint8_t>(PaletteTheme::Default)};
+    std::atomic<bool> high_contrast_{false};
+    std::atomic<uint64_t> requested_version_{1};
+
+    uint64_t built_version_ = 0;
+    ImGuiContext* built_context_ = nullptr;
+    uint64_t rebuild_count_ = 0;
+    Colors colors_;
+};
+
+#endif // THEME_PALETTE_H
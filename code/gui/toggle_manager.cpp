@@ -1,9 +1,15 @@
 #include "toggle_manager.h"
 #include "gui_settings.h"
+#include "settings_snapshot.h"
+#include "settings_writer.h"
+#include "debug.h"
+#include "event_bus.h"
+#include "events.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <bitset>
 #include <filesystem>
 #include <stdexcept>
 #include <cctype>
@@ -38,6 +44,7 @@ namespace FileOps {
 
 ToggleManager::ToggleManager() 
     : m_settings(nullptr)
+    , m_autoSave(false)
     , m_nextCallbackId(1) {
     initializeDefaultComponents();
 }
@@ -119,283 +126,242 @@ void ToggleManager::initializeDefaultComponents() {
         
         registerComponent(componentId, componentId, defaultVisible, category);
     }
+
+    // Development panel; hidden until asked for
+    registerComponent("frame_profiler", "Frame Profiler", false, "System");
     
-    std::cout << "Initialized " << m_components.size() << " default GUI components" << std::endl;
+    debuglog(DebugLevel::Info, "Initialized ", getComponentCount(), " default GUI components");
 }
 
-bool ToggleManager::registerComponent(const std::string& componentId, 
-                                     const std::string& displayName,
-                                     bool defaultVisible,
-                                     const std::string& category) {
+ToggleManager::ComponentHandle ToggleManager::registerComponent(const std::string& componentId,
+                                                                const std::string& displayName,
+                                                                bool defaultVisible,
+                                                                const std::string& category) {
     if (!isValidComponentId(componentId)) {
         std::cerr << "Invalid component ID: " << componentId << std::endl;
-        return false;
+        return kInvalidHandle;
     }
     
-    if (m_components.find(componentId) != m_components.end()) {
+    if (componentExists(componentId)) {
         std::cerr << "Component already exists: " << componentId << std::endl;
-        return false;
+        return kInvalidHandle;
     }
     
     if (!isValidCategory(category)) {
         std::cerr << "Invalid category: " << category << std::endl;
-        return false;
+        return kInvalidHandle;
+    }
+    
+    // A component registered before keeps its old slot, so handles cached by widgets stay valid
+    ComponentHandle handle;
+    auto it = m_handles.find(componentId);
+    if (it != m_handles.end()) {
+        handle = it->second;
+    } else {
+        handle = static_cast<ComponentHandle>(m_components.size());
+        m_components.emplace_back();
+        m_handles[componentId] = handle;
     }
     
-    ComponentData data;
+    ComponentData& data = m_components[handle];
+    data = ComponentData();
+    data.id = componentId;
     data.displayName = displayName;
     data.category = category;
-    data.visible = defaultVisible;
-    data.enabled = defaultEnabled;
-    data.zIndex = 0;
-    data.shortcutKey = 0;
-    data.shortcutCtrl = false;
-    data.shortcutAlt = false;
+    data.categoryIndex = getOrCreateCategory(category);
     
-    m_components[componentId] = data;
-    m_categories[category].insert(componentId);
+    assignBit(m_liveBits, handle, true);
+    assignBit(m_visibleBits, handle, defaultVisible);
+    assignBit(m_enabledBits, handle, true);
+    assignBit(m_categories[data.categoryIndex].members, handle, true);
     
-    std::cout << "Registered component: " << componentId << " in category: " << category << std::endl;
-    return true;
+    debuglog(DebugLevel::Debug, "Registered component: ", componentId, " in category: ", category);
+    return handle;
 }
 
 bool ToggleManager::unregisterComponent(const std::string& componentId) {
-    auto it = m_components.find(componentId);
-    if (it == m_components.end()) {
+    ComponentHandle handle = findLiveHandle(componentId);
+    if (handle == kInvalidHandle) {
         std::cerr << "Component not found: " << componentId << std::endl;
         return false;
     }
     
-    std::string category = it->second.category;
-    
-    m_components.erase(it);
-    m_categories[category].erase(componentId);
+    unregisterToggleShortcut(componentId);
     
-    if (m_categories[category].empty()) {
-        m_categories.erase(category);
-    }
+    ComponentData& data = m_components[handle];
+    assignBit(m_categories[data.categoryIndex].members, handle, false);
+    assignBit(m_liveBits, handle, false);
+    assignBit(m_visibleBits, handle, false);
+    assignBit(m_enabledBits, handle, false);
     
-    std::cout << "Unregistered component: " << componentId << std::endl;
+    debuglog(DebugLevel::Debug, "Unregistered component: ", componentId);
     return true;
 }
 
 bool ToggleManager::componentExists(const std::string& componentId) const {
-    return m_components.find(componentId) != m_components.end();
+    return findLiveHandle(componentId) != kInvalidHandle;
+}
+
+ToggleManager::ComponentHandle ToggleManager::getComponentHandle(const std::string& componentId) const {
+    return findLiveHandle(componentId);
 }
 
 std::vector<std::string> ToggleManager::getAllComponentIds() const {
-    std::vector<std::string> ids;
-    ids.reserve(m_components.size());
-    
-    for (const auto& pair : m_components) {
-        ids.push_back(pair.first);
-    }
-    
-    return ids;
+    return collectIds(m_liveBits, true);
 }
 
 std::vector<std::string> ToggleManager::getComponentIdsByCategory(const std::string& category) const {
-    std::vector<std::string> ids;
-    
-    auto it = m_categories.find(category);
-    if (it != m_categories.end()) {
-        ids.assign(it->second.begin(), it->second.end());
+    const CategoryData* cat = findCategory(category);
+    if (!cat) {
+        return {};
     }
-    
-    return ids;
+    return collectIds(cat->members, true);
 }
 
 std::vector<std::string> ToggleManager::getAllCategories() const {
     std::vector<std::string> categories;
     categories.reserve(m_categories.size());
     
-    for (const auto& pair : m_categories) {
-        categories.push_back(pair.first);
+    for (const auto& cat : m_categories) {
+        if (countBits(cat.members, m_liveBits) > 0) {
+            categories.push_back(cat.name);
+        }
     }
     
+    std::sort(categories.begin(), categories.end());
     return categories;
 }
 
 bool ToggleManager::setComponentVisible(const std::string& componentId, bool visible) {
-    auto it = m_components.find(componentId);
-    if (it == m_components.end()) {
+    ComponentHandle handle = findLiveHandle(componentId);
+    if (handle == kInvalidHandle) {
         std::cerr << "Component not found: " << componentId << std::endl;
         return false;
     }
+    return setComponentVisible(handle, visible);
+}
+
+bool ToggleManager::setComponentVisible(ComponentHandle handle, bool visible) {
+    if (!isLive(handle)) {
+        return false;
+    }
     
-    bool oldVisible = it->second.visible;
-    it->second.visible = visible;
-    
-    if (oldVisible != visible) {
-        notifyComponentStateChange(componentId, visible, it->second.enabled);
-        std::cout << "Component " << componentId << " visibility set to: " << (visible ? "visible" : "hidden") << std::endl;
+    if (testBit(m_visibleBits, handle) != visible) {
+        assignBit(m_visibleBits, handle, visible);
+        notifyComponentStateChange(m_components[handle].id, visible, testBit(m_enabledBits, handle));
+        scheduleAutoSave();
     }
     
     return true;
 }
 
 bool ToggleManager::isComponentVisible(const std::string& componentId) const {
-    auto it = m_components.find(componentId);
-    if (it == m_components.end()) {
-        return false;
-    }
-    
-    return it->second.visible;
+    return isComponentVisible(findLiveHandle(componentId));
 }
 
 bool ToggleManager::setComponentEnabled(const std::string& componentId, bool enabled) {
-    auto it = m_components.find(componentId);
-    if (it == m_components.end()) {
+    ComponentHandle handle = findLiveHandle(componentId);
+    if (handle == kInvalidHandle) {
         std::cerr << "Component not found: " << componentId << std::endl;
         return false;
     }
+    return setComponentEnabled(handle, enabled);
+}
+
+bool ToggleManager::setComponentEnabled(ComponentHandle handle, bool enabled) {
+    if (!isLive(handle)) {
+        return false;
+    }
     
-    bool oldEnabled = it->second.enabled;
-    it->second.enabled = enabled;
-    
-    if (oldEnabled != enabled) {
-        notifyComponentStateChange(componentId, it->second.visible, enabled);
-        std::cout << "Component " << componentId << " enabled state set to: " << (enabled ? "enabled" : "disabled") << std::endl;
+    if (testBit(m_enabledBits, handle) != enabled) {
+        assignBit(m_enabledBits, handle, enabled);
+        notifyComponentStateChange(m_components[handle].id, testBit(m_visibleBits, handle), enabled);
+        scheduleAutoSave();
     }
     
     return true;
 }
 
 bool ToggleManager::isComponentEnabled(const std::string& componentId) const {
-    auto it = m_components.find(componentId);
-    if (it == m_components.end()) {
-        return false;
-    }
-    
-    return it->second.enabled;
+    return isComponentEnabled(findLiveHandle(componentId));
 }
 
 std::string ToggleManager::getComponentDisplayName(const std::string& componentId) const {
-    auto it = m_components.find(componentId);
-    if (it == m_components.end()) {
+    ComponentHandle handle = findLiveHandle(componentId);
+    if (handle == kInvalidHandle) {
         return componentId;
     }
     
-    return it->second.displayName;
+    return m_components[handle].displayName;
 }
 
 std::string ToggleManager::getComponentCategory(const std::string& componentId) const {
-    auto it = m_components.find(componentId);
-    if (it == m_components.end()) {
+    ComponentHandle handle = findLiveHandle(componentId);
+    if (handle == kInvalidHandle) {
         return "Unknown";
     }
     
-    return it->second.category;
+    return m_components[handle].category;
 }
 
 void ToggleManager::setCategoryVisible(const std::string& category, bool visible) {
-    auto catIt = m_categories.find(category);
-    if (catIt == m_categories.end()) {
+    const CategoryData* cat = findCategory(category);
+    if (!cat || countBits(cat->members, m_liveBits) == 0) {
         std::cerr << "Category not found: " << category << std::endl;
         return;
     }
     
-    for (const auto& componentId : catIt->second) {
-        setComponentVisible(componentId, visible);
-    }
+    applyToMask(m_visibleBits, cat->members, visible);
     
     notifyBulkStateChange(category, visible, true);
-    std::cout << "Set all components in category " << category << " to " << (visible ? "visible" : "hidden") << std::endl;
+    debuglog(DebugLevel::Debug, "Set all components in category ", category, " to ",
+             (visible ? "visible" : "hidden"));
 }
 
 void ToggleManager::setCategoryEnabled(const std::string& category, bool enabled) {
-    auto catIt = m_categories.find(category);
-    if (catIt == m_categories.end()) {
+    const CategoryData* cat = findCategory(category);
+    if (!cat || countBits(cat->members, m_liveBits) == 0) {
         std::cerr << "Category not found: " << category << std::endl;
         return;
     }
     
-    for (const auto& componentId : catIt->second) {
-        setComponentEnabled(componentId, enabled);
-    }
+    applyToMask(m_enabledBits, cat->members, enabled);
     
     notifyBulkStateChange(category, true, enabled);
-    std::cout << "Set all components in category " << category << " to " << (enabled ? "enabled" : "disabled") << std::endl;
+    debuglog(DebugLevel::Debug, "Set all components in category ", category, " to ",
+             (enabled ? "enabled" : "disabled"));
 }
 
 void ToggleManager::showAll() {
-    for (auto& pair : m_components) {
-        if (!pair.second.visible) {
-            setComponentVisible(pair.first, true);
-        }
-    }
+    applyToMask(m_visibleBits, m_liveBits, true);
 }
 
 void ToggleManager::hideAll() {
-    for (auto& pair : m_components) {
-        if (pair.second.visible) {
-            setComponentVisible(pair.first, false);
-        }
-    }
+    applyToMask(m_visibleBits, m_liveBits, false);
 }
 
 void ToggleManager::enableAll() {
-    for (auto& pair : m_components) {
-        if (!pair.second.enabled) {
-            setComponentEnabled(pair.first, true);
-        }
-    }
+    applyToMask(m_enabledBits, m_liveBits, true);
 }
 
 void ToggleManager::disableAll() {
-    for (auto& pair : m_components) {
-        if (pair.second.enabled) {
-            setComponentEnabled(pair.first, false);
-        }
-    }
+    applyToMask(m_enabledBits, m_liveBits, false);
 }
 
 std::vector<std::string> ToggleManager::getVisibleComponents() const {
-    std::vector<std::string> visible;
-    
-    for (const auto& pair : m_components) {
-        if (pair.second.visible) {
-            visible.push_back(pair.first);
-        }
-    }
-    
-    return visible;
+    return collectIds(m_visibleBits, true);
 }
 
 std::vector<std::string> ToggleManager::getEnabledComponents() const {
-    std::vector<std::string> enabled;
-    
-    for (const auto& pair : m_components) {
-        if (pair.second.enabled) {
-            enabled.push_back(pair.first);
-        }
-    }
-    
-    return enabled;
+    return collectIds(m_enabledBits, true);
 }
 
 std::vector<std::string> ToggleManager::getDisabledComponents() const {
-    std::vector<std::string> disabled;
-    
-    for (const auto& pair : m_components) {
-        if (!pair.second.enabled) {
-            disabled.push_back(pair.first);
-        }
-    }
-    
-    return disabled;
+    return collectIds(m_enabledBits, false);
 }
 
 std::vector<std::string> ToggleManager::getInvisibleComponents() const {
-    std::vector<std::string> invisible;
-    
-    for (const auto& pair : m_components) {
-        if (!pair.second.visible) {
-            invisible.push_back(pair.first);
-        }
-    }
-    
-    return invisible;
+    return collectIds(m_visibleBits, false);
 }
 
 bool ToggleManager::loadFromFile(const std::string& configPath) {
@@ -408,7 +374,8 @@ bool ToggleManager::loadFromFile(const std::string& configPath) {
     try {
         Json::Value root = loadJSONFromFile(path);
         if (root.isNull()) {
-            std::cout << "Toggle configuration file not found or invalid, using defaults: " << path << std::endl;
+            debuglog(DebugLevel::Info, "Toggle configuration file not found or invalid, using defaults: ",
+                     path);
             return false;
         }
 
@@ -417,7 +384,7 @@ bool ToggleManager::loadFromFile(const std::string& configPath) {
             return false;
         }
 
-        std::cout << "Toggle configuration loaded successfully from: " << path << std::endl;
+        debuglog(DebugLevel::Info, "Toggle configuration loaded successfully from: ", path);
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error loading toggle configuration: " << e.what() << std::endl;
@@ -444,7 +411,7 @@ bool ToggleManager::saveToFile(const std::string& configPath) {
             return false;
         }
 
-        std::cout << "Toggle configuration saved successfully to: " << path << std::endl;
+        debuglog(DebugLevel::Info, "Toggle configuration saved successfully to: ", path);
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error saving toggle configuration: " << e.what() << std::endl;
@@ -452,10 +419,25 @@ bool ToggleManager::saveToFile(const std::string& configPath) {
     }
 }
 
+void ToggleManager::saveToFileAsync(const std::string& configPath) {
+    std::string path = configPath.empty() ? m_configPath : configPath;
+    
+    if (path.empty()) {
+        path = getDefaultConfigPath();
+    }
+
+    SettingsWriter::getInstance().schedule(path, serializeToString());
+}
+
+void ToggleManager::scheduleAutoSave() {
+    if (m_autoSave) {
+        saveToFileAsync();
+    }
+}
+
 void ToggleManager::resetToDefaults() {
-    std::cout << "Resetting toggle manager to defaults" << std::endl;
-    m_components.clear();
-    m_categories.clear();
+    debuglog(DebugLevel::Info, "Resetting toggle manager to defaults");
+    clearComponents();
     m_preservedKeybindings.clear();
     initializeDefaultComponents();
 }
@@ -495,18 +477,23 @@ Json::Value ToggleManager::serialize() const {
     
     // Serialize component data
     Json::Value components(Json::objectValue);
-    for (const auto& pair : m_components) {
+    for (size_t i = 0; i < m_components.size(); ++i) {
+        const ComponentHandle handle = static_cast<ComponentHandle>(i);
+        if (!isLive(handle)) {
+            continue;
+        }
+        const ComponentData& data = m_components[i];
         Json::Value compData;
-        compData["display_name"] = pair.second.displayName;
-        compData["category"] = pair.second.category;
-        compData["visible"] = pair.second.visible;
-        compData["enabled"] = pair.second.enabled;
-        compData["z_index"] = pair.second.zIndex;
-        compData["shortcut_key"] = pair.second.shortcutKey;
-        compData["shortcut_ctrl"] = pair.second.shortcutCtrl;
-        compData["shortcut_alt"] = pair.second.shortcutAlt;
+        compData["display_name"] = data.displayName;
+        compData["category"] = data.category;
+        compData["visible"] = testBit(m_visibleBits, handle);
+        compData["enabled"] = testBit(m_enabledBits, handle);
+        compData["z_index"] = data.zIndex;
+        compData["shortcut_key"] = data.shortcutKey;
+        compData["shortcut_ctrl"] = data.shortcutCtrl;
+        compData["shortcut_alt"] = data.shortcutAlt;
         
-        components[pair.first] = compData;
+        components[data.id] = compData;
     }
     root["components"] = components;
     
@@ -526,9 +513,8 @@ bool ToggleManager::deserialize(const Json::Value& data) {
     }
     
     try {
-        // Clear existing data
-        m_components.clear();
-        m_categories.clear();
+        // Clear existing data; component handles survive and are rebound below
+        clearComponents();
         m_preservedKeybindings.clear();
         
         // Deserialize component data
@@ -540,42 +526,47 @@ bool ToggleManager::deserialize(const Json::Value& data) {
                     continue;
                 }
                 
-                ComponentData comp;
+                std::string displayName;
+                std::string category = "General";
+                bool visible = true;
+                bool enabled = true;
                 
                 if (compData.isMember("display_name") && compData["display_name"].isString()) {
-                    comp.displayName = compData["display_name"].asString();
+                    displayName = compData["display_name"].asString();
                 }
                 
                 if (compData.isMember("category") && compData["category"].isString()) {
-                    comp.category = compData["category"].asString();
+                    category = compData["category"].asString();
                 }
                 
                 if (compData.isMember("visible")) {
-                    comp.visible = compData["visible"].asBool();
+                    visible = compData["visible"].asBool();
                 }
                 
                 if (compData.isMember("enabled")) {
-                    comp.enabled = compData["enabled"].asBool();
+                    enabled = compData["enabled"].asBool();
                 }
                 
-                if (compData.isMember("z_index") && compData["z_index"].isInt()) {
-                    comp.zIndex = compData["z_index"].asInt();
+                ComponentHandle handle = registerComponent(key, displayName, visible, category);
+                if (handle == kInvalidHandle) {
+                    return false;
                 }
+                assignBit(m_enabledBits, handle, enabled);
                 
-                if (compData.isMember("shortcut_key") && compData["shortcut_key"].isInt()) {
-                    comp.shortcutKey = compData["shortcut_key"].asInt();
+                if (compData.isMember("z_index") && compData["z_index"].isInt()) {
+                    m_components[handle].zIndex = compData["z_index"].asInt();
                 }
                 
-                if (compData.isMember("shortcut_ctrl")) {
-                    comp.shortcutCtrl = compData["shortcut_ctrl"].asBool();
+                int shortcutKey = 0;
+                if (compData.isMember("shortcut_key") && compData["shortcut_key"].isInt()) {
+                    shortcutKey = compData["shortcut_key"].asInt();
                 }
                 
-                if (compData.isMember("shortcut_alt")) {
-                    comp.shortcutAlt = compData["shortcut_alt"].asBool();
+                if (shortcutKey != 0) {
+                    registerToggleShortcut(key, shortcutKey,
+                                           compData.isMember("shortcut_ctrl") && compData["shortcut_ctrl"].asBool(),
+                                           compData.isMember("shortcut_alt") && compData["shortcut_alt"].asBool());
                 }
-                
-                m_components[key] = comp;
-                m_categories[comp.category].insert(key);
             }
         }
         
@@ -624,6 +615,93 @@ bool ToggleManager::deserializeFromString(const std::string& data) {
     }
 }
 
+void ToggleManager::writeSnapshot(SnapshotWriter& writer) const {
+    writer.writeU32(static_cast<uint32_t>(getComponentCount()));
+    for (size_t i = 0; i < m_components.size(); ++i) {
+        const ComponentHandle handle = static_cast<ComponentHandle>(i);
+        if (!isLive(handle)) {
+            continue;
+        }
+        const ComponentData& data = m_components[i];
+        writer.writeString(data.id);
+        writer.writeString(data.displayName);
+        writer.writeString(data.category);
+        writer.writeBool(testBit(m_visibleBits, handle));
+        writer.writeBool(testBit(m_enabledBits, handle));
+        writer.writeInt(data.zIndex);
+        writer.writeInt(data.shortcutKey);
+        writer.writeBool(data.shortcutCtrl);
+        writer.writeBool(data.shortcutAlt);
+    }
+    
+    writer.writeU32(static_cast<uint32_t>(m_preservedKeybindings.size()));
+    for (const auto& pair : m_preservedKeybindings) {
+        writer.writeString(pair.first);
+        writer.writeString(pair.second);
+    }
+}
+
+bool ToggleManager::readSnapshot(SnapshotReader& reader) {
+    struct Entry {
+        std::string id;
+        std::string displayName;
+        std::string category;
+        bool visible;
+        bool enabled;
+        int zIndex;
+        int shortcutKey;
+        bool shortcutCtrl;
+        bool shortcutAlt;
+    };
+    
+    // Read everything before touching state so a bad snapshot leaves the manager as it was
+    std::vector<Entry> entries;
+    const uint32_t count = reader.readU32();
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        Entry entry;
+        entry.id = reader.readString();
+        entry.displayName = reader.readString();
+        entry.category = reader.readString();
+        entry.visible = reader.readBool();
+        entry.enabled = reader.readBool();
+        entry.zIndex = reader.readInt();
+        entry.shortcutKey = reader.readInt();
+        entry.shortcutCtrl = reader.readBool();
+        entry.shortcutAlt = reader.readBool();
+        if (!isValidComponentId(entry.id) || !isValidCategory(entry.category)) {
+            return false;
+        }
+        entries.push_back(std::move(entry));
+    }
+    
+    std::map<std::string, std::string> keybindings;
+    const uint32_t keybindingCount = reader.readU32();
+    for (uint32_t i = 0; i < keybindingCount && reader.ok(); ++i) {
+        std::string action = reader.readString();
+        keybindings[action] = reader.readString();
+    }
+    
+    if (!reader.ok()) {
+        return false;
+    }
+    
+    clearComponents();
+    for (const Entry& entry : entries) {
+        ComponentHandle handle = registerComponent(entry.id, entry.displayName, entry.visible, entry.category);
+        if (handle == kInvalidHandle) {
+            continue;
+        }
+        assignBit(m_enabledBits, handle, entry.enabled);
+        m_components[handle].zIndex = entry.zIndex;
+        if (entry.shortcutKey != 0) {
+            registerToggleShortcut(entry.id, entry.shortcutKey, entry.shortcutCtrl, entry.shortcutAlt);
+        }
+    }
+    m_preservedKeybindings = std::move(keybindings);
+    
+    return validateComponentData();
+}
+
 int ToggleManager::addComponentStateChangeCallback(ComponentStateChangeCallback callback) {
     m_componentCallbacks.push_back(callback);
     return m_nextCallbackId++;
@@ -660,6 +738,10 @@ void ToggleManager::notifyComponentStateChange(const std::string& componentId, b
             std::cerr << "Error in component state change callback: " << e.what() << std::endl;
         }
     }
+    
+    // The overlay listens on the bus, e.g. to show the frame profiler
+    cataclysm::gui::EventBusManager::getGlobalEventBus().publish(
+        cataclysm::gui::UiComponentToggledEvent(cataclysm::gui::Symbol(componentId), visible, enabled));
 }
 
 void ToggleManager::notifyBulkStateChange(const std::string& category, bool visible, bool enabled) {
@@ -673,55 +755,87 @@ void ToggleManager::notifyBulkStateChange(const std::string& category, bool visi
 }
 
 bool ToggleManager::processKeyboardToggle(int key, bool ctrlPressed, bool altPressed) {
-    std::string componentId = getComponentIdFromShortcut(key, ctrlPressed, altPressed);
+    ComponentHandle handle = getComponentFromShortcut(key, ctrlPressed, altPressed);
     
-    if (componentId.empty()) {
+    if (handle == kInvalidHandle) {
         return false;
     }
     
     // Toggle visibility of the component
-    bool currentVisible = isComponentVisible(componentId);
-    setComponentVisible(componentId, !currentVisible);
+    bool currentVisible = isComponentVisible(handle);
+    setComponentVisible(handle, !currentVisible);
     
-    std::cout << "Toggle key pressed for component: " << componentId 
-              << " (now " << (currentVisible ? "hidden" : "visible") << ")" << std::endl;
+    debuglog(DebugLevel::Debug, "Toggle key pressed for component: ", m_components[handle].id, " (now ",
+             (currentVisible ? "hidden" : "visible"), ")");
     
     return true;
 }
 
 void ToggleManager::registerToggleShortcut(const std::string& componentId, int key, bool ctrl, bool alt) {
-    auto it = m_components.find(componentId);
-    if (it != m_components.end()) {
-        it->second.shortcutKey = key;
-        it->second.shortcutCtrl = ctrl;
-        it->second.shortcutAlt = alt;
-        
-        std::cout << "Registered toggle shortcut for " << componentId 
-                  << ": key=" << key << " ctrl=" << ctrl << " alt=" << alt << std::endl;
+    ComponentHandle handle = findLiveHandle(componentId);
+    if (handle == kInvalidHandle) {
+        return;
+    }
+    
+    unregisterToggleShortcut(componentId);
+    if (key == 0) {
+        return;
+    }
+    
+    // A shortcut toggles one component; the newest binding takes it over
+    const uint32_t packed = packShortcut(key, ctrl, alt);
+    auto it = m_shortcuts.find(packed);
+    if (it != m_shortcuts.end() && isLive(it->second)) {
+        ComponentData& previous = m_components[it->second];
+        debuglog(DebugLevel::Debug, "Toggle shortcut moved from ", previous.id, " to ", componentId);
+        previous.shortcutKey = 0;
+        previous.shortcutCtrl = false;
+        previous.shortcutAlt = false;
     }
+    m_shortcuts[packed] = handle;
+    
+    ComponentData& data = m_components[handle];
+    data.shortcutKey = key;
+    data.shortcutCtrl = ctrl;
+    data.shortcutAlt = alt;
+    
+    debuglog(DebugLevel::Debug, "Registered toggle shortcut for ", componentId, ": key=", key,
+             " ctrl=", ctrl, " alt=", alt);
 }
 
 void ToggleManager::unregisterToggleShortcut(const std::string& componentId) {
-    auto it = m_components.find(componentId);
-    if (it != m_components.end()) {
-        it->second.shortcutKey = 0;
-        it->second.shortcutCtrl = false;
-        it->second.shortcutAlt = false;
-        
-        std::cout << "Unregistered toggle shortcut for " << componentId << std::endl;
+    ComponentHandle handle = findLiveHandle(componentId);
+    if (handle == kInvalidHandle) {
+        return;
+    }
+    
+    ComponentData& data = m_components[handle];
+    if (data.shortcutKey == 0) {
+        return;
+    }
+    
+    auto it = m_shortcuts.find(packShortcut(data.shortcutKey, data.shortcutCtrl, data.shortcutAlt));
+    if (it != m_shortcuts.end() && it->second == handle) {
+        m_shortcuts.erase(it);
     }
+    data.shortcutKey = 0;
+    data.shortcutCtrl = false;
+    data.shortcutAlt = false;
+    
+    debuglog(DebugLevel::Debug, "Unregistered toggle shortcut for ", componentId);
 }
 
 std::string ToggleManager::getShortcutForComponent(const std::string& componentId) const {
-    auto it = m_components.find(componentId);
-    if (it == m_components.end() || it->second.shortcutKey == 0) {
+    ComponentHandle handle = findLiveHandle(componentId);
+    if (handle == kInvalidHandle || m_components[handle].shortcutKey == 0) {
         return "";
     }
     
+    const ComponentData& data = m_components[handle];
     std::string shortcut = "";
-    if (it->second.shortcutCtrl) shortcut += "Ctrl+";
-    if (it->second.shortcutAlt) shortcut += "Alt+";
-    shortcut += "Key_" + std::to_string(it->second.shortcutKey);
+    if (data.shortcutCtrl) shortcut += "Ctrl+";
+    if (data.shortcutAlt) shortcut += "Alt+";
+    shortcut += "Key_" + std::to_string(data.shortcutKey);
     
     return shortcut;
 }
@@ -745,17 +859,17 @@ void ToggleManager::preserveKeybindings() {
     m_preservedKeybindings["toggle_char"] = "Shift+C";
     m_preservedKeybindings["toggle_construct"] = "Shift+N";
     
-    std::cout << "Preserved " << m_preservedKeybindings.size() << " existing keybindings" << std::endl;
+    debuglog(DebugLevel::Debug, "Preserved ", m_preservedKeybindings.size(), " existing keybindings");
 }
 
 void ToggleManager::restoreKeybindings() {
     // Restore preserved keybindings
     // This would integrate with Cataclysm-BN's keybinding system
     
-    std::cout << "Restoring " << m_preservedKeybindings.size() << " preserved keybindings" << std::endl;
+    debuglog(DebugLevel::Debug, "Restoring ", m_preservedKeybindings.size(), " preserved keybindings");
     
     for (const auto& pair : m_preservedKeybindings) {
-        std::cout << "Restored: " << pair.first << " -> " << pair.second << std::endl;
+        debuglog(DebugLevel::Debug, "Restored: ", pair.first, " -> ", pair.second);
     }
 }
 
@@ -764,46 +878,29 @@ bool ToggleManager::isKeybindingPreserved(const std::string& action) const {
 }
 
 int ToggleManager::getComponentCount() const {
-    return static_cast<int>(m_components.size());
+    return countBits(m_liveBits, m_liveBits);
 }
 
 int ToggleManager::getVisibleComponentCount() const {
-    int count = 0;
-    for (const auto& pair : m_components) {
-        if (pair.second.visible) count++;
-    }
-    return count;
+    return countBits(m_visibleBits, m_liveBits);
 }
 
 int ToggleManager::getEnabledComponentCount() const {
-    int count = 0;
-    for (const auto& pair : m_components) {
-        if (pair.second.enabled) count++;
-    }
-    return count;
+    return countBits(m_enabledBits, m_liveBits);
 }
 
 std::map<std::string, int> ToggleManager::getComponentStats() const {
     std::map<std::string, int> stats;
     
-    for (const auto& catPair : m_categories) {
-        const std::string& category = catPair.first;
-        const std::set<std::string>& components = catPair.second;
-        
-        int visible = 0;
-        int enabled = 0;
-        
-        for (const auto& componentId : components) {
-            auto compIt = m_components.find(componentId);
-            if (compIt != m_components.end()) {
-                if (compIt->second.visible) visible++;
-                if (compIt->second.enabled) enabled++;
-            }
+    for (const auto& cat : m_categories) {
+        int total = countBits(cat.members, m_liveBits);
+        if (total == 0) {
+            continue;
         }
         
-        stats[category + "_total"] = static_cast<int>(components.size());
-        stats[category + "_visible"] = visible;
-        stats[category + "_enabled"] = enabled;
+        stats[cat.name + "_total"] = total;
+        stats[cat.name + "_visible"] = countBits(cat.members, m_visibleBits);
+        stats[cat.name + "_enabled"] = countBits(cat.members, m_enabledBits);
     }
     
     return stats;
@@ -811,9 +908,13 @@ std::map<std::string, int> ToggleManager::getComponentStats() const {
 
 bool ToggleManager::validateComponentData() const {
     // Validate all component data
-    for (const auto& pair : m_components) {
-        const std::string& componentId = pair.first;
-        const ComponentData& data = pair.second;
+    for (size_t i = 0; i < m_components.size(); ++i) {
+        const ComponentHandle handle = static_cast<ComponentHandle>(i);
+        if (!isLive(handle)) {
+            continue;
+        }
+        const ComponentData& data = m_components[i];
+        const std::string& componentId = data.id;
         
         if (componentId.empty()) {
             std::cerr << "Found empty component ID" << std::endl;
@@ -830,8 +931,8 @@ bool ToggleManager::validateComponentData() const {
             return false;
         }
         
-        if (m_categories.find(data.category) == m_categories.end() ||
-            m_categories.at(data.category).find(componentId) == m_categories.at(data.category).end()) {
+        const CategoryData* cat = findCategory(data.category);
+        if (!cat || !testBit(cat->members, handle)) {
             std::cerr << "Component " << componentId << " not found in its category" << std::endl;
             return false;
         }
@@ -879,18 +980,13 @@ Json::Value ToggleManager::loadJSONFromFile(const std::string& filePath) {
 
 bool ToggleManager::saveJSONToFile(const Json::Value& json, const std::string& filePath) {
     try {
-        std::ofstream file(filePath);
-        if (!file.is_open()) {
-            return false;
-        }
-        
         Json::StreamWriterBuilder writer;
+        std::ostringstream oss;
         std::unique_ptr<Json::StreamWriter> jsonWriter(writer.newStreamWriter());
-        jsonWriter->write(json, &file);
+        jsonWriter->write(json, &oss);
         jsonWriter->releaseStream();
         
-        file.close();
-        return true;
+        return SettingsWriter::getInstance().write(filePath, oss.str());
     } catch (const std::exception& e) {
         std::cerr << "Error saving JSON file: " << e.what() << std::endl;
         return false;
@@ -942,14 +1038,130 @@ std::string ToggleManager::getCurrentTimestamp() {
     return std::string(buffer);
 }
 
-std::string ToggleManager::getComponentIdFromShortcut(int key, bool ctrl, bool alt) const {
-    for (const auto& pair : m_components) {
-        const ComponentData& data = pair.second;
-        if (data.shortcutKey == key && data.shortcutCtrl == ctrl && data.shortcutAlt == alt) {
-            return pair.first;
+uint32_t ToggleManager::packShortcut(int key, bool ctrl, bool alt) {
+    return (static_cast<uint32_t>(key) << 2) | (ctrl ? 2u : 0u) | (alt ? 1u : 0u);
+}
+
+ToggleManager::ComponentHandle ToggleManager::getComponentFromShortcut(int key, bool ctrl, bool alt) const {
+    auto it = m_shortcuts.find(packShortcut(key, ctrl, alt));
+    if (it == m_shortcuts.end() || !isLive(it->second)) {
+        return kInvalidHandle;
+    }
+    return it->second;
+}
+
+void ToggleManager::assignBit(Bitset& bits, ComponentHandle handle, bool value) {
+    const size_t word = static_cast<size_t>(handle) / 64;
+    const uint64_t bit = uint64_t{1} << (static_cast<size_t>(handle) % 64);
+    if (word >= bits.size()) {
+        if (!value) {
+            return;
+        }
+        bits.resize(word + 1, 0);
+    }
+    bits[word] = value ? (bits[word] | bit) : (bits[word] & ~bit);
+}
+
+int ToggleManager::countBits(const Bitset& bits, const Bitset& mask) {
+    int count = 0;
+    const size_t words = std::min(bits.size(), mask.size());
+    for (size_t i = 0; i < words; ++i) {
+        count += static_cast<int>(std::bitset<64>(bits[i] & mask[i]).count());
+    }
+    return count;
+}
+
+std::vector<std::string> ToggleManager::collectIds(const Bitset& bits, bool value) const {
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < m_components.size(); ++i) {
+        const ComponentHandle handle = static_cast<ComponentHandle>(i);
+        if (isLive(handle) && testBit(bits, handle) == value) {
+            ids.push_back(m_components[i].id);
+        }
+    }
+    
+    // Callers have always seen IDs in sorted order
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+ToggleManager::ComponentHandle ToggleManager::findLiveHandle(const std::string& componentId) const {
+    auto it = m_handles.find(componentId);
+    if (it == m_handles.end() || !isLive(it->second)) {
+        return kInvalidHandle;
+    }
+    return it->second;
+}
+
+int ToggleManager::getOrCreateCategory(const std::string& category) {
+    auto it = m_categoryIndices.find(category);
+    if (it != m_categoryIndices.end()) {
+        return it->second;
+    }
+    
+    int index = static_cast<int>(m_categories.size());
+    m_categories.push_back(CategoryData{category, {}});
+    m_categoryIndices[category] = index;
+    return index;
+}
+
+const ToggleManager::CategoryData* ToggleManager::findCategory(const std::string& category) const {
+    auto it = m_categoryIndices.find(category);
+    return it == m_categoryIndices.end() ? nullptr : &m_categories[it->second];
+}
+
+void ToggleManager::clearComponents() {
+    // Slots and the ID -> handle map stay, so re-registered components get their old handles
+    m_liveBits.clear();
+    m_visibleBits.clear();
+    m_enabledBits.clear();
+    for (auto& cat : m_categories) {
+        cat.members.clear();
+    }
+    for (auto& data : m_components) {
+        data.shortcutKey = 0;
+        data.shortcutCtrl = false;
+        data.shortcutAlt = false;
+    }
+    m_shortcuts.clear();
+}
+
+void ToggleManager::applyToMask(Bitset& bits, const Bitset& mask, bool value) {
+    const size_t words = std::min(mask.size(), m_liveBits.size());
+    if (value && bits.size() < words) {
+        bits.resize(words, 0);
+    }
+    
+    Bitset changedBits(std::min(words, bits.size()), 0);
+    bool anyChanged = false;
+    for (size_t i = 0; i < changedBits.size(); ++i) {
+        const uint64_t target = mask[i] & m_liveBits[i];
+        changedBits[i] = value ? (target & ~bits[i]) : (target & bits[i]);
+        if (changedBits[i] == 0) {
+            continue;
         }
+        bits[i] = value ? (bits[i] | target) : (bits[i] & ~target);
+        anyChanged = true;
     }
-    return "";
+    
+    if (!anyChanged) {
+        return;
+    }
+    
+    // Notify once every word is updated so callbacks see the final state of all components
+    for (size_t i = 0; i < changedBits.size(); ++i) {
+        uint64_t changed = changedBits[i];
+        while (changed != 0) {
+            const uint64_t lowest = changed & (~changed + 1);
+            const size_t bit = std::bitset<64>(lowest - 1).count();
+            const ComponentHandle handle = static_cast<ComponentHandle>(i * 64 + bit);
+            notifyComponentStateChange(m_components[handle].id, testBit(m_visibleBits, handle),
+                                       testBit(m_enabledBits, handle));
+            changed &= changed - 1;
+        }
+    }
+    
+    scheduleAutoSave();
 }
 
 } // namespace GUI
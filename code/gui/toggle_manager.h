@@ -1,9 +1,10 @@
 #ifndef TOGGLE_MANAGER_H
 #define TOGGLE_MANAGER_H
 
+#include <cstdint>
 #include <string>
 #include <map>
-#include <set>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <memory>
@@ -14,13 +15,24 @@ namespace GUI {
 
 // Forward declarations
 class GUISettings;
+class SnapshotWriter;
+class SnapshotReader;
 
 /**
  * ToggleManager handles enabling/disabling individual GUI elements
  * and provides notification system for UI state changes
+ *
+ * Components live in a dense table indexed by handle. Visibility, enabled
+ * state and category membership are bitsets over that table, so per-frame
+ * checks are a single bit test and category-wide changes touch one word per
+ * 64 components. A handle stays bound to its component ID for the lifetime
+ * of the manager, including across unregister/register and reloads.
  */
 class ToggleManager {
 public:
+    using ComponentHandle = int;
+    static constexpr ComponentHandle kInvalidHandle = -1;
+
     // Constructor and Destructor
     ToggleManager();
     ~ToggleManager();
@@ -32,15 +44,16 @@ public:
     // Singleton access
     static ToggleManager& getInstance();
 
-    // Component management
-    bool registerComponent(const std::string& componentId, 
-                          const std::string& displayName,
-                          bool defaultVisible = true,
-                          const std::string& category = "General");
+    // Component management; returns kInvalidHandle if the component cannot be registered
+    ComponentHandle registerComponent(const std::string& componentId,
+                                      const std::string& displayName,
+                                      bool defaultVisible = true,
+                                      const std::string& category = "General");
     
     bool unregisterComponent(const std::string& componentId);
     
     bool componentExists(const std::string& componentId) const;
+    ComponentHandle getComponentHandle(const std::string& componentId) const;
     std::vector<std::string> getAllComponentIds() const;
     std::vector<std::string> getComponentIdsByCategory(const std::string& category) const;
     std::vector<std::string> getAllCategories() const;
@@ -52,6 +65,12 @@ public:
     bool setComponentEnabled(const std::string& componentId, bool enabled);
     bool isComponentEnabled(const std::string& componentId) const;
 
+    // Handle-based variants for per-frame use; unregistered handles read as hidden/disabled
+    bool setComponentVisible(ComponentHandle handle, bool visible);
+    bool setComponentEnabled(ComponentHandle handle, bool enabled);
+    bool isComponentVisible(ComponentHandle handle) const { return testBit(m_visibleBits, handle); }
+    bool isComponentEnabled(ComponentHandle handle) const { return testBit(m_enabledBits, handle); }
+
     // Component display information
     std::string getComponentDisplayName(const std::string& componentId) const;
     std::string getComponentCategory(const std::string& componentId) const;
@@ -74,16 +93,26 @@ public:
     // Persistence
     bool loadFromFile(const std::string& configPath = "");
     bool saveToFile(const std::string& configPath = "");
+    // Serialize now and hand the write to the background SettingsWriter
+    void saveToFileAsync(const std::string& configPath = "");
     void resetToDefaults();
     void setConfigPath(const std::string& path) { m_configPath = path; }
     std::string getConfigPath() const { return m_configPath; }
 
+    // Save in the background after every state change
+    void setAutoSave(bool enabled) { m_autoSave = enabled; }
+    bool getAutoSave() const { return m_autoSave; }
+
     // Serialization
     Json::Value serialize() const;
     bool deserialize(const Json::Value& data);
     std::string serializeToString() const;
     bool deserializeFromString(const std::string& data);
 
+    // Binary snapshot section holding components, state and shortcuts
+    void writeSnapshot(SnapshotWriter& writer) const;
+    bool readSnapshot(SnapshotReader& reader);
+
     // Event system
     using ComponentStateChangeCallback = std::function<void(const std::string& componentId, bool visible, bool enabled)>;
     using BulkStateChangeCallback = std::function<void(const std::string& category, bool visible, bool enabled)>;
@@ -123,13 +152,14 @@ private:
     // Configuration data
     std::string m_configPath;
     GUISettings* m_settings;
+    bool m_autoSave;
 
-    // Component data structure
+    // Component data structure; visible/enabled state lives in the bitsets below
     struct ComponentData {
+        std::string id;
         std::string displayName;
         std::string category;
-        bool visible;
-        bool enabled;
+        int categoryIndex;
         int zIndex;
         
         // Keyboard shortcut data
@@ -138,18 +168,35 @@ private:
         bool shortcutAlt;
 
         ComponentData() : 
+            id(""),
             displayName(""), 
             category("General"), 
-            visible(true), 
-            enabled(true), 
+            categoryIndex(-1),
             zIndex(0),
             shortcutKey(0),
             shortcutCtrl(false),
             shortcutAlt(false) {}
     };
 
-    std::map<std::string, ComponentData> m_components;
-    std::map<std::string, std::set<std::string>> m_categories; // category -> componentIds
+    using Bitset = std::vector<uint64_t>;
+
+    struct CategoryData {
+        std::string name;
+        Bitset members;
+    };
+
+    // Indexed by handle; unregistered slots keep their ID so re-registering reuses the handle
+    std::vector<ComponentData> m_components;
+    std::unordered_map<std::string, ComponentHandle> m_handles;
+    Bitset m_liveBits;
+    Bitset m_visibleBits;
+    Bitset m_enabledBits;
+
+    std::vector<CategoryData> m_categories;
+    std::unordered_map<std::string, int> m_categoryIndices;
+
+    // Packed (key, ctrl, alt) -> component
+    std::unordered_map<uint32_t, ComponentHandle> m_shortcuts;
 
     // Preserved keybindings for backward compatibility
     std::map<std::string, std::string> m_preservedKeybindings;
@@ -163,6 +210,7 @@ private:
     void initializeDefaultComponents();
 
     // File I/O helpers
+    void scheduleAutoSave();
     bool ensureConfigDirectory();
     Json::Value loadJSONFromFile(const std::string& filePath);
     bool saveJSONToFile(const Json::Value& json, const std::string& filePath);
@@ -171,13 +219,32 @@ private:
     void notifyComponentStateChange(const std::string& componentId, bool visible, bool enabled);
     void notifyBulkStateChange(const std::string& category, bool visible, bool enabled);
 
+    // Bitset helpers
+    static bool testBit(const Bitset& bits, ComponentHandle handle) {
+        return handle >= 0 && static_cast<size_t>(handle) / 64 < bits.size() &&
+               ((bits[static_cast<size_t>(handle) / 64] >> (static_cast<size_t>(handle) % 64)) & 1u) != 0;
+    }
+    static void assignBit(Bitset& bits, ComponentHandle handle, bool value);
+    static int countBits(const Bitset& bits, const Bitset& mask);
+    std::vector<std::string> collectIds(const Bitset& bits, bool value) const;
+
+    bool isLive(ComponentHandle handle) const { return testBit(m_liveBits, handle); }
+    ComponentHandle findLiveHandle(const std::string& componentId) const;
+    int getOrCreateCategory(const std::string& category);
+    const CategoryData* findCategory(const std::string& category) const;
+    void clearComponents();
+
+    // Set bits under mask to value and notify every component that changed
+    void applyToMask(Bitset& bits, const Bitset& mask, bool value);
+
     // Utility functions
     static bool isValidComponentId(const std::string& id);
     static bool isValidCategory(const std::string& category);
     static std::string getCurrentTimestamp();
 
     // Keyboard event processing
-    std::string getComponentIdFromShortcut(int key, bool ctrl, bool alt) const;
+    static uint32_t packShortcut(int key, bool ctrl, bool alt);
+    ComponentHandle getComponentFromShortcut(int key, bool ctrl, bool alt) const;
 };
 
 } // namespace GUI
@@ -13,50 +13,61 @@ UiManager& UiManager::instance() {
 
 void UiManager::register_adaptor(UiAdaptor& adaptor) {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (std::find(adaptors_.begin(), adaptors_.end(), &adaptor) == adaptors_.end()) {
-        adaptors_.push_back(&adaptor);
+    if (std::find(adaptors_->begin(), adaptors_->end(), &adaptor) == adaptors_->end()) {
+        auto adaptors = std::make_shared<AdaptorList>(*adaptors_);
+        adaptors->push_back(&adaptor);
+        adaptors_ = std::move(adaptors);
     }
 }
 
 void UiManager::unregister_adaptor(UiAdaptor& adaptor) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = std::find(adaptors_.begin(), adaptors_.end(), &adaptor);
-    if (it != adaptors_.end()) {
-        adaptors_.erase(it);
+    auto it = std::find(adaptors_->begin(), adaptors_->end(), &adaptor);
+    if (it != adaptors_->end()) {
+        auto adaptors = std::make_shared<AdaptorList>(*adaptors_);
+        adaptors->erase(adaptors->begin() + (it - adaptors_->begin()));
+        adaptors_ = std::move(adaptors);
     }
 }
 
 void UiManager::request_redraw() {
-    std::vector<UiAdaptor*> adaptors_copy;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        adaptors_copy = adaptors_;
-    }
-
-    dispatch_redraw(adaptors_copy);
+    redraw_pending_.store(true, std::memory_order_release);
 }
 
 void UiManager::request_screen_resize(int width, int height) {
-    std::vector<UiAdaptor*> adaptors_copy;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        adaptors_copy = adaptors_;
+    dispatch_screen_resize(*snapshot(), width, height);
+}
+
+bool UiManager::dispatch_redraws() {
+    // Cleared before dispatching, so requests made by the callbacks
+    // themselves land in the next frame instead of looping
+    if (!redraw_pending_.exchange(false, std::memory_order_acq_rel)) {
+        return false;
     }
 
-    dispatch_screen_resize(adaptors_copy, width, height);
+    dispatch_redraw(*snapshot());
+    return true;
+}
+
+bool UiManager::redraw_pending() const {
+    return redraw_pending_.load(std::memory_order_acquire);
 }
 
 std::size_t UiManager::registered_count() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return adaptors_.size();
+    return snapshot()->size();
 }
 
 bool UiManager::is_registered(const UiAdaptor& adaptor) const {
+    const auto adaptors = snapshot();
+    return std::find(adaptors->begin(), adaptors->end(), &adaptor) != adaptors->end();
+}
+
+std::shared_ptr<const UiManager::AdaptorList> UiManager::snapshot() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return std::find(adaptors_.begin(), adaptors_.end(), &adaptor) != adaptors_.end();
+    return adaptors_;
 }
 
-void UiManager::dispatch_redraw(const std::vector<UiAdaptor*>& adaptors) {
+void UiManager::dispatch_redraw(const AdaptorList& adaptors) {
     for (UiAdaptor* adaptor : adaptors) {
         if (adaptor) {
             adaptor->trigger_redraw();
@@ -64,7 +75,7 @@ void UiManager::dispatch_redraw(const std::vector<UiAdaptor*>& adaptors) {
     }
 }
 
-void UiManager::dispatch_screen_resize(const std::vector<UiAdaptor*>& adaptors, int width, int height) {
+void UiManager::dispatch_screen_resize(const AdaptorList& adaptors, int width, int height) {
     for (UiAdaptor* adaptor : adaptors) {
         if (adaptor) {
             adaptor->trigger_screen_resize(width, height);
@@ -1,7 +1,9 @@
 #ifndef CATACLYSM_GUI_UI_MANAGER_H
 #define CATACLYSM_GUI_UI_MANAGER_H
 
+#include <atomic>
 #include <cstddef>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -16,9 +18,17 @@ public:
     void register_adaptor(UiAdaptor& adaptor);
     void unregister_adaptor(UiAdaptor& adaptor);
 
+    // Mark all registered UIs for redraw. Only sets a flag, so bursts of
+    // state updates cost nothing until the next dispatch_redraws().
     void request_redraw();
     void request_screen_resize(int width, int height);
 
+    // Run one coalesced redraw if any was requested since the last call.
+    // OverlayManager::Render() calls this at the start of every frame; hosts
+    // without an overlay call it once per iteration of their main loop.
+    bool dispatch_redraws();
+    bool redraw_pending() const;
+
     std::size_t registered_count() const;
     bool is_registered(const UiAdaptor& adaptor) const;
 
@@ -27,11 +37,16 @@ private:
     UiManager(const UiManager&) = delete;
     UiManager& operator=(const UiManager&) = delete;
 
-    void dispatch_redraw(const std::vector<UiAdaptor*>& adaptors);
-    void dispatch_screen_resize(const std::vector<UiAdaptor*>& adaptors, int width, int height);
+    using AdaptorList = std::vector<UiAdaptor*>;
+
+    std::shared_ptr<const AdaptorList> snapshot() const;
+    void dispatch_redraw(const AdaptorList& adaptors);
+    void dispatch_screen_resize(const AdaptorList& adaptors, int width, int height);
 
     mutable std::mutex mutex_;
-    std::vector<UiAdaptor*> adaptors_;
+    // Replaced on register/unregister only, so dispatching never copies
+    std::shared_ptr<const AdaptorList> adaptors_ = std::make_shared<const AdaptorList>();
+    std::atomic<bool> redraw_pending_{false};
 };
 
 }  // namespace cataclysm::gui